@@ -0,0 +1,40 @@
+# All the projects, the common library (common/common.pro) first: qmake LearnOpenGL.pro && make, with CONFIG+=lto,
+# CONFIG+=pgo_generate or CONFIG+=pgo_use for the build profiles of common/build_profile.pri
+TEMPLATE = subdirs
+
+SUBDIRS += common
+
+SAMPLES = \
+    hello_projects/hello_camera \
+    hello_projects/hello_camera_class \
+    hello_projects/hello_coordinatesystem \
+    hello_projects/hello_rectangle \
+    hello_projects/hello_texture \
+    hello_projects/hello_transformation \
+    hello_projects/hello_triangle \
+    hello_projects/hello_world \
+    miscellaneous_projects/misc_coordinateaxes \
+    performance_projects/perf_assetarchive \
+    performance_projects/perf_ecs \
+    performance_projects/perf_flythrough \
+    performance_projects/perf_framepacing \
+    performance_projects/perf_glload \
+    performance_projects/perf_glreplay \
+    performance_projects/perf_gpuculling \
+    performance_projects/perf_hotreload \
+    performance_projects/perf_jobs \
+    performance_projects/perf_meshimport \
+    performance_projects/perf_multidraw \
+    performance_projects/perf_occlusion \
+    performance_projects/perf_renderthread \
+    performance_projects/perf_scenefile \
+    performance_projects/perf_shaderload \
+    performance_projects/perf_softraster \
+    performance_projects/perf_uniformnames
+
+for(sample, SAMPLES) {
+    name = $$basename(sample)
+    $${name}.subdir = $$sample
+    $${name}.depends = common
+    SUBDIRS += $$name
+}
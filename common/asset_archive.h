@@ -0,0 +1,549 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <mapped_file.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// Asset archives: many asset files packed into one file, found through a hash table of their paths, so loading an asset
+// is a lookup in the mapped archive instead of an open() of a path relative to the working directory. All numbers are
+// little-endian, the layout is
+//   AssetArchiveHeader
+//   the data of the entries, every one at an offset aligned to the Alignment of the header (stored entries can be used in
+//   place, e.g. handed to glBufferData or stbi_load_from_memory)
+//   the paths of the entries (not terminated, referenced by offset and length)
+//   AssetArchiveEntry[SlotCount]: open addressing hash table of the FNV-1a hashes of the normalized paths
+//   (normalizeAssetPath), linear probing; unused slots have a PathLength of 0
+const uint32_t ASSET_ARCHIVE_VERSION = 1;
+const char ASSET_ARCHIVE_MAGIC[8] = { 'L', 'O', 'G', 'L', 'P', 'A', 'K', '\0' };
+
+enum AssetCompression
+{
+    ASSET_STORED = 0,  // the bytes of the file
+    ASSET_LZ4 = 1      // one LZ4 block (AssetBlockCodec)
+};
+
+struct AssetArchiveHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Alignment;    // of the entry data, a power of two
+    uint64_t EntryCount;
+    uint64_t SlotCount;    // of the hash table, a power of two larger than EntryCount
+    uint64_t PathsOffset;
+    uint64_t PathsSize;
+    uint64_t IndexOffset;
+    uint64_t FileSize;
+};
+
+struct AssetArchiveEntry
+{
+    uint64_t PathHash;
+    uint64_t Offset;       // of the data from the start of the file
+    uint64_t StoredSize;   // bytes in the archive
+    uint64_t Size;         // bytes of the file
+    uint32_t PathOffset;   // into the paths
+    uint32_t PathLength;
+    uint32_t Compression;  // AssetCompression
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(AssetArchiveHeader) == 64 && sizeof(AssetArchiveEntry) == 48, "the structures of the asset archive must not be padded");
+
+// Path as it is stored in an archive and looked up in it: '\' becomes '/', empty and "." parts are dropped and ".." removes
+// the part before it, so "./textures//a/../container.jpg" and "textures/container.jpg" are the same asset
+inline std::string normalizeAssetPath(const std::string &path)
+{
+    std::vector<std::string> parts;
+    std::string part;
+    for (size_t i = 0; i <= path.size(); ++i)
+    {
+        const char c = i < path.size() ? path[i] : '/';
+        if (c != '/' && c != '\\')
+        {
+            part += c;
+            continue;
+        }
+        if (part == "..")
+        {
+            if (!parts.empty())
+                parts.pop_back();
+        }
+        else if (!part.empty() && part != ".")
+            parts.push_back(part);
+        part.clear();
+    }
+    std::string normalized;
+    for (size_t i = 0; i < parts.size(); ++i)
+        normalized += (i > 0 ? "/" : "") + parts[i];
+    return normalized;
+}
+
+// 64 bit FNV-1a hash of a normalized path
+inline uint64_t assetPathHash(const char *path, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ static_cast<unsigned char>(path[i]))*1099511628211ull;
+    return hash;
+}
+
+// Compression of the archive entries in the LZ4 block format: sequences of a token (literal count, match length - 4),
+// the literals and the 2 byte offset of the match back into the output. Compression is greedy with one hash table of the
+// last position of every 4 byte sequence, it skips ahead faster the longer it finds nothing (already compressed data like
+// JPEG or PNG). Decompression checks every length and offset against the buffers, a damaged block fails instead of
+// writing out of bounds
+class AssetBlockCodec
+{
+public:
+    static void compress(const char *source, size_t size, std::vector<char> &block)
+    {
+        block.clear();
+        block.reserve(size + size / 255 + 16);
+        const int HASH_BITS = 16;
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+        size_t anchor = 0, position = 1, misses = 0;
+        // the last match starts 12 bytes before the end, the last 5 bytes are literals (rules of the format)
+        const size_t matchLimit = size > 12 ? size - 12 : 0;
+        while (position < matchLimit)
+        {
+            const uint32_t sequence = read32(source + position);
+            const uint32_t slot = (sequence*2654435761u) >> (32 - HASH_BITS);
+            const size_t candidate = table[slot];
+            table[slot] = static_cast<uint32_t>(position);
+            if (position - candidate > 65535 || read32(source + candidate) != sequence)
+            {
+                position += 1 + (misses++ >> 6);
+                continue;
+            }
+            size_t length = 4;
+            while (position + length < size - 5 && source[candidate + length] == source[position + length])
+                ++length;
+            writeSequence(block, source + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+            misses = 0;
+        }
+        writeSequence(block, source + anchor, size - anchor, 0, 0);
+    }
+
+    // decompresses block into exactly size bytes at destination
+    static bool decompress(const char *block, size_t blockSize, char *destination, size_t size)
+    {
+        const unsigned char *in = reinterpret_cast<const unsigned char*>(block);
+        const unsigned char *inEnd = in + blockSize;
+        char *out = destination;
+        char *outEnd = destination + size;
+        while (in < inEnd)
+        {
+            const unsigned token = *in++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !readLength(in, inEnd, literals))
+                return false;
+            if (literals > size_t(inEnd - in) || literals > size_t(outEnd - out))
+                return false;
+            memcpy(out, in, literals);
+            in += literals;
+            out += literals;
+            if (in == inEnd)
+                break;
+
+            if (inEnd - in < 2)
+                return false;
+            const size_t offset = in[0] | (size_t(in[1]) << 8);
+            in += 2;
+            size_t length = token & 15;
+            if (length == 15 && !readLength(in, inEnd, length))
+                return false;
+            length += 4;
+            if (offset == 0 || offset > size_t(out - destination) || length > size_t(outEnd - out))
+                return false;
+            const char *match = out - offset;
+            if (offset >= length)
+                memcpy(out, match, length);
+            else
+                for (size_t i = 0; i < length; ++i) // overlapping: repeats the last offset bytes
+                    out[i] = match[i];
+            out += length;
+        }
+        return out == outEnd;
+    }
+
+private:
+    static uint32_t read32(const char *data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static void writeLength(std::vector<char> &block, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            block.push_back(static_cast<char>(255));
+        block.push_back(static_cast<char>(length));
+    }
+
+    static bool readLength(const unsigned char* &in, const unsigned char *end, size_t &length)
+    {
+        unsigned char byte;
+        do
+        {
+            if (in == end)
+                return false;
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // literals followed by a match (offset 0: the last literals of the block, without a match)
+    static void writeSequence(std::vector<char> &block, const char *literals, size_t literalCount, size_t offset, size_t length)
+    {
+        const size_t matchCode = offset > 0 ? length - 4 : 0;
+        block.push_back(static_cast<char>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalCount >= 15)
+            writeLength(block, literalCount - 15);
+        block.insert(block.end(), literals, literals + literalCount);
+        if (offset == 0)
+            return;
+        block.push_back(static_cast<char>(offset & 0xFF));
+        block.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15)
+            writeLength(block, matchCode - 15);
+    }
+};
+
+// Authoring of an archive: the entries are collected in memory and written with write(). A compressed entry is only kept
+// compressed when that saves at least an eighth of its size, otherwise it is stored
+class AssetArchiveWriter
+{
+public:
+    explicit AssetArchiveWriter(uint32_t alignment = 64) : alignment(std::max<uint32_t>(alignment, 8))
+    {
+        // a power of two
+        while ((this->alignment & (this->alignment - 1)) != 0)
+            this->alignment &= this->alignment - 1;
+    }
+
+    // adds the data as the asset path (replacing an asset of the same path); false for a path without a file name ("",
+    // "./", "a/..")
+    bool add(const std::string &path, const char *data, size_t size, bool compress)
+    {
+        PendingEntry entry;
+        entry.Path = normalizeAssetPath(path);
+        if (entry.Path.empty())
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::INVALID_PATH: " << path << std::endl;
+            return false;
+        }
+        entry.Size = size;
+        entry.Compression = ASSET_STORED;
+        if (compress && size > 0)
+        {
+            AssetBlockCodec::compress(data, size, entry.Data);
+            if (entry.Data.size() <= size - size / 8)
+                entry.Compression = ASSET_LZ4;
+        }
+        if (entry.Compression == ASSET_STORED)
+            entry.Data.assign(data, data + size);
+
+        for (size_t i = 0; i < entries.size(); ++i)
+            if (entries[i].Path == entry.Path)
+            {
+                entries[i].Data.swap(entry.Data);
+                entries[i].Size = entry.Size;
+                entries[i].Compression = entry.Compression;
+                return true;
+            }
+        entries.push_back(PendingEntry());
+        entries.back().Path.swap(entry.Path);
+        entries.back().Data.swap(entry.Data);
+        entries.back().Size = entry.Size;
+        entries.back().Compression = entry.Compression;
+        return true;
+    }
+
+    // adds the file at filePath as the asset path
+    bool addFile(const std::string &path, const std::string &filePath, bool compress)
+    {
+        MappedFile file;
+        std::ifstream exists(filePath.c_str(), std::ios::binary | std::ios::ate);
+        if (!exists)
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::FILE_NOT_SUCCESFULLY_READ: " << filePath << std::endl;
+            return false;
+        }
+        // empty files aren't mapped
+        if (exists.tellg() > 0 && !file.open(filePath))
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::FILE_NOT_SUCCESFULLY_READ: " << filePath << std::endl;
+            return false;
+        }
+        return add(path, file.getData(), file.getSize(), compress);
+    }
+
+    bool write(const std::string &archivePath) const
+    {
+        if (!isLittleEndianHost())
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::BIG_ENDIAN_HOST_NOT_SUPPORTED: " << archivePath << std::endl;
+            return false;
+        }
+        AssetArchiveHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.Magic, ASSET_ARCHIVE_MAGIC, sizeof(header.Magic));
+        header.Version = ASSET_ARCHIVE_VERSION;
+        header.Alignment = alignment;
+        header.EntryCount = entries.size();
+        header.SlotCount = 16;
+        while (header.SlotCount < 2*entries.size())
+            header.SlotCount *= 2;
+
+        // layout: the data of the entries, the paths, the index
+        std::vector<AssetArchiveEntry> slots(header.SlotCount);
+        memset(slots.data(), 0, slots.size()*sizeof(AssetArchiveEntry));
+        std::string paths;
+        uint64_t offset = sizeof(header);
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const PendingEntry &pending = entries[i];
+            AssetArchiveEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.PathHash = assetPathHash(pending.Path.data(), pending.Path.size());
+            offset = align(offset);
+            entry.Offset = offset;
+            entry.StoredSize = pending.Data.size();
+            entry.Size = pending.Size;
+            entry.PathOffset = static_cast<uint32_t>(paths.size());
+            entry.PathLength = static_cast<uint32_t>(pending.Path.size());
+            entry.Compression = pending.Compression;
+            paths += pending.Path;
+            offset += entry.StoredSize;
+
+            size_t slot = entry.PathHash & (header.SlotCount - 1);
+            while (slots[slot].PathLength != 0)
+                slot = (slot + 1) & (header.SlotCount - 1);
+            slots[slot] = entry;
+        }
+        header.PathsOffset = offset;
+        header.PathsSize = paths.size();
+        header.IndexOffset = align(offset + paths.size());
+        header.FileSize = header.IndexOffset + slots.size()*sizeof(AssetArchiveEntry);
+
+        std::ofstream file(archivePath.c_str(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        offset = sizeof(header);
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            offset = pad(file, offset, align(offset));
+            file.write(entries[i].Data.data(), entries[i].Data.size());
+            offset += entries[i].Data.size();
+        }
+        file.write(paths.data(), paths.size());
+        pad(file, offset + paths.size(), header.IndexOffset);
+        file.write(reinterpret_cast<const char*>(slots.data()), slots.size()*sizeof(AssetArchiveEntry));
+        if (!file)
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::FILE_NOT_SUCCESFULLY_WRITTEN: " << archivePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    size_t getEntryCount() const { return entries.size(); }
+
+private:
+    struct PendingEntry
+    {
+        std::string Path;
+        std::vector<char> Data;   // as stored
+        uint64_t Size;
+        uint32_t Compression;
+    };
+
+    uint32_t alignment;
+    std::vector<PendingEntry> entries;
+
+    uint64_t align(uint64_t offset) const
+    {
+        return (offset + alignment - 1) & ~uint64_t(alignment - 1);
+    }
+
+    static uint64_t pad(std::ofstream &file, uint64_t offset, uint64_t end)
+    {
+        static const char zeros[64] = {};
+        for (; offset < end; offset += std::min<uint64_t>(end - offset, sizeof(zeros)))
+            file.write(zeros, std::min<uint64_t>(end - offset, sizeof(zeros)));
+        return end;
+    }
+};
+
+// A mapped asset archive. open() checks the header and every used slot of the index (ranges of the data and the paths),
+// so the lookups and reads afterwards trust the index
+class AssetArchive
+{
+public:
+    AssetArchive() : header(nullptr), slots(nullptr), paths(nullptr) {}
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    bool open(const std::string &path)
+    {
+        close();
+        if (!isLittleEndianHost())
+            return fail("BIG_ENDIAN_HOST_NOT_SUPPORTED", path);
+        if (!file.open(path))
+            return fail("FILE_NOT_SUCCESFULLY_READ", path);
+        const char *data = file.getData();
+        const uint64_t size = file.getSize();
+        if (size < sizeof(AssetArchiveHeader))
+            return fail("TRUNCATED", path);
+        header = reinterpret_cast<const AssetArchiveHeader*>(data);
+        if (memcmp(header->Magic, ASSET_ARCHIVE_MAGIC, sizeof(header->Magic)) != 0)
+            return fail("NOT_AN_ASSET_ARCHIVE", path);
+        if (header->Version != ASSET_ARCHIVE_VERSION)
+            return fail("UNSUPPORTED_VERSION " + std::to_string(header->Version), path);
+        if (header->FileSize != size || header->PathsOffset > size || header->PathsSize > size - header->PathsOffset ||
+            header->IndexOffset > size || header->IndexOffset % 8 != 0 || (size - header->IndexOffset) / sizeof(AssetArchiveEntry) < header->SlotCount)
+            return fail("TRUNCATED", path);
+        if (header->SlotCount == 0 || (header->SlotCount & (header->SlotCount - 1)) != 0 || header->EntryCount >= header->SlotCount ||
+            header->Alignment == 0 || (header->Alignment & (header->Alignment - 1)) != 0)
+            return fail("BAD_INDEX", path);
+
+        slots = reinterpret_cast<const AssetArchiveEntry*>(data + header->IndexOffset);
+        paths = data + header->PathsOffset;
+        uint64_t used = 0;
+        for (uint64_t i = 0; i < header->SlotCount; ++i)
+        {
+            const AssetArchiveEntry &entry = slots[i];
+            if (entry.PathLength == 0)
+                continue;
+            ++used;
+            if (uint64_t(entry.PathOffset) + entry.PathLength > header->PathsSize || entry.Offset > size || entry.StoredSize > size - entry.Offset ||
+                entry.Offset % header->Alignment != 0 || entry.Compression > ASSET_LZ4 ||
+                (entry.Compression == ASSET_STORED && entry.StoredSize != entry.Size) ||
+                // an LZ4 block expands at most 255 times: a larger Size would only allocate for a damaged entry
+                (entry.Compression == ASSET_LZ4 && entry.Size > entry.StoredSize*255) ||
+                entry.PathHash != assetPathHash(paths + entry.PathOffset, entry.PathLength))
+                return fail("BAD_ENTRY " + std::to_string(i), path);
+        }
+        if (used != header->EntryCount)
+            return fail("BAD_INDEX", path);
+        return true;
+    }
+
+    void close()
+    {
+        file.close();
+        header = nullptr;
+        slots = nullptr;
+        paths = nullptr;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // the entry of the asset path (normalized here), nullptr if the archive has none
+    const AssetArchiveEntry* find(const std::string &path) const
+    {
+        if (header == nullptr)
+            return nullptr;
+        const std::string normalized = normalizeAssetPath(path);
+        const uint64_t hash = assetPathHash(normalized.data(), normalized.size());
+        const uint64_t mask = header->SlotCount - 1;
+        for (uint64_t slot = hash & mask; slots[slot].PathLength != 0; slot = (slot + 1) & mask)
+        {
+            const AssetArchiveEntry &entry = slots[slot];
+            if (entry.PathHash == hash && entry.PathLength == normalized.size() &&
+                memcmp(paths + entry.PathOffset, normalized.data(), normalized.size()) == 0)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    // the bytes of the entry as they are stored in the mapping (the file itself if it isn't compressed)
+    const char* getStoredData(const AssetArchiveEntry &entry) const
+    {
+        return file.getData() + entry.Offset;
+    }
+
+    // the file of the entry: copied or decompressed into data
+    bool read(const AssetArchiveEntry &entry, std::vector<char> &data) const
+    {
+        data.resize(entry.Size);
+        if (entry.Compression == ASSET_STORED)
+        {
+            if (entry.Size > 0)
+                memcpy(data.data(), getStoredData(entry), entry.Size);
+            return true;
+        }
+        if (!AssetBlockCodec::decompress(getStoredData(entry), entry.StoredSize, data.data(), data.size()))
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::DAMAGED_ENTRY: " << getPath(entry) << std::endl;
+            data.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Brings the pages of the stored data of the entry into memory (a read of every page), so the first use of the data
+    // doesn't fault; for prefetching on another thread
+    void touch(const AssetArchiveEntry &entry) const
+    {
+        const char *data = getStoredData(entry);
+#ifndef _WIN32
+        const uintptr_t page = 4096;
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+        if (entry.StoredSize > 0)
+            madvise(reinterpret_cast<void*>(begin), reinterpret_cast<uintptr_t>(data) + entry.StoredSize - begin, MADV_WILLNEED);
+#endif
+        volatile char sink = 0;
+        for (uint64_t offset = 0; offset < entry.StoredSize; offset += 4096)
+            sink = sink + data[offset];
+        (void)sink;
+    }
+
+    std::string getPath(const AssetArchiveEntry &entry) const
+    {
+        return std::string(paths + entry.PathOffset, entry.PathLength);
+    }
+
+    // all the entries (in the order of the index)
+    std::vector<const AssetArchiveEntry*> getEntries() const
+    {
+        std::vector<const AssetArchiveEntry*> entries;
+        for (uint64_t i = 0; header != nullptr && i < header->SlotCount; ++i)
+            if (slots[i].PathLength != 0)
+                entries.push_back(&slots[i]);
+        return entries;
+    }
+
+    uint64_t getEntryCount() const { return header != nullptr ? header->EntryCount : 0; }
+    uint64_t getFileSize() const { return file.getSize(); }
+
+private:
+    MappedFile file;
+    const AssetArchiveHeader *header;
+    const AssetArchiveEntry *slots;
+    const char *paths;
+
+    bool fail(const std::string &what, const std::string &path)
+    {
+        std::cout << "ERROR::ASSET_ARCHIVE::" << what << ": " << path << std::endl;
+        close();
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,23 @@
+# Build profiles of the common library and the samples, chosen with CONFIG on the qmake command line of LearnOpenGL.pro
+# so that all the projects are built alike (GCC):
+#   CONFIG+=lto            link time optimization across the library and the sample (qmake's ltcg, gcc-ar archives)
+#   CONFIG+=pgo_generate   instrumented build: every run of a sample adds its profile to the pgo folder of the build
+#   CONFIG+=pgo_use        built with the profiles of the pgo_generate runs, in the same build folder (the profiles are
+#                          found by the paths of the object files); combine with lto as CONFIG+="lto pgo_use"
+lto: CONFIG += ltcg
+
+PGO_DIR = $$clean_path($$shadowed($$PWD)/../pgo)
+pgo_generate {
+    # the job system and render thread samples count from several threads
+    PGO_FLAGS = -fprofile-generate=$$PGO_DIR -fprofile-update=atomic
+    QMAKE_CFLAGS += $$PGO_FLAGS
+    QMAKE_CXXFLAGS += $$PGO_FLAGS
+    QMAKE_LFLAGS += $$PGO_FLAGS
+}
+pgo_use {
+    # code no training run reached keeps its normal optimization, a sample without runs builds without warnings
+    PGO_FLAGS = -fprofile-use=$$PGO_DIR -fprofile-partial-training -Wno-missing-profile
+    QMAKE_CFLAGS += $$PGO_FLAGS
+    QMAKE_CXXFLAGS += $$PGO_FLAGS
+    QMAKE_LFLAGS += $$PGO_FLAGS
+}
@@ -23,6 +23,43 @@ const float SENSITIVITY =  0.1f;
 const float ZOOM        =  45.0f;
 const float SCROLLSPEED =  1.8f;
 
+// View frustum as 6 planes (left, right, bottom, top, near, far) in world space; a plane is stored as (normal, distance)
+// with the normal pointing to the inside of the frustum, so a point p is inside a plane when dot(normal, p) + distance >= 0
+struct Frustum
+{
+    glm::vec4 Planes[6];
+
+    // Extracts the planes from a (projection * view) matrix (Gribb & Hartmann)
+    explicit Frustum(const glm::mat4 &viewProjection = glm::mat4(1.0f))
+    {
+        // glm matrices are column major, so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+        const glm::mat4 &m = viewProjection;
+        for (int i = 0; i < 3; ++i)
+        {
+            glm::vec4 row(m[0][i], m[1][i], m[2][i], m[3][i]);
+            glm::vec4 w(m[0][3], m[1][3], m[2][3], m[3][3]);
+            Planes[2*i]     = w + row;
+            Planes[2*i + 1] = w - row;
+        }
+        for (int i = 0; i < 6; ++i)
+            Planes[i] /= glm::length(glm::vec3(Planes[i]));
+    }
+
+    // Returns false only if the axis aligned box (given by its center and half extents) lies completely outside of one plane
+    bool IntersectsAABB(const glm::vec3 &center, const glm::vec3 &extents) const
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            const glm::vec3 normal(Planes[i]);
+            float distance = glm::dot(normal, center) + Planes[i].w;
+            float radius = glm::dot(extents, glm::abs(normal));
+            if (distance + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
 class Camera
 {
@@ -66,6 +103,28 @@ public:
         return glm::lookAt(Position, Position + Front, Up);
     }
 
+    // Returns the perspective projection matrix for the current zoom (field of view)
+    glm::mat4 GetProjectionMatrix(float aspectRatio, float nearPlane = 0.1f, float farPlane = 100.0f)
+    {
+        return glm::perspective(glm::radians(Zoom), aspectRatio, nearPlane, farPlane);
+    }
+
+    // Returns the world space view frustum of the camera for the given projection parameters
+    Frustum GetFrustum(float aspectRatio, float nearPlane = 0.1f, float farPlane = 100.0f)
+    {
+        return Frustum(GetProjectionMatrix(aspectRatio, nearPlane, farPlane) * GetViewMatrix());
+    }
+
+    // Sets position, Euler angles and zoom at once (e.g. from a recorded camera path) and updates the camera vectors
+    void SetState(glm::vec3 position, float yaw, float pitch, float zoom)
+    {
+        Position = position;
+        Yaw = yaw;
+        Pitch = pitch;
+        Zoom = zoom;
+        updateCameraVectors();
+    }
+
     // Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
     void ProcessKeyboard(Camera_Movement direction, float deltaTime, bool groundLevel = false)
     {
@@ -0,0 +1,159 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <camera.h>
+
+// Camera state of one frame: the time of the frame since the start of the recording and what Camera::SetState() takes
+struct CameraKeyframe
+{
+    float Time;
+    glm::vec3 Position;
+    float Yaw;
+    float Pitch;
+    float Zoom;
+};
+
+// Camera path file: a 16 byte header followed by FrameCount records of 7 32 bit floats (Time, Position.x, Position.y,
+// Position.z, Yaw, Pitch, Zoom), 28 bytes per frame, in the byte order of the host (little endian on the sample platforms)
+struct CameraPathHeader
+{
+    char Magic[4];        // "LCAM"
+    uint32_t Version;     // CAMERA_PATH_VERSION
+    uint32_t FrameCount;
+    uint32_t RecordSize;  // bytes per frame
+};
+
+const uint32_t CAMERA_PATH_VERSION = 1;
+const uint32_t CAMERA_PATH_RECORD_SIZE = 7*sizeof(float);
+
+// A recorded camera flythrough, one keyframe per frame. Recording keeps the keyframes in memory (no file access while the
+// frames are measured) and saves them at the end; a replay sets the camera of frame i from keyframe i, so every run of a
+// benchmark renders exactly the same frames whatever the frame rate
+class CameraPath
+{
+public:
+    explicit CameraPath(size_t reservedFrames = 0)
+    {
+        keyframes.reserve(reservedFrames);
+    }
+
+    void record(float time, const Camera &camera)
+    {
+        CameraKeyframe keyframe;
+        keyframe.Time = time;
+        keyframe.Position = camera.Position;
+        keyframe.Yaw = camera.Yaw;
+        keyframe.Pitch = camera.Pitch;
+        keyframe.Zoom = camera.Zoom;
+        keyframes.push_back(keyframe);
+    }
+
+    // sets the camera to keyframe frame (the path must not be empty)
+    void apply(size_t frame, Camera &camera) const
+    {
+        const CameraKeyframe &keyframe = keyframes[frame];
+        camera.SetState(keyframe.Position, keyframe.Yaw, keyframe.Pitch, keyframe.Zoom);
+    }
+
+    bool save(const std::string &path) const
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        CameraPathHeader header;
+        memcpy(header.Magic, "LCAM", 4);
+        header.Version = CAMERA_PATH_VERSION;
+        header.FrameCount = static_cast<uint32_t>(keyframes.size());
+        header.RecordSize = CAMERA_PATH_RECORD_SIZE;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t i = 0; i < keyframes.size(); ++i)
+        {
+            const CameraKeyframe &keyframe = keyframes[i];
+            const float record[7] = {keyframe.Time, keyframe.Position.x, keyframe.Position.y, keyframe.Position.z,
+                                     keyframe.Yaw, keyframe.Pitch, keyframe.Zoom};
+            file.write(reinterpret_cast<const char*>(record), sizeof(record));
+        }
+        if (!file)
+        {
+            std::cout << "ERROR::CAMERA_PATH::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool load(const std::string &path)
+    {
+        keyframes.clear();
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        const uint64_t fileSize = file ? static_cast<uint64_t>(file.tellg()) : 0;
+        file.seekg(0);
+        CameraPathHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.Magic, "LCAM", 4) != 0 ||
+            header.Version != CAMERA_PATH_VERSION || header.RecordSize != CAMERA_PATH_RECORD_SIZE)
+        {
+            std::cout << "ERROR::CAMERA_PATH::NOT_A_CAMERA_PATH_FILE: " << path << std::endl;
+            return false;
+        }
+        // checked before the keyframes are allocated, so a damaged FrameCount can't make them huge
+        if (uint64_t(header.FrameCount)*CAMERA_PATH_RECORD_SIZE > fileSize - sizeof(header))
+        {
+            std::cout << "ERROR::CAMERA_PATH::FILE_TRUNCATED: " << path << std::endl;
+            return false;
+        }
+
+        keyframes.resize(header.FrameCount);
+        for (size_t i = 0; i < keyframes.size(); ++i)
+        {
+            float record[7];
+            if (!file.read(reinterpret_cast<char*>(record), sizeof(record)))
+            {
+                std::cout << "ERROR::CAMERA_PATH::FILE_TRUNCATED: " << path << std::endl;
+                keyframes.clear();
+                return false;
+            }
+            CameraKeyframe &keyframe = keyframes[i];
+            keyframe.Time = record[0];
+            keyframe.Position = glm::vec3(record[1], record[2], record[3]);
+            keyframe.Yaw = record[4];
+            keyframe.Pitch = record[5];
+            keyframe.Zoom = record[6];
+        }
+        return true;
+    }
+
+    size_t getFrameCount() const { return keyframes.size(); }
+    const CameraKeyframe& getKeyframe(size_t frame) const { return keyframes[frame]; }
+
+private:
+    std::vector<CameraKeyframe> keyframes;
+};
+
+// A deterministic flythrough without a recording: frameCount frames at frameRate, circling around center at radius while
+// looking at it, slowly moving up and down and zooming in and out
+inline CameraPath makeOrbitCameraPath(glm::vec3 center, float radius, size_t frameCount, float frameRate = 60.0f)
+{
+    CameraPath path(frameCount);
+    Camera camera;
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        const float time = i/frameRate;
+        const float angle = glm::radians(360.0f)*i/frameCount;
+        const glm::vec3 position = center + glm::vec3(radius*std::sin(angle), 0.25f*radius*std::sin(2.0f*angle), radius*std::cos(angle));
+        const glm::vec3 direction = glm::normalize(center - position);
+        const float yaw = glm::degrees(std::atan2(direction.z, direction.x));
+        const float pitch = glm::degrees(std::asin(direction.y));
+        camera.SetState(position, yaw, pitch, 45.0f - 15.0f*(1.0f - std::cos(angle))*0.5f);
+        path.record(time, camera);
+    }
+    return path;
+}
+
+#endif // CAMERA_PATH_H
@@ -0,0 +1,10 @@
+# Included by every sample: the common headers and the static library of common.pro, built with the same build profile
+INCLUDEPATH += $$PWD
+
+COMMON_LIBRARY_DIR = $$shadowed($$PWD)
+LIBS += -L$$COMMON_LIBRARY_DIR -lcommon
+PRE_TARGETDEPS += $$COMMON_LIBRARY_DIR/libcommon.a
+
+LIBS += -lglfw3 -lGL -lX11 -lpthread -lXrandr -lXi -ldl
+
+include($$PWD/build_profile.pri)
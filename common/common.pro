@@ -0,0 +1,24 @@
+# Static library of the code all the samples share: the GLAD loader, the stb_image implementation and the window setup
+# (the helpers in common/*.h stay header only). LearnOpenGL.pro builds it before the samples, which link it through
+# common.pri
+TEMPLATE = lib
+CONFIG += staticlib c++11
+CONFIG -= qt
+TARGET = common
+
+include(build_profile.pri)
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    src/glad.c \
+    src/stb_image.cpp \
+    src/gl_window.cpp
+
+HEADERS += \
+    glad/glad.h \
+    glad/glad_instrument.h \
+    glad/glad_pixel_bytes.h \
+    KHR/khrplatform.h \
+    stb_image.h \
+    gl_window.h
@@ -0,0 +1,467 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <job_system.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Handle of an entity: the index of its record and the generation of that record, so the handle of a destroyed entity
+// is recognized even after its index has been reused
+struct Entity
+{
+    uint32_t Index;
+    uint32_t Generation;
+
+    bool operator==(const Entity &other) const { return Index == other.Index && Generation == other.Generation; }
+    bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+// One bit per component type, at most MAX_COMPONENT_TYPES component types per program
+typedef uint64_t ComponentMask;
+const unsigned MAX_COMPONENT_TYPES = 64;
+
+// Size and alignment of a component type, indexed by its id
+struct ComponentInfo
+{
+    size_t Size;
+    size_t Alignment;
+};
+
+inline std::vector<ComponentInfo>& componentInfos()
+{
+    static std::vector<ComponentInfo> infos;
+    return infos;
+}
+
+// Id of component type T (0..63), given on its first use. Components are plain data (trivially copyable): they are moved
+// between chunks with memcpy and never destructed. The ids are given on the thread building the world: the first use of
+// a component type must not happen inside a job. A 65th component type has no bit in ComponentMask: the program stops
+// rather than mixing up the archetypes
+template <typename T>
+unsigned componentId()
+{
+    static_assert(std::is_trivially_copyable<T>::value, "components must be trivially copyable");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "components must not be over-aligned");
+    static const unsigned id = []() {
+        if (componentInfos().size() == MAX_COMPONENT_TYPES)
+        {
+            std::cout << "ERROR::ECS::TOO_MANY_COMPONENT_TYPES: at most " << MAX_COMPONENT_TYPES << std::endl;
+            std::abort();
+        }
+        ComponentInfo info = { sizeof(T), alignof(T) };
+        componentInfos().push_back(info);
+        return static_cast<unsigned>(componentInfos().size() - 1);
+    }();
+    return id;
+}
+
+template <typename... C>
+struct ComponentMaskOf;
+
+template <>
+struct ComponentMaskOf<>
+{
+    static ComponentMask get() { return 0; }
+};
+
+template <typename T, typename... R>
+struct ComponentMaskOf<T, R...>
+{
+    static ComponentMask get() { return (ComponentMask(1) << componentId<T>()) | ComponentMaskOf<R...>::get(); }
+};
+
+// All the entities with the same set of components. They are stored in chunks of about CHUNK_BYTES with one array per
+// component (structure of arrays) and one of the entity handles, so a system touches only the arrays of the components it
+// reads or writes, in order. The chunks stay packed: all of them are full except the last one
+class Archetype
+{
+public:
+    static const size_t CHUNK_BYTES = 16*1024;
+
+    struct Chunk
+    {
+        unsigned char* Data;
+        size_t Count;
+    };
+
+    explicit Archetype(ComponentMask mask) : mask(mask), capacity(0), chunkBytes(0), entityCount(0)
+    {
+        const std::vector<ComponentInfo> &infos = componentInfos();
+        size_t entityBytes = sizeof(Entity);
+        for (unsigned id = 0; id < MAX_COMPONENT_TYPES; ++id)
+        {
+            columnIndex[id] = -1;
+            if ((mask >> id) & 1)
+            {
+                columnIndex[id] = static_cast<int>(components.size());
+                components.push_back(id);
+                entityBytes += infos[id].Size;
+            }
+        }
+        capacity = std::max<size_t>(1, CHUNK_BYTES / entityBytes);
+        // the entity handles first, then the arrays of the components in the order of their ids
+        size_t offset = capacity*sizeof(Entity);
+        for (size_t i = 0; i < components.size(); ++i)
+        {
+            const ComponentInfo &info = infos[components[i]];
+            offset = (offset + info.Alignment - 1) / info.Alignment * info.Alignment;
+            offsets.push_back(offset);
+            offset += capacity*info.Size;
+        }
+        chunkBytes = offset;
+    }
+
+    ~Archetype()
+    {
+        for (size_t i = 0; i < chunks.size(); ++i)
+            ::operator delete(chunks[i].Data);
+    }
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    ComponentMask getMask() const { return mask; }
+    size_t getCapacity() const { return capacity; }
+    size_t getEntityCount() const { return entityCount; }
+    size_t getChunkCount() const { return chunks.size(); }
+    Chunk& getChunk(size_t index) { return chunks[index]; }
+
+    bool has(unsigned id) const { return columnIndex[id] >= 0; }
+
+    Entity* entities(const Chunk &chunk) const
+    {
+        return reinterpret_cast<Entity*>(chunk.Data);
+    }
+
+    // the array of component id in chunk (the archetype must have it)
+    void* column(const Chunk &chunk, unsigned id) const
+    {
+        return chunk.Data + offsets[columnIndex[id]];
+    }
+
+    template <typename T>
+    T* column(const Chunk &chunk) const
+    {
+        return static_cast<T*>(column(chunk, componentId<T>()));
+    }
+
+    // Appends entity (its components are left uninitialized) and returns its position as chunk*capacity + row
+    size_t push(Entity entity)
+    {
+        if (chunks.empty() || chunks.back().Count == capacity)
+        {
+            Chunk chunk = { static_cast<unsigned char*>(::operator new(chunkBytes)), 0 };
+            chunks.push_back(chunk);
+        }
+        Chunk &chunk = chunks.back();
+        entities(chunk)[chunk.Count] = entity;
+        ++entityCount;
+        return (chunks.size() - 1)*capacity + chunk.Count++;
+    }
+
+    // Removes the entity at position by moving the last entity into its place (the last chunk is released once it is
+    // empty); returns the moved entity, whose position is now position, or the removed one if it was the last
+    Entity remove(size_t position)
+    {
+        Chunk &chunk = chunks[position / capacity];
+        const size_t row = position % capacity;
+        Chunk &last = chunks.back();
+        const size_t lastRow = last.Count - 1;
+        Entity moved = entities(last)[lastRow];
+        if (&chunk != &last || row != lastRow)
+        {
+            entities(chunk)[row] = moved;
+            const std::vector<ComponentInfo> &infos = componentInfos();
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                const size_t size = infos[components[i]].Size;
+                memcpy(chunk.Data + offsets[i] + row*size, last.Data + offsets[i] + lastRow*size, size);
+            }
+        }
+        --entityCount;
+        if (--last.Count == 0)
+        {
+            ::operator delete(last.Data);
+            chunks.pop_back();
+        }
+        return moved;
+    }
+
+    // address of component id of the entity at position
+    void* component(size_t position, unsigned id) const
+    {
+        const Chunk &chunk = chunks[position / capacity];
+        return static_cast<unsigned char*>(column(chunk, id)) + (position % capacity)*componentInfos()[id].Size;
+    }
+
+private:
+    ComponentMask mask;
+    std::vector<unsigned> components;   // ids of the components, ascending
+    std::vector<size_t> offsets;        // offset of the array of every component in a chunk
+    int columnIndex[MAX_COMPONENT_TYPES]; // index into components by id, -1 for the components the archetype doesn't have
+    size_t capacity;                    // entities per chunk
+    size_t chunkBytes;
+    size_t entityCount;
+    std::vector<Chunk> chunks;
+};
+
+// Archetype based entity component system. Entities are created with their components, and the ones with the same set
+// of components share an archetype; adding or removing a component moves the entity to another archetype. Behavior lives
+// in systems, functions run on all the entities having some components (entities with a Spin component rotate instead of
+// every third entity of an array):
+//     world.create(Position(glm::vec3(0.0f)), Model());
+//     world.forEach<Position, Model>([](const Position &position, Model &model) { ... });
+//     world.parallelForEachChunk<Position, Model>(jobs, [](size_t count, const Position *positions, Model *models) { ... });
+// The chunk functions get the arrays of a whole chunk; the parallel ones spread the chunks over the threads of a JobSystem
+// (one job per chunk, the function must not write anything two chunks share). Entities must not be created, destroyed or
+// get components added or removed while a system runs
+class EntityWorld
+{
+public:
+    EntityWorld() : lastArchetype(nullptr)
+    {
+    }
+
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    template <typename... C>
+    Entity create(const C&... components)
+    {
+        Archetype &archetype = getArchetype(ComponentMaskOf<C...>::get());
+        Entity entity = allocate();
+        EntityRecord &record = records[entity.Index];
+        record.Type = &archetype;
+        record.Position = archetype.push(entity);
+        int expand[] = { 0, (*static_cast<C*>(archetype.component(record.Position, componentId<C>())) = components, 0)... };
+        (void)expand;
+        return entity;
+    }
+
+    void destroy(Entity entity)
+    {
+        if (!isAlive(entity))
+            return;
+        EntityRecord &record = records[entity.Index];
+        detach(record);
+        record.Type = nullptr;
+        ++record.Generation;
+        freeIndices.push_back(entity.Index);
+    }
+
+    bool isAlive(Entity entity) const
+    {
+        return entity.Index < records.size() && records[entity.Index].Generation == entity.Generation &&
+               records[entity.Index].Type != nullptr;
+    }
+
+    template <typename T>
+    bool has(Entity entity) const
+    {
+        return isAlive(entity) && records[entity.Index].Type->has(componentId<T>());
+    }
+
+    // component T of entity, nullptr if it has none; valid until the next structural change of the world
+    template <typename T>
+    T* get(Entity entity)
+    {
+        if (!has<T>(entity))
+            return nullptr;
+        const EntityRecord &record = records[entity.Index];
+        return static_cast<T*>(record.Type->component(record.Position, componentId<T>()));
+    }
+
+    // adds component T to entity (moving it to the archetype with T) or sets it if the entity has one already
+    template <typename T>
+    void add(Entity entity, const T &component)
+    {
+        if (!isAlive(entity))
+            return;
+        const unsigned id = componentId<T>();
+        if (!records[entity.Index].Type->has(id))
+            move(entity, records[entity.Index].Type->getMask() | (ComponentMask(1) << id));
+        *get<T>(entity) = component;
+    }
+
+    template <typename T>
+    void remove(Entity entity)
+    {
+        const unsigned id = componentId<T>();
+        if (has<T>(entity))
+            move(entity, records[entity.Index].Type->getMask() & ~(ComponentMask(1) << id));
+    }
+
+    // f(count, C*... arrays) for every chunk of the archetypes having all the components C
+    template <typename... C, typename F>
+    void forEachChunk(const F &f)
+    {
+        const ComponentMask mask = ComponentMaskOf<C...>::get();
+        for (size_t a = 0; a < archetypes.size(); ++a)
+        {
+            Archetype &archetype = *archetypes[a];
+            if ((archetype.getMask() & mask) != mask)
+                continue;
+            for (size_t c = 0; c < archetype.getChunkCount(); ++c)
+            {
+                Archetype::Chunk &chunk = archetype.getChunk(c);
+                f(chunk.Count, archetype.column<C>(chunk)...);
+            }
+        }
+    }
+
+    // f(C&... components) for every entity having all the components C
+    template <typename... C, typename F>
+    void forEach(const F &f)
+    {
+        forEachChunk<C...>(EachRow<F>(f));
+    }
+
+    // forEachChunk with one job per chunk on the threads of jobs, returns when all the chunks are done
+    template <typename... C, typename F>
+    void parallelForEachChunk(JobSystem &jobs, const F &f)
+    {
+        const ComponentMask mask = ComponentMaskOf<C...>::get();
+        matches.clear();
+        for (size_t a = 0; a < archetypes.size(); ++a)
+            if ((archetypes[a]->getMask() & mask) == mask)
+                for (size_t c = 0; c < archetypes[a]->getChunkCount(); ++c)
+                    matches.push_back(ChunkRef(archetypes[a].get(), c));
+        const std::vector<ChunkRef> &chunks = matches;
+        jobs.parallelFor(0, chunks.size(), 1, [&chunks, &f](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                Archetype &archetype = *chunks[i].first;
+                Archetype::Chunk &chunk = archetype.getChunk(chunks[i].second);
+                f(chunk.Count, archetype.column<C>(chunk)...);
+            }
+        });
+    }
+
+    template <typename... C, typename F>
+    void parallelForEach(JobSystem &jobs, const F &f)
+    {
+        parallelForEachChunk<C...>(jobs, EachRow<F>(f));
+    }
+
+    // number of entities having all the components C
+    template <typename... C>
+    size_t count() const
+    {
+        const ComponentMask mask = ComponentMaskOf<C...>::get();
+        size_t total = 0;
+        for (size_t a = 0; a < archetypes.size(); ++a)
+            if ((archetypes[a]->getMask() & mask) == mask)
+                total += archetypes[a]->getEntityCount();
+        return total;
+    }
+
+    size_t getEntityCount() const { return records.size() - freeIndices.size(); }
+    size_t getArchetypeCount() const { return archetypes.size(); }
+
+    size_t getChunkCount() const
+    {
+        size_t total = 0;
+        for (size_t a = 0; a < archetypes.size(); ++a)
+            total += archetypes[a]->getChunkCount();
+        return total;
+    }
+
+private:
+    struct EntityRecord
+    {
+        Archetype* Type;      // nullptr for a free record
+        size_t Position;      // chunk*capacity + row inside the archetype
+        uint32_t Generation;
+    };
+
+    typedef std::pair<Archetype*, size_t> ChunkRef;
+
+    // calls f on every row of a chunk
+    template <typename F>
+    struct EachRow
+    {
+        const F &f;
+
+        explicit EachRow(const F &f) : f(f) {}
+
+        template <typename... P>
+        void operator()(size_t count, P*... arrays) const
+        {
+            for (size_t i = 0; i < count; ++i)
+                f(arrays[i]...);
+        }
+    };
+
+    std::vector<EntityRecord> records;
+    std::vector<uint32_t> freeIndices;
+    std::vector<std::unique_ptr<Archetype>> archetypes;       // in the order of their creation
+    std::unordered_map<ComponentMask, Archetype*> archetypeMap;
+    Archetype* lastArchetype;                                 // most entities are created in runs of the same archetype
+    std::vector<ChunkRef> matches;
+
+    Archetype& getArchetype(ComponentMask mask)
+    {
+        if (lastArchetype != nullptr && lastArchetype->getMask() == mask)
+            return *lastArchetype;
+        std::unordered_map<ComponentMask, Archetype*>::const_iterator found = archetypeMap.find(mask);
+        if (found != archetypeMap.end())
+            return *(lastArchetype = found->second);
+        archetypes.push_back(std::unique_ptr<Archetype>(new Archetype(mask)));
+        lastArchetype = archetypeMap[mask] = archetypes.back().get();
+        return *lastArchetype;
+    }
+
+    Entity allocate()
+    {
+        Entity entity;
+        if (!freeIndices.empty())
+        {
+            entity.Index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+        else
+        {
+            entity.Index = static_cast<uint32_t>(records.size());
+            EntityRecord record = { nullptr, 0, 0 };
+            records.push_back(record);
+        }
+        entity.Generation = records[entity.Index].Generation;
+        return entity;
+    }
+
+    // takes the entity of record out of its archetype, fixing the record of the entity moved into its place
+    void detach(const EntityRecord &record)
+    {
+        Entity moved = record.Type->remove(record.Position);
+        if (records[moved.Index].Type == record.Type && records[moved.Index].Position != record.Position)
+            records[moved.Index].Position = record.Position;
+    }
+
+    // moves entity into the archetype of mask, copying the components both archetypes have
+    void move(Entity entity, ComponentMask mask)
+    {
+        EntityRecord &record = records[entity.Index];
+        Archetype &source = *record.Type;
+        Archetype &target = getArchetype(mask);
+        const size_t position = target.push(entity);
+        const std::vector<ComponentInfo> &infos = componentInfos();
+        for (unsigned id = 0; id < MAX_COMPONENT_TYPES; ++id)
+            if (source.has(id) && target.has(id))
+                memcpy(target.component(position, id), source.component(record.Position, id), infos[id].Size);
+        detach(record);
+        record.Type = &target;
+        record.Position = position;
+    }
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed capacity, lock-free single producer/single consumer ring buffer (Capacity must be a power of 2)
+// The producer only writes head and the consumer only writes tail, each on its own cache line, so push and pop are one
+// acquire load, one copy and one release store; a full queue rejects the element instead of blocking the producer
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+    SpscQueue() : head(0), tail(0)
+    {
+    }
+
+    // producer thread only; returns false if the queue is full
+    bool push(const T &element)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+        elements[h & (Capacity - 1)] = element;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer thread only; returns false if the queue is empty
+    bool pop(T &element)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        element = elements[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // number of queued elements (exact only on the producer or consumer thread when the other one is idle)
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head; // next element written by the producer
+    alignas(64) std::atomic<size_t> tail; // next element read by the consumer
+    alignas(64) T elements[Capacity];
+};
+
+// Window events recorded by the GLFW callbacks
+enum InputEventType
+{
+    INPUT_EVENT_KEY,              // Key, Scancode, Action (GLFW_PRESS, GLFW_RELEASE, GLFW_REPEAT), Mods
+    INPUT_EVENT_CURSOR_POS,       // X, Y: cursor position
+    INPUT_EVENT_SCROLL,           // X, Y: scroll offsets
+    INPUT_EVENT_FRAMEBUFFER_SIZE  // Width, Height
+};
+
+// One window event with the time (glfwGetTime()) at which its callback ran
+struct InputEvent
+{
+    InputEventType Type;
+    double Time;
+    int Key;
+    int Scancode;
+    int Action;
+    int Mods;
+    double X;
+    double Y;
+    int Width;
+    int Height;
+};
+
+// Timestamped events from the thread running glfwPollEvents (producer) to the update thread (consumer), which drains the
+// queue once per update and applies the events in the order and at the times they happened. Events arriving while the
+// queue is full are counted and dropped, so a stalled update thread never blocks event processing
+class InputEventQueue
+{
+public:
+    static const size_t CAPACITY = 1024;
+
+    InputEventQueue() : dropped(0)
+    {
+    }
+
+    // producer
+    void push(const InputEvent &event)
+    {
+        if (!events.push(event))
+            dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // consumer: returns false when no event is left
+    bool pop(InputEvent &event)
+    {
+        return events.pop(event);
+    }
+
+    size_t getDroppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    SpscQueue<InputEvent, CAPACITY> events;
+    std::atomic<size_t> dropped;
+};
+
+#endif // EVENT_QUEUE_H
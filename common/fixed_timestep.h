@@ -0,0 +1,77 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+// Fixed timestep clock ("Fix your timestep!"): the wall clock time of every frame is added to an accumulator, which is
+// consumed in whole simulation steps of constant length, so the simulation gives the same results at any frame rate.
+// The number of steps per frame is capped (a slow frame would otherwise need even more steps the next frame); time above
+// the cap is dropped and the simulation runs slower than real time. The remainder of the accumulator is the interpolation
+// factor between the last two simulated states for rendering
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(double stepTime = 1.0/120.0, unsigned maxStepsPerFrame = 8)
+        : stepTime(stepTime), maxStepsPerFrame(maxStepsPerFrame), lastTime(0.0), accumulator(0.0), frameSteps(0),
+          simulationTime(0.0), stepCount(0), droppedTime(0.0)
+    {
+    }
+
+    // Starts the clock at the wall clock time now
+    void reset(double now)
+    {
+        lastTime = now;
+        accumulator = 0.0;
+        frameSteps = 0;
+    }
+
+    // Adds the wall clock time elapsed since the last call and returns the number of steps to simulate for this frame
+    unsigned advance(double now)
+    {
+        accumulator += now - lastTime;
+        lastTime = now;
+
+        frameSteps = static_cast<unsigned>(accumulator/stepTime);
+        if (frameSteps > maxStepsPerFrame)
+        {
+            droppedTime += accumulator - maxStepsPerFrame*stepTime;
+            accumulator = maxStepsPerFrame*stepTime;
+            frameSteps = maxStepsPerFrame;
+        }
+        accumulator -= frameSteps*stepTime;
+        stepCount += frameSteps;
+        simulationTime += frameSteps*stepTime;
+        return frameSteps;
+    }
+
+    // Wall clock time at the end of step (0 to the return value of advance() - 1) of this frame: events which happened up to
+    // this time belong to the step
+    double getStepEndTime(unsigned step) const
+    {
+        return lastTime - accumulator - (frameSteps - 1 - step)*stepTime;
+    }
+
+    // Interpolation factor in [0, 1) between the state before and after the last step for the wall clock time of the frame
+    float getAlpha() const
+    {
+        return static_cast<float>(accumulator/stepTime);
+    }
+
+    double getStepTime() const { return stepTime; }
+    unsigned getMaxStepsPerFrame() const { return maxStepsPerFrame; }
+    // simulated time at the end of the last step
+    double getSimulationTime() const { return simulationTime; }
+    unsigned long long getStepCount() const { return stepCount; }
+    // wall clock time not simulated because of the step cap
+    double getDroppedTime() const { return droppedTime; }
+
+private:
+    double stepTime;
+    unsigned maxStepsPerFrame;
+    double lastTime;
+    double accumulator;
+    unsigned frameSteps;
+    double simulationTime;
+    unsigned long long stepCount;
+    double droppedTime;
+};
+
+#endif // FIXED_TIMESTEP_H
@@ -0,0 +1,233 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Sleeps until deadline: the OS sleep (which may oversleep by a scheduler tick) is used up to spinTime before the deadline,
+// the rest is spent spinning on the clock. Returns how late it woke up in seconds
+inline double sleepUntil(std::chrono::steady_clock::time_point deadline, double spinTime = 0.002)
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinTime));
+    Clock::time_point now = Clock::now();
+    if (deadline - now > spin)
+        std::this_thread::sleep_for(deadline - now - spin);
+    while ((now = Clock::now()) < deadline)
+        ;
+    return std::chrono::duration<double>(now - deadline).count();
+}
+
+// Paces frames to a target frame time (0: uncapped). Every frame has a deadline, one target frame time after the one before.
+// A classic loop works and then waits for the deadline (as a swap with vsync would), so the input sampled at the beginning of
+// the frame is a whole frame old when it is shown. With late sampling the wait moves in front of the work: the frame starts
+// (and samples input) as late as possible so that its work, estimated as the longest of the recent frames plus a margin,
+// still ends at the deadline
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const size_t WORK_HISTORY = 16;
+
+    explicit FramePacer(double targetFrameTime = 0.0, double margin = 0.001, double spinTime = 0.002)
+        : targetFrameTime(targetFrameTime), margin(margin), spinTime(spinTime), workTimes(WORK_HISTORY, 0.0), frame(0),
+          wakeErrorSum(0.0), wakeErrorMax(0.0), waits(0)
+    {
+        deadline = Clock::now();
+    }
+
+    void setTargetFrameTime(double seconds)
+    {
+        targetFrameTime = seconds;
+    }
+
+    // Starts a frame: its deadline is one target frame time after the previous one (or from now, if that one was missed)
+    void beginFrame()
+    {
+        const Clock::time_point now = Clock::now();
+        deadline += toDuration(targetFrameTime);
+        if (deadline < now)
+            deadline = now;
+    }
+
+    // Late sampling: waits until the latest start of the work which still meets the deadline of the frame
+    void waitForLateStart()
+    {
+        if (targetFrameTime > 0.0)
+            wait(deadline - toDuration(getWorkEstimate() + margin));
+    }
+
+    // Marks the beginning and the end of the work of the frame (input, update, render, swap)
+    void beginWork()
+    {
+        workStart = Clock::now();
+    }
+
+    void endWork()
+    {
+        workTimes[frame++ % WORK_HISTORY] = std::chrono::duration<double>(Clock::now() - workStart).count();
+    }
+
+    // Classic pacing: waits until the deadline of the frame after the work
+    void waitForDeadline()
+    {
+        if (targetFrameTime > 0.0)
+            wait(deadline);
+    }
+
+    // seconds from now to the deadline of the frame (negative once it has passed)
+    double getTimeToDeadline() const
+    {
+        return std::chrono::duration<double>(deadline - Clock::now()).count();
+    }
+
+    // longest work time of the recent frames in seconds
+    double getWorkEstimate() const
+    {
+        return *std::max_element(workTimes.begin(), workTimes.end());
+    }
+
+    double getTargetFrameTime() const { return targetFrameTime; }
+    // how late the waits woke up (seconds)
+    double getMeanWakeError() const { return waits > 0 ? wakeErrorSum/waits : 0.0; }
+    double getMaxWakeError() const { return wakeErrorMax; }
+
+private:
+    double targetFrameTime;
+    double margin;
+    double spinTime;
+    std::vector<double> workTimes; // ring of the last WORK_HISTORY work times
+    unsigned long long frame;
+    Clock::time_point deadline;
+    Clock::time_point workStart;
+    double wakeErrorSum;
+    double wakeErrorMax;
+    unsigned long long waits;
+
+    static Clock::duration toDuration(double seconds)
+    {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    void wait(Clock::time_point until)
+    {
+        if (until <= Clock::now())
+            return;
+        const double error = sleepUntil(until, spinTime);
+        wakeErrorSum += error;
+        wakeErrorMax = std::max(wakeErrorMax, error);
+        ++waits;
+    }
+};
+
+// How far the CPU may run ahead of the GPU
+enum GpuQueueMode
+{
+    GPU_QUEUE_UNLIMITED, // leave it to the driver (which may queue several frames)
+    GPU_QUEUE_FENCE,     // at most MaxFramesInFlight frames submitted but not finished, tracked with fence sync objects
+    GPU_QUEUE_FINISH     // glFinish after every swap: nothing is queued, the CPU waits for the GPU every frame
+};
+
+// Limits the depth of the GPU queue, so the input of a frame is not sampled while older frames still wait for the GPU
+// Call frameSubmitted() right after every swap; needs OpenGL 3.2 (sync objects) for GPU_QUEUE_FENCE
+class GpuQueueLimiter
+{
+public:
+    static const unsigned MAX_FENCES = 8;
+
+    explicit GpuQueueLimiter(GpuQueueMode mode = GPU_QUEUE_FENCE, unsigned maxFramesInFlight = 1)
+        : mode(mode), maxFramesInFlight(std::max(1u, std::min(maxFramesInFlight, MAX_FENCES))), first(0), count(0),
+          waitTime(0.0)
+    {
+    }
+
+    void frameSubmitted()
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (mode == GPU_QUEUE_FINISH)
+        {
+            glFinish();
+        }
+        else if (mode == GPU_QUEUE_FENCE)
+        {
+            fences[(first + count) % MAX_FENCES] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            ++count;
+            // wait for the oldest frames until no more than maxFramesInFlight are queued
+            while (count > maxFramesInFlight)
+            {
+                glClientWaitSync(fences[first], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                glDeleteSync(fences[first]);
+                first = (first + 1) % MAX_FENCES;
+                --count;
+            }
+        }
+        waitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void destroy()
+    {
+        for (; count > 0; --count, first = (first + 1) % MAX_FENCES)
+            glDeleteSync(fences[first]);
+    }
+
+    GpuQueueMode getMode() const { return mode; }
+    // total seconds the CPU waited for the GPU
+    double getWaitTime() const { return waitTime; }
+
+private:
+    GpuQueueMode mode;
+    unsigned maxFramesInFlight;
+    GLsync fences[MAX_FENCES];
+    unsigned first;
+    unsigned count;
+    double waitTime;
+};
+
+// Input to swap latency samples (seconds) in a preallocated ring of the most recent ones
+class LatencyStats
+{
+public:
+    explicit LatencyStats(size_t capacity = 4096) : samples(capacity), next(0), total(0), sum(0.0), max(0.0)
+    {
+    }
+
+    void add(double latency)
+    {
+        samples[next] = latency;
+        next = (next + 1) % samples.size();
+        ++total;
+        sum += latency;
+        max = std::max(max, latency);
+    }
+
+    unsigned long long getCount() const { return total; }
+    double getMean() const { return total > 0 ? sum/total : 0.0; }
+    double getMax() const { return max; }
+
+    // percentile (0 to 100) of the samples in the ring
+    double getPercentile(double percentile) const
+    {
+        const size_t size = static_cast<size_t>(std::min<unsigned long long>(total, samples.size()));
+        if (size == 0)
+            return 0.0;
+        std::vector<double> sorted(samples.begin(), samples.begin() + size);
+        const size_t rank = std::min(size - 1, static_cast<size_t>(percentile/100.0*size));
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sorted[rank];
+    }
+
+private:
+    std::vector<double> samples;
+    size_t next;
+    unsigned long long total;
+    double sum;
+    double max;
+};
+
+#endif // FRAME_PACING_H
@@ -0,0 +1,113 @@
+#ifndef FRAME_PACKETS_H
+#define FRAME_PACKETS_H
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <scene.h>
+
+// Everything the render thread needs to draw one frame: written by the update thread, then only read by the render thread
+struct FramePacket
+{
+    uint64_t FrameIndex;
+    glm::mat4 View;
+    glm::mat4 Projection;
+    float MixValue;
+    int ViewportWidth;  // framebuffer size; glViewport is called on the render thread, which owns the GL context
+    int ViewportHeight;
+    std::vector<SceneObject> DrawList; // keeps its capacity from frame to frame, so filling it does not allocate
+};
+
+// Hands frame packets from one update thread to one render thread in order through a fixed ring of 2 (double buffering) or
+// 3 (triple buffering) packets. The update thread writes packet N+1 (or N+2) while the render thread submits packet N, and
+// waits only when every packet is queued or being drawn; the render thread waits only when no packet is queued
+class FramePacketQueue
+{
+public:
+    explicit FramePacketQueue(size_t packetCount = 3)
+        : packets(packetCount), written(0), published(0), released(0), closed(false),
+          writerWaitTime(0.0), readerWaitTime(0.0)
+    {
+    }
+
+    // Update thread: returns the next packet to fill, waiting for the render thread to release one if needed
+    // (nullptr once the queue is closed)
+    FramePacket* beginWrite()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        condition.wait(lock, [this] { return closed || written - released < packets.size(); });
+        writerWaitTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (closed)
+            return nullptr;
+        FramePacket* packet = &packets[written % packets.size()];
+        packet->FrameIndex = written++;
+        return packet;
+    }
+
+    // Update thread: the packet returned by beginWrite() is complete and may be drawn
+    void endWrite()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            published = written;
+        }
+        condition.notify_all();
+    }
+
+    // Render thread: returns the oldest packet which has not been drawn yet, waiting for one if needed
+    // (nullptr once the queue is closed and all the published packets have been drawn)
+    const FramePacket* beginRead()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        condition.wait(lock, [this] { return closed || released < published; });
+        readerWaitTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (released == published)
+            return nullptr;
+        return &packets[released % packets.size()];
+    }
+
+    // Render thread: the packet returned by beginRead() has been submitted and may be overwritten
+    void endRead()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++released;
+        }
+        condition.notify_all();
+    }
+
+    // Wakes both threads; the render thread still gets the packets published before
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        condition.notify_all();
+    }
+
+    size_t getPacketCount() const { return packets.size(); }
+    // total milliseconds the update thread waited for a free packet and the render thread waited for a queued one
+    double getWriterWaitTime() const { return writerWaitTime; }
+    double getReaderWaitTime() const { return readerWaitTime; }
+
+private:
+    std::vector<FramePacket> packets;
+    uint64_t written;   // packets handed out by beginWrite()
+    uint64_t published; // packets completed by endWrite()
+    uint64_t released;  // packets completed by endRead()
+    bool closed;
+    double writerWaitTime;
+    double readerWaitTime;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+#endif // FRAME_PACKETS_H
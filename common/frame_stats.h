@@ -0,0 +1,343 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Streaming histogram of durations in the style of HdrHistogram: values (microseconds) below 128 have a bucket of their
+// own, larger ones are grouped by their power of 2 into 64 linear sub-buckets, so every bucket is at most 1/64 (1.6%) as
+// wide as its values. Recording is a few integer operations on a fixed array, percentiles walk the buckets once
+class DurationHistogram
+{
+public:
+    static const unsigned SUB_BUCKETS = 64;
+    static const unsigned MAX_EXPONENT = 40; // values up to 2^46 microseconds
+
+    DurationHistogram() : counts((MAX_EXPONENT + 2)*SUB_BUCKETS, 0), count(0), sum(0.0), max(0.0)
+    {
+    }
+
+    void record(double milliseconds)
+    {
+        const uint64_t value = static_cast<uint64_t>(std::max(0.0, milliseconds)*1000.0);
+        ++counts[std::min<size_t>(bucketIndex(value), counts.size() - 1)];
+        ++count;
+        sum += milliseconds;
+        max = std::max(max, milliseconds);
+    }
+
+    void reset()
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        count = 0;
+        sum = 0.0;
+        max = 0.0;
+    }
+
+    // value in milliseconds below which percentile (0 to 100) of the recorded values are (middle of its bucket; max is exact)
+    double getPercentile(double percentile) const
+    {
+        if (count == 0)
+            return 0.0;
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile/100.0*count + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return std::min(max, 0.5*(bucketLow(i) + bucketLow(i + 1))/1000.0);
+        }
+        return max;
+    }
+
+    uint64_t getCount() const { return count; }
+    double getMean() const { return count > 0 ? sum/count : 0.0; }
+    double getMax() const { return max; }
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t count;
+    double sum;
+    double max;
+
+    // buckets 0..127: the value itself; then SUB_BUCKETS buckets per power of 2
+    static size_t bucketIndex(uint64_t value)
+    {
+        if (value < 2*SUB_BUCKETS)
+            return static_cast<size_t>(value);
+        unsigned exponent = 0;
+        while ((value >> exponent) >= 2*SUB_BUCKETS)
+            ++exponent;
+        return exponent*SUB_BUCKETS + static_cast<size_t>(value >> exponent);
+    }
+
+    // smallest value (microseconds) of bucket index
+    static double bucketLow(size_t index)
+    {
+        if (index < 2*SUB_BUCKETS)
+            return static_cast<double>(index);
+        const size_t exponent = index/SUB_BUCKETS - 1;
+        const size_t subBucket = index % SUB_BUCKETS + SUB_BUCKETS;
+        return static_cast<double>(static_cast<uint64_t>(subBucket) << exponent);
+    }
+};
+
+// GPU time of frames measured with GL_TIME_ELAPSED queries (OpenGL 3.3). The results of a frame are only read a few frames
+// later, once the query is available, so measuring never stalls the CPU
+class GpuFrameTimer
+{
+public:
+    static const unsigned QUERY_COUNT = 4;
+
+    GpuFrameTimer() : next(0), pending(0), collected(0)
+    {
+        glGenQueries(QUERY_COUNT, queries);
+    }
+
+    void destroy()
+    {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+
+    // frame is the index the result is reported with; returns false if all queries are busy (the frame is not timed)
+    bool begin(uint64_t frame)
+    {
+        if (pending == QUERY_COUNT)
+            return false;
+        frames[next] = frame;
+        glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+        return true;
+    }
+
+    void end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        next = (next + 1) % QUERY_COUNT;
+        ++pending;
+    }
+
+    // Returns the next available result in order (GPU time in milliseconds and its frame); wait blocks for it
+    bool collect(uint64_t &frame, double &milliseconds, bool wait = false)
+    {
+        while (pending > 0 && read(frame, milliseconds, wait))
+        {
+            // the first time elapsed query with rendering commands returns garbage on some drivers (Mesa llvmpipe): dropped
+            if (collected++ > 0)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    GLuint queries[QUERY_COUNT];
+    uint64_t frames[QUERY_COUNT];
+    unsigned next;
+    unsigned pending;
+    uint64_t collected; // results read so far
+
+    bool read(uint64_t &frame, double &milliseconds, bool wait)
+    {
+        const unsigned oldest = (next + QUERY_COUNT - pending) % QUERY_COUNT;
+        GLint available = GL_FALSE;
+        if (!wait)
+        {
+            glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE)
+                return false;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &nanoseconds);
+        frame = frames[oldest];
+        milliseconds = nanoseconds/1.0e6;
+        --pending;
+        return true;
+    }
+};
+
+// Everything measured for one frame
+struct FrameSample
+{
+    uint64_t Frame;
+    double CpuTime;         // milliseconds from beginFrame() to endFrame()
+    double GpuTime;         // milliseconds, negative until known
+    unsigned DrawCalls;
+    uint64_t BytesUploaded; // buffer, texture and uniform data sent to the GL
+};
+
+// Per frame statistics for stutter analysis rather than average FPS: the last capacity frames are kept in a preallocated
+// ring (nothing allocates per frame), CPU and GPU times of all frames go into streaming histograms for the percentiles.
+// Exported as CSV (one line per frame of the ring) and JSON (summary) at exit
+class FrameStats
+{
+public:
+    explicit FrameStats(size_t capacity = 16384, bool measureGpu = true)
+        : samples(capacity), frame(0), gpuTimed(false), drawCalls(0), bytesUploaded(0),
+          totalDrawCalls(0), totalBytesUploaded(0)
+    {
+        // the timer creates its queries right away, so it only exists with measureGpu (and a current context)
+        gpuTimer = measureGpu ? new GpuFrameTimer() : nullptr;
+    }
+
+    ~FrameStats()
+    {
+        delete gpuTimer;
+    }
+
+    // with the context current: deletes the queries
+    void destroy()
+    {
+        if (gpuTimer != nullptr)
+        {
+            collectGpuTimes(true);
+            gpuTimer->destroy();
+            delete gpuTimer;
+            gpuTimer = nullptr;
+        }
+    }
+
+    void beginFrame()
+    {
+        collectGpuTimes(false);
+        frameStart = std::chrono::steady_clock::now();
+        drawCalls = 0;
+        bytesUploaded = 0;
+        gpuTimed = gpuTimer != nullptr && gpuTimer->begin(frame);
+    }
+
+    // counters of the frame, called by the renderer
+    void addDrawCalls(unsigned count) { drawCalls += count; }
+    void addBytesUploaded(uint64_t bytes) { bytesUploaded += bytes; }
+
+    void endFrame()
+    {
+        if (gpuTimed)
+            gpuTimer->end();
+
+        FrameSample &sample = samples[frame % samples.size()];
+        sample.Frame = frame;
+        sample.CpuTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        sample.GpuTime = -1.0;
+        sample.DrawCalls = drawCalls;
+        sample.BytesUploaded = bytesUploaded;
+        cpuHistogram.record(sample.CpuTime);
+        totalDrawCalls += drawCalls;
+        totalBytesUploaded += bytesUploaded;
+        ++frame;
+    }
+
+    uint64_t getFrameCount() const { return frame; }
+    const DurationHistogram& getCpuHistogram() const { return cpuHistogram; }
+    const DurationHistogram& getGpuHistogram() const { return gpuHistogram; }
+
+    void printSummary(std::ostream &out) const
+    {
+        // the table is printed with fixed precision: the format of out is restored afterwards
+        const std::ios_base::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision();
+        out << frame << " frames, " << (frame > 0 ? totalDrawCalls/frame : 0) << " draw calls and "
+            << (frame > 0 ? totalBytesUploaded/frame : 0) << " bytes uploaded per frame" << std::endl;
+        out << std::setw(10) << "[ms]" << std::setw(9) << "mean" << std::setw(9) << "p50" << std::setw(9) << "p90"
+            << std::setw(9) << "p99" << std::setw(9) << "p99.9" << std::setw(9) << "max" << std::endl;
+        printHistogram(out, "CPU", cpuHistogram);
+        if (gpuHistogram.getCount() > 0)
+            printHistogram(out, "GPU", gpuHistogram);
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    bool writeCsv(const std::string &path) const
+    {
+        std::ofstream file(path.c_str());
+        file << "frame,cpu_ms,gpu_ms,draw_calls,bytes_uploaded\n";
+        const uint64_t first = frame > samples.size() ? frame - samples.size() : 0;
+        for (uint64_t i = first; i < frame; ++i)
+        {
+            const FrameSample &sample = samples[i % samples.size()];
+            file << sample.Frame << ',' << sample.CpuTime << ',';
+            if (sample.GpuTime >= 0.0)
+                file << sample.GpuTime;
+            file << ',' << sample.DrawCalls << ',' << sample.BytesUploaded << '\n';
+        }
+        if (!file)
+        {
+            std::cout << "ERROR::FRAME_STATS::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeJson(const std::string &path) const
+    {
+        std::ofstream file(path.c_str());
+        file << "{\n  \"frames\": " << frame << ",\n"
+             << "  \"draw_calls\": " << totalDrawCalls << ",\n"
+             << "  \"bytes_uploaded\": " << totalBytesUploaded << ",\n";
+        writeJsonHistogram(file, "cpu_ms", cpuHistogram);
+        file << ",\n";
+        writeJsonHistogram(file, "gpu_ms", gpuHistogram);
+        file << "\n}\n";
+        if (!file)
+        {
+            std::cout << "ERROR::FRAME_STATS::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<FrameSample> samples; // ring of the last frames
+    uint64_t frame;
+    GpuFrameTimer* gpuTimer; // null if the GPU time is not measured
+    bool gpuTimed;
+    std::chrono::steady_clock::time_point frameStart;
+    unsigned drawCalls;
+    uint64_t bytesUploaded;
+    uint64_t totalDrawCalls;
+    uint64_t totalBytesUploaded;
+    DurationHistogram cpuHistogram;
+    DurationHistogram gpuHistogram;
+
+    FrameStats(const FrameStats&);
+    FrameStats& operator=(const FrameStats&);
+
+    // stores the GPU times which are available (all of them with wait) in their frames
+    void collectGpuTimes(bool wait)
+    {
+        if (gpuTimer == nullptr)
+            return;
+        uint64_t timedFrame;
+        double milliseconds;
+        while (gpuTimer->collect(timedFrame, milliseconds, wait))
+        {
+            gpuHistogram.record(milliseconds);
+            if (frame - timedFrame <= samples.size())
+                samples[timedFrame % samples.size()].GpuTime = milliseconds;
+        }
+    }
+
+    static void printHistogram(std::ostream &out, const char* name, const DurationHistogram &histogram)
+    {
+        out << std::fixed << std::setprecision(2) << std::setw(10) << name << std::setw(9) << histogram.getMean()
+            << std::setw(9) << histogram.getPercentile(50.0) << std::setw(9) << histogram.getPercentile(90.0)
+            << std::setw(9) << histogram.getPercentile(99.0) << std::setw(9) << histogram.getPercentile(99.9)
+            << std::setw(9) << histogram.getMax() << std::endl;
+    }
+
+    static void writeJsonHistogram(std::ostream &out, const char* name, const DurationHistogram &histogram)
+    {
+        out << "  \"" << name << "\": {\"count\": " << histogram.getCount() << ", \"mean\": " << histogram.getMean()
+            << ", \"p50\": " << histogram.getPercentile(50.0) << ", \"p90\": " << histogram.getPercentile(90.0)
+            << ", \"p99\": " << histogram.getPercentile(99.0) << ", \"p99.9\": " << histogram.getPercentile(99.9)
+            << ", \"max\": " << histogram.getMax() << "}";
+    }
+};
+
+#endif // FRAME_STATS_H
@@ -0,0 +1,1053 @@
+#ifndef GL_TRACE_H
+#define GL_TRACE_H
+
+#include <glad/glad.h>
+#include <glad/glad_pixel_bytes.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// GL command capture and replay on top of the glad loader. GlTraceCapture points every glad_glX function pointer at a
+// wrapper which serializes the call, its arguments and the client memory it reads (buffer data, texture images, uniform
+// arrays, shader sources, names) into a trace file; GlTraceReplayer runs a trace back in another context, e.g. headless on
+// a machine without the application, optionally timing every call.
+//
+// Trace file (host byte order): GlTraceHeader, the names of the FunctionCount functions of the capturing build (a length
+// byte and the characters each, records refer to them by index), then one record per call:
+//   uint16    function index (GL_TRACE_FRAME_MARKER: a frame starts, the default framebuffer is cleared)
+//   arguments each with the size of its type, pointers with 8 bytes
+//   [payload] client memory read by the call: uint32 size, zero padding to a multiple of 8 in the file, size bytes
+//   [return]  the return value with the size of its type
+//   [output]  the object names made by glGen*: uint32 size, padding, size bytes
+// Whether a function has a payload or an output follows from its name and parameters (GlTraceFunction) in the same way for
+// the capture and the replay, so records carry no flags.
+//
+// Limitations: object names are not remapped, the replay expects a fresh context to hand out the same names as the captured
+// one (glGen* and glCreate* results are checked and mismatches counted); uniform locations and sync objects are remapped.
+// Client memory of unknown size (e.g. glTexParameterfv, glMultiDrawArrays) is not captured, the capture warns once per
+// function. All GL calls have to come from the thread with the context
+
+struct GlTraceHeader
+{
+    char Magic[4];          // "LGLT"
+    uint32_t Version;       // GL_TRACE_VERSION
+    uint32_t Width;         // default framebuffer of the capture
+    uint32_t Height;
+    uint32_t GLMajor;       // context version of the capture
+    uint32_t GLMinor;
+    uint32_t FunctionCount; // names in the function table
+    uint32_t Reserved;
+};
+
+const uint32_t GL_TRACE_VERSION = 1;
+const uint16_t GL_TRACE_FRAME_MARKER = 0xFFFF;
+
+enum GlTraceFunctionIndex
+{
+#define GLAD_ENTRY(ret, name, type, params, args) GL_TRACE_##name,
+#define GLAD_VOID_ENTRY(name, type, params, args) GL_TRACE_##name,
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    GL_TRACE_FUNCTION_COUNT
+};
+
+// Client memory read by a call, serialized as its payload
+enum GlTracePayload
+{
+    GL_TRACE_PAYLOAD_NONE,
+    GL_TRACE_PAYLOAD_SIZED,         // PayloadArg points to SizeArg bytes (glBufferData, glCompressedTexImage2D, ...)
+    GL_TRACE_PAYLOAD_ELEMENTS,      // CountArg (or one) times Components elements (glUniform4fv, glDeleteBuffers, ...)
+    GL_TRACE_PAYLOAD_PIXELS,        // texture images, unless a pixel unpack buffer is bound (then pixels is an offset)
+    GL_TRACE_PAYLOAD_STRING,        // a null terminated name (glGetUniformLocation, glBindAttribLocation, ...)
+    GL_TRACE_PAYLOAD_SHADER_SOURCE, // the strings of glShaderSource, each as an uint32 length and its characters
+    GL_TRACE_PAYLOAD_UNMAP          // what the application wrote to a mapped buffer, captured when it is unmapped
+};
+
+// How a function is captured and replayed: the sizes and kinds of its arguments come from its glad function pointer type,
+// the payload from its name and the names of its parameters
+struct GlTraceFunction
+{
+    static const unsigned MAX_ARGS = 12;
+
+    const char* Name;
+    unsigned ArgCount;
+    unsigned ArgSize[MAX_ARGS];      // bytes in the trace
+    bool ArgInput[MAX_ARGS];         // pointer to const: client memory the call reads
+    bool ArgOutput[MAX_ARGS];        // pointer to non-const: memory the call writes (scratch memory in the replay)
+    bool ArgSync[MAX_ARGS];          // GLsync, remapped in the replay
+    unsigned ArgPointeeSize[MAX_ARGS];
+    std::string ArgName[MAX_ARGS];
+    unsigned ReturnSize;
+
+    GlTracePayload Payload;
+    int PayloadArg;
+    int SizeArg;                     // bytes of GL_TRACE_PAYLOAD_SIZED, lengths of GL_TRACE_PAYLOAD_SHADER_SOURCE
+    int CountArg;                    // elements of GL_TRACE_PAYLOAD_ELEMENTS (-1: one), strings of the shader source
+    unsigned Components;             // per element
+    int WidthArg, HeightArg, DepthArg, FormatArg, TypeArg;
+
+    bool GeneratesNames;             // glGen*: the n names written to the second argument are the output
+    bool UniformLocation;            // the first argument is a uniform location of the current program
+    bool DrawCall;
+    int UncapturedArg;               // reads client memory of unknown size (only the pointer is traced), -1: none
+
+    // calls function (the glad pointer type of this function) with the arguments as bits, returns the result as bits
+    uint64_t (*Invoke)(void (*function)(), const uint64_t *args);
+};
+
+template<typename T>
+inline uint64_t glTraceToBits(T value)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(T));
+    return bits;
+}
+
+template<typename T>
+inline T glTraceFromBits(uint64_t bits)
+{
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template<>
+inline void glTraceFromBits<void>(uint64_t)
+{
+}
+
+// Fills the names of the parameters from the stringized parameter list of glad_entries.h and works out the payload
+inline void glTraceClassify(GlTraceFunction &function, const char *params)
+{
+    // "(GLenum target, GLsizeiptr size, const void *data, GLenum usage)" or "(void)": the names are the last identifiers
+    std::string list(params);
+    list = list.substr(1, list.size() - 2);
+    unsigned arg = 0;
+    size_t begin = 0;
+    while (arg < function.ArgCount && begin <= list.size())
+    {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos)
+            end = list.size();
+        size_t last = end;
+        while (last > begin && !(isalnum(static_cast<unsigned char>(list[last - 1])) || list[last - 1] == '_'))
+            --last;
+        size_t first = last;
+        while (first > begin && (isalnum(static_cast<unsigned char>(list[first - 1])) || list[first - 1] == '_'))
+            --first;
+        function.ArgName[arg++] = list.substr(first, last - first);
+        begin = end + 1;
+    }
+
+    const std::string name(function.Name);
+    struct Finder
+    {
+        const GlTraceFunction &Function;
+        int operator()(const char *argName) const
+        {
+            for (unsigned i = 0; i < Function.ArgCount; ++i)
+                if (Function.ArgName[i] == argName)
+                    return static_cast<int>(i);
+            return -1;
+        }
+    } find = {function};
+    const auto startsWith = [&name](const char *prefix) { return name.compare(0, strlen(prefix), prefix) == 0; };
+
+    function.Payload = GL_TRACE_PAYLOAD_NONE;
+    function.PayloadArg = function.SizeArg = function.CountArg = -1;
+    function.Components = 1;
+    function.WidthArg = find("width");
+    function.HeightArg = find("height");
+    function.DepthArg = find("depth");
+    function.FormatArg = find("format");
+    function.TypeArg = find("type");
+    function.DrawCall = startsWith("glDraw") || startsWith("glMultiDraw");
+    function.GeneratesNames = startsWith("glGen") && function.ArgCount == 2 && function.ArgOutput[1];
+    function.UniformLocation = startsWith("glUniform") && function.ArgCount > 0 && function.ArgName[0] == "location";
+
+    if (name == "glShaderSource")
+    {
+        function.Payload = GL_TRACE_PAYLOAD_SHADER_SOURCE;
+        function.PayloadArg = find("string");
+        function.CountArg = find("count");
+        function.SizeArg = find("length");
+    }
+    else if (name == "glUnmapBuffer")
+    {
+        function.Payload = GL_TRACE_PAYLOAD_UNMAP;
+    }
+    else if ((startsWith("glTexImage") || startsWith("glTexSubImage")) && find("pixels") >= 0)
+    {
+        function.Payload = GL_TRACE_PAYLOAD_PIXELS;
+        function.PayloadArg = find("pixels");
+    }
+    else if (find("data") >= 0 && function.ArgInput[find("data")] && (find("size") >= 0 || find("imageSize") >= 0))
+    {
+        function.Payload = GL_TRACE_PAYLOAD_SIZED;
+        function.PayloadArg = find("data");
+        function.SizeArg = find("size") >= 0 ? find("size") : find("imageSize");
+    }
+    else if (function.UniformLocation && name[name.size() - 1] == 'v')
+    {
+        // glUniform3fv: count vectors of 3, glUniformMatrix2x4fv: count matrices of 2 x 4
+        function.Payload = GL_TRACE_PAYLOAD_ELEMENTS;
+        function.PayloadArg = find("value");
+        function.CountArg = find("count");
+        if (startsWith("glUniformMatrix"))
+        {
+            const unsigned columns = name[15] - '0';
+            function.Components = name[16] == 'x' ? columns*(name[17] - '0') : columns*columns;
+        }
+        else
+        {
+            function.Components = name[9] - '0';
+        }
+    }
+    else if (startsWith("glVertexAttrib") && name[name.size() - 1] == 'v' && (find("v") >= 0 || find("value") >= 0))
+    {
+        // glVertexAttrib4Nubv: 4 elements, the packed glVertexAttribP3uiv: 1
+        function.Payload = GL_TRACE_PAYLOAD_ELEMENTS;
+        function.PayloadArg = find("v") >= 0 ? find("v") : find("value");
+        const size_t digit = name.find_first_of("1234", 14);
+        function.Components = name[14] == 'P' || digit == std::string::npos ? 1 : name[digit] - '0';
+    }
+    else if (find("n") >= 0 || (startsWith("glDelete") && find("count") == 0))
+    {
+        // glDeleteBuffers, glDeleteSamplers, glDrawBuffers, ...: n names or enums
+        for (unsigned i = 0; i < function.ArgCount; ++i)
+            if (function.ArgInput[i] && function.ArgPointeeSize[i] == 4)
+            {
+                function.Payload = GL_TRACE_PAYLOAD_ELEMENTS;
+                function.PayloadArg = static_cast<int>(i);
+                function.CountArg = find("n") >= 0 ? find("n") : find("count");
+            }
+    }
+    else
+    {
+        // name, uniformBlockName, ...
+        for (unsigned i = 0; i < function.ArgCount; ++i)
+        {
+            const std::string &argName = function.ArgName[i];
+            if (function.ArgInput[i] && function.ArgPointeeSize[i] == 1 &&
+                (argName == "name" || (argName.size() > 4 && argName.compare(argName.size() - 4, 4, "Name") == 0)))
+            {
+                function.Payload = GL_TRACE_PAYLOAD_STRING;
+                function.PayloadArg = static_cast<int>(i);
+            }
+        }
+    }
+
+    // glGetBufferSubData: the size of the output (not the GLint *size output of glGetActiveUniform)
+    if (function.Payload == GL_TRACE_PAYLOAD_NONE && find("size") >= 0 && !function.ArgOutput[find("size")])
+        function.SizeArg = find("size");
+
+    // in the core profile these are offsets into the bound buffers, not client memory
+    function.UncapturedArg = -1;
+    for (unsigned i = 0; i < function.ArgCount; ++i)
+        if (function.ArgInput[i] && static_cast<int>(i) != function.PayloadArg && function.ArgName[i] != "pointer" &&
+            function.ArgName[i] != "indices" && function.ArgName[i] != "indirect" && function.Payload != GL_TRACE_PAYLOAD_SHADER_SOURCE)
+            function.UncapturedArg = static_cast<int>(i);
+}
+
+template<typename T>
+struct GlTracePointee
+{
+    static const unsigned Size = sizeof(T);
+};
+
+template<>
+struct GlTracePointee<void>
+{
+    static const unsigned Size = 0;
+};
+
+template<>
+struct GlTracePointee<const void>
+{
+    static const unsigned Size = 0;
+};
+
+// Size and kind of an argument or return type
+template<typename T>
+struct GlTraceArg
+{
+    typedef typename std::remove_pointer<T>::type Pointee;
+    static const bool Pointer = std::is_pointer<T>::value;
+    static const bool Sync = std::is_same<T, GLsync>::value;
+    static const bool Input = Pointer && !Sync && std::is_const<Pointee>::value;
+    static const bool Output = Pointer && !Sync && !std::is_const<Pointee>::value;
+    static const unsigned Size = Pointer ? 8 : sizeof(T);
+    static const unsigned PointeeSize = Pointer ? GlTracePointee<typename std::conditional<Sync, void, Pointee>::type>::Size : 0;
+};
+
+template<>
+struct GlTraceArg<void>
+{
+    static const unsigned Size = 0;
+};
+
+template<typename R>
+struct GlTraceCall
+{
+    template<typename F, typename... A>
+    static uint64_t call(F function, A... args)
+    {
+        return glTraceToBits(function(args...));
+    }
+};
+
+template<>
+struct GlTraceCall<void>
+{
+    template<typename F, typename... A>
+    static uint64_t call(F function, A... args)
+    {
+        function(args...);
+        return 0;
+    }
+};
+
+template<unsigned... I>
+struct GlTraceIndices
+{
+};
+
+template<unsigned N, unsigned... I>
+struct GlTraceMakeIndices : GlTraceMakeIndices<N - 1, N - 1, I...>
+{
+};
+
+template<unsigned... I>
+struct GlTraceMakeIndices<0, I...>
+{
+    typedef GlTraceIndices<I...> Type;
+};
+
+// The capture of all glad functions; static, since the wrappers are plain function pointers
+class GlTraceCapture
+{
+public:
+    // Starts the capture into path: call it right after gladLoadGLLoader, as the trace has to contain the creation of every
+    // object the replay uses; width and height are the size of the default framebuffer
+    static bool begin(const std::string &path, unsigned width, unsigned height);
+    // Restores the glad pointers and writes the rest of the trace
+    static void end();
+
+    static bool isCapturing() { return state().Capturing; }
+    static uint64_t getCallCount() { return state().Calls; }
+    static uint64_t getFrameCount() { return state().Frames; }
+    static uint64_t getBytesWritten() { return state().Written + state().Buffer.size(); }
+
+    // called by the wrappers around every call
+    static void before(unsigned function, const uint64_t *args);
+    static void after(unsigned function, const uint64_t *args, uint64_t result);
+    static void (*getReal(unsigned function))() { return state().Real[function]; }
+
+private:
+    struct MappedBuffer
+    {
+        GLenum Target;
+        const void* Pointer;
+        uint64_t Length;
+        bool Write;
+    };
+
+    struct State
+    {
+        bool Capturing = false;
+        std::ofstream File;
+        std::vector<char> Buffer;
+        uint64_t Written = 0;
+        uint64_t Calls = 0;
+        uint64_t Frames = 0;
+        void (*Real[GL_TRACE_FUNCTION_COUNT])();
+        std::vector<bool> Warned;
+        // tracked GL state the records depend on
+        GLuint DrawFramebuffer = 0;
+        GLuint UnpackBuffer = 0;
+        GLint UnpackAlignment = 4;
+        std::vector<MappedBuffer> Mapped;
+    };
+
+    static const size_t FLUSH_SIZE = 4 << 20;
+
+    static State& state()
+    {
+        static State capture;
+        return capture;
+    }
+
+    static void write(const void *data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        state().Buffer.insert(state().Buffer.end(), bytes, bytes + size);
+    }
+
+    static void writePayload(const void *data, uint64_t size)
+    {
+        State &s = state();
+        const uint32_t size32 = static_cast<uint32_t>(size);
+        write(&size32, sizeof(size32));
+        s.Buffer.resize(s.Buffer.size() + (8 - (s.Written + s.Buffer.size()) % 8) % 8, 0);
+        write(data, size32);
+    }
+
+    static void flush()
+    {
+        State &s = state();
+        s.File.write(s.Buffer.data(), static_cast<std::streamsize>(s.Buffer.size()));
+        s.Written += s.Buffer.size();
+        s.Buffer.clear();
+    }
+};
+
+// Capture wrapper and replay call of every glad function pointer type
+template<typename F>
+struct GlTraceSignature;
+
+template<typename R, typename... A>
+struct GlTraceSignature<R (APIENTRY *)(A...)>
+{
+    typedef R (APIENTRY *Function)(A...);
+
+    static GlTraceFunction describe(const char *name, const char *params)
+    {
+        static_assert(sizeof...(A) <= GlTraceFunction::MAX_ARGS, "too many arguments");
+        const unsigned sizes[] = {GlTraceArg<A>::Size..., 0};
+        const bool inputs[] = {GlTraceArg<A>::Input..., false};
+        const bool outputs[] = {GlTraceArg<A>::Output..., false};
+        const bool syncs[] = {GlTraceArg<A>::Sync..., false};
+        const unsigned pointeeSizes[] = {GlTraceArg<A>::PointeeSize..., 0};
+
+        GlTraceFunction function;
+        function.Name = name;
+        function.ArgCount = sizeof...(A);
+        for (unsigned i = 0; i < function.ArgCount; ++i)
+        {
+            function.ArgSize[i] = sizes[i];
+            function.ArgInput[i] = inputs[i];
+            function.ArgOutput[i] = outputs[i];
+            function.ArgSync[i] = syncs[i];
+            function.ArgPointeeSize[i] = pointeeSizes[i];
+        }
+        function.ReturnSize = GlTraceArg<R>::Size;
+        function.Invoke = &invoke;
+        glTraceClassify(function, params);
+        return function;
+    }
+
+    template<unsigned Index>
+    static R APIENTRY capture(A... args)
+    {
+        const uint64_t values[GlTraceFunction::MAX_ARGS] = {glTraceToBits(args)...};
+        GlTraceCapture::before(Index, values);
+        const uint64_t result = GlTraceCall<R>::call(reinterpret_cast<Function>(GlTraceCapture::getReal(Index)), args...);
+        GlTraceCapture::after(Index, values, result);
+        return glTraceFromBits<R>(result);
+    }
+
+    static uint64_t invoke(void (*function)(), const uint64_t *args)
+    {
+        return invoke(function, args, typename GlTraceMakeIndices<sizeof...(A)>::Type());
+    }
+
+    template<unsigned... I>
+    static uint64_t invoke(void (*function)(), const uint64_t *args, GlTraceIndices<I...>)
+    {
+        (void)args;
+        return GlTraceCall<R>::call(reinterpret_cast<Function>(function), glTraceFromBits<A>(args[I])...);
+    }
+};
+
+// The descriptions of all functions of glad_entries.h, indexed by GlTraceFunctionIndex
+inline const std::vector<GlTraceFunction>& glTraceFunctions()
+{
+    static std::vector<GlTraceFunction> functions;
+    if (functions.empty())
+    {
+        functions.resize(GL_TRACE_FUNCTION_COUNT);
+#define GLAD_ENTRY(ret, name, type, params, args) functions[GL_TRACE_##name] = GlTraceSignature<type>::describe(#name, #params);
+#define GLAD_VOID_ENTRY(name, type, params, args) functions[GL_TRACE_##name] = GlTraceSignature<type>::describe(#name, #params);
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    }
+    return functions;
+}
+
+// the loaded glad function pointers, indexed by GlTraceFunctionIndex
+inline std::vector<void (*)()> glTraceLoadedFunctions()
+{
+    std::vector<void (*)()> loaded(GL_TRACE_FUNCTION_COUNT);
+#define GLAD_ENTRY(ret, name, type, params, args) loaded[GL_TRACE_##name] = reinterpret_cast<void (*)()>(glad_##name);
+#define GLAD_VOID_ENTRY(name, type, params, args) loaded[GL_TRACE_##name] = reinterpret_cast<void (*)()>(glad_##name);
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    return loaded;
+}
+
+inline bool GlTraceCapture::begin(const std::string &path, unsigned width, unsigned height)
+{
+    State &s = state();
+    if (s.Capturing)
+        return false;
+    const std::vector<GlTraceFunction> &functions = glTraceFunctions();
+    s.File.open(path.c_str(), std::ios::binary);
+    if (!s.File)
+    {
+        std::cout << "ERROR::GL_TRACE::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+        return false;
+    }
+
+    GlTraceHeader header;
+    memcpy(header.Magic, "LGLT", 4);
+    header.Version = GL_TRACE_VERSION;
+    header.Width = width;
+    header.Height = height;
+    header.GLMajor = static_cast<uint32_t>(GLVersion.major);
+    header.GLMinor = static_cast<uint32_t>(GLVersion.minor);
+    header.FunctionCount = GL_TRACE_FUNCTION_COUNT;
+    header.Reserved = 0;
+    s.Buffer.reserve(FLUSH_SIZE + (1 << 20));
+    write(&header, sizeof(header));
+    for (size_t i = 0; i < functions.size(); ++i)
+    {
+        const uint8_t length = static_cast<uint8_t>(strlen(functions[i].Name));
+        write(&length, 1);
+        write(functions[i].Name, length);
+    }
+
+    s.Capturing = true;
+    s.Written = 0;
+    s.Calls = 0;
+    s.Frames = 0;
+    s.Warned.assign(GL_TRACE_FUNCTION_COUNT, false);
+    s.DrawFramebuffer = 0;
+    s.UnpackBuffer = 0;
+    s.UnpackAlignment = 4;
+    s.Mapped.clear();
+
+    // functions which were not loaded stay NULL
+#define GLAD_ENTRY(ret, name, type, params, args) \
+    s.Real[GL_TRACE_##name] = reinterpret_cast<void (*)()>(glad_##name); \
+    if (glad_##name != nullptr) glad_##name = &GlTraceSignature<type>::capture<GL_TRACE_##name>;
+#define GLAD_VOID_ENTRY(name, type, params, args) \
+    s.Real[GL_TRACE_##name] = reinterpret_cast<void (*)()>(glad_##name); \
+    if (glad_##name != nullptr) glad_##name = &GlTraceSignature<type>::capture<GL_TRACE_##name>;
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    return true;
+}
+
+inline void GlTraceCapture::end()
+{
+    State &s = state();
+    if (!s.Capturing)
+        return;
+#define GLAD_ENTRY(ret, name, type, params, args) \
+    if (glad_##name != nullptr) glad_##name = reinterpret_cast<type>(s.Real[GL_TRACE_##name]);
+#define GLAD_VOID_ENTRY(name, type, params, args) \
+    if (glad_##name != nullptr) glad_##name = reinterpret_cast<type>(s.Real[GL_TRACE_##name]);
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    flush();
+    s.File.close();
+    s.Capturing = false;
+}
+
+inline void GlTraceCapture::before(unsigned index, const uint64_t *args)
+{
+    State &s = state();
+    const GlTraceFunction &function = glTraceFunctions()[index];
+
+    // clearing the color of the default framebuffer starts a frame
+    if (index == GL_TRACE_glClear && s.DrawFramebuffer == 0 && (args[0] & GL_COLOR_BUFFER_BIT) != 0)
+    {
+        write(&GL_TRACE_FRAME_MARKER, sizeof(GL_TRACE_FRAME_MARKER));
+        ++s.Frames;
+    }
+
+    const uint16_t index16 = static_cast<uint16_t>(index);
+    write(&index16, sizeof(index16));
+    for (unsigned i = 0; i < function.ArgCount; ++i)
+        write(&args[i], function.ArgSize[i]);
+    ++s.Calls;
+
+    const void* data = function.PayloadArg >= 0 ? glTraceFromBits<const void*>(args[function.PayloadArg]) : nullptr;
+    switch (function.Payload)
+    {
+        case GL_TRACE_PAYLOAD_NONE:
+            break;
+        case GL_TRACE_PAYLOAD_SIZED:
+            writePayload(data, data != nullptr ? args[function.SizeArg] : 0);
+            break;
+        case GL_TRACE_PAYLOAD_ELEMENTS:
+        {
+            const uint64_t count = function.CountArg >= 0 ? glTraceFromBits<GLsizei>(args[function.CountArg]) : 1;
+            writePayload(data, data != nullptr ? count*function.Components*function.ArgPointeeSize[function.PayloadArg] : 0);
+            break;
+        }
+        case GL_TRACE_PAYLOAD_PIXELS:
+        {
+            uint64_t size = 0;
+            if (data != nullptr && s.UnpackBuffer == 0)
+                size = gladPixelBytes(glTraceFromBits<GLsizei>(args[function.WidthArg]),
+                                      function.HeightArg >= 0 ? glTraceFromBits<GLsizei>(args[function.HeightArg]) : 1,
+                                      function.DepthArg >= 0 ? glTraceFromBits<GLsizei>(args[function.DepthArg]) : 1,
+                                      static_cast<GLenum>(args[function.FormatArg]), static_cast<GLenum>(args[function.TypeArg]),
+                                      s.UnpackAlignment);
+            writePayload(data, size);
+            break;
+        }
+        case GL_TRACE_PAYLOAD_STRING:
+            writePayload(data, data != nullptr ? strlen(static_cast<const char*>(data)) + 1 : 0);
+            break;
+        case GL_TRACE_PAYLOAD_SHADER_SOURCE:
+        {
+            const GLsizei count = glTraceFromBits<GLsizei>(args[function.CountArg]);
+            const GLchar* const* strings = glTraceFromBits<const GLchar* const*>(args[function.PayloadArg]);
+            const GLint* lengths = glTraceFromBits<const GLint*>(args[function.SizeArg]);
+            std::vector<char> sources;
+            for (GLsizei i = 0; i < count; ++i)
+            {
+                const uint32_t length = static_cast<uint32_t>(lengths != nullptr && lengths[i] >= 0 ? lengths[i] : strlen(strings[i]));
+                sources.insert(sources.end(), reinterpret_cast<const char*>(&length), reinterpret_cast<const char*>(&length) + 4);
+                sources.insert(sources.end(), strings[i], strings[i] + length);
+            }
+            writePayload(sources.data(), sources.size());
+            break;
+        }
+        case GL_TRACE_PAYLOAD_UNMAP:
+        {
+            const GLenum target = static_cast<GLenum>(args[0]);
+            const MappedBuffer* mapped = nullptr;
+            for (size_t i = 0; i < s.Mapped.size(); ++i)
+                if (s.Mapped[i].Target == target)
+                    mapped = &s.Mapped[i];
+            if (mapped != nullptr && mapped->Write)
+                writePayload(mapped->Pointer, mapped->Length);
+            else
+                writePayload(nullptr, 0);
+            break;
+        }
+    }
+
+    if (function.UncapturedArg >= 0 && args[function.UncapturedArg] != 0 && !s.Warned[index])
+    {
+        std::cout << "WARNING::GL_TRACE::CLIENT_MEMORY_NOT_CAPTURED: " << function.Name << std::endl;
+        s.Warned[index] = true;
+    }
+}
+
+inline void GlTraceCapture::after(unsigned index, const uint64_t *args, uint64_t result)
+{
+    State &s = state();
+    const GlTraceFunction &function = glTraceFunctions()[index];
+    write(&result, function.ReturnSize);
+    if (function.GeneratesNames)
+        writePayload(glTraceFromBits<const GLuint*>(args[1]), 4*static_cast<uint64_t>(glTraceFromBits<GLsizei>(args[0])));
+
+    switch (index)
+    {
+        case GL_TRACE_glBindFramebuffer:
+            if (args[0] == GL_FRAMEBUFFER || args[0] == GL_DRAW_FRAMEBUFFER)
+                s.DrawFramebuffer = static_cast<GLuint>(args[1]);
+            break;
+        case GL_TRACE_glBindBuffer:
+            if (args[0] == GL_PIXEL_UNPACK_BUFFER)
+                s.UnpackBuffer = static_cast<GLuint>(args[1]);
+            break;
+        case GL_TRACE_glPixelStorei:
+            if (args[0] == GL_UNPACK_ALIGNMENT)
+                s.UnpackAlignment = glTraceFromBits<GLint>(args[1]);
+            break;
+        case GL_TRACE_glMapBufferRange:
+        case GL_TRACE_glMapBuffer:
+        {
+            MappedBuffer mapped;
+            mapped.Target = static_cast<GLenum>(args[0]);
+            mapped.Pointer = glTraceFromBits<const void*>(result);
+            if (index == GL_TRACE_glMapBufferRange)
+            {
+                mapped.Length = static_cast<uint64_t>(glTraceFromBits<GLsizeiptr>(args[2]));
+                mapped.Write = (args[3] & GL_MAP_WRITE_BIT) != 0;
+            }
+            else
+            {
+                GLint size = 0;
+                reinterpret_cast<PFNGLGETBUFFERPARAMETERIVPROC>(s.Real[GL_TRACE_glGetBufferParameteriv])(mapped.Target, GL_BUFFER_SIZE, &size);
+                mapped.Length = static_cast<uint64_t>(size);
+                mapped.Write = args[1] != GL_READ_ONLY;
+            }
+            if (mapped.Pointer != nullptr)
+                s.Mapped.push_back(mapped);
+            break;
+        }
+        case GL_TRACE_glUnmapBuffer:
+            for (size_t i = 0; i < s.Mapped.size(); ++i)
+                if (s.Mapped[i].Target == static_cast<GLenum>(args[0]))
+                {
+                    s.Mapped.erase(s.Mapped.begin() + i);
+                    break;
+                }
+            break;
+    }
+
+    if (s.Buffer.size() >= FLUSH_SIZE)
+        flush();
+}
+
+// Counters of one replayed frame (the calls from one frame marker to the next)
+struct GlTraceFrame
+{
+    uint64_t Calls;
+    unsigned DrawCalls;
+    uint64_t PayloadBytes;  // client memory passed to the GL: buffer, texture and uniform data, ...
+    double CallTime;        // seconds spent in the GL calls (only with timing)
+};
+
+// Time spent in one function during a replay with timing
+struct GlTraceCallStats
+{
+    const char* Name;
+    uint64_t Calls;
+    double Seconds;
+};
+
+// Replays a trace in the current context: load() reads the trace, replayFrame() runs it frame by frame
+class GlTraceReplayer
+{
+public:
+    GlTraceReplayer() : position(0), timing(false), failed(false), currentProgram(0), mismatchedNames(0)
+    {
+    }
+
+    // reads the whole trace into memory and maps its functions to the ones of this build
+    bool load(const std::string &path)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            std::cout << "ERROR::GL_TRACE::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        size = static_cast<size_t>(file.tellg());
+        file.seekg(0);
+        // 8 byte aligned storage, so the padded payloads are aligned for the GL
+        storage.assign((size + 7)/8, 0);
+        file.read(reinterpret_cast<char*>(storage.data()), static_cast<std::streamsize>(size));
+        if (!file || size < sizeof(header))
+        {
+            std::cout << "ERROR::GL_TRACE::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        memcpy(&header, data(), sizeof(header));
+        if (memcmp(header.Magic, "LGLT", 4) != 0 || header.Version != GL_TRACE_VERSION)
+        {
+            std::cout << "ERROR::GL_TRACE::NOT_A_TRACE_FILE: " << path << std::endl;
+            return false;
+        }
+        position = sizeof(header);
+
+        const std::vector<GlTraceFunction> &functions = glTraceFunctions();
+        std::unordered_map<std::string, unsigned> indices;
+        for (unsigned i = 0; i < functions.size(); ++i)
+            indices[functions[i].Name] = i;
+        // every name takes at least its length byte: a larger count can only come from a damaged header
+        if (header.FunctionCount > size - sizeof(header))
+        {
+            std::cout << "ERROR::GL_TRACE::FILE_TRUNCATED: " << path << std::endl;
+            return false;
+        }
+        functionMap.assign(header.FunctionCount, GL_TRACE_FUNCTION_COUNT);
+        for (uint32_t i = 0; i < header.FunctionCount; ++i)
+        {
+            const uint8_t length = position < size ? static_cast<uint8_t>(data()[position]) : 0;
+            if (position >= size || position + 1 + length > size)
+            {
+                std::cout << "ERROR::GL_TRACE::FILE_TRUNCATED: " << path << std::endl;
+                return false;
+            }
+            const std::string name(data() + position + 1, length);
+            position += 1 + length;
+            std::unordered_map<std::string, unsigned>::const_iterator found = indices.find(name);
+            if (found != indices.end())
+                functionMap[i] = found->second;
+        }
+        return true;
+    }
+
+    const GlTraceHeader& getHeader() const { return header; }
+
+    // With timing every call is timed (per function and per frame); the clock reads add to the frame time
+    void setTiming(bool enabled) { timing = enabled; }
+
+    // Replays the calls up to the next frame marker with the glad functions loaded for the current context. The first
+    // "frame" holds the calls before the first frame marker (loading). Returns false at the end of the trace or on an error
+    bool replayFrame(GlTraceFrame &frame)
+    {
+        frame.Calls = 0;
+        frame.DrawCalls = 0;
+        frame.PayloadBytes = 0;
+        frame.CallTime = 0.0;
+        if (failed || position >= size)
+            return false;
+        if (loaded.empty())
+        {
+            loaded = glTraceLoadedFunctions();
+            callStats.resize(GL_TRACE_FUNCTION_COUNT);
+            for (size_t i = 0; i < callStats.size(); ++i)
+            {
+                callStats[i].Name = glTraceFunctions()[i].Name;
+                callStats[i].Calls = 0;
+                callStats[i].Seconds = 0.0;
+            }
+        }
+
+        bool first = true;
+        while (position < size)
+        {
+            uint16_t traced;
+            if (!read(&traced, sizeof(traced)))
+                return false;
+            if (traced == GL_TRACE_FRAME_MARKER)
+            {
+                if (!first)
+                {
+                    position -= sizeof(traced);
+                    return true;
+                }
+                first = false;
+                continue;
+            }
+            first = false;
+            if (!replayCall(traced, frame))
+                return false;
+        }
+        return true;
+    }
+
+    bool hasFailed() const { return failed; }
+    // true once every frame has been replayed (or the replay failed)
+    bool isAtEnd() const { return failed || position >= size; }
+    // glGen* and glCreate* names which differ from the capture: the replay may use the wrong objects
+    uint64_t getMismatchedNames() const { return mismatchedNames; }
+    const std::vector<GlTraceCallStats>& getCallStats() const { return callStats; }
+
+private:
+    static const size_t SCRATCH_SIZE = 16 << 20;
+
+    std::vector<uint64_t> storage;
+    size_t size;
+    size_t position;
+    GlTraceHeader header;
+    std::vector<unsigned> functionMap;  // trace function index -> GlTraceFunctionIndex
+    std::vector<void (*)()> loaded;
+    std::vector<GlTraceCallStats> callStats;
+    std::vector<uint64_t> scratch;      // memory written by the calls (glGet*, glReadPixels, glGen*, ...)
+    bool timing;
+    bool failed;
+
+    // remapped state
+    GLuint currentProgram;
+    std::unordered_map<uint64_t, GLint> uniformLocations; // program << 32 | traced location -> location
+    std::unordered_map<uint64_t, GLsync> syncs;           // traced GLsync -> GLsync
+    std::vector<std::pair<GLenum, void*> > mapped;        // target -> mapped memory
+    uint64_t mismatchedNames;
+
+    const char* data() const { return reinterpret_cast<const char*>(storage.data()); }
+
+    bool read(void *destination, size_t bytes)
+    {
+        if (position + bytes > size)
+            return fail("FILE_TRUNCATED");
+        memcpy(destination, data() + position, bytes);
+        position += bytes;
+        return true;
+    }
+
+    bool readPayload(const char* &payload, uint32_t &payloadSize)
+    {
+        if (!read(&payloadSize, sizeof(payloadSize)))
+            return false;
+        position += (8 - position % 8) % 8;
+        if (position + payloadSize > size)
+            return fail("FILE_TRUNCATED");
+        payload = data() + position;
+        position += payloadSize;
+        return true;
+    }
+
+    bool fail(const char *error, const char *name = "")
+    {
+        std::cout << "ERROR::GL_TRACE::" << error << ": " << name << std::endl;
+        failed = true;
+        return false;
+    }
+
+    bool replayCall(uint16_t traced, GlTraceFrame &frame)
+    {
+        if (traced >= functionMap.size() || functionMap[traced] == GL_TRACE_FUNCTION_COUNT)
+            return fail("UNKNOWN_FUNCTION");
+        const unsigned index = functionMap[traced];
+        const GlTraceFunction &function = glTraceFunctions()[index];
+
+        uint64_t args[GlTraceFunction::MAX_ARGS] = {0};
+        for (unsigned i = 0; i < function.ArgCount; ++i)
+            if (!read(&args[i], function.ArgSize[i]))
+                return false;
+
+        const char* payload = nullptr;
+        uint32_t payloadSize = 0;
+        std::vector<const GLchar*> sources;
+        std::vector<GLint> sourceLengths;
+        if (function.Payload != GL_TRACE_PAYLOAD_NONE && !readPayload(payload, payloadSize))
+            return false;
+        if (function.Payload == GL_TRACE_PAYLOAD_SHADER_SOURCE)
+        {
+            for (uint32_t offset = 0; offset + 4 <= payloadSize; )
+            {
+                uint32_t length;
+                memcpy(&length, payload + offset, 4);
+                if (static_cast<uint64_t>(offset) + 4 + length > payloadSize)
+                    return fail("CORRUPT_PAYLOAD", function.Name);
+                sources.push_back(payload + offset + 4);
+                sourceLengths.push_back(static_cast<GLint>(length));
+                offset += 4 + length;
+            }
+            args[function.PayloadArg] = glTraceToBits(sources.data());
+            args[function.SizeArg] = glTraceToBits(sourceLengths.data());
+        }
+        else if (payloadSize > 0 && function.PayloadArg >= 0)
+        {
+            // without a payload the traced value stays: null or an offset into a bound buffer
+            args[function.PayloadArg] = glTraceToBits(payload);
+        }
+        frame.PayloadBytes += payloadSize;
+
+        uint64_t tracedResult = 0;
+        if (!read(&tracedResult, function.ReturnSize))
+            return false;
+        const char* tracedNames = nullptr;
+        uint32_t tracedNamesSize = 0;
+        if (function.GeneratesNames && !readPayload(tracedNames, tracedNamesSize))
+            return false;
+
+        // remapping and scratch memory for what the call writes
+        for (unsigned i = 0; i < function.ArgCount; ++i)
+        {
+            if (function.ArgSync[i])
+                args[i] = glTraceToBits(syncs[args[i]]);
+            else if (function.ArgOutput[i])
+                args[i] = glTraceToBits(static_cast<void*>(getScratch(function, args)));
+        }
+        if (function.UniformLocation)
+        {
+            const GLint location = glTraceFromBits<GLint>(args[0]);
+            std::unordered_map<uint64_t, GLint>::const_iterator found =
+                uniformLocations.find(static_cast<uint64_t>(currentProgram) << 32 | static_cast<uint32_t>(location));
+            if (found != uniformLocations.end())
+                args[0] = glTraceToBits(found->second);
+        }
+        if (function.Payload == GL_TRACE_PAYLOAD_UNMAP && payloadSize > 0)
+        {
+            for (size_t i = 0; i < mapped.size(); ++i)
+                if (mapped[i].first == static_cast<GLenum>(args[0]))
+                    memcpy(mapped[i].second, payload, payloadSize);
+        }
+
+        if (loaded[index] == nullptr)
+            return fail("FUNCTION_NOT_AVAILABLE", function.Name);
+        uint64_t result;
+        if (timing)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            result = function.Invoke(loaded[index], args);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            callStats[index].Seconds += seconds;
+            frame.CallTime += seconds;
+        }
+        else
+        {
+            result = function.Invoke(loaded[index], args);
+        }
+        ++callStats[index].Calls;
+        ++frame.Calls;
+        if (function.DrawCall)
+            ++frame.DrawCalls;
+
+        afterCall(index, function, args, result, tracedResult, tracedNames, tracedNamesSize);
+        return true;
+    }
+
+    void afterCall(unsigned index, const GlTraceFunction &function, const uint64_t *args, uint64_t result,
+                   uint64_t tracedResult, const char *tracedNames, uint32_t tracedNamesSize)
+    {
+        switch (index)
+        {
+            case GL_TRACE_glUseProgram:
+                currentProgram = static_cast<GLuint>(args[0]);
+                break;
+            case GL_TRACE_glGetUniformLocation:
+                uniformLocations[static_cast<uint64_t>(static_cast<GLuint>(args[0])) << 32 | static_cast<uint32_t>(tracedResult)] =
+                    glTraceFromBits<GLint>(result);
+                break;
+            case GL_TRACE_glFenceSync:
+                syncs[tracedResult] = glTraceFromBits<GLsync>(result);
+                break;
+            case GL_TRACE_glMapBufferRange:
+            case GL_TRACE_glMapBuffer:
+                mapped.push_back(std::make_pair(static_cast<GLenum>(args[0]), glTraceFromBits<void*>(result)));
+                break;
+            case GL_TRACE_glUnmapBuffer:
+                for (size_t i = 0; i < mapped.size(); ++i)
+                    if (mapped[i].first == static_cast<GLenum>(args[0]))
+                    {
+                        mapped.erase(mapped.begin() + i);
+                        break;
+                    }
+                break;
+            case GL_TRACE_glCreateProgram:
+            case GL_TRACE_glCreateShader:
+                if (result != tracedResult)
+                    ++mismatchedNames;
+                break;
+        }
+        // names the replay didn't even make room for count as mismatched
+        if (function.GeneratesNames && tracedNamesSize > 0 &&
+            (tracedNamesSize > scratch.size()*8 || memcmp(scratch.data(), tracedNames, tracedNamesSize) != 0))
+            ++mismatchedNames;
+    }
+
+    // scratch memory for the outputs of a call, large enough for glReadPixels and glGetBufferSubData
+    char* getScratch(const GlTraceFunction &function, const uint64_t *args)
+    {
+        uint64_t needed = SCRATCH_SIZE;
+        if (function.WidthArg >= 0 && function.HeightArg >= 0 && function.FormatArg >= 0 && function.TypeArg >= 0)
+            needed = std::max<uint64_t>(needed, gladPixelBytes(glTraceFromBits<GLsizei>(args[function.WidthArg]),
+                                                               glTraceFromBits<GLsizei>(args[function.HeightArg]), 1,
+                                                               static_cast<GLenum>(args[function.FormatArg]),
+                                                               static_cast<GLenum>(args[function.TypeArg]), 8));
+        if (function.SizeArg >= 0 && function.Payload == GL_TRACE_PAYLOAD_NONE)
+            needed = std::max(needed, args[function.SizeArg]);
+        if (scratch.size()*8 < needed)
+            scratch.resize((needed + 7)/8);
+        return reinterpret_cast<char*>(scratch.data());
+    }
+};
+
+#endif // GL_TRACE_H
@@ -0,0 +1,12 @@
+#ifndef GL_WINDOW_H
+#define GL_WINDOW_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// glfw + glad: initializes GLFW, creates a window with an OpenGL core profile context of version major.minor (hidden
+// unless visible, for the headless runs), makes the context current and loads all function pointers. nullptr after an
+// error, GLFW is terminated then. Part of the common library (common/src/gl_window.cpp)
+GLFWwindow* createGLWindow(int width, int height, const char* title, bool visible = true, int major = 3, int minor = 3);
+
+#endif
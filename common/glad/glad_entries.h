@@ -0,0 +1,398 @@
+/*
+
+    X-macro list of the OpenGL functions loaded by glad (glad/glad.h), one line per function in the order of glad.h:
+
+        GLAD_ENTRY(return type, name, function pointer type, (parameters), (arguments))
+        GLAD_VOID_ENTRY(name, function pointer type, (parameters), (arguments))
+
+    Define both macros before including it (the file has no include guard, so it can be expanded several times). It has to
+    be regenerated together with glad, from the "typedef ... (APIENTRYP PFN...PROC)(...)" lines of glad.h
+
+*/
+
+GLAD_VOID_ENTRY(glCullFace, PFNGLCULLFACEPROC, (GLenum mode), (mode))
+GLAD_VOID_ENTRY(glFrontFace, PFNGLFRONTFACEPROC, (GLenum mode), (mode))
+GLAD_VOID_ENTRY(glHint, PFNGLHINTPROC, (GLenum target, GLenum mode), (target, mode))
+GLAD_VOID_ENTRY(glLineWidth, PFNGLLINEWIDTHPROC, (GLfloat width), (width))
+GLAD_VOID_ENTRY(glPointSize, PFNGLPOINTSIZEPROC, (GLfloat size), (size))
+GLAD_VOID_ENTRY(glPolygonMode, PFNGLPOLYGONMODEPROC, (GLenum face, GLenum mode), (face, mode))
+GLAD_VOID_ENTRY(glScissor, PFNGLSCISSORPROC, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+GLAD_VOID_ENTRY(glTexParameterf, PFNGLTEXPARAMETERFPROC, (GLenum target, GLenum pname, GLfloat param), (target, pname, param))
+GLAD_VOID_ENTRY(glTexParameterfv, PFNGLTEXPARAMETERFVPROC, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params))
+GLAD_VOID_ENTRY(glTexParameteri, PFNGLTEXPARAMETERIPROC, (GLenum target, GLenum pname, GLint param), (target, pname, param))
+GLAD_VOID_ENTRY(glTexParameteriv, PFNGLTEXPARAMETERIVPROC, (GLenum target, GLenum pname, const GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glTexImage1D, PFNGLTEXIMAGE1DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, border, format, type, pixels))
+GLAD_VOID_ENTRY(glTexImage2D, PFNGLTEXIMAGE2DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, border, format, type, pixels))
+GLAD_VOID_ENTRY(glDrawBuffer, PFNGLDRAWBUFFERPROC, (GLenum buf), (buf))
+GLAD_VOID_ENTRY(glClear, PFNGLCLEARPROC, (GLbitfield mask), (mask))
+GLAD_VOID_ENTRY(glClearColor, PFNGLCLEARCOLORPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha))
+GLAD_VOID_ENTRY(glClearStencil, PFNGLCLEARSTENCILPROC, (GLint s), (s))
+GLAD_VOID_ENTRY(glClearDepth, PFNGLCLEARDEPTHPROC, (GLdouble depth), (depth))
+GLAD_VOID_ENTRY(glStencilMask, PFNGLSTENCILMASKPROC, (GLuint mask), (mask))
+GLAD_VOID_ENTRY(glColorMask, PFNGLCOLORMASKPROC, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha))
+GLAD_VOID_ENTRY(glDepthMask, PFNGLDEPTHMASKPROC, (GLboolean flag), (flag))
+GLAD_VOID_ENTRY(glDisable, PFNGLDISABLEPROC, (GLenum cap), (cap))
+GLAD_VOID_ENTRY(glEnable, PFNGLENABLEPROC, (GLenum cap), (cap))
+GLAD_VOID_ENTRY(glFinish, PFNGLFINISHPROC, (void), ())
+GLAD_VOID_ENTRY(glFlush, PFNGLFLUSHPROC, (void), ())
+GLAD_VOID_ENTRY(glBlendFunc, PFNGLBLENDFUNCPROC, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor))
+GLAD_VOID_ENTRY(glLogicOp, PFNGLLOGICOPPROC, (GLenum opcode), (opcode))
+GLAD_VOID_ENTRY(glStencilFunc, PFNGLSTENCILFUNCPROC, (GLenum func, GLint ref, GLuint mask), (func, ref, mask))
+GLAD_VOID_ENTRY(glStencilOp, PFNGLSTENCILOPPROC, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass))
+GLAD_VOID_ENTRY(glDepthFunc, PFNGLDEPTHFUNCPROC, (GLenum func), (func))
+GLAD_VOID_ENTRY(glPixelStoref, PFNGLPIXELSTOREFPROC, (GLenum pname, GLfloat param), (pname, param))
+GLAD_VOID_ENTRY(glPixelStorei, PFNGLPIXELSTOREIPROC, (GLenum pname, GLint param), (pname, param))
+GLAD_VOID_ENTRY(glReadBuffer, PFNGLREADBUFFERPROC, (GLenum src), (src))
+GLAD_VOID_ENTRY(glReadPixels, PFNGLREADPIXELSPROC, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels), (x, y, width, height, format, type, pixels))
+GLAD_VOID_ENTRY(glGetBooleanv, PFNGLGETBOOLEANVPROC, (GLenum pname, GLboolean *data), (pname, data))
+GLAD_VOID_ENTRY(glGetDoublev, PFNGLGETDOUBLEVPROC, (GLenum pname, GLdouble *data), (pname, data))
+GLAD_ENTRY(GLenum, glGetError, PFNGLGETERRORPROC, (void), ())
+GLAD_VOID_ENTRY(glGetFloatv, PFNGLGETFLOATVPROC, (GLenum pname, GLfloat *data), (pname, data))
+GLAD_VOID_ENTRY(glGetIntegerv, PFNGLGETINTEGERVPROC, (GLenum pname, GLint *data), (pname, data))
+GLAD_ENTRY(const GLubyte *, glGetString, PFNGLGETSTRINGPROC, (GLenum name), (name))
+GLAD_VOID_ENTRY(glGetTexImage, PFNGLGETTEXIMAGEPROC, (GLenum target, GLint level, GLenum format, GLenum type, void *pixels), (target, level, format, type, pixels))
+GLAD_VOID_ENTRY(glGetTexParameterfv, PFNGLGETTEXPARAMETERFVPROC, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetTexParameteriv, PFNGLGETTEXPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetTexLevelParameterfv, PFNGLGETTEXLEVELPARAMETERFVPROC, (GLenum target, GLint level, GLenum pname, GLfloat *params), (target, level, pname, params))
+GLAD_VOID_ENTRY(glGetTexLevelParameteriv, PFNGLGETTEXLEVELPARAMETERIVPROC, (GLenum target, GLint level, GLenum pname, GLint *params), (target, level, pname, params))
+GLAD_ENTRY(GLboolean, glIsEnabled, PFNGLISENABLEDPROC, (GLenum cap), (cap))
+GLAD_VOID_ENTRY(glDepthRange, PFNGLDEPTHRANGEPROC, (GLdouble n, GLdouble f), (n, f))
+GLAD_VOID_ENTRY(glViewport, PFNGLVIEWPORTPROC, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+GLAD_VOID_ENTRY(glDrawArrays, PFNGLDRAWARRAYSPROC, (GLenum mode, GLint first, GLsizei count), (mode, first, count))
+GLAD_VOID_ENTRY(glDrawElements, PFNGLDRAWELEMENTSPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices), (mode, count, type, indices))
+GLAD_VOID_ENTRY(glPolygonOffset, PFNGLPOLYGONOFFSETPROC, (GLfloat factor, GLfloat units), (factor, units))
+GLAD_VOID_ENTRY(glCopyTexImage1D, PFNGLCOPYTEXIMAGE1DPROC, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border), (target, level, internalformat, x, y, width, border))
+GLAD_VOID_ENTRY(glCopyTexImage2D, PFNGLCOPYTEXIMAGE2DPROC, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border))
+GLAD_VOID_ENTRY(glCopyTexSubImage1D, PFNGLCOPYTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width), (target, level, xoffset, x, y, width))
+GLAD_VOID_ENTRY(glCopyTexSubImage2D, PFNGLCOPYTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height))
+GLAD_VOID_ENTRY(glTexSubImage1D, PFNGLTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, width, format, type, pixels))
+GLAD_VOID_ENTRY(glTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels))
+GLAD_VOID_ENTRY(glBindTexture, PFNGLBINDTEXTUREPROC, (GLenum target, GLuint texture), (target, texture))
+GLAD_VOID_ENTRY(glDeleteTextures, PFNGLDELETETEXTURESPROC, (GLsizei n, const GLuint *textures), (n, textures))
+GLAD_VOID_ENTRY(glGenTextures, PFNGLGENTEXTURESPROC, (GLsizei n, GLuint *textures), (n, textures))
+GLAD_ENTRY(GLboolean, glIsTexture, PFNGLISTEXTUREPROC, (GLuint texture), (texture))
+GLAD_VOID_ENTRY(glDrawRangeElements, PFNGLDRAWRANGEELEMENTSPROC, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices), (mode, start, end, count, type, indices))
+GLAD_VOID_ENTRY(glTexImage3D, PFNGLTEXIMAGE3DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, depth, border, format, type, pixels))
+GLAD_VOID_ENTRY(glTexSubImage3D, PFNGLTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels))
+GLAD_VOID_ENTRY(glCopyTexSubImage3D, PFNGLCOPYTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, zoffset, x, y, width, height))
+GLAD_VOID_ENTRY(glActiveTexture, PFNGLACTIVETEXTUREPROC, (GLenum texture), (texture))
+GLAD_VOID_ENTRY(glSampleCoverage, PFNGLSAMPLECOVERAGEPROC, (GLfloat value, GLboolean invert), (value, invert))
+GLAD_VOID_ENTRY(glCompressedTexImage3D, PFNGLCOMPRESSEDTEXIMAGE3DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, depth, border, imageSize, data))
+GLAD_VOID_ENTRY(glCompressedTexImage2D, PFNGLCOMPRESSEDTEXIMAGE2DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, border, imageSize, data))
+GLAD_VOID_ENTRY(glCompressedTexImage1D, PFNGLCOMPRESSEDTEXIMAGE1DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, border, imageSize, data))
+GLAD_VOID_ENTRY(glCompressedTexSubImage3D, PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data))
+GLAD_VOID_ENTRY(glCompressedTexSubImage2D, PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data))
+GLAD_VOID_ENTRY(glCompressedTexSubImage1D, PFNGLCOMPRESSEDTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, width, format, imageSize, data))
+GLAD_VOID_ENTRY(glGetCompressedTexImage, PFNGLGETCOMPRESSEDTEXIMAGEPROC, (GLenum target, GLint level, void *img), (target, level, img))
+GLAD_VOID_ENTRY(glBlendFuncSeparate, PFNGLBLENDFUNCSEPARATEPROC, (GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha), (sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha))
+GLAD_VOID_ENTRY(glMultiDrawArrays, PFNGLMULTIDRAWARRAYSPROC, (GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount), (mode, first, count, drawcount))
+GLAD_VOID_ENTRY(glMultiDrawElements, PFNGLMULTIDRAWELEMENTSPROC, (GLenum mode, const GLsizei *count, GLenum type, const void *const*indices, GLsizei drawcount), (mode, count, type, indices, drawcount))
+GLAD_VOID_ENTRY(glPointParameterf, PFNGLPOINTPARAMETERFPROC, (GLenum pname, GLfloat param), (pname, param))
+GLAD_VOID_ENTRY(glPointParameterfv, PFNGLPOINTPARAMETERFVPROC, (GLenum pname, const GLfloat *params), (pname, params))
+GLAD_VOID_ENTRY(glPointParameteri, PFNGLPOINTPARAMETERIPROC, (GLenum pname, GLint param), (pname, param))
+GLAD_VOID_ENTRY(glPointParameteriv, PFNGLPOINTPARAMETERIVPROC, (GLenum pname, const GLint *params), (pname, params))
+GLAD_VOID_ENTRY(glBlendColor, PFNGLBLENDCOLORPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha))
+GLAD_VOID_ENTRY(glBlendEquation, PFNGLBLENDEQUATIONPROC, (GLenum mode), (mode))
+GLAD_VOID_ENTRY(glGenQueries, PFNGLGENQUERIESPROC, (GLsizei n, GLuint *ids), (n, ids))
+GLAD_VOID_ENTRY(glDeleteQueries, PFNGLDELETEQUERIESPROC, (GLsizei n, const GLuint *ids), (n, ids))
+GLAD_ENTRY(GLboolean, glIsQuery, PFNGLISQUERYPROC, (GLuint id), (id))
+GLAD_VOID_ENTRY(glBeginQuery, PFNGLBEGINQUERYPROC, (GLenum target, GLuint id), (target, id))
+GLAD_VOID_ENTRY(glEndQuery, PFNGLENDQUERYPROC, (GLenum target), (target))
+GLAD_VOID_ENTRY(glGetQueryiv, PFNGLGETQUERYIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC, (GLuint id, GLenum pname, GLint *params), (id, pname, params))
+GLAD_VOID_ENTRY(glGetQueryObjectuiv, PFNGLGETQUERYOBJECTUIVPROC, (GLuint id, GLenum pname, GLuint *params), (id, pname, params))
+GLAD_VOID_ENTRY(glBindBuffer, PFNGLBINDBUFFERPROC, (GLenum target, GLuint buffer), (target, buffer))
+GLAD_VOID_ENTRY(glDeleteBuffers, PFNGLDELETEBUFFERSPROC, (GLsizei n, const GLuint *buffers), (n, buffers))
+GLAD_VOID_ENTRY(glGenBuffers, PFNGLGENBUFFERSPROC, (GLsizei n, GLuint *buffers), (n, buffers))
+GLAD_ENTRY(GLboolean, glIsBuffer, PFNGLISBUFFERPROC, (GLuint buffer), (buffer))
+GLAD_VOID_ENTRY(glBufferData, PFNGLBUFFERDATAPROC, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage))
+GLAD_VOID_ENTRY(glBufferSubData, PFNGLBUFFERSUBDATAPROC, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data), (target, offset, size, data))
+GLAD_VOID_ENTRY(glGetBufferSubData, PFNGLGETBUFFERSUBDATAPROC, (GLenum target, GLintptr offset, GLsizeiptr size, void *data), (target, offset, size, data))
+GLAD_ENTRY(void *, glMapBuffer, PFNGLMAPBUFFERPROC, (GLenum target, GLenum access), (target, access))
+GLAD_ENTRY(GLboolean, glUnmapBuffer, PFNGLUNMAPBUFFERPROC, (GLenum target), (target))
+GLAD_VOID_ENTRY(glGetBufferParameteriv, PFNGLGETBUFFERPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetBufferPointerv, PFNGLGETBUFFERPOINTERVPROC, (GLenum target, GLenum pname, void **params), (target, pname, params))
+GLAD_VOID_ENTRY(glBlendEquationSeparate, PFNGLBLENDEQUATIONSEPARATEPROC, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha))
+GLAD_VOID_ENTRY(glDrawBuffers, PFNGLDRAWBUFFERSPROC, (GLsizei n, const GLenum *bufs), (n, bufs))
+GLAD_VOID_ENTRY(glStencilOpSeparate, PFNGLSTENCILOPSEPARATEPROC, (GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass), (face, sfail, dpfail, dppass))
+GLAD_VOID_ENTRY(glStencilFuncSeparate, PFNGLSTENCILFUNCSEPARATEPROC, (GLenum face, GLenum func, GLint ref, GLuint mask), (face, func, ref, mask))
+GLAD_VOID_ENTRY(glStencilMaskSeparate, PFNGLSTENCILMASKSEPARATEPROC, (GLenum face, GLuint mask), (face, mask))
+GLAD_VOID_ENTRY(glAttachShader, PFNGLATTACHSHADERPROC, (GLuint program, GLuint shader), (program, shader))
+GLAD_VOID_ENTRY(glBindAttribLocation, PFNGLBINDATTRIBLOCATIONPROC, (GLuint program, GLuint index, const GLchar *name), (program, index, name))
+GLAD_VOID_ENTRY(glCompileShader, PFNGLCOMPILESHADERPROC, (GLuint shader), (shader))
+GLAD_ENTRY(GLuint, glCreateProgram, PFNGLCREATEPROGRAMPROC, (void), ())
+GLAD_ENTRY(GLuint, glCreateShader, PFNGLCREATESHADERPROC, (GLenum type), (type))
+GLAD_VOID_ENTRY(glDeleteProgram, PFNGLDELETEPROGRAMPROC, (GLuint program), (program))
+GLAD_VOID_ENTRY(glDeleteShader, PFNGLDELETESHADERPROC, (GLuint shader), (shader))
+GLAD_VOID_ENTRY(glDetachShader, PFNGLDETACHSHADERPROC, (GLuint program, GLuint shader), (program, shader))
+GLAD_VOID_ENTRY(glDisableVertexAttribArray, PFNGLDISABLEVERTEXATTRIBARRAYPROC, (GLuint index), (index))
+GLAD_VOID_ENTRY(glEnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC, (GLuint index), (index))
+GLAD_VOID_ENTRY(glGetActiveAttrib, PFNGLGETACTIVEATTRIBPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GLAD_VOID_ENTRY(glGetActiveUniform, PFNGLGETACTIVEUNIFORMPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GLAD_VOID_ENTRY(glGetAttachedShaders, PFNGLGETATTACHEDSHADERSPROC, (GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders), (program, maxCount, count, shaders))
+GLAD_ENTRY(GLint, glGetAttribLocation, PFNGLGETATTRIBLOCATIONPROC, (GLuint program, const GLchar *name), (program, name))
+GLAD_VOID_ENTRY(glGetProgramiv, PFNGLGETPROGRAMIVPROC, (GLuint program, GLenum pname, GLint *params), (program, pname, params))
+GLAD_VOID_ENTRY(glGetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (program, bufSize, length, infoLog))
+GLAD_VOID_ENTRY(glGetShaderiv, PFNGLGETSHADERIVPROC, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params))
+GLAD_VOID_ENTRY(glGetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (shader, bufSize, length, infoLog))
+GLAD_VOID_ENTRY(glGetShaderSource, PFNGLGETSHADERSOURCEPROC, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source), (shader, bufSize, length, source))
+GLAD_ENTRY(GLint, glGetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC, (GLuint program, const GLchar *name), (program, name))
+GLAD_VOID_ENTRY(glGetUniformfv, PFNGLGETUNIFORMFVPROC, (GLuint program, GLint location, GLfloat *params), (program, location, params))
+GLAD_VOID_ENTRY(glGetUniformiv, PFNGLGETUNIFORMIVPROC, (GLuint program, GLint location, GLint *params), (program, location, params))
+GLAD_VOID_ENTRY(glGetVertexAttribdv, PFNGLGETVERTEXATTRIBDVPROC, (GLuint index, GLenum pname, GLdouble *params), (index, pname, params))
+GLAD_VOID_ENTRY(glGetVertexAttribfv, PFNGLGETVERTEXATTRIBFVPROC, (GLuint index, GLenum pname, GLfloat *params), (index, pname, params))
+GLAD_VOID_ENTRY(glGetVertexAttribiv, PFNGLGETVERTEXATTRIBIVPROC, (GLuint index, GLenum pname, GLint *params), (index, pname, params))
+GLAD_VOID_ENTRY(glGetVertexAttribPointerv, PFNGLGETVERTEXATTRIBPOINTERVPROC, (GLuint index, GLenum pname, void **pointer), (index, pname, pointer))
+GLAD_ENTRY(GLboolean, glIsProgram, PFNGLISPROGRAMPROC, (GLuint program), (program))
+GLAD_ENTRY(GLboolean, glIsShader, PFNGLISSHADERPROC, (GLuint shader), (shader))
+GLAD_VOID_ENTRY(glLinkProgram, PFNGLLINKPROGRAMPROC, (GLuint program), (program))
+GLAD_VOID_ENTRY(glShaderSource, PFNGLSHADERSOURCEPROC, (GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length), (shader, count, string, length))
+GLAD_VOID_ENTRY(glUseProgram, PFNGLUSEPROGRAMPROC, (GLuint program), (program))
+GLAD_VOID_ENTRY(glUniform1f, PFNGLUNIFORM1FPROC, (GLint location, GLfloat v0), (location, v0))
+GLAD_VOID_ENTRY(glUniform2f, PFNGLUNIFORM2FPROC, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1))
+GLAD_VOID_ENTRY(glUniform3f, PFNGLUNIFORM3FPROC, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2))
+GLAD_VOID_ENTRY(glUniform4f, PFNGLUNIFORM4FPROC, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3))
+GLAD_VOID_ENTRY(glUniform1i, PFNGLUNIFORM1IPROC, (GLint location, GLint v0), (location, v0))
+GLAD_VOID_ENTRY(glUniform2i, PFNGLUNIFORM2IPROC, (GLint location, GLint v0, GLint v1), (location, v0, v1))
+GLAD_VOID_ENTRY(glUniform3i, PFNGLUNIFORM3IPROC, (GLint location, GLint v0, GLint v1, GLint v2), (location, v0, v1, v2))
+GLAD_VOID_ENTRY(glUniform4i, PFNGLUNIFORM4IPROC, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (location, v0, v1, v2, v3))
+GLAD_VOID_ENTRY(glUniform1fv, PFNGLUNIFORM1FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform2fv, PFNGLUNIFORM2FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform3fv, PFNGLUNIFORM3FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform4fv, PFNGLUNIFORM4FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform1iv, PFNGLUNIFORM1IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform2iv, PFNGLUNIFORM2IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform3iv, PFNGLUNIFORM3IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform4iv, PFNGLUNIFORM4IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniformMatrix2fv, PFNGLUNIFORMMATRIX2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix3fv, PFNGLUNIFORMMATRIX3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glValidateProgram, PFNGLVALIDATEPROGRAMPROC, (GLuint program), (program))
+GLAD_VOID_ENTRY(glVertexAttrib1d, PFNGLVERTEXATTRIB1DPROC, (GLuint index, GLdouble x), (index, x))
+GLAD_VOID_ENTRY(glVertexAttrib1dv, PFNGLVERTEXATTRIB1DVPROC, (GLuint index, const GLdouble *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib1f, PFNGLVERTEXATTRIB1FPROC, (GLuint index, GLfloat x), (index, x))
+GLAD_VOID_ENTRY(glVertexAttrib1fv, PFNGLVERTEXATTRIB1FVPROC, (GLuint index, const GLfloat *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib1s, PFNGLVERTEXATTRIB1SPROC, (GLuint index, GLshort x), (index, x))
+GLAD_VOID_ENTRY(glVertexAttrib1sv, PFNGLVERTEXATTRIB1SVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib2d, PFNGLVERTEXATTRIB2DPROC, (GLuint index, GLdouble x, GLdouble y), (index, x, y))
+GLAD_VOID_ENTRY(glVertexAttrib2dv, PFNGLVERTEXATTRIB2DVPROC, (GLuint index, const GLdouble *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib2f, PFNGLVERTEXATTRIB2FPROC, (GLuint index, GLfloat x, GLfloat y), (index, x, y))
+GLAD_VOID_ENTRY(glVertexAttrib2fv, PFNGLVERTEXATTRIB2FVPROC, (GLuint index, const GLfloat *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib2s, PFNGLVERTEXATTRIB2SPROC, (GLuint index, GLshort x, GLshort y), (index, x, y))
+GLAD_VOID_ENTRY(glVertexAttrib2sv, PFNGLVERTEXATTRIB2SVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib3d, PFNGLVERTEXATTRIB3DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z), (index, x, y, z))
+GLAD_VOID_ENTRY(glVertexAttrib3dv, PFNGLVERTEXATTRIB3DVPROC, (GLuint index, const GLdouble *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib3f, PFNGLVERTEXATTRIB3FPROC, (GLuint index, GLfloat x, GLfloat y, GLfloat z), (index, x, y, z))
+GLAD_VOID_ENTRY(glVertexAttrib3fv, PFNGLVERTEXATTRIB3FVPROC, (GLuint index, const GLfloat *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib3s, PFNGLVERTEXATTRIB3SPROC, (GLuint index, GLshort x, GLshort y, GLshort z), (index, x, y, z))
+GLAD_VOID_ENTRY(glVertexAttrib3sv, PFNGLVERTEXATTRIB3SVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Nbv, PFNGLVERTEXATTRIB4NBVPROC, (GLuint index, const GLbyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Niv, PFNGLVERTEXATTRIB4NIVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Nsv, PFNGLVERTEXATTRIB4NSVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Nub, PFNGLVERTEXATTRIB4NUBPROC, (GLuint index, GLubyte x, GLubyte y, GLubyte z, GLubyte w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttrib4Nubv, PFNGLVERTEXATTRIB4NUBVPROC, (GLuint index, const GLubyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Nuiv, PFNGLVERTEXATTRIB4NUIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4Nusv, PFNGLVERTEXATTRIB4NUSVPROC, (GLuint index, const GLushort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4bv, PFNGLVERTEXATTRIB4BVPROC, (GLuint index, const GLbyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4d, PFNGLVERTEXATTRIB4DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z, GLdouble w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttrib4dv, PFNGLVERTEXATTRIB4DVPROC, (GLuint index, const GLdouble *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4f, PFNGLVERTEXATTRIB4FPROC, (GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttrib4fv, PFNGLVERTEXATTRIB4FVPROC, (GLuint index, const GLfloat *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4iv, PFNGLVERTEXATTRIB4IVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4s, PFNGLVERTEXATTRIB4SPROC, (GLuint index, GLshort x, GLshort y, GLshort z, GLshort w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttrib4sv, PFNGLVERTEXATTRIB4SVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4ubv, PFNGLVERTEXATTRIB4UBVPROC, (GLuint index, const GLubyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4uiv, PFNGLVERTEXATTRIB4UIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttrib4usv, PFNGLVERTEXATTRIB4USVPROC, (GLuint index, const GLushort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), (index, size, type, normalized, stride, pointer))
+GLAD_VOID_ENTRY(glUniformMatrix2x3fv, PFNGLUNIFORMMATRIX2X3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix3x2fv, PFNGLUNIFORMMATRIX3X2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix2x4fv, PFNGLUNIFORMMATRIX2X4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix4x2fv, PFNGLUNIFORMMATRIX4X2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix3x4fv, PFNGLUNIFORMMATRIX3X4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glUniformMatrix4x3fv, PFNGLUNIFORMMATRIX4X3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GLAD_VOID_ENTRY(glColorMaski, PFNGLCOLORMASKIPROC, (GLuint index, GLboolean r, GLboolean g, GLboolean b, GLboolean a), (index, r, g, b, a))
+GLAD_VOID_ENTRY(glGetBooleani_v, PFNGLGETBOOLEANI_VPROC, (GLenum target, GLuint index, GLboolean *data), (target, index, data))
+GLAD_VOID_ENTRY(glGetIntegeri_v, PFNGLGETINTEGERI_VPROC, (GLenum target, GLuint index, GLint *data), (target, index, data))
+GLAD_VOID_ENTRY(glEnablei, PFNGLENABLEIPROC, (GLenum target, GLuint index), (target, index))
+GLAD_VOID_ENTRY(glDisablei, PFNGLDISABLEIPROC, (GLenum target, GLuint index), (target, index))
+GLAD_ENTRY(GLboolean, glIsEnabledi, PFNGLISENABLEDIPROC, (GLenum target, GLuint index), (target, index))
+GLAD_VOID_ENTRY(glBeginTransformFeedback, PFNGLBEGINTRANSFORMFEEDBACKPROC, (GLenum primitiveMode), (primitiveMode))
+GLAD_VOID_ENTRY(glEndTransformFeedback, PFNGLENDTRANSFORMFEEDBACKPROC, (void), ())
+GLAD_VOID_ENTRY(glBindBufferRange, PFNGLBINDBUFFERRANGEPROC, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, index, buffer, offset, size))
+GLAD_VOID_ENTRY(glBindBufferBase, PFNGLBINDBUFFERBASEPROC, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer))
+GLAD_VOID_ENTRY(glTransformFeedbackVaryings, PFNGLTRANSFORMFEEDBACKVARYINGSPROC, (GLuint program, GLsizei count, const GLchar *const*varyings, GLenum bufferMode), (program, count, varyings, bufferMode))
+GLAD_VOID_ENTRY(glGetTransformFeedbackVarying, PFNGLGETTRANSFORMFEEDBACKVARYINGPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLsizei *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GLAD_VOID_ENTRY(glClampColor, PFNGLCLAMPCOLORPROC, (GLenum target, GLenum clamp), (target, clamp))
+GLAD_VOID_ENTRY(glBeginConditionalRender, PFNGLBEGINCONDITIONALRENDERPROC, (GLuint id, GLenum mode), (id, mode))
+GLAD_VOID_ENTRY(glEndConditionalRender, PFNGLENDCONDITIONALRENDERPROC, (void), ())
+GLAD_VOID_ENTRY(glVertexAttribIPointer, PFNGLVERTEXATTRIBIPOINTERPROC, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer))
+GLAD_VOID_ENTRY(glGetVertexAttribIiv, PFNGLGETVERTEXATTRIBIIVPROC, (GLuint index, GLenum pname, GLint *params), (index, pname, params))
+GLAD_VOID_ENTRY(glGetVertexAttribIuiv, PFNGLGETVERTEXATTRIBIUIVPROC, (GLuint index, GLenum pname, GLuint *params), (index, pname, params))
+GLAD_VOID_ENTRY(glVertexAttribI1i, PFNGLVERTEXATTRIBI1IPROC, (GLuint index, GLint x), (index, x))
+GLAD_VOID_ENTRY(glVertexAttribI2i, PFNGLVERTEXATTRIBI2IPROC, (GLuint index, GLint x, GLint y), (index, x, y))
+GLAD_VOID_ENTRY(glVertexAttribI3i, PFNGLVERTEXATTRIBI3IPROC, (GLuint index, GLint x, GLint y, GLint z), (index, x, y, z))
+GLAD_VOID_ENTRY(glVertexAttribI4i, PFNGLVERTEXATTRIBI4IPROC, (GLuint index, GLint x, GLint y, GLint z, GLint w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttribI1ui, PFNGLVERTEXATTRIBI1UIPROC, (GLuint index, GLuint x), (index, x))
+GLAD_VOID_ENTRY(glVertexAttribI2ui, PFNGLVERTEXATTRIBI2UIPROC, (GLuint index, GLuint x, GLuint y), (index, x, y))
+GLAD_VOID_ENTRY(glVertexAttribI3ui, PFNGLVERTEXATTRIBI3UIPROC, (GLuint index, GLuint x, GLuint y, GLuint z), (index, x, y, z))
+GLAD_VOID_ENTRY(glVertexAttribI4ui, PFNGLVERTEXATTRIBI4UIPROC, (GLuint index, GLuint x, GLuint y, GLuint z, GLuint w), (index, x, y, z, w))
+GLAD_VOID_ENTRY(glVertexAttribI1iv, PFNGLVERTEXATTRIBI1IVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI2iv, PFNGLVERTEXATTRIBI2IVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI3iv, PFNGLVERTEXATTRIBI3IVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4iv, PFNGLVERTEXATTRIBI4IVPROC, (GLuint index, const GLint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI1uiv, PFNGLVERTEXATTRIBI1UIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI2uiv, PFNGLVERTEXATTRIBI2UIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI3uiv, PFNGLVERTEXATTRIBI3UIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4uiv, PFNGLVERTEXATTRIBI4UIVPROC, (GLuint index, const GLuint *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4bv, PFNGLVERTEXATTRIBI4BVPROC, (GLuint index, const GLbyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4sv, PFNGLVERTEXATTRIBI4SVPROC, (GLuint index, const GLshort *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4ubv, PFNGLVERTEXATTRIBI4UBVPROC, (GLuint index, const GLubyte *v), (index, v))
+GLAD_VOID_ENTRY(glVertexAttribI4usv, PFNGLVERTEXATTRIBI4USVPROC, (GLuint index, const GLushort *v), (index, v))
+GLAD_VOID_ENTRY(glGetUniformuiv, PFNGLGETUNIFORMUIVPROC, (GLuint program, GLint location, GLuint *params), (program, location, params))
+GLAD_VOID_ENTRY(glBindFragDataLocation, PFNGLBINDFRAGDATALOCATIONPROC, (GLuint program, GLuint color, const GLchar *name), (program, color, name))
+GLAD_ENTRY(GLint, glGetFragDataLocation, PFNGLGETFRAGDATALOCATIONPROC, (GLuint program, const GLchar *name), (program, name))
+GLAD_VOID_ENTRY(glUniform1ui, PFNGLUNIFORM1UIPROC, (GLint location, GLuint v0), (location, v0))
+GLAD_VOID_ENTRY(glUniform2ui, PFNGLUNIFORM2UIPROC, (GLint location, GLuint v0, GLuint v1), (location, v0, v1))
+GLAD_VOID_ENTRY(glUniform3ui, PFNGLUNIFORM3UIPROC, (GLint location, GLuint v0, GLuint v1, GLuint v2), (location, v0, v1, v2))
+GLAD_VOID_ENTRY(glUniform4ui, PFNGLUNIFORM4UIPROC, (GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (location, v0, v1, v2, v3))
+GLAD_VOID_ENTRY(glUniform1uiv, PFNGLUNIFORM1UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform2uiv, PFNGLUNIFORM2UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform3uiv, PFNGLUNIFORM3UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GLAD_VOID_ENTRY(glUniform4uiv, PFNGLUNIFORM4UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GLAD_VOID_ENTRY(glTexParameterIiv, PFNGLTEXPARAMETERIIVPROC, (GLenum target, GLenum pname, const GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glTexParameterIuiv, PFNGLTEXPARAMETERIUIVPROC, (GLenum target, GLenum pname, const GLuint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetTexParameterIiv, PFNGLGETTEXPARAMETERIIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glGetTexParameterIuiv, PFNGLGETTEXPARAMETERIUIVPROC, (GLenum target, GLenum pname, GLuint *params), (target, pname, params))
+GLAD_VOID_ENTRY(glClearBufferiv, PFNGLCLEARBUFFERIVPROC, (GLenum buffer, GLint drawbuffer, const GLint *value), (buffer, drawbuffer, value))
+GLAD_VOID_ENTRY(glClearBufferuiv, PFNGLCLEARBUFFERUIVPROC, (GLenum buffer, GLint drawbuffer, const GLuint *value), (buffer, drawbuffer, value))
+GLAD_VOID_ENTRY(glClearBufferfv, PFNGLCLEARBUFFERFVPROC, (GLenum buffer, GLint drawbuffer, const GLfloat *value), (buffer, drawbuffer, value))
+GLAD_VOID_ENTRY(glClearBufferfi, PFNGLCLEARBUFFERFIPROC, (GLenum buffer, GLint drawbuffer, GLfloat depth, GLint stencil), (buffer, drawbuffer, depth, stencil))
+GLAD_ENTRY(const GLubyte *, glGetStringi, PFNGLGETSTRINGIPROC, (GLenum name, GLuint index), (name, index))
+GLAD_ENTRY(GLboolean, glIsRenderbuffer, PFNGLISRENDERBUFFERPROC, (GLuint renderbuffer), (renderbuffer))
+GLAD_VOID_ENTRY(glBindRenderbuffer, PFNGLBINDRENDERBUFFERPROC, (GLenum target, GLuint renderbuffer), (target, renderbuffer))
+GLAD_VOID_ENTRY(glDeleteRenderbuffers, PFNGLDELETERENDERBUFFERSPROC, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers))
+GLAD_VOID_ENTRY(glGenRenderbuffers, PFNGLGENRENDERBUFFERSPROC, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers))
+GLAD_VOID_ENTRY(glRenderbufferStorage, PFNGLRENDERBUFFERSTORAGEPROC, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height))
+GLAD_VOID_ENTRY(glGetRenderbufferParameteriv, PFNGLGETRENDERBUFFERPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GLAD_ENTRY(GLboolean, glIsFramebuffer, PFNGLISFRAMEBUFFERPROC, (GLuint framebuffer), (framebuffer))
+GLAD_VOID_ENTRY(glBindFramebuffer, PFNGLBINDFRAMEBUFFERPROC, (GLenum target, GLuint framebuffer), (target, framebuffer))
+GLAD_VOID_ENTRY(glDeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC, (GLsizei n, const GLuint *framebuffers), (n, framebuffers))
+GLAD_VOID_ENTRY(glGenFramebuffers, PFNGLGENFRAMEBUFFERSPROC, (GLsizei n, GLuint *framebuffers), (n, framebuffers))
+GLAD_ENTRY(GLenum, glCheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC, (GLenum target), (target))
+GLAD_VOID_ENTRY(glFramebufferTexture1D, PFNGLFRAMEBUFFERTEXTURE1DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level))
+GLAD_VOID_ENTRY(glFramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level))
+GLAD_VOID_ENTRY(glFramebufferTexture3D, PFNGLFRAMEBUFFERTEXTURE3DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset), (target, attachment, textarget, texture, level, zoffset))
+GLAD_VOID_ENTRY(glFramebufferRenderbuffer, PFNGLFRAMEBUFFERRENDERBUFFERPROC, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer))
+GLAD_VOID_ENTRY(glGetFramebufferAttachmentParameteriv, PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params))
+GLAD_VOID_ENTRY(glGenerateMipmap, PFNGLGENERATEMIPMAPPROC, (GLenum target), (target))
+GLAD_VOID_ENTRY(glBlitFramebuffer, PFNGLBLITFRAMEBUFFERPROC, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter))
+GLAD_VOID_ENTRY(glRenderbufferStorageMultisample, PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height), (target, samples, internalformat, width, height))
+GLAD_VOID_ENTRY(glFramebufferTextureLayer, PFNGLFRAMEBUFFERTEXTURELAYERPROC, (GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer), (target, attachment, texture, level, layer))
+GLAD_ENTRY(void *, glMapBufferRange, PFNGLMAPBUFFERRANGEPROC, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access))
+GLAD_VOID_ENTRY(glFlushMappedBufferRange, PFNGLFLUSHMAPPEDBUFFERRANGEPROC, (GLenum target, GLintptr offset, GLsizeiptr length), (target, offset, length))
+GLAD_VOID_ENTRY(glBindVertexArray, PFNGLBINDVERTEXARRAYPROC, (GLuint array), (array))
+GLAD_VOID_ENTRY(glDeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC, (GLsizei n, const GLuint *arrays), (n, arrays))
+GLAD_VOID_ENTRY(glGenVertexArrays, PFNGLGENVERTEXARRAYSPROC, (GLsizei n, GLuint *arrays), (n, arrays))
+GLAD_ENTRY(GLboolean, glIsVertexArray, PFNGLISVERTEXARRAYPROC, (GLuint array), (array))
+GLAD_VOID_ENTRY(glDrawArraysInstanced, PFNGLDRAWARRAYSINSTANCEDPROC, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount), (mode, first, count, instancecount))
+GLAD_VOID_ENTRY(glDrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount), (mode, count, type, indices, instancecount))
+GLAD_VOID_ENTRY(glTexBuffer, PFNGLTEXBUFFERPROC, (GLenum target, GLenum internalformat, GLuint buffer), (target, internalformat, buffer))
+GLAD_VOID_ENTRY(glPrimitiveRestartIndex, PFNGLPRIMITIVERESTARTINDEXPROC, (GLuint index), (index))
+GLAD_VOID_ENTRY(glCopyBufferSubData, PFNGLCOPYBUFFERSUBDATAPROC, (GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size), (readTarget, writeTarget, readOffset, writeOffset, size))
+GLAD_VOID_ENTRY(glGetUniformIndices, PFNGLGETUNIFORMINDICESPROC, (GLuint program, GLsizei uniformCount, const GLchar *const*uniformNames, GLuint *uniformIndices), (program, uniformCount, uniformNames, uniformIndices))
+GLAD_VOID_ENTRY(glGetActiveUniformsiv, PFNGLGETACTIVEUNIFORMSIVPROC, (GLuint program, GLsizei uniformCount, const GLuint *uniformIndices, GLenum pname, GLint *params), (program, uniformCount, uniformIndices, pname, params))
+GLAD_VOID_ENTRY(glGetActiveUniformName, PFNGLGETACTIVEUNIFORMNAMEPROC, (GLuint program, GLuint uniformIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformName), (program, uniformIndex, bufSize, length, uniformName))
+GLAD_ENTRY(GLuint, glGetUniformBlockIndex, PFNGLGETUNIFORMBLOCKINDEXPROC, (GLuint program, const GLchar *uniformBlockName), (program, uniformBlockName))
+GLAD_VOID_ENTRY(glGetActiveUniformBlockiv, PFNGLGETACTIVEUNIFORMBLOCKIVPROC, (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params), (program, uniformBlockIndex, pname, params))
+GLAD_VOID_ENTRY(glGetActiveUniformBlockName, PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC, (GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName), (program, uniformBlockIndex, bufSize, length, uniformBlockName))
+GLAD_VOID_ENTRY(glUniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC, (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding), (program, uniformBlockIndex, uniformBlockBinding))
+GLAD_VOID_ENTRY(glDrawElementsBaseVertex, PFNGLDRAWELEMENTSBASEVERTEXPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, count, type, indices, basevertex))
+GLAD_VOID_ENTRY(glDrawRangeElementsBaseVertex, PFNGLDRAWRANGEELEMENTSBASEVERTEXPROC, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, start, end, count, type, indices, basevertex))
+GLAD_VOID_ENTRY(glDrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex), (mode, count, type, indices, instancecount, basevertex))
+GLAD_VOID_ENTRY(glMultiDrawElementsBaseVertex, PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC, (GLenum mode, const GLsizei *count, GLenum type, const void *const*indices, GLsizei drawcount, const GLint *basevertex), (mode, count, type, indices, drawcount, basevertex))
+GLAD_VOID_ENTRY(glProvokingVertex, PFNGLPROVOKINGVERTEXPROC, (GLenum mode), (mode))
+GLAD_ENTRY(GLsync, glFenceSync, PFNGLFENCESYNCPROC, (GLenum condition, GLbitfield flags), (condition, flags))
+GLAD_ENTRY(GLboolean, glIsSync, PFNGLISSYNCPROC, (GLsync sync), (sync))
+GLAD_VOID_ENTRY(glDeleteSync, PFNGLDELETESYNCPROC, (GLsync sync), (sync))
+GLAD_ENTRY(GLenum, glClientWaitSync, PFNGLCLIENTWAITSYNCPROC, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout))
+GLAD_VOID_ENTRY(glWaitSync, PFNGLWAITSYNCPROC, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout))
+GLAD_VOID_ENTRY(glGetInteger64v, PFNGLGETINTEGER64VPROC, (GLenum pname, GLint64 *data), (pname, data))
+GLAD_VOID_ENTRY(glGetSynciv, PFNGLGETSYNCIVPROC, (GLsync sync, GLenum pname, GLsizei bufSize, GLsizei *length, GLint *values), (sync, pname, bufSize, length, values))
+GLAD_VOID_ENTRY(glGetInteger64i_v, PFNGLGETINTEGER64I_VPROC, (GLenum target, GLuint index, GLint64 *data), (target, index, data))
+GLAD_VOID_ENTRY(glGetBufferParameteri64v, PFNGLGETBUFFERPARAMETERI64VPROC, (GLenum target, GLenum pname, GLint64 *params), (target, pname, params))
+GLAD_VOID_ENTRY(glFramebufferTexture, PFNGLFRAMEBUFFERTEXTUREPROC, (GLenum target, GLenum attachment, GLuint texture, GLint level), (target, attachment, texture, level))
+GLAD_VOID_ENTRY(glTexImage2DMultisample, PFNGLTEXIMAGE2DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, fixedsamplelocations))
+GLAD_VOID_ENTRY(glTexImage3DMultisample, PFNGLTEXIMAGE3DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, depth, fixedsamplelocations))
+GLAD_VOID_ENTRY(glGetMultisamplefv, PFNGLGETMULTISAMPLEFVPROC, (GLenum pname, GLuint index, GLfloat *val), (pname, index, val))
+GLAD_VOID_ENTRY(glSampleMaski, PFNGLSAMPLEMASKIPROC, (GLuint maskNumber, GLbitfield mask), (maskNumber, mask))
+GLAD_VOID_ENTRY(glBindFragDataLocationIndexed, PFNGLBINDFRAGDATALOCATIONINDEXEDPROC, (GLuint program, GLuint colorNumber, GLuint index, const GLchar *name), (program, colorNumber, index, name))
+GLAD_ENTRY(GLint, glGetFragDataIndex, PFNGLGETFRAGDATAINDEXPROC, (GLuint program, const GLchar *name), (program, name))
+GLAD_VOID_ENTRY(glGenSamplers, PFNGLGENSAMPLERSPROC, (GLsizei count, GLuint *samplers), (count, samplers))
+GLAD_VOID_ENTRY(glDeleteSamplers, PFNGLDELETESAMPLERSPROC, (GLsizei count, const GLuint *samplers), (count, samplers))
+GLAD_ENTRY(GLboolean, glIsSampler, PFNGLISSAMPLERPROC, (GLuint sampler), (sampler))
+GLAD_VOID_ENTRY(glBindSampler, PFNGLBINDSAMPLERPROC, (GLuint unit, GLuint sampler), (unit, sampler))
+GLAD_VOID_ENTRY(glSamplerParameteri, PFNGLSAMPLERPARAMETERIPROC, (GLuint sampler, GLenum pname, GLint param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glSamplerParameteriv, PFNGLSAMPLERPARAMETERIVPROC, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glSamplerParameterf, PFNGLSAMPLERPARAMETERFPROC, (GLuint sampler, GLenum pname, GLfloat param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glSamplerParameterfv, PFNGLSAMPLERPARAMETERFVPROC, (GLuint sampler, GLenum pname, const GLfloat *param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glSamplerParameterIiv, PFNGLSAMPLERPARAMETERIIVPROC, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glSamplerParameterIuiv, PFNGLSAMPLERPARAMETERIUIVPROC, (GLuint sampler, GLenum pname, const GLuint *param), (sampler, pname, param))
+GLAD_VOID_ENTRY(glGetSamplerParameteriv, PFNGLGETSAMPLERPARAMETERIVPROC, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params))
+GLAD_VOID_ENTRY(glGetSamplerParameterIiv, PFNGLGETSAMPLERPARAMETERIIVPROC, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params))
+GLAD_VOID_ENTRY(glGetSamplerParameterfv, PFNGLGETSAMPLERPARAMETERFVPROC, (GLuint sampler, GLenum pname, GLfloat *params), (sampler, pname, params))
+GLAD_VOID_ENTRY(glGetSamplerParameterIuiv, PFNGLGETSAMPLERPARAMETERIUIVPROC, (GLuint sampler, GLenum pname, GLuint *params), (sampler, pname, params))
+GLAD_VOID_ENTRY(glQueryCounter, PFNGLQUERYCOUNTERPROC, (GLuint id, GLenum target), (id, target))
+GLAD_VOID_ENTRY(glGetQueryObjecti64v, PFNGLGETQUERYOBJECTI64VPROC, (GLuint id, GLenum pname, GLint64 *params), (id, pname, params))
+GLAD_VOID_ENTRY(glGetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC, (GLuint id, GLenum pname, GLuint64 *params), (id, pname, params))
+GLAD_VOID_ENTRY(glVertexAttribDivisor, PFNGLVERTEXATTRIBDIVISORPROC, (GLuint index, GLuint divisor), (index, divisor))
+GLAD_VOID_ENTRY(glVertexAttribP1ui, PFNGLVERTEXATTRIBP1UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP1uiv, PFNGLVERTEXATTRIBP1UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP2ui, PFNGLVERTEXATTRIBP2UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP2uiv, PFNGLVERTEXATTRIBP2UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP3ui, PFNGLVERTEXATTRIBP3UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP3uiv, PFNGLVERTEXATTRIBP3UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP4ui, PFNGLVERTEXATTRIBP4UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexAttribP4uiv, PFNGLVERTEXATTRIBP4UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GLAD_VOID_ENTRY(glVertexP2ui, PFNGLVERTEXP2UIPROC, (GLenum type, GLuint value), (type, value))
+GLAD_VOID_ENTRY(glVertexP2uiv, PFNGLVERTEXP2UIVPROC, (GLenum type, const GLuint *value), (type, value))
+GLAD_VOID_ENTRY(glVertexP3ui, PFNGLVERTEXP3UIPROC, (GLenum type, GLuint value), (type, value))
+GLAD_VOID_ENTRY(glVertexP3uiv, PFNGLVERTEXP3UIVPROC, (GLenum type, const GLuint *value), (type, value))
+GLAD_VOID_ENTRY(glVertexP4ui, PFNGLVERTEXP4UIPROC, (GLenum type, GLuint value), (type, value))
+GLAD_VOID_ENTRY(glVertexP4uiv, PFNGLVERTEXP4UIVPROC, (GLenum type, const GLuint *value), (type, value))
+GLAD_VOID_ENTRY(glTexCoordP1ui, PFNGLTEXCOORDP1UIPROC, (GLenum type, GLuint coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP1uiv, PFNGLTEXCOORDP1UIVPROC, (GLenum type, const GLuint *coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP2ui, PFNGLTEXCOORDP2UIPROC, (GLenum type, GLuint coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP2uiv, PFNGLTEXCOORDP2UIVPROC, (GLenum type, const GLuint *coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP3ui, PFNGLTEXCOORDP3UIPROC, (GLenum type, GLuint coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP3uiv, PFNGLTEXCOORDP3UIVPROC, (GLenum type, const GLuint *coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP4ui, PFNGLTEXCOORDP4UIPROC, (GLenum type, GLuint coords), (type, coords))
+GLAD_VOID_ENTRY(glTexCoordP4uiv, PFNGLTEXCOORDP4UIVPROC, (GLenum type, const GLuint *coords), (type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP1ui, PFNGLMULTITEXCOORDP1UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP1uiv, PFNGLMULTITEXCOORDP1UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP2ui, PFNGLMULTITEXCOORDP2UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP2uiv, PFNGLMULTITEXCOORDP2UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP3ui, PFNGLMULTITEXCOORDP3UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP3uiv, PFNGLMULTITEXCOORDP3UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP4ui, PFNGLMULTITEXCOORDP4UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glMultiTexCoordP4uiv, PFNGLMULTITEXCOORDP4UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GLAD_VOID_ENTRY(glNormalP3ui, PFNGLNORMALP3UIPROC, (GLenum type, GLuint coords), (type, coords))
+GLAD_VOID_ENTRY(glNormalP3uiv, PFNGLNORMALP3UIVPROC, (GLenum type, const GLuint *coords), (type, coords))
+GLAD_VOID_ENTRY(glColorP3ui, PFNGLCOLORP3UIPROC, (GLenum type, GLuint color), (type, color))
+GLAD_VOID_ENTRY(glColorP3uiv, PFNGLCOLORP3UIVPROC, (GLenum type, const GLuint *color), (type, color))
+GLAD_VOID_ENTRY(glColorP4ui, PFNGLCOLORP4UIPROC, (GLenum type, GLuint color), (type, color))
+GLAD_VOID_ENTRY(glColorP4uiv, PFNGLCOLORP4UIVPROC, (GLenum type, const GLuint *color), (type, color))
+GLAD_VOID_ENTRY(glSecondaryColorP3ui, PFNGLSECONDARYCOLORP3UIPROC, (GLenum type, GLuint color), (type, color))
+GLAD_VOID_ENTRY(glSecondaryColorP3uiv, PFNGLSECONDARYCOLORP3UIVPROC, (GLenum type, const GLuint *color), (type, color))
+GLAD_VOID_ENTRY(glDrawArraysInstancedBaseInstance, PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance), (mode, first, count, instancecount, baseinstance))
+GLAD_VOID_ENTRY(glDrawElementsInstancedBaseInstance, PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLuint baseinstance), (mode, count, type, indices, instancecount, baseinstance))
+GLAD_VOID_ENTRY(glDrawElementsInstancedBaseVertexBaseInstance, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance), (mode, count, type, indices, instancecount, basevertex, baseinstance))
+GLAD_VOID_ENTRY(glDispatchCompute, PFNGLDISPATCHCOMPUTEPROC, (GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z), (num_groups_x, num_groups_y, num_groups_z))
+GLAD_VOID_ENTRY(glDispatchComputeIndirect, PFNGLDISPATCHCOMPUTEINDIRECTPROC, (GLintptr indirect), (indirect))
+GLAD_VOID_ENTRY(glDrawArraysIndirect, PFNGLDRAWARRAYSINDIRECTPROC, (GLenum mode, const void *indirect), (mode, indirect))
+GLAD_VOID_ENTRY(glDrawElementsIndirect, PFNGLDRAWELEMENTSINDIRECTPROC, (GLenum mode, GLenum type, const void *indirect), (mode, type, indirect))
+GLAD_VOID_ENTRY(glMultiDrawArraysIndirect, PFNGLMULTIDRAWARRAYSINDIRECTPROC, (GLenum mode, const void *indirect, GLsizei drawcount, GLsizei stride), (mode, indirect, drawcount, stride))
+GLAD_VOID_ENTRY(glMultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECTPROC, (GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride), (mode, type, indirect, drawcount, stride))
+GLAD_VOID_ENTRY(glBindImageTexture, PFNGLBINDIMAGETEXTUREPROC, (GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format), (unit, texture, level, layered, layer, access, format))
+GLAD_VOID_ENTRY(glMemoryBarrier, PFNGLMEMORYBARRIERPROC, (GLbitfield barriers), (barriers))
+GLAD_VOID_ENTRY(glShaderStorageBlockBinding, PFNGLSHADERSTORAGEBLOCKBINDINGPROC, (GLuint program, GLuint storageBlockIndex, GLuint storageBlockBinding), (program, storageBlockIndex, storageBlockBinding))
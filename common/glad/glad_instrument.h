@@ -0,0 +1,55 @@
+/*
+
+    Per-frame OpenGL call counters of the instrumented glad loader.
+
+    Build common/src/glad.c with GLAD_INSTRUMENT defined (qmake "DEFINES+=GLAD_INSTRUMENT" for any sample) and
+    gladLoadGLLoader() installs a counting wrapper in front of every function it loaded: the calls of every entry point,
+    the bytes of data passed to glBufferData, glBufferSubData, glTexImage2D and glTexSubImage2D and the time spent in the
+    calls. No sample code changes: a frame ends when the default framebuffer is cleared with GL_COLOR_BUFFER_BIT (or
+    with gladInstrumentEndFrame()), and the per-frame averages are printed to stderr at exit.
+
+    Environment variables:
+        GLAD_INSTRUMENT_REPORT=N   also print the counters of the last frame every N frames
+        GLAD_INSTRUMENT_QUIET=1    no report at exit
+
+    The counters are not synchronized: all calls have to come from one thread (the one with the context).
+    This header is only needed to read the counters from the program itself.
+
+*/
+
+#ifndef GLAD_INSTRUMENT_H
+#define GLAD_INSTRUMENT_H
+
+#include <stdio.h>
+
+#include <glad/glad.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gladCallCounters {
+    const char *name;         /* entry point, e.g. "glDrawArrays" */
+    unsigned long long calls;
+    unsigned long long bytes; /* data passed in (tightly packed size for textures), 0 for the other functions */
+    double seconds;           /* time spent in the calls, including the overhead of the wrapper's two clock reads */
+};
+
+/* Ends the current frame: its counters become the last frame and are added to the totals, then they are reset */
+GLAPI void gladInstrumentEndFrame(void);
+
+/* Number of entry points (0 without GLAD_INSTRUMENT); lastFrame and total (may be NULL) receive arrays of that many
+   counters, in the order of glad.h */
+GLAPI int gladInstrumentGetCounters(const struct gladCallCounters **lastFrame, const struct gladCallCounters **total);
+
+/* Number of frames which have ended */
+GLAPI unsigned long long gladInstrumentGetFrameCount(void);
+
+/* Prints the counters of the last frame (lastFrame != 0) or the averages per frame, sorted by time */
+GLAPI void gladInstrumentPrintReport(FILE *file, int lastFrame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
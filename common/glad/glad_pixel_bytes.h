@@ -0,0 +1,41 @@
+/*
+
+    Size of the client memory of pixel transfers (glTexImage*, glTexSubImage*, glReadPixels), shared by the instrumented
+    glad loader (common/src/glad.c, C) and the GL trace (gl_trace.h, C++).
+
+*/
+
+#ifndef GLAD_PIXEL_BYTES_H
+#define GLAD_PIXEL_BYTES_H
+
+#include <glad/glad.h>
+
+/* bytes of width x height x depth pixels of format and type with every row aligned to alignment (1: tightly packed) */
+static inline unsigned long long gladPixelBytes(long long width, long long height, long long depth, GLenum format,
+                                                GLenum type, int alignment) {
+    unsigned long long components, pixelSize, align, rowSize;
+    switch(format) {
+        case GL_RED: case GL_GREEN: case GL_BLUE: case GL_RED_INTEGER: case GL_STENCIL_INDEX:
+        case GL_DEPTH_COMPONENT: case GL_DEPTH_STENCIL: components = 1; break;
+        case GL_RG: case GL_RG_INTEGER: components = 2; break;
+        case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER: components = 3; break;
+        default: components = 4; break;
+    }
+    switch(type) {
+        case GL_UNSIGNED_BYTE: case GL_BYTE: pixelSize = components; break;
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: pixelSize = 2 * components; break;
+        case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: pixelSize = 4 * components; break;
+        case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: pixelSize = 8; break;
+        /* packed types hold the whole pixel */
+        case GL_UNSIGNED_BYTE_3_3_2: case GL_UNSIGNED_BYTE_2_3_3_REV: pixelSize = 1; break;
+        case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_5_6_5_REV: case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_4_4_4_4_REV: case GL_UNSIGNED_SHORT_5_5_5_1: case GL_UNSIGNED_SHORT_1_5_5_5_REV: pixelSize = 2; break;
+        default: pixelSize = 4; break;
+    }
+    if(width <= 0 || height <= 0 || depth <= 0) return 0;
+    align = alignment > 1 ? (unsigned long long)alignment : 1;
+    rowSize = ((unsigned long long)width * pixelSize + align - 1) / align * align;
+    return rowSize * (unsigned long long)height * (unsigned long long)depth;
+}
+
+#endif
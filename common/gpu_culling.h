@@ -0,0 +1,132 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+
+// World space axis aligned bounding box of one object, laid out as in the std430 bounds buffer of the culling shader
+struct ObjectBounds
+{
+    glm::vec4 Center;  // xyz = center of the box, w unused
+    glm::vec4 Extents; // xyz = half size of the box, w unused
+};
+
+// Frustum culling on the GPU (OpenGL 4.3 or GL_ARB_compute_shader + GL_ARB_shader_storage_buffer_object):
+// a compute pass tests the bounds of every object against the camera frustum and atomically appends the model matrix of
+// every visible object to the instance buffer of a MeshPool, while counting them in the instanceCount of an indirect draw
+// record. The CPU only resets one counter, dispatches and issues one indirect draw per frame, whatever the object count is
+// Shader storage bindings used by the compute shader: 0 = bounds, 1 = model matrices, 2 = draw record, 3 = visible matrices
+class GpuFrustumCuller
+{
+public:
+    GLuint BoundsBuffer;
+    GLuint ModelsBuffer;
+    GLuint CommandBuffer;
+    GLuint ObjectCount;
+
+    // work group size declared in the compute shader (layout (local_size_x = ...))
+    static const GLuint WORK_GROUP_SIZE = 64;
+
+    GpuFrustumCuller(const char* computePath) : BoundsBuffer(0), ModelsBuffer(0), CommandBuffer(0), ObjectCount(0),
+        instanceBuffer(0), program(computePath)
+    {
+        glGenBuffers(1, &BoundsBuffer);
+        glGenBuffers(1, &ModelsBuffer);
+        glGenBuffers(1, &CommandBuffer);
+        planesLocation = glGetUniformLocation(program.ID, "frustumPlanes");
+        objectCountLocation = glGetUniformLocation(program.ID, "objectCount");
+    }
+
+    // Uploads the bounds and model matrices of all the objects (one entry per object in both arrays)
+    void setObjects(const std::vector<ObjectBounds> &bounds, const std::vector<glm::mat4> &models)
+    {
+        ObjectCount = static_cast<GLuint>(bounds.size());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, BoundsBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bounds.size()*sizeof(ObjectBounds), bounds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ModelsBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, models.size()*sizeof(glm::mat4), models.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // Sets the mesh drawn for every visible object and the instance buffer the visible model matrices are written to
+    // (e.g. MeshPool::InstanceVBO, which must hold storage for ObjectCount matrices)
+    void setOutput(const MeshRange &mesh, GLuint instanceVBO)
+    {
+        instanceBuffer = instanceVBO;
+
+        DrawElementsIndirectCommand command;
+        command.count = mesh.indexCount;
+        command.instanceCount = 0;
+        command.firstIndex = mesh.firstIndex;
+        command.baseVertex = mesh.baseVertex;
+        command.baseInstance = 0;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), &command, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Runs the culling pass: afterwards the draw record holds the number of visible objects
+    void cull(const Frustum &frustum)
+    {
+        // reset the instance counter of the draw record
+        const GLuint zero = 0;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offsetof(DrawElementsIndirectCommand, instanceCount), sizeof(GLuint), &zero);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        program.use();
+        glUniform4fv(planesLocation, 6, &frustum.Planes[0][0]);
+        glUniform1ui(objectCountLocation, ObjectCount);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, BoundsBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ModelsBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, CommandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, instanceBuffer);
+        glDispatchCompute((ObjectCount + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE, 1, 1);
+
+        // make the shader writes visible to the indirect draw (command) and the instanced attributes (vertex fetch)
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+
+    // Draws the visible objects; the VAO of the MeshPool given to setOutput has to be bound
+    void draw(GLenum mode = GL_TRIANGLES) const
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+        glDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Reads back the number of visible objects of the last culling pass (waits for the GPU, use for tests/statistics only)
+    GLuint readVisibleCount() const
+    {
+        GLuint visible = 0;
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+        glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, offsetof(DrawElementsIndirectCommand, instanceCount), sizeof(GLuint), &visible);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return visible;
+    }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &BoundsBuffer);
+        glDeleteBuffers(1, &ModelsBuffer);
+        glDeleteBuffers(1, &CommandBuffer);
+        glDeleteProgram(program.ID);
+        BoundsBuffer = ModelsBuffer = CommandBuffer = 0;
+    }
+
+private:
+    GLuint instanceBuffer;
+    Shader program;
+    GLint planesLocation;
+    GLint objectCountLocation;
+};
+
+#endif // GPU_CULLING_H
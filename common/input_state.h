@@ -0,0 +1,175 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Set of 512 keys (every GLFW key code from GLFW_KEY_SPACE = 32 to GLFW_KEY_LAST = 348 fits) in 8 machine words
+struct KeyBits
+{
+    static const int KEY_COUNT = 512;
+    static const int WORD_COUNT = KEY_COUNT/64;
+
+    uint64_t Words[WORD_COUNT];
+
+    KeyBits()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < WORD_COUNT; ++i)
+            Words[i] = 0;
+    }
+
+    // keys outside [0, 512) (GLFW_KEY_UNKNOWN) are ignored
+    void set(int key, bool value)
+    {
+        if (key < 0 || key >= KEY_COUNT)
+            return;
+        const uint64_t bit = uint64_t(1) << (key & 63);
+        if (value)
+            Words[key >> 6] |= bit;
+        else
+            Words[key >> 6] &= ~bit;
+    }
+
+    bool test(int key) const
+    {
+        return key >= 0 && key < KEY_COUNT && (Words[key >> 6] >> (key & 63) & 1) != 0;
+    }
+
+    // true if any key of mask is in this set
+    bool intersects(const KeyBits &mask) const
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            any |= Words[i] & mask.Words[i];
+        return any != 0;
+    }
+};
+
+// Snapshot of the keyboard for one update, built from key events (GLFW key callback) instead of asking GLFW for every key:
+// the keys held down now and at the previous snapshot, plus the keys pressed and released since then, so a key tapped
+// between two updates still reports one press and one release
+class InputState
+{
+public:
+    // GLFW_PRESS and GLFW_REPEAT hold the key down, GLFW_RELEASE (0) releases it
+    void applyKeyEvent(int key, int action)
+    {
+        const bool down = action != 0;
+        if (down && !current.test(key))
+            pressed.set(key, true);
+        else if (!down && current.test(key))
+            released.set(key, true);
+        current.set(key, down);
+    }
+
+    // Starts the snapshot of the next update: the keys held now become the previous ones and the edges are cleared
+    void nextFrame()
+    {
+        previous = current;
+        pressed.clear();
+        released.clear();
+    }
+
+    // held down at the end of the update
+    bool isDown(int key) const { return current.test(key); }
+    // held down at the previous snapshot
+    bool wasDown(int key) const { return previous.test(key); }
+    // went down (released: went up) at least once since the previous snapshot
+    bool isPressed(int key) const { return pressed.test(key); }
+    bool isReleased(int key) const { return released.test(key); }
+
+    const KeyBits& getDown() const { return current; }
+    const KeyBits& getPressed() const { return pressed; }
+    const KeyBits& getReleased() const { return released; }
+
+private:
+    KeyBits current;
+    KeyBits previous;
+    KeyBits pressed;
+    KeyBits released;
+};
+
+// When a binding triggers its action
+enum ActionTrigger
+{
+    ACTION_WHILE_DOWN, // every update while the key is held down
+    ACTION_ON_PRESS,   // in the update in which the key went down
+    ACTION_ON_RELEASE  // in the update in which the key went up
+};
+
+// One row of an action mapping table: key (GLFW key code) triggers action (0 to 63, defined by the application)
+struct ActionBinding
+{
+    unsigned Action;
+    int Key;
+    ActionTrigger Trigger;
+};
+
+// Data driven key bindings: the table is compiled into one key mask per action and trigger, so evaluating all the actions
+// is a few AND/OR of 8 words per action, however many keys are bound to each of them. Actions are returned as a bit mask
+class ActionMap
+{
+public:
+    static const unsigned MAX_ACTIONS = 64;
+
+    ActionMap() : actionCount(0)
+    {
+    }
+
+    ActionMap(const ActionBinding* bindings, size_t count) : actionCount(0)
+    {
+        for (size_t i = 0; i < count; ++i)
+            bind(bindings[i]);
+    }
+
+    // actions above MAX_ACTIONS are ignored
+    void bind(const ActionBinding &binding)
+    {
+        if (binding.Action >= MAX_ACTIONS)
+            return;
+        masks[binding.Action][binding.Trigger].set(binding.Key, true);
+        if (binding.Action >= actionCount)
+            actionCount = binding.Action + 1;
+    }
+
+    void unbindAll()
+    {
+        for (unsigned action = 0; action < actionCount; ++action)
+            for (int trigger = 0; trigger < TRIGGER_COUNT; ++trigger)
+                masks[action][trigger].clear();
+        actionCount = 0;
+    }
+
+    // bit i of the result is set if action i is triggered by the snapshot
+    uint64_t evaluate(const InputState &input) const
+    {
+        uint64_t actions = 0;
+        for (unsigned action = 0; action < actionCount; ++action)
+        {
+            if (masks[action][ACTION_WHILE_DOWN].intersects(input.getDown()) ||
+                masks[action][ACTION_ON_PRESS].intersects(input.getPressed()) ||
+                masks[action][ACTION_ON_RELEASE].intersects(input.getReleased()))
+                actions |= uint64_t(1) << action;
+        }
+        return actions;
+    }
+
+private:
+    static const int TRIGGER_COUNT = 3;
+
+    KeyBits masks[MAX_ACTIONS][TRIGGER_COUNT];
+    unsigned actionCount; // highest bound action + 1
+};
+
+// true if action is set in the result of ActionMap::evaluate
+inline bool isActionActive(uint64_t actions, unsigned action)
+{
+    return (actions >> action & 1) != 0;
+}
+
+#endif // INPUT_STATE_H
@@ -0,0 +1,431 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+class JobCounter;
+
+// Unit of work: function(job) is called once on one of the threads of the job system. Range jobs (parallelFor) carry the
+// half open index range [begin, end) they still have to process and split it further while it is larger than grain
+struct Job
+{
+    void (*function)(const Job &job);
+    void (*task)(void* data); // function of a job started with run()/runAfter()
+    void* data;
+    size_t begin;
+    size_t end;
+    size_t grain;
+    JobCounter* counter; // decremented once the job has run (may be null)
+    JobSystem* system;
+};
+
+// Number of unfinished jobs of a group. wait() returns when it reaches zero; jobs started with runAfter() are only scheduled
+// once the counter they depend on has reached zero. A counter is only done once the threads which finished its jobs don't
+// touch it any more (finishing), so it may be destroyed as soon as wait() returns
+class JobCounter
+{
+public:
+    JobCounter() : pending(0), finishing(0)
+    {
+    }
+
+    bool done() const
+    {
+        return pending.load(std::memory_order_acquire) == 0 && finishing.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending;
+    std::atomic<int> finishing;   // threads between the decrement of pending and their last access of the counter
+    std::mutex continuationMutex;
+    std::vector<Job> continuations; // jobs waiting for this counter
+};
+
+// Chase-Lev work-stealing deque of fixed capacity (a power of 2): the owning thread pushes and pops jobs at the bottom (LIFO,
+// cache friendly), the other threads steal from the top (FIFO, the largest pieces of split ranges)
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(size_t capacity = 4096) : top(0), bottom(0), mask(capacity - 1), buffer(capacity)
+    {
+    }
+
+    // owner only; returns false if the deque is full
+    bool push(Job* job)
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > static_cast<int64_t>(mask))
+            return false;
+        buffer[b & mask].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // owner only
+    Job* pop()
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = buffer[b & mask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // last job: race against the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // any thread
+    Job* steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+
+        Job* job = buffer[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // lost the race against the owner or another thief
+        return job;
+    }
+
+private:
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    const size_t mask;
+    std::vector<std::atomic<Job*> > buffer;
+};
+
+// Fixed size pool of worker threads with one work-stealing deque per thread. The thread which creates the job system takes
+// part as thread 0 whenever it waits for a counter, so a job system with 0 workers runs everything on the calling thread
+// Jobs may only be started from the creating thread or from inside jobs. OpenGL calls must stay on the thread owning the
+// context: jobs prepare data (transforms, culling, decoding), the main thread submits it
+class JobSystem
+{
+public:
+    // every thread can have this many jobs in flight at the same time
+    static const size_t JOBS_PER_THREAD = 4096;
+
+    explicit JobSystem(unsigned workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1)
+        : threads(workerCount + 1), stopping(false), sleeping(0)
+    {
+        currentThread() = &threads[0];
+        threads[0].system = this;
+        for (unsigned i = 1; i < threads.size(); ++i)
+        {
+            threads[i].system = this;
+            threads[i].random = i*2654435761u;
+        }
+        for (unsigned i = 1; i < threads.size(); ++i)
+            workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+    }
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true);
+        }
+        wakeCondition.notify_all();
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+        currentThread() = nullptr;
+    }
+
+    // number of threads running jobs (workers and the creating thread)
+    unsigned getThreadCount() const
+    {
+        return static_cast<unsigned>(threads.size());
+    }
+
+    // Starts function(data) as one job; counter (may be null) is incremented now and decremented when the job is done
+    void run(void (*function)(void*), void* data, JobCounter* counter)
+    {
+        Job job = makeJob(&runTask, data, counter);
+        job.task = function;
+        submit(job);
+    }
+
+    // Starts function(data) once dependency has reached zero
+    void runAfter(JobCounter &dependency, void (*function)(void*), void* data, JobCounter* counter)
+    {
+        Job job = makeJob(&runTask, data, counter);
+        job.task = function;
+        submitAfter(dependency, job);
+    }
+
+    // Calls f(begin, end) on sub-ranges of [begin, end) of at most grain indices spread over all the threads; f must stay
+    // alive until counter has reached zero
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, const F &f, JobCounter &counter)
+    {
+        if (begin < end)
+            submit(makeRangeJob(begin, end, grain, f, counter));
+    }
+
+    // as parallelFor, but the range only starts to be processed once dependency has reached zero
+    template <typename F>
+    void parallelForAfter(JobCounter &dependency, size_t begin, size_t end, size_t grain, const F &f, JobCounter &counter)
+    {
+        if (begin < end)
+            submitAfter(dependency, makeRangeJob(begin, end, grain, f, counter));
+    }
+
+    // Blocking parallelFor: returns when f has been called for the whole range
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, const F &f)
+    {
+        JobCounter counter;
+        parallelFor(begin, end, grain, f, counter);
+        wait(counter);
+    }
+
+    // Runs jobs on the calling thread until counter has reached zero
+    void wait(JobCounter &counter)
+    {
+        ThreadData* self = currentThread();
+        Job job;
+        while (!counter.done())
+        {
+            if (findJob(self, job))
+                execute(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    // per thread state: its deque and the ring buffer its jobs are stored in, a slot of the ring is busy from the push of
+    // its job until a thread has taken the job from the deque
+    struct ThreadData
+    {
+        WorkStealingDeque deque;
+        std::vector<Job> jobs;
+        std::vector<std::atomic<bool>> busy;
+        size_t nextJob;
+        unsigned random;
+        JobSystem* system;
+
+        ThreadData() : deque(JOBS_PER_THREAD), jobs(JOBS_PER_THREAD), busy(JOBS_PER_THREAD), nextJob(0), random(1), system(nullptr)
+        {
+        }
+    };
+
+    std::vector<ThreadData> threads;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping;
+    std::atomic<int> sleeping;
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+
+    static ThreadData*& currentThread()
+    {
+        static thread_local ThreadData* thread = nullptr;
+        return thread;
+    }
+
+    static void runTask(const Job &job)
+    {
+        job.task(job.data);
+    }
+
+    // Range job: hands the upper half of the range to the deque (where idle threads steal it) until the rest fits into grain
+    template <typename F>
+    static void runRange(const Job &job)
+    {
+        Job rest = job;
+        while (rest.end - rest.begin > rest.grain)
+        {
+            Job upper = rest;
+            upper.begin = rest.begin + (rest.end - rest.begin)/2;
+            rest.end = upper.begin;
+            job.system->submit(upper);
+        }
+        (*static_cast<const F*>(job.data))(rest.begin, rest.end);
+    }
+
+    template <typename F>
+    Job makeRangeJob(size_t begin, size_t end, size_t grain, const F &f, JobCounter &counter)
+    {
+        Job job = makeJob(&runRange<F>, const_cast<void*>(static_cast<const void*>(&f)), &counter);
+        job.begin = begin;
+        job.end = end;
+        job.grain = std::max<size_t>(1, grain);
+        return job;
+    }
+
+    Job makeJob(void (*function)(const Job&), void* data, JobCounter* counter)
+    {
+        Job job;
+        job.function = function;
+        job.task = nullptr;
+        job.data = data;
+        job.begin = job.end = 0;
+        job.grain = 1;
+        job.counter = counter;
+        job.system = this;
+        return job;
+    }
+
+    void submit(const Job &job)
+    {
+        if (job.counter != nullptr)
+            job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+        enqueue(job);
+    }
+
+    // Copies the job into a free slot of the ring of the calling thread and pushes it onto its deque (runs it right away if
+    // the deque is full). A slot whose job is still waiting in the deque is skipped: a range job with many sub-ranges keeps
+    // its first upper half queued while more than JOBS_PER_THREAD jobs are submitted for the lower one
+    void enqueue(const Job &job)
+    {
+        ThreadData* self = currentThread();
+        Job* stored = nullptr;
+        for (size_t i = 0; i < JOBS_PER_THREAD && stored == nullptr; ++i)
+        {
+            const size_t slot = self->nextJob++ & (JOBS_PER_THREAD - 1);
+            if (!self->busy[slot].load(std::memory_order_acquire))
+            {
+                self->busy[slot].store(true, std::memory_order_relaxed);
+                stored = &self->jobs[slot];
+            }
+        }
+        if (stored == nullptr)
+        {
+            execute(job);
+            return;
+        }
+        *stored = job;
+        if (!self->deque.push(stored))
+        {
+            self->busy[stored - self->jobs.data()].store(false, std::memory_order_relaxed);
+            execute(job);
+            return;
+        }
+
+        if (sleeping.load(std::memory_order_relaxed) > 0)
+            wakeCondition.notify_one();
+    }
+
+    void submitAfter(JobCounter &dependency, const Job &job)
+    {
+        {
+            // only pending: a releasing thread may already have taken the continuations
+            std::lock_guard<std::mutex> lock(dependency.continuationMutex);
+            if (dependency.pending.load(std::memory_order_acquire) != 0)
+            {
+                if (job.counter != nullptr)
+                    job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+                dependency.continuations.push_back(job);
+                return;
+            }
+        }
+        submit(job);
+    }
+
+    void execute(const Job &job)
+    {
+        job.function(job);
+        JobCounter* counter = job.counter;
+        if (counter == nullptr)
+            return;
+        counter->finishing.fetch_add(1, std::memory_order_relaxed);
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            releaseContinuations(*counter);
+        // the last access: a waiting thread may destroy the counter from here on
+        counter->finishing.fetch_sub(1, std::memory_order_release);
+    }
+
+    // schedules the jobs which were waiting for the counter (their counters were already incremented by submitAfter)
+    void releaseContinuations(JobCounter &counter)
+    {
+        std::vector<Job> ready;
+        {
+            std::lock_guard<std::mutex> lock(counter.continuationMutex);
+            ready.swap(counter.continuations);
+        }
+        for (size_t i = 0; i < ready.size(); ++i)
+            enqueue(ready[i]);
+    }
+
+    // own deque first, then steal from the other threads starting at a random one; the job is copied out of the ring of
+    // the thread which pushed it, whose slot is free again from then on
+    bool findJob(ThreadData* self, Job &job)
+    {
+        ThreadData* owner = self;
+        Job* found = self->deque.pop();
+        if (found == nullptr)
+        {
+            self->random = self->random*1664525u + 1013904223u;
+            const size_t count = threads.size();
+            const size_t start = (self->random >> 8) % count;
+            for (size_t i = 0; i < count && found == nullptr; ++i)
+            {
+                owner = &threads[(start + i) % count];
+                if (owner != self)
+                    found = owner->deque.steal();
+            }
+            if (found == nullptr)
+                return false;
+        }
+        job = *found;
+        owner->busy[found - owner->jobs.data()].store(false, std::memory_order_release);
+        return true;
+    }
+
+    void workerLoop(unsigned index)
+    {
+        ThreadData* self = &threads[index];
+        currentThread() = self;
+        int idleRounds = 0;
+        Job job;
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            if (findJob(self, job))
+            {
+                execute(job);
+                idleRounds = 0;
+            }
+            else if (++idleRounds < 64)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                // nothing to do for a while: sleep until a job is submitted (the timeout covers a missed notification)
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleeping.fetch_add(1);
+                wakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+                sleeping.fetch_sub(1);
+                idleRounds = 0;
+            }
+        }
+    }
+};
+
+#endif // JOB_SYSTEM_H
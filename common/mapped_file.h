@@ -0,0 +1,96 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the binary files mapped by the samples (scene files, asset archives) are little-endian and used in place
+inline bool isLittleEndianHost()
+{
+    const uint16_t one = 1;
+    unsigned char first;
+    memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+// A file mapped read-only into memory (read into a buffer on Windows), its text is not zero terminated
+class MappedFile
+{
+public:
+    MappedFile() : data(nullptr), size(0) {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string &path)
+    {
+        close();
+#ifdef _WIN32
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!buffer.empty() && !file.read(buffer.data(), buffer.size()))
+            return false;
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+#else
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+        struct stat status;
+        bool opened = fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode);
+        if (opened && status.st_size > 0)
+        {
+            void *mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            opened = mapping != MAP_FAILED;
+            if (opened)
+            {
+                data = static_cast<const char*>(mapping);
+                size = static_cast<size_t>(status.st_size);
+            }
+        }
+        // the mapping stays valid without the descriptor
+        ::close(descriptor);
+        return opened;
+#endif
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        buffer.clear();
+#else
+        if (data != nullptr)
+            munmap(const_cast<char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    const char *data;
+    size_t size;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+};
+
+#endif
@@ -0,0 +1,892 @@
+#ifndef MESH_IMPORT_H
+#define MESH_IMPORT_H
+
+#include <job_system.h>
+#include <mapped_file.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Mesh with the interleaved vertex layout of MeshPool and Scene (3 floats position, 2 floats texture coordinates) and
+// 32 bit indices, triangles only
+struct ImportedMesh
+{
+    std::vector<float> Vertices;
+    std::vector<uint32_t> Indices;
+
+    static const unsigned VERTEX_SIZE = 5;
+
+    uint32_t vertexCount() const
+    {
+        return static_cast<uint32_t>(Vertices.size() / VERTEX_SIZE);
+    }
+
+    void clear()
+    {
+        Vertices.clear();
+        Indices.clear();
+    }
+};
+
+// Open addressing hash table over the vertices of a mesh: add() returns the index of the vertex with the same bytes if the
+// mesh has one already, otherwise it appends the vertex to the mesh. The table stores the index and the hash of every
+// vertex, the vertex itself is only compared when the hashes are equal
+class VertexDeduplicator
+{
+public:
+    explicit VertexDeduplicator(ImportedMesh &mesh, size_t expectedVertices = 0) : mesh(mesh), count(0)
+    {
+        size_t capacity = 64;
+        while (capacity < 2*expectedVertices)
+            capacity *= 2;
+        slots.assign(capacity, Slot());
+        for (uint32_t i = 0; i < mesh.vertexCount(); ++i)
+            insert(i, hash(&mesh.Vertices[i*ImportedMesh::VERTEX_SIZE]));
+    }
+
+    uint32_t add(const float* vertex)
+    {
+        const uint32_t vertexHash = hash(vertex);
+        const size_t mask = slots.size() - 1;
+        for (size_t slot = vertexHash & mask; ; slot = (slot + 1) & mask)
+        {
+            const Slot &entry = slots[slot];
+            if (entry.Index == EMPTY)
+                break;
+            if (entry.Hash == vertexHash &&
+                memcmp(&mesh.Vertices[size_t(entry.Index)*ImportedMesh::VERTEX_SIZE], vertex, ImportedMesh::VERTEX_SIZE*sizeof(float)) == 0)
+                return entry.Index;
+        }
+        const uint32_t index = mesh.vertexCount();
+        mesh.Vertices.insert(mesh.Vertices.end(), vertex, vertex + ImportedMesh::VERTEX_SIZE);
+        if (2*(count + 1) > slots.size())
+            grow();
+        insert(index, vertexHash);
+        return index;
+    }
+
+private:
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot
+    {
+        uint32_t Index;
+        uint32_t Hash;
+
+        Slot() : Index(EMPTY), Hash(0) {}
+    };
+
+    ImportedMesh &mesh;
+    std::vector<Slot> slots;
+    size_t count;
+
+    // 64 bit multiply-xorshift over the bits of the floats, folded to 32 bits
+    static uint32_t hash(const float* vertex)
+    {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (unsigned i = 0; i < ImportedMesh::VERTEX_SIZE; ++i)
+        {
+            uint32_t bits;
+            memcpy(&bits, &vertex[i], sizeof(bits));
+            h = (h ^ bits)*0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+        return static_cast<uint32_t>(h);
+    }
+
+    void insert(uint32_t index, uint32_t vertexHash)
+    {
+        const size_t mask = slots.size() - 1;
+        size_t slot = vertexHash & mask;
+        while (slots[slot].Index != EMPTY)
+            slot = (slot + 1) & mask;
+        slots[slot].Index = index;
+        slots[slot].Hash = vertexHash;
+        ++count;
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size()*2, Slot());
+        old.swap(slots);
+        count = 0;
+        for (size_t i = 0; i < old.size(); ++i)
+            if (old[i].Index != EMPTY)
+                insert(old[i].Index, old[i].Hash);
+    }
+};
+
+// What the last import read and where its time went (milliseconds)
+struct MeshImportStats
+{
+    uint64_t Bytes;           // size of the file
+    uint64_t SourceVertices;  // positions (OBJ) or accessor vertices (glTF) in the file
+    uint64_t Triangles;
+    unsigned Chunks;          // pieces the OBJ text was split into
+    double ParseTime;         // OBJ: parsing the chunks; glTF: header and JSON
+    double BuildTime;         // resolving the indices and deduplicating the vertices
+
+    MeshImportStats() : Bytes(0), SourceVertices(0), Triangles(0), Chunks(0), ParseTime(0.0), BuildTime(0.0) {}
+};
+
+// A JSON value as far as the glTF importer needs it (numbers are doubles, objects keep the order of their members)
+struct JsonValue
+{
+    enum Type
+    {
+        JSON_NULL,
+        JSON_BOOL,
+        JSON_NUMBER,
+        JSON_STRING,
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+
+    Type Kind;
+    double Number;
+    std::string String;
+    std::vector<JsonValue> Items;
+    std::vector<std::pair<std::string, JsonValue>> Members;
+
+    JsonValue() : Kind(JSON_NULL), Number(0.0) {}
+
+    // member key of an object, nullptr if there is none
+    const JsonValue* find(const char* key) const
+    {
+        for (size_t i = 0; i < Members.size(); ++i)
+            if (Members[i].first == key)
+                return &Members[i].second;
+        return nullptr;
+    }
+
+    // member key as an unsigned number, fallback if it is missing, no number or out of the range of uint64_t (the cast
+    // of such a double is undefined; NaN fails both comparisons)
+    uint64_t unsignedMember(const char* key, uint64_t fallback) const
+    {
+        const JsonValue* value = find(key);
+        return value != nullptr && value->Kind == JSON_NUMBER && value->Number >= 0.0 && value->Number < 18446744073709551616.0 ?
+            static_cast<uint64_t>(value->Number) : fallback;
+    }
+
+    // Parses [begin, end) into value; false on a syntax error
+    static bool parse(const char* begin, const char* end, JsonValue &value)
+    {
+        const char* p = begin;
+        return parseValue(p, end, value, 0) && skipSpace(p, end) == end;
+    }
+
+private:
+    static const char* skipSpace(const char* &p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            ++p;
+        return p;
+    }
+
+    static bool parseValue(const char* &p, const char* end, JsonValue &value, int depth)
+    {
+        if (depth > 64 || skipSpace(p, end) == end)
+            return false;
+        if (*p == '{')
+        {
+            value.Kind = JSON_OBJECT;
+            ++p;
+            if (skipSpace(p, end) < end && *p == '}')
+                return ++p, true;
+            while (true)
+            {
+                std::pair<std::string, JsonValue> member;
+                if (skipSpace(p, end) == end || *p != '"' || !parseString(p, end, member.first) ||
+                    skipSpace(p, end) == end || *p++ != ':' || !parseValue(p, end, member.second, depth + 1))
+                    return false;
+                value.Members.push_back(std::move(member));
+                if (skipSpace(p, end) == end)
+                    return false;
+                if (*p == '}')
+                    return ++p, true;
+                if (*p++ != ',')
+                    return false;
+            }
+        }
+        if (*p == '[')
+        {
+            value.Kind = JSON_ARRAY;
+            ++p;
+            if (skipSpace(p, end) < end && *p == ']')
+                return ++p, true;
+            while (true)
+            {
+                value.Items.push_back(JsonValue());
+                if (!parseValue(p, end, value.Items.back(), depth + 1) || skipSpace(p, end) == end)
+                    return false;
+                if (*p == ']')
+                    return ++p, true;
+                if (*p++ != ',')
+                    return false;
+            }
+        }
+        if (*p == '"')
+        {
+            value.Kind = JSON_STRING;
+            return parseString(p, end, value.String);
+        }
+        if (end - p >= 4 && strncmp(p, "true", 4) == 0)
+        {
+            value.Kind = JSON_BOOL;
+            value.Number = 1.0;
+            return p += 4, true;
+        }
+        if (end - p >= 5 && strncmp(p, "false", 5) == 0)
+        {
+            value.Kind = JSON_BOOL;
+            return p += 5, true;
+        }
+        if (end - p >= 4 && strncmp(p, "null", 4) == 0)
+            return p += 4, true;
+
+        // number: copied, as strtod needs a terminated string
+        const char* start = p;
+        while (p < end && (isdigit(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+            ++p;
+        if (p == start)
+            return false;
+        const std::string text(start, p);
+        char* numberEnd;
+        value.Kind = JSON_NUMBER;
+        value.Number = strtod(text.c_str(), &numberEnd);
+        return *numberEnd == '\0';
+    }
+
+    static bool parseString(const char* &p, const char* end, std::string &text)
+    {
+        ++p;
+        while (p < end && *p != '"')
+        {
+            if (*p != '\\')
+            {
+                text += *p++;
+                continue;
+            }
+            if (++p == end)
+                return false;
+            const char escaped = *p++;
+            switch (escaped)
+            {
+            case 'b': text += '\b'; break;
+            case 'f': text += '\f'; break;
+            case 'n': text += '\n'; break;
+            case 'r': text += '\r'; break;
+            case 't': text += '\t'; break;
+            case 'u':
+            {
+                // code point of the basic plane as UTF-8 (paths and names only, surrogate pairs are kept as two)
+                if (end - p < 4)
+                    return false;
+                unsigned code = 0;
+                for (int i = 0; i < 4; ++i, ++p)
+                {
+                    const char c = *p;
+                    if (!isxdigit(static_cast<unsigned char>(c)))
+                        return false;
+                    code = code*16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+                }
+                if (code < 0x80)
+                    text += static_cast<char>(code);
+                else if (code < 0x800)
+                {
+                    text += static_cast<char>(0xC0 | (code >> 6));
+                    text += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    text += static_cast<char>(0xE0 | (code >> 12));
+                    text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    text += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: text += escaped; break;
+            }
+        }
+        if (p == end)
+            return false;
+        ++p;
+        return true;
+    }
+};
+
+// Imports triangle meshes from Wavefront OBJ text and binary glTF 2.0 (.glb) files into an ImportedMesh, merging all the
+// objects/primitives of the file into one mesh with deduplicated vertices (VertexDeduplicator).
+// OBJ: the text is split into chunks at line starts which are parsed in parallel on the threads of a JobSystem (or one
+// after another without one); "v", "vt" and "f" lines are read (polygons as triangle fans, negative indices relative to
+// the vertices before the line), everything else is skipped.
+// glTF: the JSON chunk is parsed, the vertex and index data is read in place from the binary chunk of the mapped file
+// through the accessors and buffer views (nothing is copied before the deduplication). Triangle primitives of all the
+// meshes are imported with their POSITION and TEXCOORD_0 in mesh space (node transforms are not applied); the texture
+// coordinates are flipped vertically to the convention of the samples, whose textures are loaded flipped
+class MeshImporter
+{
+public:
+    explicit MeshImporter(JobSystem* jobs = nullptr, size_t chunkBytes = 1 << 20) : jobs(jobs), chunkBytes(std::max<size_t>(chunkBytes, 4096))
+    {
+    }
+
+    // imports path by its extension (.obj or .glb)
+    bool importFile(const std::string &path, ImportedMesh &mesh)
+    {
+        MappedFile file;
+        if (!file.open(path))
+        {
+            std::cout << "ERROR::MESH_IMPORT::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        const size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+        for (size_t i = 0; i < extension.size(); ++i)
+            extension[i] = static_cast<char>(tolower(static_cast<unsigned char>(extension[i])));
+        if (extension == "obj")
+            return importObj(file.getData(), file.getSize(), mesh);
+        if (extension == "glb")
+            return importGlb(file.getData(), file.getSize(), mesh);
+        std::cout << "ERROR::MESH_IMPORT::UNSUPPORTED_FORMAT: " << path << std::endl;
+        return false;
+    }
+
+    bool importObj(const char* text, size_t size, ImportedMesh &mesh)
+    {
+        mesh.clear();
+        stats = MeshImportStats();
+        stats.Bytes = size;
+        auto start = std::chrono::steady_clock::now();
+
+        // chunks end after a newline, so no line is split
+        std::vector<ObjChunk> chunks;
+        for (size_t begin = 0; begin < size; )
+        {
+            size_t end = std::min(size, begin + chunkBytes);
+            const char* newline = end < size ? static_cast<const char*>(memchr(text + end, '\n', size - end)) : nullptr;
+            end = newline != nullptr ? newline - text + 1 : size;
+            chunks.push_back(ObjChunk(text + begin, text + end));
+            begin = end;
+        }
+        stats.Chunks = static_cast<unsigned>(chunks.size());
+        if (jobs != nullptr)
+            jobs->parallelFor(0, chunks.size(), 1, [&chunks](size_t begin, size_t end) { for (size_t i = begin; i < end; ++i) chunks[i].parse(); });
+        else
+            for (size_t i = 0; i < chunks.size(); ++i)
+                chunks[i].parse();
+        stats.ParseTime = milliseconds(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t lines = 0, positionCount = 0, texCoordCount = 0, cornerCount = 0;
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            ObjChunk &chunk = chunks[i];
+            if (chunk.ErrorLine != 0)
+            {
+                std::cout << "ERROR::MESH_IMPORT::OBJ_SYNTAX_ERROR at line " << lines + chunk.ErrorLine << std::endl;
+                return false;
+            }
+            // the chunk relative indices become absolute now that the vertices of the chunks before are known
+            for (size_t j = 0; j < chunk.RelativePositions.size(); ++j)
+                chunk.Corners[chunk.RelativePositions[j]] += static_cast<int64_t>(positionCount);
+            for (size_t j = 0; j < chunk.RelativeTexCoords.size(); ++j)
+                chunk.Corners[chunk.RelativeTexCoords[j]] += static_cast<int64_t>(texCoordCount);
+            lines += chunk.Lines;
+            positionCount += chunk.Positions.size() / 3;
+            texCoordCount += chunk.TexCoords.size() / 2;
+            cornerCount += chunk.Corners.size() / 2;
+        }
+        stats.SourceVertices = positionCount;
+
+        std::vector<float> positions, texCoords;
+        positions.reserve(positionCount*3);
+        texCoords.reserve(texCoordCount*2);
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            positions.insert(positions.end(), chunks[i].Positions.begin(), chunks[i].Positions.end());
+            texCoords.insert(texCoords.end(), chunks[i].TexCoords.begin(), chunks[i].TexCoords.end());
+        }
+
+        mesh.Indices.reserve(cornerCount);
+        VertexDeduplicator vertices(mesh, positionCount);
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const std::vector<int64_t> &corners = chunks[i].Corners;
+            for (size_t j = 0; j < corners.size(); j += 2)
+            {
+                const int64_t position = corners[j];
+                const int64_t texCoord = corners[j + 1];
+                if (position < 0 || position >= static_cast<int64_t>(positionCount) ||
+                    (texCoord != ObjChunk::NONE && (texCoord < 0 || texCoord >= static_cast<int64_t>(texCoordCount))))
+                {
+                    std::cout << "ERROR::MESH_IMPORT::OBJ_INDEX_OUT_OF_RANGE" << std::endl;
+                    return false;
+                }
+                float vertex[ImportedMesh::VERTEX_SIZE] = { positions[position*3], positions[position*3 + 1], positions[position*3 + 2], 0.0f, 0.0f };
+                if (texCoord != ObjChunk::NONE)
+                {
+                    vertex[3] = texCoords[texCoord*2];
+                    vertex[4] = texCoords[texCoord*2 + 1];
+                }
+                mesh.Indices.push_back(vertices.add(vertex));
+            }
+        }
+        stats.Triangles = mesh.Indices.size() / 3;
+        stats.BuildTime = milliseconds(start);
+        return true;
+    }
+
+    bool importGlb(const char* data, size_t size, ImportedMesh &mesh)
+    {
+        mesh.clear();
+        stats = MeshImportStats();
+        stats.Bytes = size;
+        auto start = std::chrono::steady_clock::now();
+
+        // header (magic, version, length) and the JSON chunk, then the optional binary chunk
+        const uint32_t GLB_MAGIC = 0x46546C67, CHUNK_JSON = 0x4E4F534A, CHUNK_BIN = 0x004E4942;
+        if (size < 20 || read32(data) != GLB_MAGIC)
+            return fail("GLB_BAD_HEADER");
+        if (read32(data + 4) != 2)
+            return fail("GLB_UNSUPPORTED_VERSION");
+        if (read32(data + 8) > size || read32(data + 16) != CHUNK_JSON || 20 + uint64_t(read32(data + 12)) > read32(data + 8))
+            return fail("GLB_BAD_HEADER");
+        const size_t length = read32(data + 8);
+        const char* json = data + 20;
+        const size_t jsonSize = read32(data + 12);
+        const char* binary = nullptr;
+        size_t binarySize = 0;
+        const size_t binaryHeader = 20 + ((jsonSize + 3) & ~size_t(3));
+        if (binaryHeader + 8 <= length && read32(data + binaryHeader + 4) == CHUNK_BIN)
+        {
+            binary = data + binaryHeader + 8;
+            binarySize = read32(data + binaryHeader);
+            if (binaryHeader + 8 + binarySize > length)
+                return fail("GLB_BAD_HEADER");
+        }
+
+        JsonValue document;
+        if (!JsonValue::parse(json, json + jsonSize, document) || document.Kind != JsonValue::JSON_OBJECT)
+            return fail("GLTF_BAD_JSON");
+        stats.ParseTime = milliseconds(start);
+
+        start = std::chrono::steady_clock::now();
+        GltfBuffers buffers(document, binary, binarySize);
+        const JsonValue* meshes = document.find("meshes");
+        if (meshes == nullptr || meshes->Kind != JsonValue::JSON_ARRAY)
+            return fail("GLTF_NO_MESHES");
+
+        VertexDeduplicator vertices(mesh);
+        std::vector<uint32_t> remap;
+        for (size_t m = 0; m < meshes->Items.size(); ++m)
+        {
+            const JsonValue* primitives = meshes->Items[m].find("primitives");
+            if (primitives == nullptr || primitives->Kind != JsonValue::JSON_ARRAY)
+                return fail("GLTF_BAD_MESH");
+            for (size_t p = 0; p < primitives->Items.size(); ++p)
+            {
+                const JsonValue &primitive = primitives->Items[p];
+                if (primitive.unsignedMember("mode", 4) != 4) // only GL_TRIANGLES
+                    continue;
+                const JsonValue* attributes = primitive.find("attributes");
+                const JsonValue* position = attributes != nullptr ? attributes->find("POSITION") : nullptr;
+                const JsonValue* texCoord = attributes != nullptr ? attributes->find("TEXCOORD_0") : nullptr;
+                const JsonValue* indices = primitive.find("indices");
+
+                GltfAccessor positions, texCoords, indexAccessor;
+                if (position == nullptr || !buffers.accessor(*position, positions) || positions.Components != 3 ||
+                    positions.ComponentType != GltfAccessor::FLOAT)
+                    return fail("GLTF_BAD_POSITIONS");
+                if (texCoord != nullptr && (!buffers.accessor(*texCoord, texCoords) || texCoords.Components != 2 ||
+                                            texCoords.Count != positions.Count))
+                    return fail("GLTF_BAD_TEXCOORDS");
+                if (indices != nullptr && (!buffers.accessor(*indices, indexAccessor) || indexAccessor.Components != 1 ||
+                                           (indexAccessor.ComponentType != GltfAccessor::UNSIGNED_BYTE &&
+                                            indexAccessor.ComponentType != GltfAccessor::UNSIGNED_SHORT &&
+                                            indexAccessor.ComponentType != GltfAccessor::UNSIGNED_INT)))
+                    return fail("GLTF_BAD_INDICES");
+                stats.SourceVertices += positions.Count;
+
+                // every vertex of the primitive once through the hash, then its indices through the remap table
+                remap.resize(positions.Count);
+                for (uint64_t v = 0; v < positions.Count; ++v)
+                {
+                    float vertex[ImportedMesh::VERTEX_SIZE] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+                    positions.readFloats(v, vertex);
+                    if (texCoord != nullptr)
+                    {
+                        texCoords.readFloats(v, vertex + 3);
+                        vertex[4] = 1.0f - vertex[4];
+                    }
+                    remap[v] = vertices.add(vertex);
+                }
+                const uint64_t indexCount = indices != nullptr ? indexAccessor.Count : positions.Count;
+                for (uint64_t i = 0; i < indexCount - indexCount % 3; ++i)
+                {
+                    const uint64_t index = indices != nullptr ? indexAccessor.readIndex(i) : i;
+                    if (index >= positions.Count)
+                        return fail("GLTF_INDEX_OUT_OF_RANGE");
+                    mesh.Indices.push_back(remap[index]);
+                }
+            }
+        }
+        stats.Triangles = mesh.Indices.size() / 3;
+        stats.BuildTime = milliseconds(start);
+        return true;
+    }
+
+    const MeshImportStats& getStats() const { return stats; }
+
+private:
+    JobSystem* jobs;
+    size_t chunkBytes;
+    MeshImportStats stats;
+
+    // The "v", "vt" and "f" lines of a piece of OBJ text. Corners holds a position and a texture coordinate index per
+    // triangle corner, 0 based; negative OBJ indices refer to the vertices before the line, which are only known within
+    // the chunk: such indices are stored relative to the first vertex of the chunk and listed in RelativePositions and
+    // RelativeTexCoords, so the importer can add the vertex counts of the chunks before
+    struct ObjChunk
+    {
+        static const int64_t NONE = std::numeric_limits<int64_t>::min();
+
+        const char* Begin;
+        const char* End;
+        std::vector<float> Positions;    // x, y, z
+        std::vector<float> TexCoords;    // u, v
+        std::vector<int64_t> Corners;
+        std::vector<size_t> RelativePositions;
+        std::vector<size_t> RelativeTexCoords;
+        size_t Lines;
+        size_t ErrorLine;                // 1 based line of the chunk with a syntax error, 0 if none
+
+        ObjChunk(const char* begin, const char* end) : Begin(begin), End(end), Lines(0), ErrorLine(0) {}
+
+        void parse()
+        {
+            // a rough guess of what the text holds, so the arrays don't grow too often
+            Positions.reserve((End - Begin) / 40 * 3);
+            Corners.reserve((End - Begin) / 40 * 6);
+            int64_t polygon[2][4];
+            for (const char* p = Begin; p < End; )
+            {
+                const char* lineEnd = static_cast<const char*>(memchr(p, '\n', End - p));
+                if (lineEnd == nullptr)
+                    lineEnd = End;
+                ++Lines;
+                skipBlanks(p, lineEnd);
+                bool valid = true;
+                if (lineEnd - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+                {
+                    p += 2;
+                    float x, y, z;
+                    valid = parseFloat(p, lineEnd, x) && parseFloat(p, lineEnd, y) && parseFloat(p, lineEnd, z);
+                    Positions.push_back(x);
+                    Positions.push_back(y);
+                    Positions.push_back(z);
+                }
+                else if (lineEnd - p > 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t'))
+                {
+                    p += 3;
+                    float u, v = 0.0f;
+                    valid = parseFloat(p, lineEnd, u);
+                    parseFloat(p, lineEnd, v);
+                    TexCoords.push_back(u);
+                    TexCoords.push_back(v);
+                }
+                else if (lineEnd - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+                {
+                    // a polygon as a triangle fan: corner 0 and the previous corner with every corner from the third on
+                    p += 2;
+                    int corners = 0;
+                    int64_t corner[4];
+                    while (valid && parseCorner(p, lineEnd, corner, valid))
+                    {
+                        if (corners >= 2)
+                        {
+                            addCorner(polygon[0]);
+                            addCorner(polygon[1]);
+                            addCorner(corner);
+                        }
+                        memcpy(polygon[std::min(corners, 1)], corner, sizeof(corner));
+                        ++corners;
+                    }
+                    valid = valid && corners >= 3;
+                }
+                if (!valid && ErrorLine == 0)
+                    ErrorLine = Lines;
+                p = lineEnd + 1;
+            }
+        }
+
+        // the indices of a corner "v", "v/vt", "v//vn" or "v/vt/vn" as position, texture coordinate and whether these
+        // are chunk relative; false at the end of the line or on an error
+        bool parseCorner(const char* &p, const char* end, int64_t corner[4], bool &valid)
+        {
+            skipBlanks(p, end);
+            if (p == end || *p == '\r' || *p == '#')
+                return false;
+            int64_t indices[2] = { 0, 0 };
+            valid = parseInt(p, end, indices[0]);
+            if (valid && p < end && *p == '/')
+            {
+                ++p;
+                if (p < end && *p != '/')
+                    valid = parseInt(p, end, indices[1]);
+                if (valid && p < end && *p == '/')
+                {
+                    int64_t normal;
+                    ++p;
+                    valid = parseInt(p, end, normal);
+                }
+            }
+            valid = valid && indices[0] != 0 && (p == end || *p == ' ' || *p == '\t' || *p == '\r');
+            if (!valid)
+                return false;
+            // 1 based absolute indices to 0 based, negative ones relative to the vertices of the chunk before the line
+            corner[0] = indices[0] > 0 ? indices[0] - 1 : static_cast<int64_t>(Positions.size() / 3) + indices[0];
+            corner[1] = indices[1] == 0 ? NONE : indices[1] > 0 ? indices[1] - 1 : static_cast<int64_t>(TexCoords.size() / 2) + indices[1];
+            corner[2] = indices[0] < 0;
+            corner[3] = indices[1] < 0;
+            return true;
+        }
+
+        void addCorner(const int64_t corner[4])
+        {
+            if (corner[2])
+                RelativePositions.push_back(Corners.size());
+            Corners.push_back(corner[0]);
+            if (corner[3])
+                RelativeTexCoords.push_back(Corners.size());
+            Corners.push_back(corner[1]);
+        }
+
+        static void skipBlanks(const char* &p, const char* end)
+        {
+            while (p < end && (*p == ' ' || *p == '\t'))
+                ++p;
+        }
+
+        static bool parseInt(const char* &p, const char* end, int64_t &value)
+        {
+            bool negative = p < end && *p == '-';
+            if (negative || (p < end && *p == '+'))
+                ++p;
+            if (p == end || *p < '0' || *p > '9')
+                return false;
+            value = 0;
+            while (p < end && *p >= '0' && *p <= '9')
+                value = value*10 + (*p++ - '0');
+            if (negative)
+                value = -value;
+            return true;
+        }
+
+        // decimal floating point number with an optional exponent: the digits are gathered into an integer which is
+        // scaled by an exact power of ten when possible (correctly rounded up to 15 digits), otherwise by std::pow
+        static bool parseFloat(const char* &p, const char* end, float &value)
+        {
+            static const double POWERS[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+            skipBlanks(p, end);
+            const bool negative = p < end && *p == '-';
+            if (negative || (p < end && *p == '+'))
+                ++p;
+            uint64_t mantissa = 0;
+            int exponent = 0, digits = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits)
+            {
+                if (mantissa < 100000000000000000ull)
+                    mantissa = mantissa*10 + (*p - '0');
+                else
+                    ++exponent;
+            }
+            if (p < end && *p == '.')
+            {
+                for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits)
+                    if (mantissa < 100000000000000000ull)
+                    {
+                        mantissa = mantissa*10 + (*p - '0');
+                        --exponent;
+                    }
+            }
+            if (digits == 0)
+                return false;
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                int64_t written;
+                if (!parseInt(p, end, written))
+                    return false;
+                exponent += static_cast<int>(std::max<int64_t>(-400, std::min<int64_t>(400, written)));
+            }
+            double result = static_cast<double>(mantissa);
+            if (exponent >= 0 && exponent <= 22)
+                result *= POWERS[exponent];
+            else if (exponent < 0 && exponent >= -22)
+                result /= POWERS[-exponent];
+            else
+                result *= std::pow(10.0, exponent);
+            value = static_cast<float>(negative ? -result : result);
+            return true;
+        }
+    };
+
+    // Accessor of a glTF buffer view in the binary chunk: Count elements of Components components of ComponentType,
+    // Stride bytes apart starting at Data
+    struct GltfAccessor
+    {
+        enum
+        {
+            BYTE = 5120,
+            UNSIGNED_BYTE = 5121,
+            SHORT = 5122,
+            UNSIGNED_SHORT = 5123,
+            UNSIGNED_INT = 5125,
+            FLOAT = 5126
+        };
+
+        const char* Data;
+        uint64_t Count;
+        uint64_t Stride;
+        unsigned Components;
+        unsigned ComponentType;
+        bool Normalized;
+
+        GltfAccessor() : Data(nullptr), Count(0), Stride(0), Components(0), ComponentType(0), Normalized(false) {}
+
+        static unsigned componentSize(unsigned type)
+        {
+            switch (type)
+            {
+            case BYTE: case UNSIGNED_BYTE: return 1;
+            case SHORT: case UNSIGNED_SHORT: return 2;
+            case UNSIGNED_INT: case FLOAT: return 4;
+            default: return 0;
+            }
+        }
+
+        // the components of element i as floats (normalized integers are mapped to [0, 1] or [-1, 1])
+        void readFloats(uint64_t i, float* values) const
+        {
+            const char* element = Data + i*Stride;
+            for (unsigned c = 0; c < Components; ++c)
+            {
+                switch (ComponentType)
+                {
+                case FLOAT: memcpy(&values[c], element + 4*c, 4); break;
+                case UNSIGNED_BYTE: values[c] = static_cast<unsigned char>(element[c]) / (Normalized ? 255.0f : 1.0f); break;
+                case BYTE: values[c] = std::max(static_cast<signed char>(element[c]) / (Normalized ? 127.0f : 1.0f), -1.0f); break;
+                case UNSIGNED_SHORT:
+                {
+                    uint16_t value;
+                    memcpy(&value, element + 2*c, 2);
+                    values[c] = value / (Normalized ? 65535.0f : 1.0f);
+                    break;
+                }
+                case SHORT:
+                {
+                    int16_t value;
+                    memcpy(&value, element + 2*c, 2);
+                    values[c] = std::max(value / (Normalized ? 32767.0f : 1.0f), -1.0f);
+                    break;
+                }
+                default: values[c] = 0.0f; break;
+                }
+            }
+        }
+
+        uint64_t readIndex(uint64_t i) const
+        {
+            const char* element = Data + i*Stride;
+            if (ComponentType == UNSIGNED_BYTE)
+                return static_cast<unsigned char>(*element);
+            if (ComponentType == UNSIGNED_SHORT)
+            {
+                uint16_t value;
+                memcpy(&value, element, 2);
+                return value;
+            }
+            return read32(element);
+        }
+    };
+
+    // The accessors and buffer views of a glTF document over its binary chunk (buffer 0 without an uri)
+    struct GltfBuffers
+    {
+        const JsonValue* Accessors;
+        const JsonValue* BufferViews;
+        const char* Binary;
+        size_t BinarySize;
+
+        GltfBuffers(const JsonValue &document, const char* binary, size_t binarySize)
+            : Accessors(document.find("accessors")), BufferViews(document.find("bufferViews")), Binary(binary), BinarySize(binarySize)
+        {
+        }
+
+        // the accessor with the index in value, false if it is missing, sparse or outside of its buffer view
+        bool accessor(const JsonValue &value, GltfAccessor &result) const
+        {
+            if (value.Kind != JsonValue::JSON_NUMBER || Accessors == nullptr || value.Number < 0 || value.Number >= Accessors->Items.size() ||
+                Binary == nullptr || BufferViews == nullptr)
+                return false;
+            const JsonValue &accessor = Accessors->Items[static_cast<size_t>(value.Number)];
+            const uint64_t viewIndex = accessor.unsignedMember("bufferView", UINT64_MAX);
+            const JsonValue* type = accessor.find("type");
+            const JsonValue* normalized = accessor.find("normalized");
+            if (accessor.find("sparse") != nullptr || viewIndex >= BufferViews->Items.size() || type == nullptr)
+                return false;
+            const JsonValue &view = BufferViews->Items[viewIndex];
+            if (view.unsignedMember("buffer", 0) != 0)
+                return false;
+
+            result.ComponentType = static_cast<unsigned>(accessor.unsignedMember("componentType", 0));
+            result.Components = type->String == "SCALAR" ? 1 : type->String == "VEC2" ? 2 : type->String == "VEC3" ? 3 : type->String == "VEC4" ? 4 : 0;
+            result.Count = accessor.unsignedMember("count", 0);
+            result.Normalized = normalized != nullptr && normalized->Kind == JsonValue::JSON_BOOL && normalized->Number != 0.0;
+            const uint64_t elementSize = uint64_t(GltfAccessor::componentSize(result.ComponentType))*result.Components;
+            result.Stride = view.unsignedMember("byteStride", elementSize);
+            const uint64_t viewOffset = view.unsignedMember("byteOffset", 0);
+            const uint64_t viewLength = view.unsignedMember("byteLength", 0);
+            const uint64_t offset = accessor.unsignedMember("byteOffset", 0);
+            if (elementSize == 0 || result.Stride < elementSize || viewOffset > BinarySize || viewLength > BinarySize - viewOffset ||
+                (result.Count > 0 && (offset > viewLength || (result.Count - 1) > (viewLength - offset - std::min(elementSize, viewLength - offset)) / result.Stride ||
+                                      offset + elementSize > viewLength)))
+                return false;
+            result.Data = Binary + viewOffset + offset;
+            return true;
+        }
+    };
+
+    static uint32_t read32(const char* data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static double milliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static bool fail(const char* what)
+    {
+        std::cout << "ERROR::MESH_IMPORT::" << what << std::endl;
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Layout of one draw record in a GL_DRAW_INDIRECT_BUFFER as read by glDrawElementsIndirect/glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    GLuint count;         // number of indices of the mesh
+    GLuint instanceCount; // number of instances to draw (0 skips the draw)
+    GLuint firstIndex;    // offset of the first index of the mesh in the shared EBO
+    GLint  baseVertex;    // offset of the first vertex of the mesh in the shared VBO
+    GLuint baseInstance;  // offset of the first per-object record in the instance attributes
+};
+
+// Location of a mesh which has been sub-allocated inside a MeshPool
+struct MeshRange
+{
+    GLuint firstIndex;
+    GLuint indexCount;
+    GLint  baseVertex;
+    GLuint vertexCount;
+};
+
+// Stores many meshes with the interleaved vertex layout of the samples (3 floats position, 2 floats texture coordinates)
+// in one shared VBO/EBO pair behind one VAO, together with a per-object model matrix buffer (instanced attribute)
+// Every mesh is addressed by its MeshRange, so no buffer or VAO has to be re-bound between the draws of different meshes
+class MeshPool
+{
+public:
+    GLuint VAO;
+    GLuint VBO;
+    GLuint EBO;
+    GLuint InstanceVBO;
+
+    // floats per vertex of the interleaved layout
+    static const GLuint VERTEX_SIZE = 5;
+
+    MeshPool() : VAO(0), VBO(0), EBO(0), InstanceVBO(0)
+    {
+    }
+
+    // Appends a mesh to the CPU side copy of the pool. Indices are local to the mesh (starting at 0), the offset
+    // of the mesh inside the shared VBO is applied by the draw call through baseVertex
+    MeshRange addMesh(const GLfloat* vertices, GLuint vertexCount, const GLuint* indices, GLuint indexCount)
+    {
+        MeshRange range;
+        range.firstIndex = static_cast<GLuint>(indexData.size());
+        range.indexCount = indexCount;
+        range.baseVertex = static_cast<GLint>(vertexData.size() / VERTEX_SIZE);
+        range.vertexCount = vertexCount;
+
+        vertexData.insert(vertexData.end(), vertices, vertices + vertexCount*VERTEX_SIZE);
+        indexData.insert(indexData.end(), indices, indices + indexCount);
+        return range;
+    }
+
+    // Appends an indexed box of the given size centered at the origin (4 vertices per face so that every face gets its own
+    // texture coordinates)
+    MeshRange addBox(const glm::vec3 &size)
+    {
+        const glm::vec3 h = 0.5f*size;
+        const GLfloat vertices[] = {
+            // back face
+            -h.x, -h.y, -h.z,  0.0f, 0.0f,
+             h.x, -h.y, -h.z,  1.0f, 0.0f,
+             h.x,  h.y, -h.z,  1.0f, 1.0f,
+            -h.x,  h.y, -h.z,  0.0f, 1.0f,
+            // front face
+            -h.x, -h.y,  h.z,  0.0f, 0.0f,
+             h.x, -h.y,  h.z,  1.0f, 0.0f,
+             h.x,  h.y,  h.z,  1.0f, 1.0f,
+            -h.x,  h.y,  h.z,  0.0f, 1.0f,
+            // left face
+            -h.x,  h.y,  h.z,  1.0f, 0.0f,
+            -h.x,  h.y, -h.z,  1.0f, 1.0f,
+            -h.x, -h.y, -h.z,  0.0f, 1.0f,
+            -h.x, -h.y,  h.z,  0.0f, 0.0f,
+            // right face
+             h.x,  h.y,  h.z,  1.0f, 0.0f,
+             h.x,  h.y, -h.z,  1.0f, 1.0f,
+             h.x, -h.y, -h.z,  0.0f, 1.0f,
+             h.x, -h.y,  h.z,  0.0f, 0.0f,
+            // bottom face
+            -h.x, -h.y, -h.z,  0.0f, 1.0f,
+             h.x, -h.y, -h.z,  1.0f, 1.0f,
+             h.x, -h.y,  h.z,  1.0f, 0.0f,
+            -h.x, -h.y,  h.z,  0.0f, 0.0f,
+            // top face
+            -h.x,  h.y, -h.z,  0.0f, 1.0f,
+             h.x,  h.y, -h.z,  1.0f, 1.0f,
+             h.x,  h.y,  h.z,  1.0f, 0.0f,
+            -h.x,  h.y,  h.z,  0.0f, 0.0f
+        };
+        const GLuint indices[] = {
+             0,  1,  2,   2,  3,  0,
+             4,  5,  6,   6,  7,  4,
+             8,  9, 10,  10, 11,  8,
+            12, 13, 14,  14, 15, 12,
+            16, 17, 18,  18, 19, 16,
+            20, 21, 22,  22, 23, 20
+        };
+        return addMesh(vertices, 24, indices, 36);
+    }
+
+    // Creates the GL objects and uploads all the meshes added so far in one glBufferData call per buffer
+    // Attribute locations: 0 = position, 1 = texture coordinates, 2..5 = per-object model matrix (divisor 1)
+    void upload()
+    {
+        if (VAO == 0)
+        {
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+            glGenBuffers(1, &EBO);
+            glGenBuffers(1, &InstanceVBO);
+        }
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexData.size()*sizeof(GLfloat), vertexData.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        // the element buffer binding is stored in the VAO, so it must stay bound while the VAO is bound
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size()*sizeof(GLuint), indexData.data(), GL_STATIC_DRAW);
+
+        // a mat4 attribute occupies 4 consecutive locations (one per column)
+        glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column*sizeof(glm::vec4)));
+            glEnableVertexAttribArray(2 + column);
+            glVertexAttribDivisor(2 + column, 1); // advance once per instance and not once per vertex
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // Uploads the per-object model matrices; the record used by a draw is selected through its baseInstance
+    void setInstanceData(const std::vector<glm::mat4> &models)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, models.size()*sizeof(glm::mat4), models.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void bind() const
+    {
+        glBindVertexArray(VAO);
+    }
+
+    GLuint vertexCount() const
+    {
+        return static_cast<GLuint>(vertexData.size() / VERTEX_SIZE);
+    }
+
+    GLuint indexCount() const
+    {
+        return static_cast<GLuint>(indexData.size());
+    }
+
+    // de-allocate the GL objects (must be called while the context is still current)
+    void destroy()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteBuffers(1, &InstanceVBO);
+        VAO = VBO = EBO = InstanceVBO = 0;
+    }
+
+private:
+    std::vector<GLfloat> vertexData;
+    std::vector<GLuint> indexData;
+};
+
+// List of draw records which is submitted with a single glMultiDrawElementsIndirect call
+class IndirectDrawBuffer
+{
+public:
+    GLuint ID;
+    std::vector<DrawElementsIndirectCommand> Commands;
+
+    IndirectDrawBuffer() : ID(0)
+    {
+    }
+
+    // Records a draw of the mesh; baseInstance selects the per-object record(s) of the instance attributes
+    void add(const MeshRange &mesh, GLuint baseInstance, GLuint instanceCount = 1)
+    {
+        DrawElementsIndirectCommand command;
+        command.count = mesh.indexCount;
+        command.instanceCount = instanceCount;
+        command.firstIndex = mesh.firstIndex;
+        command.baseVertex = mesh.baseVertex;
+        command.baseInstance = baseInstance;
+        Commands.push_back(command);
+    }
+
+    void clear()
+    {
+        Commands.clear();
+    }
+
+    // Uploads the draw records into the GL_DRAW_INDIRECT_BUFFER
+    void upload()
+    {
+        if (ID == 0)
+            glGenBuffers(1, &ID);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ID);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, Commands.size()*sizeof(DrawElementsIndirectCommand), Commands.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Draws every record with one call; the VAO of the MeshPool the records refer to has to be bound
+    void draw(GLenum mode = GL_TRIANGLES) const
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ID);
+        glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(Commands.size()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &ID);
+        ID = 0;
+    }
+};
+
+#endif // MESH_POOL_H
@@ -0,0 +1,267 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_CULLING_SSE 1
+#endif
+
+// Software occlusion culling: a few chosen occluders are rasterized on the CPU into a low resolution depth buffer (depth only,
+// 4 pixels at a time with SSE2 and in horizontal bands on several threads), from which a hierarchical-Z (Hi-Z) pyramid is built
+// where every texel holds the farthest depth of the 2x2 texels below it. An object's bounding box is hidden when its nearest
+// depth lies behind the farthest depth of every Hi-Z texel its screen rectangle covers
+// Depth values are window depths in [0, 1] (0 = near plane), pixel row 0 is the bottom of the screen as in OpenGL
+class OcclusionCuller
+{
+public:
+    // width must be a multiple of 4 (SIMD width)
+    OcclusionCuller(int width = 256, int height = 128, unsigned threadCount = std::thread::hardware_concurrency())
+        : width((width + 3) & ~3), height(height), threadCount(std::max(1u, threadCount))
+    {
+        depth.assign(this->width*this->height, 1.0f);
+        buildLevelSizes();
+    }
+
+    // Starts a new frame: sets the camera and forgets the occluders of the last frame
+    void beginFrame(const glm::mat4 &viewProjection)
+    {
+        this->viewProjection = viewProjection;
+        triangles.clear();
+    }
+
+    // Adds an occluder given as non-indexed triangle list (GL_TRIANGLES) in model space. stride is the number of floats between
+    // two vertices (e.g. 5 for the interleaved position/texture coordinate arrays of the samples), the position comes first
+    void addOccluder(const float* vertices, size_t vertexCount, size_t stride, const glm::mat4 &model)
+    {
+        const glm::mat4 mvp = viewProjection * model;
+        for (size_t i = 0; i + 2 < vertexCount; i += 3)
+        {
+            Triangle triangle;
+            bool valid = true;
+            for (int j = 0; j < 3; ++j)
+            {
+                const float* p = vertices + (i + j)*stride;
+                glm::vec4 clip = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+                // triangles crossing the near plane are skipped: fewer occluder pixels only ever make the culling less effective
+                if (clip.w <= 1e-5f || clip.z < -clip.w)
+                {
+                    valid = false;
+                    break;
+                }
+                triangle.v[j] = toWindow(clip);
+            }
+            if (valid)
+                triangles.push_back(triangle);
+        }
+    }
+
+    // Clears the depth buffer to the far plane, rasterizes all occluders of the frame and builds the Hi-Z pyramid
+    void rasterize()
+    {
+        std::fill(depth.begin(), depth.end(), 1.0f);
+
+        // every thread owns a band of rows, so no two threads ever write the same pixel
+        const int bands = static_cast<int>(std::min<unsigned>(threadCount, static_cast<unsigned>(height)));
+        const int rowsPerBand = (height + bands - 1) / bands;
+        std::vector<std::thread> workers;
+        for (int band = 1; band < bands; ++band)
+            workers.push_back(std::thread(&OcclusionCuller::rasterizeBand, this, band*rowsPerBand, std::min(height, (band + 1)*rowsPerBand)));
+        rasterizeBand(0, std::min(height, rowsPerBand));
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+
+        buildPyramid();
+    }
+
+    // Returns false if the axis aligned box (center, half extents) is completely hidden behind the occluders or off screen
+    bool isVisible(const glm::vec3 &center, const glm::vec3 &extents) const
+    {
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minDepth = 1.0f;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 p = center + glm::vec3((corner & 1) ? extents.x : -extents.x,
+                                             (corner & 2) ? extents.y : -extents.y,
+                                             (corner & 4) ? extents.z : -extents.z);
+            glm::vec4 clip = viewProjection * glm::vec4(p, 1.0f);
+            // the box reaches through the near plane: it can't be hidden
+            if (clip.w <= 1e-5f || clip.z < -clip.w)
+                return true;
+            glm::vec3 window = toWindow(clip);
+            minX = std::min(minX, window.x);
+            maxX = std::max(maxX, window.x);
+            minY = std::min(minY, window.y);
+            maxY = std::max(maxY, window.y);
+            minDepth = std::min(minDepth, window.z);
+        }
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+            return false;
+        int x0 = std::max(0, static_cast<int>(minX)), x1 = std::min(width - 1, static_cast<int>(maxX));
+        int y0 = std::max(0, static_cast<int>(minY)), y1 = std::min(height - 1, static_cast<int>(maxY));
+
+        // pick the level on which the rectangle covers at most 2x2 texels
+        int size = std::max(x1 - x0, y1 - y0) + 1;
+        int level = 0;
+        while ((1 << level) < size && level + 1 < static_cast<int>(levelWidths.size()))
+            ++level;
+
+        const std::vector<float> &hiz = level == 0 ? depth : levels[level - 1];
+        const int levelWidth = levelWidths[level];
+        for (int y = y0 >> level; y <= (y1 >> level); ++y)
+            for (int x = x0 >> level; x <= (x1 >> level); ++x)
+                if (minDepth <= hiz[y*levelWidth + x])
+                    return true;
+        return false;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getTriangleCount() const { return triangles.size(); }
+    // depth buffer (level 0 of the pyramid), row by row from the bottom of the screen
+    const std::vector<float>& getDepthBuffer() const { return depth; }
+
+private:
+    struct Triangle
+    {
+        glm::vec3 v[3]; // window x, y (pixels) and depth
+    };
+
+    int width;
+    int height;
+    unsigned threadCount;
+    glm::mat4 viewProjection;
+    std::vector<Triangle> triangles;
+    std::vector<float> depth;
+    std::vector<std::vector<float> > levels; // Hi-Z levels 1..n (level 0 is the depth buffer)
+    std::vector<int> levelWidths;
+    std::vector<int> levelHeights;
+
+    glm::vec3 toWindow(const glm::vec4 &clip) const
+    {
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        return glm::vec3((0.5f*ndc.x + 0.5f)*width, (0.5f*ndc.y + 0.5f)*height, 0.5f*ndc.z + 0.5f);
+    }
+
+    void buildLevelSizes()
+    {
+        int w = width, h = height;
+        levelWidths.push_back(w);
+        levelHeights.push_back(h);
+        while (w > 1 || h > 1)
+        {
+            w = std::max(1, (w + 1)/2);
+            h = std::max(1, (h + 1)/2);
+            levelWidths.push_back(w);
+            levelHeights.push_back(h);
+            levels.push_back(std::vector<float>(w*h, 1.0f));
+        }
+    }
+
+    // every Hi-Z texel keeps the farthest depth of the (up to) 2x2 texels of the level below
+    void buildPyramid()
+    {
+        for (size_t level = 1; level < levelWidths.size(); ++level)
+        {
+            const std::vector<float> &src = level == 1 ? depth : levels[level - 2];
+            std::vector<float> &dst = levels[level - 1];
+            const int srcWidth = levelWidths[level - 1], srcHeight = levelHeights[level - 1];
+            const int dstWidth = levelWidths[level], dstHeight = levelHeights[level];
+            for (int y = 0; y < dstHeight; ++y)
+            {
+                const int sy0 = 2*y, sy1 = std::min(2*y + 1, srcHeight - 1);
+                for (int x = 0; x < dstWidth; ++x)
+                {
+                    const int sx0 = 2*x, sx1 = std::min(2*x + 1, srcWidth - 1);
+                    dst[y*dstWidth + x] = std::max(std::max(src[sy0*srcWidth + sx0], src[sy0*srcWidth + sx1]),
+                                                   std::max(src[sy1*srcWidth + sx0], src[sy1*srcWidth + sx1]));
+                }
+            }
+        }
+    }
+
+    // Rasterizes every triangle into the rows [rowBegin, rowEnd) keeping the nearest depth per pixel
+    void rasterizeBand(int rowBegin, int rowEnd)
+    {
+        for (size_t t = 0; t < triangles.size(); ++t)
+        {
+            glm::vec3 v0 = triangles[t].v[0], v1 = triangles[t].v[1], v2 = triangles[t].v[2];
+
+            // counter-clockwise order so that the inside of all edges is positive; degenerate triangles are skipped
+            float area = (v1.x - v0.x)*(v2.y - v0.y) - (v1.y - v0.y)*(v2.x - v0.x);
+            if (area < 0.0f)
+            {
+                std::swap(v1, v2);
+                area = -area;
+            }
+            if (area < 1e-8f)
+                continue;
+
+            // bounding box of the pixel centers inside the band
+            int minX = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)) - 0.5f)));
+            int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)) - 0.5f)));
+            int minY = std::max(rowBegin, static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)) - 0.5f)));
+            int maxY = std::min(rowEnd - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)) - 0.5f)));
+            if (minX > maxX || minY > maxY)
+                continue;
+            minX &= ~3; // start at a SIMD aligned column
+
+            // edge functions E(x, y) = A*x + B*y + C, Ei is positive on the inner side of the edge opposite to vertex i
+            const float A0 = v1.y - v2.y, B0 = v2.x - v1.x, C0 = -A0*v1.x - B0*v1.y;
+            const float A1 = v2.y - v0.y, B1 = v0.x - v2.x, C1 = -A1*v2.x - B1*v2.y;
+            const float A2 = v0.y - v1.y, B2 = v1.x - v0.x, C2 = -A2*v0.x - B2*v0.y;
+            // depth is an affine function of the window position: z = ZA*x + ZB*y + ZC
+            const float ZA = (A0*v0.z + A1*v1.z + A2*v2.z)/area;
+            const float ZB = (B0*v0.z + B1*v1.z + B2*v2.z)/area;
+            const float ZC = (C0*v0.z + C1*v1.z + C2*v2.z)/area;
+
+            for (int y = minY; y <= maxY; ++y)
+            {
+                const float py = y + 0.5f;
+                float* row = &depth[y*width];
+#ifdef OCCLUSION_CULLING_SSE
+                const __m128 px0 = _mm_add_ps(_mm_set1_ps(minX + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+                const __m128 step = _mm_set1_ps(4.0f);
+                const __m128 zero = _mm_setzero_ps();
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A0), px0), _mm_set1_ps(B0*py + C0));
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A1), px0), _mm_set1_ps(B1*py + C1));
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A2), px0), _mm_set1_ps(B2*py + C2));
+                __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ZA), px0), _mm_set1_ps(ZB*py + ZC));
+                const __m128 e0Step = _mm_mul_ps(_mm_set1_ps(A0), step);
+                const __m128 e1Step = _mm_mul_ps(_mm_set1_ps(A1), step);
+                const __m128 e2Step = _mm_mul_ps(_mm_set1_ps(A2), step);
+                const __m128 zStep = _mm_mul_ps(_mm_set1_ps(ZA), step);
+                for (int x = minX; x <= maxX; x += 4)
+                {
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                    if (_mm_movemask_ps(inside))
+                    {
+                        __m128 old = _mm_loadu_ps(row + x);
+                        __m128 nearest = _mm_min_ps(old, z);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+                    }
+                    e0 = _mm_add_ps(e0, e0Step);
+                    e1 = _mm_add_ps(e1, e1Step);
+                    e2 = _mm_add_ps(e2, e2Step);
+                    z = _mm_add_ps(z, zStep);
+                }
+#else
+                for (int x = minX; x <= maxX; ++x)
+                {
+                    const float px = x + 0.5f;
+                    if (A0*px + B0*py + C0 >= 0.0f && A1*px + B1*py + C1 >= 0.0f && A2*px + B2*py + C2 >= 0.0f)
+                        row[x] = std::min(row[x], ZA*px + ZB*py + ZC);
+                }
+#endif
+            }
+        }
+    }
+};
+
+#endif // OCCLUSION_CULLING_H
@@ -0,0 +1,196 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <string>
+#include <vector>
+
+// Primitive types of the draw model used by the samples (glDrawArrays with GL_TRIANGLES or GL_LINES)
+enum ScenePrimitive
+{
+    SCENE_TRIANGLES,
+    SCENE_LINES
+};
+
+// Non-indexed mesh with the interleaved vertex layout of the samples (3 floats position, 2 floats texture coordinates)
+struct SceneMesh
+{
+    std::vector<float> Vertices;
+    ScenePrimitive Primitive;
+
+    static const unsigned VERTEX_SIZE = 5;
+
+    unsigned vertexCount() const
+    {
+        return static_cast<unsigned>(Vertices.size() / VERTEX_SIZE);
+    }
+};
+
+// One draw of a mesh with its model matrix
+struct SceneObject
+{
+    unsigned Mesh;
+    glm::mat4 Model;
+};
+
+// Renderer independent description of a scene drawn with the shaders of hello_camera_class (projection*view*model transform,
+// two textures mixed with mixValue): it holds no GL objects, so the same scene can be drawn through OpenGL or on the CPU
+struct Scene
+{
+    std::vector<SceneMesh> Meshes;
+    std::vector<SceneObject> Objects;
+    std::string TexturePaths[2]; // texture1 and texture2 of the fragment shader, relative to the common folder
+    float MixValue;
+    glm::vec4 ClearColor;
+
+    Scene() : MixValue(0.2f), ClearColor(0.2f, 0.3f, 0.3f, 1.0f)
+    {
+        TexturePaths[0] = "resources/textures/container.jpg";
+        TexturePaths[1] = "resources/textures/awesomeface.png";
+    }
+
+    unsigned addMesh(const float* vertices, unsigned vertexCount, ScenePrimitive primitive)
+    {
+        SceneMesh mesh;
+        mesh.Vertices.assign(vertices, vertices + vertexCount*SceneMesh::VERTEX_SIZE);
+        mesh.Primitive = primitive;
+        Meshes.push_back(mesh);
+        return static_cast<unsigned>(Meshes.size() - 1);
+    }
+
+    void addObject(unsigned mesh, const glm::mat4 &model)
+    {
+        SceneObject object;
+        object.Mesh = mesh;
+        object.Model = model;
+        Objects.push_back(object);
+    }
+
+    // The textured cube of the samples (retrieved directly from LearnOpenGL), 36 vertices
+    unsigned addCubeMesh()
+    {
+        const float vertices[] = {
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        };
+        return addMesh(vertices, 36, SCENE_TRIANGLES);
+    }
+
+    // The coordinate axes of misc_coordinateaxes (one line and an arrow head per axis), 18 vertices drawn as GL_LINES
+    unsigned addCoordinateAxesMesh(float c = 0.5f)
+    {
+        const float vertices[] = {
+               0.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+             c*1.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+             c*1.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+             c*0.95f,    0.00f,  c*0.05f,    0.00f, 0.00f,
+             c*1.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+             c*0.95f,    0.00f, c*-0.05f,    0.00f, 0.00f,
+
+               0.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+               0.00f,  c*1.00f,    0.00f,    0.00f, 0.00f,
+               0.00f,  c*1.00f,    0.00f,    0.00f, 0.00f,
+               0.00f,  c*0.95f,  c*0.05f,    0.00f, 0.00f,
+               0.00f,  c*1.00f,    0.00f,    0.00f, 0.00f,
+               0.00f,  c*0.95f, c*-0.05f,    0.00f, 0.00f,
+
+               0.00f,    0.00f,    0.00f,    0.00f, 0.00f,
+               0.00f,    0.00f,  c*1.00f,    0.00f, 0.00f,
+               0.00f,    0.00f,  c*1.00f,    0.00f, 0.00f,
+             c*0.05f,    0.00f,  c*0.95f,    0.00f, 0.00f,
+               0.00f,    0.00f,  c*1.00f,    0.00f, 0.00f,
+            c*-0.05f,    0.00f,  c*0.95f,    0.00f, 0.00f,
+        };
+        return addMesh(vertices, 18, SCENE_LINES);
+    }
+};
+
+// The scene of hello_camera_class/misc_coordinateaxes: ten containers (every one rotated by 20 degrees more than the one
+// before) and the coordinate axes at the origin
+inline Scene makeContainersScene()
+{
+    const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    Scene scene;
+    unsigned cube = scene.addCubeMesh();
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        model = glm::rotate(model, glm::radians(20.0f*i), glm::vec3(1.0f, 0.0f, 0.0f));
+        scene.addObject(cube, model);
+    }
+    scene.addObject(scene.addCoordinateAxesMesh(), glm::mat4(1.0f));
+    return scene;
+}
+
+// A large grid of containers (gridSize^3 cubes, 1.5 units apart) for load tests
+inline Scene makeCubeGridScene(unsigned gridSize)
+{
+    Scene scene;
+    unsigned cube = scene.addCubeMesh();
+    const float offset = 0.75f*(gridSize - 1);
+    for (unsigned x = 0; x < gridSize; ++x)
+        for (unsigned y = 0; y < gridSize; ++y)
+            for (unsigned z = 0; z < gridSize; ++z)
+            {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(1.5f*x - offset, 1.5f*y - offset, -1.5f*z - 2.0f));
+                scene.addObject(cube, glm::scale(model, glm::vec3(0.5f)));
+            }
+    scene.addObject(scene.addCoordinateAxesMesh(), glm::mat4(1.0f));
+    return scene;
+}
+
+#endif // SCENE_H
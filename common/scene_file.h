@@ -0,0 +1,570 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <mapped_file.h>
+#include <scene.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary scene files: the content of a Scene compiled into the arrays the renderer hands to OpenGL (interleaved vertices,
+// indices, model matrices of the instances), so loading one maps the file and uses the sections in place, nothing is
+// parsed or copied. All numbers are little-endian, the layout is
+//   SceneFileHeader
+//   SceneFileSection[SectionCount] right after the header
+//   the sections, every one at an offset aligned to SCENE_FILE_ALIGNMENT
+// A reader skips the sections of types it doesn't know, so sections can be added without a new version
+const uint32_t SCENE_FILE_VERSION = 1;
+const uint64_t SCENE_FILE_ALIGNMENT = 64;
+const char SCENE_FILE_MAGIC[8] = { 'L', 'O', 'G', 'L', 'S', 'C', 'N', '\0' };
+const uint32_t SCENE_FILE_NO_STRING = 0xFFFFFFFFu;
+
+enum SceneFileSectionType
+{
+    SCENE_SECTION_SETTINGS = 1,   // one SceneFileSettings
+    SCENE_SECTION_STRINGS = 2,    // zero terminated strings referenced by their offset
+    SCENE_SECTION_VERTICES = 3,   // interleaved vertices of all the meshes, SceneMesh::VERTEX_SIZE floats each
+    SCENE_SECTION_INDICES = 4,    // uint32_t, relative to the first vertex of their mesh (the base vertex of the draw)
+    SCENE_SECTION_MESHES = 5,     // SceneFileMesh
+    SCENE_SECTION_INSTANCES = 6,  // model matrices (16 floats, column major) grouped by batch
+    SCENE_SECTION_BATCHES = 7     // SceneFileBatch
+};
+
+struct SceneFileHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t SectionCount;
+    uint64_t FileSize;
+};
+
+struct SceneFileSection
+{
+    uint32_t Type;
+    uint32_t ElementSize;  // bytes per element
+    uint64_t Offset;       // from the start of the file
+    uint64_t Count;        // number of elements
+};
+
+struct SceneFileSettings
+{
+    float ClearColor[4];
+    float MixValue;
+    uint32_t TexturePaths[2];  // offsets into the strings, relative to the common folder (SCENE_FILE_NO_STRING: none)
+    uint32_t Reserved;
+};
+
+struct SceneFileMesh
+{
+    uint32_t FirstVertex;
+    uint32_t VertexCount;
+    uint32_t FirstIndex;
+    uint32_t IndexCount;
+    uint32_t Primitive;    // ScenePrimitive
+    uint32_t Reserved;
+};
+
+// instances [FirstInstance, FirstInstance + InstanceCount) of a mesh, drawn with one instanced draw call
+struct SceneFileBatch
+{
+    uint32_t Mesh;
+    uint32_t FirstInstance;
+    uint32_t InstanceCount;
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(SceneFileHeader) == 24 && sizeof(SceneFileSection) == 24 && sizeof(SceneFileSettings) == 32 &&
+              sizeof(SceneFileMesh) == 24 && sizeof(SceneFileBatch) == 16 && sizeof(glm::mat4) == 64,
+              "the structures of the scene file must not be padded");
+
+// The arrays of a binary scene file, built from a Scene: the vertices of every mesh are deduplicated into an indexed mesh
+// and the objects are grouped by mesh into batches (in the order of the meshes, objects of a mesh in their order)
+struct SceneFileContent
+{
+    std::vector<float> Vertices;
+    std::vector<uint32_t> Indices;
+    std::vector<SceneFileMesh> Meshes;
+    std::vector<glm::mat4> Instances;
+    std::vector<SceneFileBatch> Batches;
+
+    void build(const Scene &scene)
+    {
+        Vertices.clear();
+        Indices.clear();
+        Meshes.clear();
+        Instances.clear();
+        Batches.clear();
+
+        const size_t vertexBytes = SceneMesh::VERTEX_SIZE*sizeof(float);
+        for (size_t m = 0; m < scene.Meshes.size(); ++m)
+        {
+            const SceneMesh &source = scene.Meshes[m];
+            SceneFileMesh mesh;
+            mesh.FirstVertex = static_cast<uint32_t>(Vertices.size() / SceneMesh::VERTEX_SIZE);
+            mesh.FirstIndex = static_cast<uint32_t>(Indices.size());
+            mesh.Primitive = source.Primitive;
+            mesh.Reserved = 0;
+            // the bytes of a vertex as the key: equal vertices have equal bytes
+            std::unordered_map<std::string, uint32_t> unique;
+            for (unsigned v = 0; v < source.vertexCount(); ++v)
+            {
+                const float *vertex = &source.Vertices[v*SceneMesh::VERTEX_SIZE];
+                std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> inserted =
+                    unique.insert(std::make_pair(std::string(reinterpret_cast<const char*>(vertex), vertexBytes), static_cast<uint32_t>(unique.size())));
+                if (inserted.second)
+                    Vertices.insert(Vertices.end(), vertex, vertex + SceneMesh::VERTEX_SIZE);
+                Indices.push_back(inserted.first->second);
+            }
+            mesh.VertexCount = static_cast<uint32_t>(unique.size());
+            mesh.IndexCount = static_cast<uint32_t>(Indices.size()) - mesh.FirstIndex;
+            Meshes.push_back(mesh);
+        }
+
+        std::vector<uint32_t> instanceCounts(scene.Meshes.size(), 0);
+        for (size_t i = 0; i < scene.Objects.size(); ++i)
+            ++instanceCounts[scene.Objects[i].Mesh];
+        std::vector<uint32_t> next(scene.Meshes.size(), 0);
+        uint32_t first = 0;
+        for (size_t m = 0; m < scene.Meshes.size(); ++m)
+        {
+            next[m] = first;
+            if (instanceCounts[m] > 0)
+            {
+                SceneFileBatch batch = { static_cast<uint32_t>(m), first, instanceCounts[m], 0 };
+                Batches.push_back(batch);
+            }
+            first += instanceCounts[m];
+        }
+        Instances.resize(scene.Objects.size());
+        for (size_t i = 0; i < scene.Objects.size(); ++i)
+            Instances[next[scene.Objects[i].Mesh]++] = scene.Objects[i].Model;
+    }
+};
+
+// Compiles scene into the binary scene file at path
+inline bool writeSceneFile(const std::string &path, const Scene &scene)
+{
+    if (!isLittleEndianHost())
+    {
+        std::cout << "ERROR::SCENE_FILE::BIG_ENDIAN_HOST_NOT_SUPPORTED" << std::endl;
+        return false;
+    }
+    SceneFileContent content;
+    content.build(scene);
+
+    std::string strings;
+    SceneFileSettings settings;
+    memcpy(settings.ClearColor, &scene.ClearColor[0], sizeof(settings.ClearColor));
+    settings.MixValue = scene.MixValue;
+    for (int i = 0; i < 2; ++i)
+    {
+        settings.TexturePaths[i] = SCENE_FILE_NO_STRING;
+        if (!scene.TexturePaths[i].empty())
+        {
+            settings.TexturePaths[i] = static_cast<uint32_t>(strings.size());
+            strings.append(scene.TexturePaths[i].c_str(), scene.TexturePaths[i].size() + 1);
+        }
+    }
+    settings.Reserved = 0;
+
+    struct Payload
+    {
+        uint32_t Type;
+        uint32_t ElementSize;
+        const void* Data;
+        uint64_t Count;
+    };
+    const Payload payloads[] = {
+        { SCENE_SECTION_SETTINGS, sizeof(SceneFileSettings), &settings, 1 },
+        { SCENE_SECTION_STRINGS, 1, strings.data(), strings.size() },
+        { SCENE_SECTION_MESHES, sizeof(SceneFileMesh), content.Meshes.data(), content.Meshes.size() },
+        { SCENE_SECTION_BATCHES, sizeof(SceneFileBatch), content.Batches.data(), content.Batches.size() },
+        { SCENE_SECTION_VERTICES, SceneMesh::VERTEX_SIZE*sizeof(float), content.Vertices.data(), content.Vertices.size() / SceneMesh::VERTEX_SIZE },
+        { SCENE_SECTION_INDICES, sizeof(uint32_t), content.Indices.data(), content.Indices.size() },
+        { SCENE_SECTION_INSTANCES, sizeof(glm::mat4), content.Instances.data(), content.Instances.size() }
+    };
+    const uint32_t sectionCount = sizeof(payloads) / sizeof(payloads[0]);
+
+    SceneFileHeader header;
+    memcpy(header.Magic, SCENE_FILE_MAGIC, sizeof(header.Magic));
+    header.Version = SCENE_FILE_VERSION;
+    header.SectionCount = sectionCount;
+    std::vector<SceneFileSection> sections(sectionCount);
+    uint64_t offset = sizeof(SceneFileHeader) + sectionCount*sizeof(SceneFileSection);
+    for (uint32_t i = 0; i < sectionCount; ++i)
+    {
+        offset = (offset + SCENE_FILE_ALIGNMENT - 1) / SCENE_FILE_ALIGNMENT * SCENE_FILE_ALIGNMENT;
+        sections[i].Type = payloads[i].Type;
+        sections[i].ElementSize = payloads[i].ElementSize;
+        sections[i].Offset = offset;
+        sections[i].Count = payloads[i].Count;
+        offset += payloads[i].Count*payloads[i].ElementSize;
+    }
+    header.FileSize = offset;
+
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections.data()), sections.size()*sizeof(SceneFileSection));
+    const char padding[SCENE_FILE_ALIGNMENT] = {};
+    uint64_t written = sizeof(SceneFileHeader) + sectionCount*sizeof(SceneFileSection);
+    for (uint32_t i = 0; i < sectionCount; ++i)
+    {
+        file.write(padding, static_cast<std::streamsize>(sections[i].Offset - written));
+        file.write(static_cast<const char*>(payloads[i].Data), static_cast<std::streamsize>(payloads[i].Count*payloads[i].ElementSize));
+        written = sections[i].Offset + payloads[i].Count*payloads[i].ElementSize;
+    }
+    if (!file)
+    {
+        std::cout << "ERROR::SCENE_FILE::WRITE_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// A binary scene file mapped into memory. open() checks the header and that every section, mesh and batch lies inside the
+// file, which only reads the header, the section table and the small sections: the pages of the vertices, indices and
+// instances are first read when they are used (e.g. by glBufferData), so the load time of a large scene is the time of its
+// page faults. The indices are not checked (that would read all of them), the range of an index is the VertexCount of
+// its mesh. The arrays stay valid until close()
+class SceneFile
+{
+public:
+    SceneFile()
+    {
+        clear();
+    }
+
+    bool open(const std::string &path)
+    {
+        close();
+        if (!isLittleEndianHost())
+            return fail("BIG_ENDIAN_HOST_NOT_SUPPORTED", path);
+        if (!file.open(path))
+            return fail("FILE_NOT_SUCCESFULLY_READ", path);
+        const char *data = file.getData();
+        const uint64_t size = file.getSize();
+
+        SceneFileHeader header;
+        if (size < sizeof(header))
+            return fail("TRUNCATED", path);
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.Magic, SCENE_FILE_MAGIC, sizeof(header.Magic)) != 0)
+            return fail("NOT_A_SCENE_FILE", path);
+        if (header.Version != SCENE_FILE_VERSION)
+            return fail("UNSUPPORTED_VERSION " + std::to_string(header.Version), path);
+        if (header.FileSize != size || (size - sizeof(header)) / sizeof(SceneFileSection) < header.SectionCount)
+            return fail("TRUNCATED", path);
+
+        const SceneFileSection *sections = reinterpret_cast<const SceneFileSection*>(data + sizeof(header));
+        for (uint32_t i = 0; i < header.SectionCount; ++i)
+        {
+            const SceneFileSection &section = sections[i];
+            if (section.Offset % SCENE_FILE_ALIGNMENT != 0 || section.Offset > size || section.ElementSize == 0 ||
+                section.Count > (size - section.Offset) / section.ElementSize)
+                return fail("BAD_SECTION " + std::to_string(i), path);
+            bool known = true;
+            switch (section.Type)
+            {
+            case SCENE_SECTION_SETTINGS: known = take(section, settings, settingsCount); break;
+            case SCENE_SECTION_STRINGS: known = take(section, strings, stringsSize); break;
+            case SCENE_SECTION_VERTICES: known = section.ElementSize == SceneMesh::VERTEX_SIZE*sizeof(float);
+                                         vertices = reinterpret_cast<const float*>(data + section.Offset); vertexCount = section.Count; break;
+            case SCENE_SECTION_INDICES: known = take(section, indices, indexCount); break;
+            case SCENE_SECTION_MESHES: known = take(section, meshes, meshCount); break;
+            case SCENE_SECTION_INSTANCES: known = take(section, instances, instanceCount); break;
+            case SCENE_SECTION_BATCHES: known = take(section, batches, batchCount); break;
+            default: break;
+            }
+            if (!known)
+                return fail("BAD_ELEMENT_SIZE OF SECTION " + std::to_string(i), path);
+        }
+
+        if (settingsCount != 1)
+            return fail("NO_SETTINGS", path);
+        for (int i = 0; i < 2; ++i)
+            if (settings->TexturePaths[i] != SCENE_FILE_NO_STRING &&
+                (settings->TexturePaths[i] >= stringsSize || memchr(strings + settings->TexturePaths[i], '\0', stringsSize - settings->TexturePaths[i]) == nullptr))
+                return fail("BAD_TEXTURE_PATH", path);
+        // indices need a vertex: toScene() maps an index out of the mesh to its first vertex
+        for (uint64_t i = 0; i < meshCount; ++i)
+            if (uint64_t(meshes[i].FirstVertex) + meshes[i].VertexCount > vertexCount ||
+                (meshes[i].IndexCount > 0 && meshes[i].VertexCount == 0) ||
+                uint64_t(meshes[i].FirstIndex) + meshes[i].IndexCount > indexCount || meshes[i].Primitive > SCENE_LINES)
+                return fail("BAD_MESH " + std::to_string(i), path);
+        for (uint64_t i = 0; i < batchCount; ++i)
+            if (batches[i].Mesh >= meshCount || uint64_t(batches[i].FirstInstance) + batches[i].InstanceCount > instanceCount)
+                return fail("BAD_BATCH " + std::to_string(i), path);
+        return true;
+    }
+
+    void close()
+    {
+        file.close();
+        clear();
+    }
+
+    const SceneFileSettings& getSettings() const { return *settings; }
+    const float* getVertices() const { return vertices; }
+    uint64_t getVertexCount() const { return vertexCount; }
+    const uint32_t* getIndices() const { return indices; }
+    uint64_t getIndexCount() const { return indexCount; }
+    const SceneFileMesh* getMeshes() const { return meshes; }
+    uint64_t getMeshCount() const { return meshCount; }
+    const glm::mat4* getInstances() const { return instances; }
+    uint64_t getInstanceCount() const { return instanceCount; }
+    const SceneFileBatch* getBatches() const { return batches; }
+    uint64_t getBatchCount() const { return batchCount; }
+    uint64_t getFileSize() const { return file.getSize(); }
+
+    // texture path i of the settings (relative to the common folder), "" if there is none
+    const char* getTexturePath(int i) const
+    {
+        return settings->TexturePaths[i] == SCENE_FILE_NO_STRING ? "" : strings + settings->TexturePaths[i];
+    }
+
+    // Copies the content into a Scene (with the non-indexed meshes it has) for the renderers which take one
+    Scene toScene() const
+    {
+        Scene scene;
+        scene.ClearColor = glm::vec4(settings->ClearColor[0], settings->ClearColor[1], settings->ClearColor[2], settings->ClearColor[3]);
+        scene.MixValue = settings->MixValue;
+        for (int i = 0; i < 2; ++i)
+            scene.TexturePaths[i] = getTexturePath(i);
+        for (uint64_t m = 0; m < meshCount; ++m)
+        {
+            SceneMesh mesh;
+            mesh.Primitive = static_cast<ScenePrimitive>(meshes[m].Primitive);
+            for (uint32_t i = 0; i < meshes[m].IndexCount; ++i)
+            {
+                const uint32_t index = indices[meshes[m].FirstIndex + i];
+                const float *vertex = vertices + (uint64_t(meshes[m].FirstVertex) + (index < meshes[m].VertexCount ? index : 0))*SceneMesh::VERTEX_SIZE;
+                mesh.Vertices.insert(mesh.Vertices.end(), vertex, vertex + SceneMesh::VERTEX_SIZE);
+            }
+            scene.Meshes.push_back(mesh);
+        }
+        for (uint64_t b = 0; b < batchCount; ++b)
+            for (uint32_t i = 0; i < batches[b].InstanceCount; ++i)
+                scene.addObject(batches[b].Mesh, instances[batches[b].FirstInstance + i]);
+        return scene;
+    }
+
+private:
+    MappedFile file;
+    const SceneFileSettings* settings;
+    uint64_t settingsCount;
+    const char* strings;
+    uint64_t stringsSize;
+    const float* vertices;
+    uint64_t vertexCount;
+    const uint32_t* indices;
+    uint64_t indexCount;
+    const SceneFileMesh* meshes;
+    uint64_t meshCount;
+    const glm::mat4* instances;
+    uint64_t instanceCount;
+    const SceneFileBatch* batches;
+    uint64_t batchCount;
+
+    void clear()
+    {
+        settings = nullptr;
+        strings = nullptr;
+        vertices = nullptr;
+        indices = nullptr;
+        meshes = nullptr;
+        instances = nullptr;
+        batches = nullptr;
+        settingsCount = stringsSize = vertexCount = indexCount = meshCount = instanceCount = batchCount = 0;
+    }
+
+    // points data at a section whose elements are T (false if their size differs)
+    template <typename T>
+    bool take(const SceneFileSection &section, const T* &data, uint64_t &count)
+    {
+        if (section.ElementSize != sizeof(T))
+            return false;
+        data = reinterpret_cast<const T*>(file.getData() + section.Offset);
+        count = section.Count;
+        return true;
+    }
+
+    bool fail(const std::string &what, const std::string &path)
+    {
+        std::cout << "ERROR::SCENE_FILE::" << what << ": " << path << std::endl;
+        close();
+        return false;
+    }
+};
+
+// Reads a text description of a scene, one command per line ('#' starts a comment):
+//   texture1 PATH / texture2 PATH      the textures of the fragment shader, relative to the common folder
+//   mix VALUE                          the mix value of the textures
+//   clear R G B A                      the clear color
+//   mesh NAME cube / mesh NAME axes    the built-in meshes of Scene
+//   mesh NAME triangles|lines          a mesh of the vertices on the following lines "v X Y Z S T", ended by "end"
+//   object MESH X Y Z [rotate DEGREES AX AY AZ] [scale S]
+//                                      one object at (X, Y, Z), rotated and scaled in that order
+//   grid MESH N SPACING SCALE          N^3 objects as in makeCubeGridScene (N a whole number up to SCENE_DESCRIPTION_MAX_GRID)
+const unsigned SCENE_DESCRIPTION_MAX_GRID = 256;
+
+inline bool parseSceneDescription(const std::string &path, Scene &scene)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        std::cout << "ERROR::SCENE_DESCRIPTION::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+        return false;
+    }
+    scene = Scene();
+    std::unordered_map<std::string, unsigned> meshNames;
+    SceneMesh* openMesh = nullptr;
+    std::string line;
+    std::vector<std::string> words;
+    const char *text = file.getData();
+    const char *end = text + file.getSize();
+    unsigned lineNumber = 0;
+    for (const char *start = text; start < end; )
+    {
+        const char *lineEnd = static_cast<const char*>(memchr(start, '\n', end - start));
+        if (lineEnd == nullptr)
+            lineEnd = end;
+        ++lineNumber;
+        line.assign(start, lineEnd);
+        start = lineEnd + 1;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        // split into words, every word zero terminated inside line for strtof
+        words.clear();
+        for (size_t i = 0; i < line.size(); )
+        {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r'))
+                ++i;
+            size_t wordEnd = i;
+            while (wordEnd < line.size() && line[wordEnd] != ' ' && line[wordEnd] != '\t' && line[wordEnd] != '\r')
+                ++wordEnd;
+            if (wordEnd > i)
+                words.push_back(line.substr(i, wordEnd - i));
+            i = wordEnd;
+        }
+        if (words.empty())
+            continue;
+
+        bool valid = true;
+        auto number = [&words, &valid](size_t i) -> float {
+            if (i >= words.size())
+            {
+                valid = false;
+                return 0.0f;
+            }
+            char *numberEnd;
+            float value = strtof(words[i].c_str(), &numberEnd);
+            valid = valid && *numberEnd == '\0';
+            return value;
+        };
+        auto meshIndex = [&meshNames, &valid](const std::string &name) -> unsigned {
+            std::unordered_map<std::string, unsigned>::const_iterator found = meshNames.find(name);
+            valid = valid && found != meshNames.end();
+            return found != meshNames.end() ? found->second : 0;
+        };
+
+        const std::string &command = words[0];
+        if (openMesh != nullptr)
+        {
+            if (command == "end")
+                openMesh = nullptr;
+            else if (command == "v" && words.size() == 6)
+                for (size_t i = 1; i < 6; ++i)
+                    openMesh->Vertices.push_back(number(i));
+            else
+                valid = false;
+        }
+        else if ((command == "texture1" || command == "texture2") && words.size() == 2)
+            scene.TexturePaths[command == "texture1" ? 0 : 1] = words[1];
+        else if (command == "mix" && words.size() == 2)
+            scene.MixValue = number(1);
+        else if (command == "clear" && words.size() == 5)
+            scene.ClearColor = glm::vec4(number(1), number(2), number(3), number(4));
+        else if (command == "mesh" && words.size() == 3)
+        {
+            unsigned mesh = 0;
+            if (words[2] == "cube")
+                mesh = scene.addCubeMesh();
+            else if (words[2] == "axes")
+                mesh = scene.addCoordinateAxesMesh();
+            else if (words[2] == "triangles" || words[2] == "lines")
+            {
+                mesh = scene.addMesh(nullptr, 0, words[2] == "lines" ? SCENE_LINES : SCENE_TRIANGLES);
+                openMesh = &scene.Meshes[mesh];
+            }
+            else
+                valid = false;
+            meshNames[words[1]] = mesh;
+        }
+        else if (command == "object" && words.size() >= 5)
+        {
+            const unsigned mesh = meshIndex(words[1]);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(number(2), number(3), number(4)));
+            size_t i = 5;
+            if (i < words.size() && words[i] == "rotate")
+            {
+                model = glm::rotate(model, glm::radians(number(i + 1)), glm::vec3(number(i + 2), number(i + 3), number(i + 4)));
+                i += 5;
+            }
+            if (i < words.size() && words[i] == "scale")
+            {
+                model = glm::scale(model, glm::vec3(number(i + 1)));
+                i += 2;
+            }
+            valid = valid && i == words.size();
+            if (valid)
+                scene.addObject(mesh, model);
+        }
+        else if (command == "grid" && words.size() == 5)
+        {
+            const unsigned mesh = meshIndex(words[1]);
+            // checked before the cast: a negative or huge float doesn't convert to unsigned
+            const float size = number(2);
+            valid = valid && size >= 0.0f && size <= SCENE_DESCRIPTION_MAX_GRID && size == std::floor(size);
+            const unsigned gridSize = valid ? static_cast<unsigned>(size) : 0;
+            const float spacing = number(3);
+            const float scale = number(4);
+            const float offset = 0.5f*spacing*(gridSize - 1);
+            for (unsigned x = 0; valid && x < gridSize; ++x)
+                for (unsigned y = 0; y < gridSize; ++y)
+                    for (unsigned z = 0; z < gridSize; ++z)
+                    {
+                        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(spacing*x - offset, spacing*y - offset, -spacing*z - 2.0f));
+                        scene.addObject(mesh, glm::scale(model, glm::vec3(scale)));
+                    }
+        }
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            std::cout << "ERROR::SCENE_DESCRIPTION::SYNTAX_ERROR: " << path << ":" << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+    }
+    if (openMesh != nullptr)
+    {
+        std::cout << "ERROR::SCENE_DESCRIPTION::MISSING_END: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -4,86 +4,35 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+#include <shader_source.h>
+#include <uniform_name.h>
+
 class Shader
 {
 public:
     GLuint ID;
-    // constructor generates the shader on the fly
+    // constructor generates the shader on the fly; defines (e.g. "#define USE_TEXTURE2\n") are put after the #version
+    // line of every stage
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr, const std::string &defines = std::string())
     {
-        // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::string geometryCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        std::ifstream gShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try 
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();		
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();			
-            // if geometry shader path is present, also load a geometry shader
-            if(geometryPath != nullptr)
-            {
-                gShaderFile.open(geometryPath);
-                std::stringstream gShaderStream;
-                gShaderStream << gShaderFile.rdbuf();
-                gShaderFile.close();
-                geometryCode = gShaderStream.str();
-            }
-        }
-        catch (std::ifstream::failure e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
-        }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        GLuint vertex, fragment;
-        GLint success;
-        char infoLog[512];
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
+        // 1. compile the shaders from their files (mapped and #include resolved once per session, see shader_source.h)
+        GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexPath, "VERTEX", defines);
+        GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentPath, "FRAGMENT", defines);
         // if geometry shader is given, compile geometry shader
-        GLuint geometry;
+        GLuint geometry = 0;
         if(geometryPath != nullptr)
-        {
-            const char * gShaderCode = geometryCode.c_str();
-            geometry = glCreateShader(GL_GEOMETRY_SHADER);
-            glShaderSource(geometry, 1, &gShaderCode, NULL);
-            glCompileShader(geometry);
-            checkCompileErrors(geometry, "GEOMETRY");
-        }
-        // shader Program
+            geometry = compileShader(GL_GEOMETRY_SHADER, geometryPath, "GEOMETRY", defines);
+        // 2. shader Program
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
@@ -91,6 +40,7 @@ public:
             glAttachShader(ID, geometry);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
+        reflectUniforms();
         // delete the shaders as they're linked into our program now and no longer necessery
         glDeleteShader(vertex);
         glDeleteShader(fragment);
@@ -98,75 +48,223 @@ public:
             glDeleteShader(geometry);
 
     }
+    // constructor generates a compute shader program (OpenGL 4.3 or GL_ARB_compute_shader) on the fly
+    // ------------------------------------------------------------------------
+    explicit Shader(const char* computePath)
+    {
+        // 1. compile shader
+        GLuint compute = compileShader(GL_COMPUTE_SHADER, computePath, "COMPUTE");
+        // 2. shader Program
+        ID = glCreateProgram();
+        glAttachShader(ID, compute);
+        glLinkProgram(ID);
+        checkCompileErrors(ID, "PROGRAM");
+        reflectUniforms();
+        glDeleteShader(compute);
+    }
+    // compiles and links a vertex/fragment program with the files read through cache; the program or 0 (nothing is left
+    // behind) if a stage doesn't compile or the program doesn't link. Doesn't touch any Shader, so it can run on a
+    // thread with a context sharing the objects of the one which draws (see ShaderHotReloader)
+    // ------------------------------------------------------------------------
+    static GLuint buildProgram(const char* vertexPath, const char* fragmentPath, const std::string &defines, ShaderSourceCache &cache)
+    {
+        GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexPath, "VERTEX", defines, cache);
+        GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentPath, "FRAGMENT", defines, cache);
+        GLint compiled[2];
+        glGetShaderiv(vertex, GL_COMPILE_STATUS, &compiled[0]);
+        glGetShaderiv(fragment, GL_COMPILE_STATUS, &compiled[1]);
+        GLuint program = 0;
+        if(compiled[0] && compiled[1])
+        {
+            program = glCreateProgram();
+            glAttachShader(program, vertex);
+            glAttachShader(program, fragment);
+            glLinkProgram(program);
+            if(!checkCompileErrors(program, "PROGRAM"))
+            {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return program;
+    }
+    // takes over a linked program in place of the current one (which is deleted): the uniforms are read again, so the
+    // set* functions find the locations of the new program
+    // ------------------------------------------------------------------------
+    void replaceProgram(GLuint program)
+    {
+        glDeleteProgram(ID);
+        ID = program;
+        uniforms.clear();
+        missingUniforms.clear();
+        reflectUniforms();
+    }
     // activate the shader
     // ------------------------------------------------------------------------
     void use() 
     { 
         glUseProgram(ID); 
     }
+    // location of the uniform name, found by its hash in the active uniforms of the program (no glGetUniformLocation
+    // call, no allocation); -1 for a name which isn't one of them, which is remembered for getMissingUniforms(): the first
+    // miss of each such name allocates its copy, later ones don't. Like the GL calls of set*, only for the thread of the context
+    // ------------------------------------------------------------------------
+    GLint getUniformLocation(UniformName name) const
+    {
+        // names with the same hash are next to each other: all of them are compared
+        for(std::vector<ShaderUniform>::const_iterator found = std::lower_bound(uniforms.begin(), uniforms.end(), name.Hash,
+                [](const ShaderUniform &uniform, uint32_t hash) { return uniform.Hash < hash; });
+            found != uniforms.end() && found->Hash == name.Hash; ++found)
+            if(found->Name.size() == name.Length && memcmp(found->Name.data(), name.Name, name.Length) == 0)
+                return found->Location;
+        // inactive (optimized out) or misspelled: set* does nothing, as with location -1
+        for(size_t i = 0; i < missingUniforms.size(); ++i)
+            if(missingUniforms[i].size() == name.Length && memcmp(missingUniforms[i].data(), name.Name, name.Length) == 0)
+                return -1;
+        missingUniforms.push_back(std::string(name.Name, name.Length));
+        return -1;
+    }
+    // names passed to set* which aren't active uniforms of the program
+    // ------------------------------------------------------------------------
+    const std::vector<std::string>& getMissingUniforms() const
+    {
+        return missingUniforms;
+    }
     // utility uniform functions
     // ------------------------------------------------------------------------
-    void setBool(const std::string &name, bool value) const
+    void setBool(UniformName name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        glUniform1i(getUniformLocation(name), (int)value); 
     }
     // ------------------------------------------------------------------------
-    void setInt(const std::string &name, int value) const
+    void setInt(UniformName name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1i(getUniformLocation(name), value); 
     }
     // ------------------------------------------------------------------------
-    void setFloat(const std::string &name, float value) const
+    void setFloat(UniformName name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1f(getUniformLocation(name), value); 
     }
     // ------------------------------------------------------------------------
-    void setVec2(const std::string &name, const glm::vec2 &value) const
+    void setVec2(UniformName name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform2fv(getUniformLocation(name), 1, &value[0]); 
     }
-    void setVec2(const std::string &name, float x, float y) const
+    void setVec2(UniformName name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        glUniform2f(getUniformLocation(name), x, y); 
     }
     // ------------------------------------------------------------------------
-    void setVec3(const std::string &name, const glm::vec3 &value) const
+    void setVec3(UniformName name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform3fv(getUniformLocation(name), 1, &value[0]); 
     }
-    void setVec3(const std::string &name, float x, float y, float z) const
+    void setVec3(UniformName name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        glUniform3f(getUniformLocation(name), x, y, z); 
     }
     // ------------------------------------------------------------------------
-    void setVec4(const std::string &name, const glm::vec4 &value) const
+    void setVec4(UniformName name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform4fv(getUniformLocation(name), 1, &value[0]); 
     }
-    void setVec4(const std::string &name, float x, float y, float z, float w) 
+    void setVec4(UniformName name, float x, float y, float z, float w) 
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        glUniform4f(getUniformLocation(name), x, y, z, w); 
     }
     // ------------------------------------------------------------------------
-    void setMat2(const std::string &name, const glm::mat2 &mat) const
+    void setMat2(UniformName name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat3(const std::string &name, const glm::mat3 &mat) const
+    void setMat3(UniformName name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    void setMat4(UniformName name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    // an active uniform of the program: its name, the hash of the name and its location
+    struct ShaderUniform
+    {
+        uint32_t Hash;
+        GLint Location;
+        std::string Name;
+    };
+    std::vector<ShaderUniform> uniforms;                  // sorted by Hash
+    mutable std::vector<std::string> missingUniforms;
+
+    // reads the active uniforms of the linked program: every element of an array is listed ("lights[2]") and the array
+    // itself as its first element ("lights")
+    // ------------------------------------------------------------------------
+    void reflectUniforms()
+    {
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<GLchar> nameBuffer(std::max(maxLength, 1));
+        for(GLint i = 0; i < count; ++i)
+        {
+            GLint size;
+            GLenum type;
+            GLsizei length;
+            glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), length);
+            const GLint location = glGetUniformLocation(ID, name.c_str());
+            if(location < 0)
+                continue; // member of a uniform block
+            addUniform(name, location);
+            if(name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            {
+                const std::string base = name.substr(0, name.size() - 3);
+                addUniform(base, location);
+                for(GLint element = 1; element < size; ++element)
+                {
+                    const std::string elementName = base + "[" + std::to_string(element) + "]";
+                    addUniform(elementName, glGetUniformLocation(ID, elementName.c_str()));
+                }
+            }
+        }
+        std::sort(uniforms.begin(), uniforms.end(), [](const ShaderUniform &a, const ShaderUniform &b) { return a.Hash < b.Hash; });
+    }
+    void addUniform(const std::string &name, GLint location)
+    {
+        ShaderUniform uniform;
+        uniform.Hash = uniformNameHashN(name.data(), name.size());
+        uniform.Location = location;
+        uniform.Name = name;
+        uniforms.push_back(uniform);
+    }
+    // compiles the source file at path: its pieces (the mapped files of path and its includes) go to glShaderSource
+    // without being copied into one string
+    // ------------------------------------------------------------------------
+    static GLuint compileShader(GLenum type, const char* path, const std::string &typeName, const std::string &defines = std::string(),
+                                ShaderSourceCache &cache = ShaderSourceCache::session())
+    {
+        ShaderSource source;
+        cache.load(path, source, defines);
+        GLuint shader = glCreateShader(type);
+        source.setSource(shader);
+        glCompileShader(shader);
+        if(!checkCompileErrors(shader, typeName) && source.Files.size() > 1)
+        {
+            // the first number of a message is the file it is in
+            for(size_t i = 0; i < source.Files.size(); ++i)
+                std::cout << "    " << i << ": " << source.Files[i] << std::endl;
+        }
+        return shader;
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
+    static bool checkCompileErrors(GLuint shader, std::string type)
     {
         GLint success;
         GLchar infoLog[1024];
@@ -188,6 +286,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
     }
 };
 #endif
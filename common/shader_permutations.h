@@ -0,0 +1,117 @@
+#ifndef SHADER_PERMUTATIONS_H
+#define SHADER_PERMUTATIONS_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <shader.h>
+
+// Key of a shader variant: bit i set = feature i of its ShaderPermutations enabled
+typedef uint32_t ShaderKey;
+
+// Key of a set of features (their bit numbers, e.g. an enum), built at compile time: shaderKey(TEXTURE1, TEXTURE2)
+constexpr ShaderKey shaderKey()
+{
+    return 0;
+}
+
+template <typename... Features>
+constexpr ShaderKey shaderKey(unsigned feature, Features... features)
+{
+    return (ShaderKey(1) << feature) | shaderKey(features...);
+}
+
+// Variants of one vertex/fragment shader pair specialized by feature bits. Feature i is the name of a preprocessor symbol
+// (e.g. "USE_TEXTURE2") which the variants with bit i in their key get as "#define USE_TEXTURE2" after their #version
+// line, so the shader selects its code with #ifdef instead of branching on uniforms at run time. A variant is compiled on
+// its first use (or up front with compile()) and looked up by its key in a table of 2^features entries, no hashing or
+// string compares on the hot path
+class ShaderPermutations
+{
+public:
+    static const unsigned MAX_FEATURES = 8;
+
+    ShaderPermutations(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &features)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath), features(features), compiledCount(0)
+    {
+        if (this->features.size() > MAX_FEATURES)
+        {
+            std::cout << "ERROR::SHADER_PERMUTATIONS::TOO_MANY_FEATURES: " << this->features.size() << std::endl;
+            this->features.resize(MAX_FEATURES);
+        }
+        variants.resize(size_t(1) << this->features.size());
+    }
+
+    // The variant of key, compiled now if it is its first use
+    Shader& get(ShaderKey key)
+    {
+        if (key >= variants.size())
+        {
+            std::cout << "ERROR::SHADER_PERMUTATIONS::UNKNOWN_FEATURE in key " << key << std::endl;
+            key &= static_cast<ShaderKey>(variants.size() - 1);
+        }
+        if (!variants[key])
+            compile(key);
+        return *variants[key];
+    }
+
+    // The variant of a key known at compile time
+    template <ShaderKey Key>
+    Shader& get()
+    {
+        static_assert(Key < (ShaderKey(1) << MAX_FEATURES), "feature bit out of range");
+        return get(Key);
+    }
+
+    // Compiles the variant of key (again if it exists): the programs used by a frame can be built before the first one
+    Shader& compile(ShaderKey key)
+    {
+        key &= static_cast<ShaderKey>(variants.size() - 1);
+        if (variants[key])
+            glDeleteProgram(variants[key]->ID);
+        else
+            ++compiledCount;
+        variants[key].reset(new Shader(vertexPath.c_str(), fragmentPath.c_str(), nullptr, getDefines(key)));
+        return *variants[key];
+    }
+
+    // The #define lines of the features of key
+    std::string getDefines(ShaderKey key) const
+    {
+        std::string defines;
+        for (size_t i = 0; i < features.size(); ++i)
+            if (key & (ShaderKey(1) << i))
+                defines += "#define " + features[i] + "\n";
+        return defines;
+    }
+
+    unsigned getCompiledCount() const { return compiledCount; }
+    unsigned getFeatureCount() const { return static_cast<unsigned>(features.size()); }
+
+    // Deletes the programs of all the variants
+    void destroy()
+    {
+        for (size_t i = 0; i < variants.size(); ++i)
+            if (variants[i])
+            {
+                glDeleteProgram(variants[i]->ID);
+                variants[i].reset();
+            }
+        compiledCount = 0;
+    }
+
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::vector<std::string> features;
+    std::vector<std::unique_ptr<Shader>> variants;
+    unsigned compiledCount;
+};
+
+#endif
@@ -0,0 +1,500 @@
+#ifndef SHADER_RELOAD_H
+#define SHADER_RELOAD_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include <shader.h>
+#include <shader_source.h>
+
+// Watches shader files for changes on a background thread: with inotify on Linux (the directories of the files, for files
+// written and closed or moved in, which is how editors save), elsewhere by polling their modification times.
+// takeChanges() hands the changed files to the thread which reloads them
+class ShaderFileWatcher
+{
+public:
+    ShaderFileWatcher() : running(false), descriptor(-1) {}
+    ~ShaderFileWatcher() { stop(); }
+    ShaderFileWatcher(const ShaderFileWatcher&) = delete;
+    ShaderFileWatcher& operator=(const ShaderFileWatcher&) = delete;
+
+    // Starts the thread; false if inotify isn't available
+    bool start()
+    {
+        if (running)
+            return true;
+#ifdef __linux__
+        descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (descriptor < 0)
+        {
+            std::cout << "ERROR::SHADER_WATCHER::INOTIFY_NOT_AVAILABLE" << std::endl;
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < files.size(); ++i)
+                addDirectory(directory(files[i]));
+        }
+#endif
+        running = true;
+        thread = std::thread(&ShaderFileWatcher::run, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (!running)
+            return;
+        running = false;
+        thread.join();
+#ifdef __linux__
+        close(descriptor);
+        descriptor = -1;
+        directories.clear();
+#endif
+    }
+
+    // Adds a file (once), also while the thread runs
+    void watch(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (std::find(files.begin(), files.end(), path) != files.end())
+            return;
+        files.push_back(path);
+#ifdef __linux__
+        if (descriptor >= 0)
+            addDirectory(directory(path));
+#else
+        modified.push_back(modificationTime(path));
+#endif
+    }
+
+    // Appends the files changed since the last call to changed; false if there are none
+    bool takeChanges(std::vector<std::string> &changed)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (changes.empty())
+            return false;
+        changed.insert(changed.end(), changes.begin(), changes.end());
+        changes.clear();
+        return true;
+    }
+
+private:
+    std::thread thread;
+    std::atomic<bool> running;
+    std::mutex mutex;                   // guards files, changes and directories/modified
+    std::vector<std::string> files;
+    std::vector<std::string> changes;   // each changed file once until it is taken
+    int descriptor;                     // of the inotify instance
+#ifdef __linux__
+    std::unordered_map<int, std::string> directories;  // by watch descriptor
+#else
+    std::vector<time_t> modified;       // of files
+#endif
+
+#ifdef __linux__
+    void addDirectory(const std::string &path)
+    {
+        const int watch = inotify_add_watch(descriptor, path.empty() ? "." : path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch < 0)
+            std::cout << "ERROR::SHADER_WATCHER::DIRECTORY_NOT_WATCHED: " << (path.empty() ? "." : path) << std::endl;
+        else
+            directories[watch] = path;
+    }
+
+    void run()
+    {
+        alignas(inotify_event) char buffer[4096];
+        pollfd request = { descriptor, POLLIN, 0 };
+        while (running)
+        {
+            // wakes up every 100 ms to see whether it has to stop
+            if (poll(&request, 1, 100) <= 0)
+                continue;
+            ssize_t length;
+            while ((length = read(descriptor, buffer, sizeof(buffer))) > 0)
+                for (const char *event = buffer; event < buffer + length; )
+                {
+                    const inotify_event *info = reinterpret_cast<const inotify_event*>(event);
+                    if (info->len > 0)
+                        changed(info->wd, info->name);
+                    event += sizeof(inotify_event) + info->len;
+                }
+        }
+    }
+
+    void changed(int watch, const char *name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<int, std::string>::const_iterator found = directories.find(watch);
+        if (found == directories.end())
+            return;
+        const std::string path = found->second + name;
+        if (std::find(files.begin(), files.end(), path) != files.end() &&
+            std::find(changes.begin(), changes.end(), path) == changes.end())
+            changes.push_back(path);
+    }
+#else
+    void run()
+    {
+        while (running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                const time_t time = modificationTime(files[i]);
+                if (time != modified[i])
+                {
+                    modified[i] = time;
+                    if (std::find(changes.begin(), changes.end(), files[i]) == changes.end())
+                        changes.push_back(files[i]);
+                }
+            }
+        }
+    }
+
+    static time_t modificationTime(const std::string &path)
+    {
+        struct stat status;
+        return stat(path.c_str(), &status) == 0 ? status.st_mtime : 0;
+    }
+#endif
+
+    // directory of path with its separator, "" for a file in the working directory
+    static std::string directory(const std::string &path)
+    {
+        const size_t separator = path.find_last_of("/\\");
+        return separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+    }
+};
+
+// Reloads the programs of Shaders whose files (or the files they include) change while the program runs, without
+// stalling the frames: the changed programs are compiled and linked on a thread with its own context, which shares the
+// objects of the drawing one, and update(), called once per frame by the drawing thread, swaps a program in between two
+// frames only after it linked. A shader with an error keeps its last working program. Started with background false,
+// update() compiles on the drawing thread instead and the frame waits for the compiler, as a restart-free baseline
+class ShaderHotReloader
+{
+public:
+    ShaderHotReloader() : worker(nullptr), background(false), running(false), reloadCount(0), failureCount(0),
+        lastCompileTime(0.0)
+    {
+    }
+
+    ~ShaderHotReloader()
+    {
+        stopThread();
+    }
+
+    ShaderHotReloader(const ShaderHotReloader&) = delete;
+    ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+    // Starts watching and, with background, the compile thread; window's context has to be current. The context of the
+    // thread belongs to a hidden window created here (GLFW creates windows on the main thread only) with the current
+    // window hints, so the ones window was created with should still be set. False if the watcher or context fails
+    bool start(GLFWwindow *window, bool background = true)
+    {
+        this->background = background;
+        if (background)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            worker = glfwCreateWindow(1, 1, "shader reload", nullptr, window);
+            if (worker == nullptr)
+            {
+                std::cout << "ERROR::SHADER_RELOAD::SHARED_CONTEXT_NOT_CREATED" << std::endl;
+                return false;
+            }
+        }
+        if (!watcher.start())
+        {
+            stop();
+            return false;
+        }
+        if (background)
+        {
+            running = true;
+            thread = std::thread(&ShaderHotReloader::compileLoop, this);
+        }
+        return true;
+    }
+
+    // Reloads shader, built from these files, when one of them or a file they include changes. onReload (if given) is
+    // called by update() with the new program in use, for the uniforms which are only set once (e.g. the texture units of
+    // samplers) or a UniformStaging of the program to build again. shader has to outlive the reloader
+    void add(Shader &shader, const std::string &vertexPath, const std::string &fragmentPath,
+             const std::string &defines = std::string(), const std::function<void(Shader&)> &onReload = nullptr)
+    {
+        std::unique_ptr<Program> program(new Program());
+        program->Target = &shader;
+        program->VertexPath = vertexPath;
+        program->FragmentPath = fragmentPath;
+        program->Defines = defines;
+        program->OnReload = onReload;
+        program->Pending = program->Again = false;
+        ShaderSourceCache cache;
+        listFiles(*program, cache, program->Files);
+        for (size_t i = 0; i < program->Files.size(); ++i)
+            watcher.watch(program->Files[i]);
+        programs.push_back(std::move(program));
+    }
+
+    // Draws with every program the compile thread has linked, on that thread, before it is handed to update(). Drivers
+    // finish compiling a program for the state it is drawn with at its first draw (Mesa's llvmpipe generates all of its
+    // code there), which would otherwise stall the first frame drawing with it: warmUp should draw something small with
+    // the program (it is in use) and the state of the real draws, with objects of the compile thread's context (vertex
+    // arrays aren't shared, buffers are). Set it before start()
+    void setWarmUp(const std::function<void(GLuint program)> &warmUp)
+    {
+        this->warmUp = warmUp;
+    }
+
+    // Once per frame on the drawing thread, between two frames: starts the reloads of the changed programs and swaps in
+    // those which have linked since the last call. Returns the number of programs swapped
+    unsigned update()
+    {
+        changed.clear();
+        if (watcher.takeChanges(changed))
+            for (size_t i = 0; i < changed.size(); ++i)
+            {
+                // the files Shader loads next are read again
+                ShaderSourceCache::session().invalidate(changed[i]);
+                for (size_t j = 0; j < programs.size(); ++j)
+                    if (std::find(programs[j]->Files.begin(), programs[j]->Files.end(), changed[i]) != programs[j]->Files.end())
+                        request(*programs[j]);
+            }
+        if (!background)
+            while (!requests.empty())
+            {
+                Program *program = requests.front();
+                requests.pop_front();
+                results.push_back(build(*program));
+            }
+
+        finished.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.swap(results);
+        }
+        unsigned swapped = 0;
+        for (size_t i = 0; i < finished.size(); ++i)
+        {
+            Program &program = *finished[i].Owner;
+            program.Pending = false;
+            lastCompileTime = finished[i].Time;
+            if (finished[i].ID != 0)
+            {
+                swap(program, finished[i].ID);
+                ++reloadCount;
+                ++swapped;
+            }
+            else
+                ++failureCount;
+            // an #include added or removed
+            for (size_t j = 0; j < finished[i].Files.size(); ++j)
+                watcher.watch(finished[i].Files[j]);
+            if (!finished[i].Files.empty())
+                program.Files.swap(finished[i].Files);
+            // changed again while it was compiled
+            if (program.Again)
+            {
+                program.Again = false;
+                request(program);
+            }
+        }
+        return swapped;
+    }
+
+    // Stops the threads and deletes the programs which linked but weren't swapped in; with the drawing context current
+    void stop()
+    {
+        stopThread();
+        watcher.stop();
+        for (size_t i = 0; i < results.size(); ++i)
+            if (results[i].ID != 0)
+                glDeleteProgram(results[i].ID);
+        results.clear();
+        requests.clear();
+        if (worker != nullptr)
+        {
+            glfwDestroyWindow(worker);
+            worker = nullptr;
+        }
+    }
+
+    // true while a changed program hasn't been swapped in (or failed) yet
+    bool isReloading() const
+    {
+        for (size_t i = 0; i < programs.size(); ++i)
+            if (programs[i]->Pending)
+                return true;
+        return false;
+    }
+
+    // programs swapped in and reloads which failed to compile or link, compile time of the last one in milliseconds
+    uint64_t getReloadCount() const { return reloadCount; }
+    uint64_t getFailureCount() const { return failureCount; }
+    double getLastCompileTime() const { return lastCompileTime; }
+
+private:
+    // a Shader to reload, used by the drawing thread only (the compile thread only reads the paths and defines)
+    struct Program
+    {
+        Shader *Target;
+        std::string VertexPath;
+        std::string FragmentPath;
+        std::string Defines;
+        std::function<void(Shader&)> OnReload;
+        std::vector<std::string> Files;  // its files and their includes
+        bool Pending;                    // requested and not swapped in yet
+        bool Again;                      // changed again while Pending
+    };
+
+    // a program compiled for a reload, 0 if it failed
+    struct Result
+    {
+        Program *Owner;
+        GLuint ID;
+        double Time;
+        std::vector<std::string> Files;
+    };
+
+    std::vector<std::unique_ptr<Program>> programs;
+    ShaderFileWatcher watcher;
+    GLFWwindow *worker;                 // hidden window with the context of the compile thread
+    bool background;
+    std::thread thread;
+    std::mutex mutex;                   // guards requests, results and running
+    std::condition_variable wake;
+    bool running;
+    std::deque<Program*> requests;
+    std::vector<Result> results;
+    std::vector<Result> finished;       // taken from results by update()
+    std::vector<std::string> changed;
+    std::function<void(GLuint)> warmUp;
+    uint64_t reloadCount;
+    uint64_t failureCount;
+    double lastCompileTime;
+
+    void request(Program &program)
+    {
+        if (program.Pending)
+        {
+            program.Again = true;
+            return;
+        }
+        program.Pending = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(&program);
+        }
+        wake.notify_one();
+    }
+
+    // compiles the program from its files as they are now, through a cache of its own (the compile thread can't share
+    // the session's, which isn't synchronized, and the files are unmapped right away)
+    static Result build(Program &program)
+    {
+        Result result;
+        result.Owner = &program;
+        ShaderSourceCache cache;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        result.ID = Shader::buildProgram(program.VertexPath.c_str(), program.FragmentPath.c_str(), program.Defines, cache);
+        result.Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        listFiles(program, cache, result.Files);
+        return result;
+    }
+
+    static void listFiles(const Program &program, ShaderSourceCache &cache, std::vector<std::string> &files)
+    {
+        ShaderSource source;
+        for (const std::string *path : { &program.VertexPath, &program.FragmentPath })
+        {
+            cache.load(*path, source, program.Defines);
+            for (size_t i = 0; i < source.Files.size(); ++i)
+                if (std::find(files.begin(), files.end(), source.Files[i]) == files.end())
+                    files.push_back(source.Files[i]);
+        }
+    }
+
+    // the new program replaces the old one in the Shader; the program in use stays in use (the new one if it was the old)
+    static void swap(Program &program, GLuint id)
+    {
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        const bool wasCurrent = static_cast<GLuint>(current) == program.Target->ID;
+        program.Target->replaceProgram(id);
+        if (program.OnReload)
+        {
+            glUseProgram(id);
+            program.OnReload(*program.Target);
+        }
+        glUseProgram(wasCurrent ? id : static_cast<GLuint>(current));
+    }
+
+    void compileLoop()
+    {
+        glfwMakeContextCurrent(worker);
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wake.wait(lock, [this] { return !running || !requests.empty(); });
+            if (!running)
+                break;
+            Program *program = requests.front();
+            requests.pop_front();
+            lock.unlock();
+            Result result = build(*program);
+            if (result.ID != 0 && warmUp)
+            {
+                glUseProgram(result.ID);
+                warmUp(result.ID);
+                glUseProgram(0);
+            }
+            // the program is complete before the drawing context uses it
+            glFinish();
+            lock.lock();
+            results.push_back(result);
+        }
+        lock.unlock();
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    void stopThread()
+    {
+        if (!thread.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+};
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef SHADER_SOURCE_H
+#define SHADER_SOURCE_H
+
+#include <glad/glad.h>
+#include <mapped_file.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// The source of one shader stage as the pieces glShaderSource takes: pointers into the mapped files (nothing is copied)
+// and the #line directives between them, so the compiler's messages give the line in the file they come from.
+// Source string number i of the messages ("i:line(column)" on Mesa) is Files[i]
+struct ShaderSource
+{
+    std::vector<const GLchar*> Strings;
+    std::vector<GLint> Lengths;
+    std::vector<std::string> Files;
+    std::deque<std::string> Directives;  // deque: the pointers to them stay valid while it grows
+    size_t Bytes;                        // total length of the pieces
+
+    ShaderSource() : Bytes(0) {}
+
+    void clear()
+    {
+        Strings.clear();
+        Lengths.clear();
+        Files.clear();
+        Directives.clear();
+        Bytes = 0;
+    }
+
+    void append(const char *text, size_t length)
+    {
+        if (length == 0)
+            return;
+        Strings.push_back(text);
+        Lengths.push_back(static_cast<GLint>(length));
+        Bytes += length;
+    }
+
+    void appendDirective(const std::string &directive)
+    {
+        Directives.push_back(directive);
+        append(Directives.back().c_str(), Directives.back().size());
+    }
+
+    GLsizei getCount() const { return static_cast<GLsizei>(Strings.size()); }
+
+    // hands all the pieces to shader at once
+    void setSource(GLuint shader) const
+    {
+        glShaderSource(shader, getCount(), Strings.data(), Lengths.data());
+    }
+};
+
+// Shader source files of the session: every file is mapped on its first use and stays mapped, so a file included by
+// many shaders (or loaded by many programs) is opened and read once. load() resolves the #include "file" lines of a
+// shader (the path is relative to the including file, <file> is accepted too) into a ShaderSource. Every file is
+// included once per shader like with #pragma once, which also ends include cycles.
+// Not synchronized: shaders are loaded on the thread with the context
+class ShaderSourceCache
+{
+public:
+    // the cache Shader loads its files through
+    static ShaderSourceCache& session()
+    {
+        static ShaderSourceCache cache;
+        return cache;
+    }
+
+    ShaderSourceCache() : bytesMapped(0), hits(0) {}
+
+    // The mapped file of path or nullptr if it can't be read
+    const MappedFile* map(const std::string &path)
+    {
+        std::unordered_map<std::string, std::unique_ptr<MappedFile>>::const_iterator found = files.find(path);
+        if (found != files.end())
+        {
+            ++hits;
+            return found->second.get();
+        }
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->open(path))
+            return nullptr;
+        bytesMapped += file->getSize();
+        return (files[path] = std::move(file)).get();
+    }
+
+    // Resolves path and its includes into source (cleared first); false if a file can't be read. The preamble (e.g.
+    // "#define X\n" lines, see ShaderPermutations) is put after the #version line of path
+    bool load(const std::string &path, ShaderSource &source, const std::string &preamble = std::string())
+    {
+        source.clear();
+        std::unordered_set<std::string> included;
+        included.insert(path);
+        return append(path, source, included, preamble.empty() ? nullptr : &preamble);
+    }
+
+    // Unmaps all the files: the ShaderSources loaded so far must not be used any more
+    void clear()
+    {
+        files.clear();
+        bytesMapped = 0;
+        hits = 0;
+    }
+
+    // Unmaps the file of path if it is mapped (it changed on disk), so the next load reads it again; the ShaderSources
+    // holding pieces of it must not be used any more
+    void invalidate(const std::string &path)
+    {
+        std::unordered_map<std::string, std::unique_ptr<MappedFile>>::iterator found = files.find(path);
+        if (found == files.end())
+            return;
+        bytesMapped -= found->second->getSize();
+        files.erase(found);
+    }
+
+    size_t getFileCount() const { return files.size(); }
+    size_t getBytesMapped() const { return bytesMapped; }
+    uint64_t getHits() const { return hits; }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<MappedFile>> files;
+    size_t bytesMapped;
+    uint64_t hits;
+
+    bool append(const std::string &path, ShaderSource &source, std::unordered_set<std::string> &included,
+                const std::string *preamble = nullptr)
+    {
+        const MappedFile *file = map(path);
+        if (file == nullptr)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        const size_t number = source.Files.size();
+        source.Files.push_back(path);
+        // an empty file maps to no data (nullptr), which isn't scanned: only its preamble is added
+        if (file->getSize() == 0)
+        {
+            if (preamble != nullptr)
+                source.appendDirective(*preamble + "#line 1 " + std::to_string(number) + "\n");
+            return true;
+        }
+
+        const char *text = file->getData();
+        const char *end = text + file->getSize();
+        const char *segment = text;
+        unsigned line = 1;
+        if (preamble != nullptr && !hasVersion(text, end))
+        {
+            source.appendDirective(*preamble + "#line 1 " + std::to_string(number) + "\n");
+            preamble = nullptr;
+        }
+        for (const char *start = text; start < end; ++line)
+        {
+            const char *lineEnd = static_cast<const char*>(memchr(start, '\n', end - start));
+            if (lineEnd == nullptr)
+                lineEnd = end;
+            std::string name;
+            if (preamble != nullptr && lineEnd < end && isVersion(start, lineEnd))
+            {
+                // the preamble between the #version line and the next one
+                source.append(segment, lineEnd + 1 - segment);
+                source.appendDirective(*preamble + "#line " + std::to_string(line + 1) + " " + std::to_string(number) + "\n");
+                segment = lineEnd + 1;
+                preamble = nullptr;
+            }
+            else if (parseInclude(start, lineEnd, name))
+            {
+                // the text up to the #include line, which is left out (its newline is kept)
+                source.append(segment, start - segment);
+                segment = lineEnd;
+                const std::string includePath = directory(path) + name;
+                if (included.insert(includePath).second)
+                {
+                    source.appendDirective("#line 1 " + std::to_string(source.Files.size()) + "\n");
+                    if (!append(includePath, source, included))
+                        return false;
+                    // back in this file at the line after the #include, ended by the #include line's newline
+                    source.appendDirective("\n#line " + std::to_string(line + 1) + " " + std::to_string(number));
+                }
+            }
+            start = lineEnd + 1;
+        }
+        source.append(segment, end - segment);
+        return true;
+    }
+
+    // true for the #version line
+    static bool isVersion(const char *start, const char *end)
+    {
+        while (start < end && (*start == ' ' || *start == '\t'))
+            ++start;
+        return end - start >= 8 && strncmp(start, "#version", 8) == 0;
+    }
+
+    // true if a line of the text (followed by another one) is the #version line
+    static bool hasVersion(const char *start, const char *end)
+    {
+        for (const char *lineEnd; (lineEnd = static_cast<const char*>(memchr(start, '\n', end - start))) != nullptr; start = lineEnd + 1)
+            if (isVersion(start, lineEnd))
+                return true;
+        return false;
+    }
+
+    // true for a line '#include "name"' or '#include <name>' (blanks allowed around the #)
+    static bool parseInclude(const char *start, const char *end, std::string &name)
+    {
+        while (start < end && (*start == ' ' || *start == '\t'))
+            ++start;
+        if (start == end || *start++ != '#')
+            return false;
+        while (start < end && (*start == ' ' || *start == '\t'))
+            ++start;
+        if (end - start < 8 || strncmp(start, "include", 7) != 0)
+            return false;
+        start += 7;
+        while (start < end && (*start == ' ' || *start == '\t'))
+            ++start;
+        if (start == end || (*start != '"' && *start != '<'))
+            return false;
+        const char close = *start++ == '"' ? '"' : '>';
+        const char *nameEnd = static_cast<const char*>(memchr(start, close, end - start));
+        if (nameEnd == nullptr || nameEnd == start)
+            return false;
+        name.assign(start, nameEnd);
+        return true;
+    }
+
+    // directory of path with its separator, "" for a file in the working directory
+    static std::string directory(const std::string &path)
+    {
+        const size_t separator = path.find_last_of("/\\");
+        return separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+    }
+};
+
+#endif
@@ -0,0 +1,535 @@
+#ifndef SOFTWARE_RASTERIZER_H
+#define SOFTWARE_RASTERIZER_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <scene.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFTWARE_RASTERIZER_SSE 1
+#endif
+
+// RGBA texture sampled like a GL_TEXTURE_2D with GL_REPEAT wrapping and GL_LINEAR filtering. Mipmaps are not needed: the
+// samples set GL_LINEAR as minification filter as well, so OpenGL only ever reads level 0
+class SoftwareTexture
+{
+public:
+    SoftwareTexture() : width(0), height(0)
+    {
+    }
+
+    // data is given row by row from the bottom as for glTexImage2D (e.g. loaded with stbi_set_flip_vertically_on_load(true)),
+    // channels is 3 (RGB, alpha = 1) or 4 (RGBA)
+    void setImage(const unsigned char* data, int width, int height, int channels)
+    {
+        this->width = width;
+        this->height = height;
+        texels.resize(width*height);
+        for (int i = 0; i < width*height; ++i)
+        {
+            const unsigned char* p = data + i*channels;
+            texels[i] = glm::vec4(p[0], p[1], p[2], channels == 4 ? p[3] : 255) / 255.0f;
+        }
+    }
+
+    // Bilinear sample at the texture coordinates (s, t); an empty texture returns (0, 0, 0, 1) like an incomplete GL texture
+    glm::vec4 sample(float s, float t) const
+    {
+        if (texels.empty())
+            return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        const float x = s*width - 0.5f, y = t*height - 0.5f;
+        const float fx = std::floor(x), fy = std::floor(y);
+        const float wx = x - fx, wy = y - fy;
+        const int x0 = wrap(static_cast<int>(fx), width), x1 = wrap(static_cast<int>(fx) + 1, width);
+        const int y0 = wrap(static_cast<int>(fy), height), y1 = wrap(static_cast<int>(fy) + 1, height);
+
+        const glm::vec4 bottom = glm::mix(texels[y0*width + x0], texels[y0*width + x1], wx);
+        const glm::vec4 top = glm::mix(texels[y1*width + x0], texels[y1*width + x1], wx);
+        return glm::mix(bottom, top, wy);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width;
+    int height;
+    std::vector<glm::vec4> texels;
+
+    // GL_REPEAT
+    static int wrap(int i, int size)
+    {
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+};
+
+// Tile based renderer on the CPU for the draw model of the samples: non-indexed GL_TRIANGLES/GL_LINES draws of interleaved
+// position/texture coordinate vertices, transformed as in hello_camera_class.vert (projection*view*model) and shaded as in
+// hello_camera_class.frag (mix of two textures by mixValue), with a GL_LESS depth test
+// Draw calls only transform, clip (near plane) and set up the primitives and sort them into the screen tiles they overlap
+// (binning). finish() then renders the tiles on several threads: every thread takes the next free tile, so no two threads
+// ever write the same pixel and every tile sees its primitives in submission order. Inside a tile the edge functions, the
+// depth test and the interpolation run 4 pixels at a time with SSE2
+// The color buffer is RGBA8 (GL_RGBA/GL_UNSIGNED_BYTE layout), row 0 is the bottom of the screen as in OpenGL
+class SoftwareRasterizer
+{
+public:
+    // width and tileSize must be multiples of 4 (SIMD width)
+    SoftwareRasterizer(int width, int height, int tileSize = 64, unsigned threadCount = std::thread::hardware_concurrency())
+        : width((width + 3) & ~3), height(height), tileSize((tileSize + 3) & ~3), threadCount(std::max(1u, threadCount)),
+          model(1.0f), view(1.0f), projection(1.0f), mixValue(0.2f), clearPending(false)
+    {
+        tilesX = (this->width + this->tileSize - 1) / this->tileSize;
+        tilesY = (height + this->tileSize - 1) / this->tileSize;
+        color.assign(this->width*height, 0);
+        depth.assign(this->width*height, 1.0f);
+        tileBins.resize(tilesX*tilesY);
+        tileTimes.assign(tilesX*tilesY, 0.0);
+        textures[0] = textures[1] = nullptr;
+    }
+
+    // uniforms of hello_camera_class.vert and hello_camera_class.frag
+    void setModel(const glm::mat4 &model) { this->model = model; }
+    void setView(const glm::mat4 &view) { this->view = view; }
+    void setProjection(const glm::mat4 &projection) { this->projection = projection; }
+    void setMixValue(float mixValue) { this->mixValue = mixValue; }
+    // texture unit 0 = texture1, 1 = texture2 (the texture must stay alive until finish())
+    void bindTexture(int unit, const SoftwareTexture* texture) { textures[unit] = texture; }
+
+    // glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT): the clear is done per tile by the next finish()
+    void clear(const glm::vec4 &clearColor)
+    {
+        if (!primitives.empty())
+            finish();
+        this->clearColor = pack(clearColor);
+        clearPending = true;
+    }
+
+    // glDrawArrays(mode, first, count) on vertices with SceneMesh::VERTEX_SIZE floats per vertex
+    void drawArrays(ScenePrimitive mode, const float* vertices, unsigned first, unsigned count)
+    {
+        DrawState state;
+        state.textures[0] = textures[0];
+        state.textures[1] = textures[1];
+        state.mixValue = mixValue;
+        states.push_back(state);
+        const unsigned stateIndex = static_cast<unsigned>(states.size() - 1);
+
+        const glm::mat4 mvp = projection * view * model;
+        const unsigned verticesPerPrimitive = mode == SCENE_LINES ? 2 : 3;
+        for (unsigned i = first; i + verticesPerPrimitive <= first + count; i += verticesPerPrimitive)
+        {
+            ClipVertex clip[3];
+            for (unsigned j = 0; j < verticesPerPrimitive; ++j)
+            {
+                const float* p = vertices + (i + j)*SceneMesh::VERTEX_SIZE;
+                clip[j].position = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+                clip[j].texCoord = glm::vec2(p[3], p[4]);
+            }
+            if (mode == SCENE_LINES)
+                addLine(clip, stateIndex);
+            else
+                addTriangle(clip, stateIndex);
+        }
+    }
+
+    // Renders all the primitives drawn since the last finish() into the color and depth buffers and records the time spent on
+    // every tile
+    void finish()
+    {
+        std::atomic<int> nextTile(0);
+        const unsigned workerCount = std::min<unsigned>(threadCount, static_cast<unsigned>(tilesX*tilesY));
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < workerCount; ++i)
+            workers.push_back(std::thread(&SoftwareRasterizer::renderTiles, this, &nextTile));
+        renderTiles(&nextTile);
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+
+        primitives.clear();
+        states.clear();
+        for (size_t i = 0; i < tileBins.size(); ++i)
+            tileBins[i].clear();
+        clearPending = false;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getTileSize() const { return tileSize; }
+    int getTilesX() const { return tilesX; }
+    int getTilesY() const { return tilesY; }
+    unsigned getThreadCount() const { return threadCount; }
+    size_t getPrimitiveCount() const { return primitives.size(); }
+    // milliseconds spent on every tile (row by row from the bottom) by the last finish()
+    const std::vector<double>& getTileTimes() const { return tileTimes; }
+    // RGBA8 pixels, row by row from the bottom of the screen (ready for glTexSubImage2D(..., GL_RGBA, GL_UNSIGNED_BYTE, ...))
+    const std::vector<uint32_t>& getColorBuffer() const { return color; }
+    const std::vector<float>& getDepthBuffer() const { return depth; }
+
+private:
+    struct ClipVertex
+    {
+        glm::vec4 position;
+        glm::vec2 texCoord;
+    };
+
+    // uniforms used by the fragments of one draw call
+    struct DrawState
+    {
+        const SoftwareTexture* textures[2];
+        float mixValue;
+    };
+
+    // Set up primitive in window coordinates (pixels, depth in [0, 1])
+    // Triangles: values which are affine in window space are stored as planes value = a*x + b*y + c, i.e. the three edge
+    // functions, the depth and 1/w, s/w, t/w for perspective correct texture coordinates
+    // Lines: the two end points (x, y, depth, 1/w, s/w, t/w)
+    struct Primitive
+    {
+        bool line;
+        unsigned state;
+        float minX, minY, maxX, maxY; // bounding box in pixels
+        float edges[3][3];
+        bool topLeft[3];
+        float planes[4][3]; // depth, 1/w, s/w, t/w
+        float ends[2][6];
+    };
+
+    int width;
+    int height;
+    int tileSize;
+    int tilesX;
+    int tilesY;
+    unsigned threadCount;
+
+    glm::mat4 model;
+    glm::mat4 view;
+    glm::mat4 projection;
+    float mixValue;
+    const SoftwareTexture* textures[2];
+
+    bool clearPending;
+    uint32_t clearColor;
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+
+    std::vector<DrawState> states;
+    std::vector<Primitive> primitives;
+    std::vector<std::vector<unsigned> > tileBins; // indices of the primitives overlapping every tile, in submission order
+    std::vector<double> tileTimes;
+
+    static uint32_t pack(const glm::vec4 &c)
+    {
+        const glm::vec4 b = glm::clamp(c, 0.0f, 1.0f)*255.0f + 0.5f;
+        return static_cast<uint32_t>(b.r) | (static_cast<uint32_t>(b.g) << 8) | (static_cast<uint32_t>(b.b) << 16) | (static_cast<uint32_t>(b.a) << 24);
+    }
+
+    // pixel index floor(v) clamped to [0, size - 1]; primitives close to the near plane may reach far outside the screen
+    static int pixel(float v, int size)
+    {
+        return static_cast<int>(std::min(std::max(std::floor(v), 0.0f), static_cast<float>(size - 1)));
+    }
+
+    // fragment shader of hello_camera_class
+    static uint32_t shade(const DrawState &state, float s, float t)
+    {
+        const glm::vec4 c1 = state.textures[0] != nullptr ? state.textures[0]->sample(s, t) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        const glm::vec4 c2 = state.textures[1] != nullptr ? state.textures[1]->sample(s, t) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        return pack(glm::mix(c1, c2, state.mixValue));
+    }
+
+    // perspective division and viewport transform; returns x, y, depth, 1/w, s/w, t/w
+    void toWindow(const ClipVertex &v, float* out) const
+    {
+        const float invW = 1.0f / v.position.w;
+        out[0] = (0.5f*v.position.x*invW + 0.5f)*width;
+        out[1] = (0.5f*v.position.y*invW + 0.5f)*height;
+        out[2] = 0.5f*v.position.z*invW + 0.5f;
+        out[3] = invW;
+        out[4] = v.texCoord.x*invW;
+        out[5] = v.texCoord.y*invW;
+    }
+
+    // distance of a vertex to the near plane (positive inside), z >= -w
+    static float nearDistance(const ClipVertex &v)
+    {
+        return v.position.z + v.position.w;
+    }
+
+    static ClipVertex lerp(const ClipVertex &a, const ClipVertex &b, float t)
+    {
+        ClipVertex v;
+        v.position = glm::mix(a.position, b.position, t);
+        v.texCoord = glm::mix(a.texCoord, b.texCoord, t);
+        return v;
+    }
+
+    // Clips the triangle at the near plane (the other planes are handled by the tile bounds and the depth test) and sets up
+    // the resulting one or two triangles
+    void addTriangle(const ClipVertex* triangle, unsigned state)
+    {
+        ClipVertex polygon[4];
+        int count = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            const ClipVertex &a = triangle[i], &b = triangle[(i + 1) % 3];
+            const float da = nearDistance(a), db = nearDistance(b);
+            if (da >= 0.0f)
+                polygon[count++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+                polygon[count++] = lerp(a, b, da / (da - db));
+        }
+        for (int i = 2; i < count; ++i)
+            setupTriangle(polygon[0], polygon[i - 1], polygon[i], state);
+    }
+
+    void setupTriangle(const ClipVertex &c0, const ClipVertex &c1, const ClipVertex &c2, unsigned state)
+    {
+        float v[3][6];
+        toWindow(c0, v[0]);
+        toWindow(c1, v[1]);
+        toWindow(c2, v[2]);
+
+        // counter-clockwise order so that the inside of all edges is positive (no face culling, as in the samples)
+        float area = (v[1][0] - v[0][0])*(v[2][1] - v[0][1]) - (v[1][1] - v[0][1])*(v[2][0] - v[0][0]);
+        if (area < 0.0f)
+        {
+            std::swap_ranges(v[1], v[1] + 6, v[2]);
+            area = -area;
+        }
+        if (area < 1e-8f)
+            return;
+
+        Primitive primitive;
+        primitive.line = false;
+        primitive.state = state;
+        primitive.minX = std::min(v[0][0], std::min(v[1][0], v[2][0]));
+        primitive.maxX = std::max(v[0][0], std::max(v[1][0], v[2][0]));
+        primitive.minY = std::min(v[0][1], std::min(v[1][1], v[2][1]));
+        primitive.maxY = std::max(v[0][1], std::max(v[1][1], v[2][1]));
+
+        // edge functions E(x, y) = A*x + B*y + C, Ei is positive on the inner side of the edge opposite to vertex i
+        for (int i = 0; i < 3; ++i)
+        {
+            const float* a = v[(i + 1) % 3];
+            const float* b = v[(i + 2) % 3];
+            const float A = a[1] - b[1], B = b[0] - a[0];
+            primitive.edges[i][0] = A;
+            primitive.edges[i][1] = B;
+            primitive.edges[i][2] = -A*a[0] - B*a[1];
+            // top-left fill rule: pixel centers exactly on a left or top edge belong to the triangle, so that shared edges are
+            // drawn only once
+            primitive.topLeft[i] = A > 0.0f || (A == 0.0f && B < 0.0f);
+        }
+        for (int p = 0; p < 4; ++p)
+            for (int k = 0; k < 3; ++k)
+                primitive.planes[p][k] = (primitive.edges[0][k]*v[0][p + 2] + primitive.edges[1][k]*v[1][p + 2] +
+                                          primitive.edges[2][k]*v[2][p + 2]) / area;
+
+        bin(primitive);
+    }
+
+    // Clips the line at the near plane and sets it up
+    void addLine(ClipVertex* line, unsigned state)
+    {
+        const float d0 = nearDistance(line[0]), d1 = nearDistance(line[1]);
+        if (d0 < 0.0f && d1 < 0.0f)
+            return;
+        if (d0 < 0.0f)
+            line[0] = lerp(line[0], line[1], d0 / (d0 - d1));
+        else if (d1 < 0.0f)
+            line[1] = lerp(line[1], line[0], d1 / (d1 - d0));
+
+        Primitive primitive;
+        primitive.line = true;
+        primitive.state = state;
+        toWindow(line[0], primitive.ends[0]);
+        toWindow(line[1], primitive.ends[1]);
+        primitive.minX = std::min(primitive.ends[0][0], primitive.ends[1][0]);
+        primitive.maxX = std::max(primitive.ends[0][0], primitive.ends[1][0]);
+        primitive.minY = std::min(primitive.ends[0][1], primitive.ends[1][1]);
+        primitive.maxY = std::max(primitive.ends[0][1], primitive.ends[1][1]);
+        bin(primitive);
+    }
+
+    // Adds the primitive to the bins of all the tiles its bounding box overlaps
+    void bin(const Primitive &primitive)
+    {
+        if (primitive.maxX < 0.0f || primitive.maxY < 0.0f || primitive.minX > width || primitive.minY > height)
+            return;
+        const int tx0 = pixel(primitive.minX - 0.5f, width) / tileSize, tx1 = pixel(primitive.maxX, width) / tileSize;
+        const int ty0 = pixel(primitive.minY - 0.5f, height) / tileSize, ty1 = pixel(primitive.maxY, height) / tileSize;
+
+        primitives.push_back(primitive);
+        const unsigned index = static_cast<unsigned>(primitives.size() - 1);
+        for (int ty = ty0; ty <= ty1; ++ty)
+            for (int tx = tx0; tx <= tx1; ++tx)
+                tileBins[ty*tilesX + tx].push_back(index);
+    }
+
+    // worker loop of finish(): renders free tiles until all of them are done
+    void renderTiles(std::atomic<int>* nextTile)
+    {
+        for (int tile = nextTile->fetch_add(1); tile < tilesX*tilesY; tile = nextTile->fetch_add(1))
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            const int x0 = (tile % tilesX)*tileSize, y0 = (tile / tilesX)*tileSize;
+            const int x1 = std::min(width, x0 + tileSize), y1 = std::min(height, y0 + tileSize);
+            if (clearPending)
+            {
+                for (int y = y0; y < y1; ++y)
+                {
+                    std::fill(color.begin() + y*width + x0, color.begin() + y*width + x1, clearColor);
+                    std::fill(depth.begin() + y*width + x0, depth.begin() + y*width + x1, 1.0f);
+                }
+            }
+
+            const std::vector<unsigned> &bin = tileBins[tile];
+            for (size_t i = 0; i < bin.size(); ++i)
+            {
+                const Primitive &primitive = primitives[bin[i]];
+                if (primitive.line)
+                    rasterizeLine(primitive, x0, y0, x1, y1);
+                else
+                    rasterizeTriangle(primitive, x0, y0, x1, y1);
+            }
+
+            tileTimes[tile] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    // Rasterizes the triangle inside the tile [x0, x1) x [y0, y1), 4 pixels at a time
+    void rasterizeTriangle(const Primitive &primitive, int x0, int y0, int x1, int y1)
+    {
+        // bounding box of the pixel centers inside the tile
+        int minX = std::max(x0, pixel(primitive.minX - 0.5f, width));
+        const int maxX = std::min(x1 - 1, pixel(std::ceil(primitive.maxX - 0.5f), width));
+        const int minY = std::max(y0, pixel(primitive.minY - 0.5f, height));
+        const int maxY = std::min(y1 - 1, pixel(std::ceil(primitive.maxY - 0.5f), height));
+        if (minX > maxX || minY > maxY)
+            return;
+        minX &= ~3; // start at a SIMD aligned column (tiles start at multiples of 4)
+
+        const DrawState &state = states[primitive.state];
+        const float (*e)[3] = primitive.edges;
+        const float (*p)[3] = primitive.planes;
+
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const float py = y + 0.5f;
+            uint32_t* colorRow = &color[y*width];
+            float* depthRow = &depth[y*width];
+            for (int x = minX; x <= maxX; x += 4)
+            {
+                // coverage, depth test and interpolated values of the 4 pixels x .. x+3
+                int mask = 0;
+                float z[4], invW[4], sW[4], tW[4];
+#ifdef SOFTWARE_RASTERIZER_SSE
+                const __m128 px = _mm_add_ps(_mm_set1_ps(x + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+                const __m128 zero = _mm_setzero_ps();
+                __m128 inside = _mm_castsi128_ps(_mm_cmplt_epi32(_mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3)), _mm_set1_epi32(maxX + 1)));
+                for (int i = 0; i < 3; ++i)
+                {
+                    const __m128 edge = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[i][0]), px), _mm_set1_ps(e[i][1]*py + e[i][2]));
+                    __m128 in = _mm_cmpgt_ps(edge, zero);
+                    if (primitive.topLeft[i])
+                        in = _mm_or_ps(in, _mm_cmpeq_ps(edge, zero));
+                    inside = _mm_and_ps(inside, in);
+                }
+                if (!_mm_movemask_ps(inside))
+                    continue;
+                const __m128 zv = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0][0]), px), _mm_set1_ps(p[0][1]*py + p[0][2]));
+                inside = _mm_and_ps(inside, _mm_cmplt_ps(zv, _mm_loadu_ps(depthRow + x)));
+                mask = _mm_movemask_ps(inside);
+                if (!mask)
+                    continue;
+                _mm_storeu_ps(z, zv);
+                _mm_storeu_ps(invW, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[1][0]), px), _mm_set1_ps(p[1][1]*py + p[1][2])));
+                _mm_storeu_ps(sW, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[2][0]), px), _mm_set1_ps(p[2][1]*py + p[2][2])));
+                _mm_storeu_ps(tW, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[3][0]), px), _mm_set1_ps(p[3][1]*py + p[3][2])));
+#else
+                for (int lane = 0; lane < 4 && x + lane <= maxX; ++lane)
+                {
+                    const float px = x + lane + 0.5f;
+                    bool in = true;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        const float edge = e[i][0]*px + e[i][1]*py + e[i][2];
+                        in = in && (edge > 0.0f || (edge == 0.0f && primitive.topLeft[i]));
+                    }
+                    z[lane] = p[0][0]*px + p[0][1]*py + p[0][2];
+                    if (!in || !(z[lane] < depthRow[x + lane]))
+                        continue;
+                    invW[lane] = p[1][0]*px + p[1][1]*py + p[1][2];
+                    sW[lane] = p[2][0]*px + p[2][1]*py + p[2][2];
+                    tW[lane] = p[3][0]*px + p[3][1]*py + p[3][2];
+                    mask |= 1 << lane;
+                }
+#endif
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if (!(mask & (1 << lane)))
+                        continue;
+                    const float w = 1.0f / invW[lane];
+                    depthRow[x + lane] = z[lane];
+                    colorRow[x + lane] = shade(state, sW[lane]*w, tW[lane]*w);
+                }
+            }
+        }
+    }
+
+    // Rasterizes the part of the line inside the tile [x0, x1) x [y0, y1): one fragment per pixel column (x-major lines) or
+    // row (y-major lines) whose center lies on the half open segment, as a 1 pixel wide GL_LINES line
+    void rasterizeLine(const Primitive &primitive, int x0, int y0, int x1, int y1)
+    {
+        const float* a = primitive.ends[0];
+        const float* b = primitive.ends[1];
+        const float dx = b[0] - a[0], dy = b[1] - a[1];
+        const bool xMajor = std::fabs(dx) >= std::fabs(dy);
+        const float delta = xMajor ? dx : dy;
+        if (std::fabs(delta) < 1e-6f)
+            return;
+
+        // range of pixel centers along the major axis covered by the segment and the tile
+        const float start = xMajor ? a[0] : a[1];
+        const float lo = std::min(start, start + delta), hi = std::max(start, start + delta);
+        const int size = xMajor ? width : height;
+        // (clamped to [0, size] and [-1, size - 1], so a segment beyond an edge of the target covers no pixel)
+        const int first = std::max(xMajor ? x0 : y0,
+                                   static_cast<int>(std::min(std::max(std::ceil(lo - 0.5f), 0.0f), static_cast<float>(size))));
+        const int last = std::min((xMajor ? x1 : y1) - 1,
+                                  static_cast<int>(std::min(std::max(std::ceil(hi - 0.5f) - 1.0f, -1.0f), static_cast<float>(size - 1))));
+
+        const DrawState &state = states[primitive.state];
+        for (int i = first; i <= last; ++i)
+        {
+            const float t = (i + 0.5f - start) / delta;
+            const float minor = xMajor ? a[1] + t*dy : a[0] + t*dx;
+            const int m = static_cast<int>(std::floor(minor));
+            const int x = xMajor ? i : m, y = xMajor ? m : i;
+            if (x < x0 || x >= x1 || y < y0 || y >= y1)
+                continue;
+
+            const float z = a[2] + t*(b[2] - a[2]);
+            if (!(z < depth[y*width + x]))
+                continue;
+            const float w = 1.0f / (a[3] + t*(b[3] - a[3]));
+            depth[y*width + x] = z;
+            color[y*width + x] = shade(state, (a[4] + t*(b[4] - a[4]))*w, (a[5] + t*(b[5] - a[5]))*w);
+        }
+    }
+};
+
+#endif // SOFTWARE_RASTERIZER_H
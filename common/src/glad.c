@@ -7,17 +7,28 @@
     APIs: gl=3.3
     Profile: core
     Extensions:
-        
+        GL_ARB_base_instance,
+        GL_ARB_compute_shader,
+        GL_ARB_draw_indirect,
+        GL_ARB_multi_draw_indirect,
+        GL_ARB_shader_draw_parameters,
+        GL_ARB_shader_image_load_store,
+        GL_ARB_shader_storage_buffer_object
     Loader: True
     Local files: False
     Omit khrplatform: False
 
     Commandline:
-        --profile="core" --api="gl=3.3" --generator="c" --spec="gl" --extensions=""
+        --profile="core" --api="gl=3.3" --generator="c" --spec="gl" --extensions="GL_ARB_base_instance,GL_ARB_compute_shader,GL_ARB_draw_indirect,GL_ARB_multi_draw_indirect,GL_ARB_shader_draw_parameters,GL_ARB_shader_image_load_store,GL_ARB_shader_storage_buffer_object"
     Online:
-        http://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.3
+        http://glad.dav1d.de/#profile=core&language=c&specification=gl&extensions=GL_ARB_base_instance&extensions=GL_ARB_compute_shader&extensions=GL_ARB_draw_indirect&extensions=GL_ARB_multi_draw_indirect&extensions=GL_ARB_shader_draw_parameters&extensions=GL_ARB_shader_image_load_store&extensions=GL_ARB_shader_storage_buffer_object&loader=on&api=gl%3D3.3
 */
 
+#if defined(GLAD_INSTRUMENT) && !defined(_WIN32) && !defined(__CYGWIN__) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+/* clock_gettime of the instrumented build: strict C (-std=c99) only declares it with POSIX.1b (before any system header) */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -165,6 +176,18 @@ static const char *exts = NULL;
 static int num_exts_i = 0;
 static char **exts_i = NULL;
 
+/* open addressing hash set of the extensions of exts_i (index + 1, 0: empty), so has_ext does not compare every name */
+static int *exts_hash = NULL;
+static unsigned int exts_hash_mask = 0;
+
+static unsigned int glad_hash_string(const char *string) {
+    unsigned int hash = 2166136261u;
+    for(; *string != '\0'; string++) {
+        hash = (hash ^ (unsigned char)*string) * 16777619u;
+    }
+    return hash;
+}
+
 static int get_exts(void) {
 #ifdef _GLAD_IS_SOME_NEW_VERSION
     if(max_loaded_major < 3) {
@@ -194,6 +217,18 @@ static int get_exts(void) {
             }
             exts_i[index] = local_str;
         }
+
+        exts_hash_mask = 15;
+        while(exts_hash_mask + 1 < 2 * (unsigned)num_exts_i) exts_hash_mask = exts_hash_mask * 2 + 1;
+        exts_hash = (int*)calloc(exts_hash_mask + 1, sizeof *exts_hash);
+        if(exts_hash != NULL) {
+            for(index = 0; index < (unsigned)num_exts_i; index++) {
+                unsigned int slot;
+                if(exts_i[index] == NULL) continue;
+                for(slot = glad_hash_string(exts_i[index]) & exts_hash_mask; exts_hash[slot] != 0; slot = (slot + 1) & exts_hash_mask);
+                exts_hash[slot] = (int)index + 1;
+            }
+        }
     }
 #endif
     return 1;
@@ -208,6 +243,8 @@ static void free_exts(void) {
         free((void *)exts_i);
         exts_i = NULL;
     }
+    free(exts_hash);
+    exts_hash = NULL;
 }
 
 static int has_ext(const char *ext) {
@@ -239,6 +276,13 @@ static int has_ext(const char *ext) {
     } else {
         int index;
         if(exts_i == NULL) return 0;
+        if(exts_hash != NULL) {
+            unsigned int slot;
+            for(slot = glad_hash_string(ext) & exts_hash_mask; exts_hash[slot] != 0; slot = (slot + 1) & exts_hash_mask) {
+                if(strcmp(exts_i[exts_hash[slot] - 1], ext) == 0) return 1;
+            }
+            return 0;
+        }
         for(index = 0; index < num_exts_i; index++) {
             const char *e = exts_i[index];
 
@@ -263,6 +307,13 @@ int GLAD_GL_VERSION_3_0 = 0;
 int GLAD_GL_VERSION_3_1 = 0;
 int GLAD_GL_VERSION_3_2 = 0;
 int GLAD_GL_VERSION_3_3 = 0;
+int GLAD_GL_ARB_base_instance = 0;
+int GLAD_GL_ARB_compute_shader = 0;
+int GLAD_GL_ARB_draw_indirect = 0;
+int GLAD_GL_ARB_multi_draw_indirect = 0;
+int GLAD_GL_ARB_shader_draw_parameters = 0;
+int GLAD_GL_ARB_shader_image_load_store = 0;
+int GLAD_GL_ARB_shader_storage_buffer_object = 0;
 PFNGLCOPYTEXIMAGE1DPROC glad_glCopyTexImage1D = NULL;
 PFNGLVERTEXATTRIBI3UIPROC glad_glVertexAttribI3ui = NULL;
 PFNGLSTENCILMASKSEPARATEPROC glad_glStencilMaskSeparate = NULL;
@@ -637,6 +688,18 @@ PFNGLGETUNIFORMBLOCKINDEXPROC glad_glGetUniformBlockIndex = NULL;
 PFNGLTEXIMAGE2DMULTISAMPLEPROC glad_glTexImage2DMultisample = NULL;
 PFNGLGETACTIVEUNIFORMPROC glad_glGetActiveUniform = NULL;
 PFNGLFRONTFACEPROC glad_glFrontFace = NULL;
+PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC glad_glDrawArraysInstancedBaseInstance = NULL;
+PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC glad_glDrawElementsInstancedBaseInstance = NULL;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glad_glDrawElementsInstancedBaseVertexBaseInstance = NULL;
+PFNGLDISPATCHCOMPUTEPROC glad_glDispatchCompute = NULL;
+PFNGLDISPATCHCOMPUTEINDIRECTPROC glad_glDispatchComputeIndirect = NULL;
+PFNGLDRAWARRAYSINDIRECTPROC glad_glDrawArraysIndirect = NULL;
+PFNGLDRAWELEMENTSINDIRECTPROC glad_glDrawElementsIndirect = NULL;
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glad_glMultiDrawArraysIndirect = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect = NULL;
+PFNGLBINDIMAGETEXTUREPROC glad_glBindImageTexture = NULL;
+PFNGLMEMORYBARRIERPROC glad_glMemoryBarrier = NULL;
+PFNGLSHADERSTORAGEBLOCKBINDINGPROC glad_glShaderStorageBlockBinding = NULL;
 static void load_GL_VERSION_1_0(GLADloadproc load) {
 	if(!GLAD_GL_VERSION_1_0) return;
 	glad_glCullFace = (PFNGLCULLFACEPROC)load("glCullFace");
@@ -1050,9 +1113,45 @@ static void load_GL_VERSION_3_3(GLADloadproc load) {
 	glad_glSecondaryColorP3ui = (PFNGLSECONDARYCOLORP3UIPROC)load("glSecondaryColorP3ui");
 	glad_glSecondaryColorP3uiv = (PFNGLSECONDARYCOLORP3UIVPROC)load("glSecondaryColorP3uiv");
 }
+static void load_GL_ARB_base_instance(GLADloadproc load) {
+	if(!GLAD_GL_ARB_base_instance) return;
+	glad_glDrawArraysInstancedBaseInstance = (PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC)load("glDrawArraysInstancedBaseInstance");
+	glad_glDrawElementsInstancedBaseInstance = (PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC)load("glDrawElementsInstancedBaseInstance");
+	glad_glDrawElementsInstancedBaseVertexBaseInstance = (PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)load("glDrawElementsInstancedBaseVertexBaseInstance");
+}
+static void load_GL_ARB_compute_shader(GLADloadproc load) {
+	if(!GLAD_GL_ARB_compute_shader) return;
+	glad_glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)load("glDispatchCompute");
+	glad_glDispatchComputeIndirect = (PFNGLDISPATCHCOMPUTEINDIRECTPROC)load("glDispatchComputeIndirect");
+}
+static void load_GL_ARB_draw_indirect(GLADloadproc load) {
+	if(!GLAD_GL_ARB_draw_indirect) return;
+	glad_glDrawArraysIndirect = (PFNGLDRAWARRAYSINDIRECTPROC)load("glDrawArraysIndirect");
+	glad_glDrawElementsIndirect = (PFNGLDRAWELEMENTSINDIRECTPROC)load("glDrawElementsIndirect");
+}
+static void load_GL_ARB_multi_draw_indirect(GLADloadproc load) {
+	if(!GLAD_GL_ARB_multi_draw_indirect) return;
+	glad_glMultiDrawArraysIndirect = (PFNGLMULTIDRAWARRAYSINDIRECTPROC)load("glMultiDrawArraysIndirect");
+	glad_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+}
+static void load_GL_ARB_shader_image_load_store(GLADloadproc load) {
+	if(!GLAD_GL_ARB_shader_image_load_store) return;
+	glad_glBindImageTexture = (PFNGLBINDIMAGETEXTUREPROC)load("glBindImageTexture");
+	glad_glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)load("glMemoryBarrier");
+}
+static void load_GL_ARB_shader_storage_buffer_object(GLADloadproc load) {
+	if(!GLAD_GL_ARB_shader_storage_buffer_object) return;
+	glad_glShaderStorageBlockBinding = (PFNGLSHADERSTORAGEBLOCKBINDINGPROC)load("glShaderStorageBlockBinding");
+}
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
-	(void)&has_ext;
+	GLAD_GL_ARB_base_instance = has_ext("GL_ARB_base_instance");
+	GLAD_GL_ARB_compute_shader = has_ext("GL_ARB_compute_shader");
+	GLAD_GL_ARB_draw_indirect = has_ext("GL_ARB_draw_indirect");
+	GLAD_GL_ARB_multi_draw_indirect = has_ext("GL_ARB_multi_draw_indirect");
+	GLAD_GL_ARB_shader_draw_parameters = has_ext("GL_ARB_shader_draw_parameters");
+	GLAD_GL_ARB_shader_image_load_store = has_ext("GL_ARB_shader_image_load_store");
+	GLAD_GL_ARB_shader_storage_buffer_object = has_ext("GL_ARB_shader_storage_buffer_object");
 	free_exts();
 	return 1;
 }
@@ -1111,6 +1210,293 @@ static void find_coreGL(void) {
 	}
 }
 
+/* Index and name of every function of glad/glad_entries.h (instrumented build and lazy loading) */
+enum {
+#define GLAD_ENTRY(ret, name, type, params, args) GLAD_INDEX_##name,
+#define GLAD_VOID_ENTRY(name, type, params, args) GLAD_INDEX_##name,
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    GLAD_INDEX_COUNT
+};
+
+static const char *glad_function_names[GLAD_INDEX_COUNT] = {
+#define GLAD_ENTRY(ret, name, type, params, args) #name,
+#define GLAD_VOID_ENTRY(name, type, params, args) #name,
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+};
+
+#ifdef GLAD_INSTRUMENT
+/* Instrumented build (glad/glad_instrument.h): a counting wrapper in front of every loaded function */
+#include <glad/glad_instrument.h>
+#include <glad/glad_pixel_bytes.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+static double glad_instrument_now(void) {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if(frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+#include <time.h>
+static double glad_instrument_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+#endif
+
+static struct gladCallCounters glad_frame_counters[GLAD_INDEX_COUNT];
+static struct gladCallCounters glad_last_frame_counters[GLAD_INDEX_COUNT];
+static struct gladCallCounters glad_total_counters[GLAD_INDEX_COUNT];
+static unsigned long long glad_frame_count = 0;
+static unsigned long long glad_report_interval = 0;
+static GLuint glad_draw_framebuffer = 0;
+
+/* the functions as loaded and their counting wrappers, which glad_glX points to once installed */
+#define GLAD_ENTRY(ret, name, type, params, args) \
+    static type glad_real_##name; \
+    static ret APIENTRY glad_counting_##name params { \
+        const double glad_start = glad_instrument_now(); \
+        ret glad_result = glad_real_##name args; \
+        glad_frame_counters[GLAD_INDEX_##name].seconds += glad_instrument_now() - glad_start; \
+        ++glad_frame_counters[GLAD_INDEX_##name].calls; \
+        return glad_result; \
+    }
+#define GLAD_VOID_ENTRY(name, type, params, args) \
+    static type glad_real_##name; \
+    static void APIENTRY glad_counting_##name params { \
+        const double glad_start = glad_instrument_now(); \
+        glad_real_##name args; \
+        glad_frame_counters[GLAD_INDEX_##name].seconds += glad_instrument_now() - glad_start; \
+        ++glad_frame_counters[GLAD_INDEX_##name].calls; \
+    }
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+
+/* the functions with more to count than calls and time wrap their counting wrappers */
+static void APIENTRY glad_instrumented_glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    glad_counting_glBufferData(target, size, data, usage);
+    if(data != NULL) glad_frame_counters[GLAD_INDEX_glBufferData].bytes += (unsigned long long)size;
+}
+
+static void APIENTRY glad_instrumented_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    glad_counting_glBufferSubData(target, offset, size, data);
+    glad_frame_counters[GLAD_INDEX_glBufferSubData].bytes += (unsigned long long)size;
+}
+
+static void APIENTRY glad_instrumented_glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {
+    glad_counting_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    if(pixels != NULL) glad_frame_counters[GLAD_INDEX_glTexImage2D].bytes += gladPixelBytes(width, height, 1, format, type, 1);
+}
+
+static void APIENTRY glad_instrumented_glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+    glad_counting_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    glad_frame_counters[GLAD_INDEX_glTexSubImage2D].bytes += gladPixelBytes(width, height, 1, format, type, 1);
+}
+
+/* the draw framebuffer is tracked here, so finding the frame boundary needs no glGet */
+static void APIENTRY glad_instrumented_glBindFramebuffer(GLenum target, GLuint framebuffer) {
+    glad_counting_glBindFramebuffer(target, framebuffer);
+    if(target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) glad_draw_framebuffer = framebuffer;
+}
+
+/* clearing the color of the default framebuffer starts a new frame */
+static void APIENTRY glad_instrumented_glClear(GLbitfield mask) {
+    if(glad_draw_framebuffer == 0 && (mask & GL_COLOR_BUFFER_BIT) != 0) gladInstrumentEndFrame();
+    glad_counting_glClear(mask);
+}
+
+static int glad_compare_seconds(const void *a, const void *b) {
+    const double left = ((const struct gladCallCounters*)a)->seconds;
+    const double right = ((const struct gladCallCounters*)b)->seconds;
+    return left < right ? 1 : (left > right ? -1 : 0);
+}
+
+void gladInstrumentEndFrame(void) {
+    int index;
+    for(index = 0; index < GLAD_INDEX_COUNT; index++) {
+        glad_last_frame_counters[index] = glad_frame_counters[index];
+        glad_total_counters[index].calls += glad_frame_counters[index].calls;
+        glad_total_counters[index].bytes += glad_frame_counters[index].bytes;
+        glad_total_counters[index].seconds += glad_frame_counters[index].seconds;
+        glad_frame_counters[index].calls = 0;
+        glad_frame_counters[index].bytes = 0;
+        glad_frame_counters[index].seconds = 0.0;
+    }
+    ++glad_frame_count;
+    if(glad_report_interval > 0 && glad_frame_count % glad_report_interval == 0) {
+        gladInstrumentPrintReport(stderr, 1);
+    }
+}
+
+int gladInstrumentGetCounters(const struct gladCallCounters **lastFrame, const struct gladCallCounters **total) {
+    if(lastFrame != NULL) *lastFrame = glad_last_frame_counters;
+    if(total != NULL) *total = glad_total_counters;
+    return GLAD_INDEX_COUNT;
+}
+
+unsigned long long gladInstrumentGetFrameCount(void) {
+    return glad_frame_count;
+}
+
+void gladInstrumentPrintReport(FILE *file, int lastFrame) {
+    struct gladCallCounters sorted[GLAD_INDEX_COUNT];
+    const double frames = lastFrame || glad_frame_count == 0 ? 1.0 : (double)glad_frame_count;
+    double calls = 0.0, bytes = 0.0, seconds = 0.0;
+    int index;
+
+    memcpy(sorted, lastFrame ? glad_last_frame_counters : glad_total_counters, sizeof(sorted));
+    qsort(sorted, GLAD_INDEX_COUNT, sizeof(sorted[0]), glad_compare_seconds);
+    if(lastFrame) {
+        fprintf(file, "GL calls of frame %llu:\n", glad_frame_count);
+    } else {
+        fprintf(file, "GL calls per frame (average of %llu frames):\n", glad_frame_count);
+    }
+    fprintf(file, "    %-36s %12s %14s %12s\n", "function", "calls", "bytes", "time [ms]");
+    for(index = 0; index < GLAD_INDEX_COUNT; index++) {
+        /* sorted by time: a function which wasn't called may come before one whose calls took no measurable time */
+        if(sorted[index].calls == 0) continue;
+        fprintf(file, "    %-36s %12.1f %14.0f %12.4f\n", sorted[index].name, sorted[index].calls / frames,
+                sorted[index].bytes / frames, sorted[index].seconds * 1000.0 / frames);
+        calls += sorted[index].calls / frames;
+        bytes += sorted[index].bytes / frames;
+        seconds += sorted[index].seconds / frames;
+    }
+    fprintf(file, "    %-36s %12.1f %14.0f %12.4f\n", "total", calls, bytes, seconds * 1000.0);
+}
+
+static void glad_instrument_report_at_exit(void) {
+    gladInstrumentEndFrame();
+    gladInstrumentPrintReport(stderr, 0);
+}
+
+static void glad_instrument_install(void) {
+    static int initialized = 0;
+    int index;
+    if(!initialized) {
+        const char *interval = getenv("GLAD_INSTRUMENT_REPORT");
+        const char *quiet = getenv("GLAD_INSTRUMENT_QUIET");
+        initialized = 1;
+        for(index = 0; index < GLAD_INDEX_COUNT; index++) {
+            glad_frame_counters[index].name = glad_function_names[index];
+            glad_last_frame_counters[index].name = glad_function_names[index];
+            glad_total_counters[index].name = glad_function_names[index];
+        }
+        if(interval != NULL) glad_report_interval = strtoull(interval, NULL, 10);
+        if(quiet == NULL || strcmp(quiet, "1") != 0) atexit(glad_instrument_report_at_exit);
+    }
+
+    /* functions which were not loaded stay NULL */
+#define GLAD_ENTRY(ret, name, type, params, args) \
+    glad_real_##name = glad_##name; \
+    if(glad_##name != NULL) glad_##name = glad_counting_##name;
+#define GLAD_VOID_ENTRY(name, type, params, args) \
+    glad_real_##name = glad_##name; \
+    if(glad_##name != NULL) glad_##name = glad_counting_##name;
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    if(glad_glBufferData != NULL) glad_glBufferData = glad_instrumented_glBufferData;
+    if(glad_glBufferSubData != NULL) glad_glBufferSubData = glad_instrumented_glBufferSubData;
+    if(glad_glTexImage2D != NULL) glad_glTexImage2D = glad_instrumented_glTexImage2D;
+    if(glad_glTexSubImage2D != NULL) glad_glTexSubImage2D = glad_instrumented_glTexSubImage2D;
+    if(glad_glBindFramebuffer != NULL) glad_glBindFramebuffer = glad_instrumented_glBindFramebuffer;
+    if(glad_glClear != NULL) glad_glClear = glad_instrumented_glClear;
+}
+#else
+/* Without GLAD_INSTRUMENT there is nothing to count (glad/glad_instrument.h) */
+#include <glad/glad_instrument.h>
+
+void gladInstrumentEndFrame(void) {
+}
+
+int gladInstrumentGetCounters(const struct gladCallCounters **lastFrame, const struct gladCallCounters **total) {
+    if(lastFrame != NULL) *lastFrame = NULL;
+    if(total != NULL) *total = NULL;
+    return 0;
+}
+
+unsigned long long gladInstrumentGetFrameCount(void) {
+    return 0;
+}
+
+void gladInstrumentPrintReport(FILE *file, int lastFrame) {
+    (void)lastFrame;
+    fprintf(file, "GL calls are not counted: glad.c was built without GLAD_INSTRUMENT\n");
+}
+#endif
+
+/* Lazy loading (gladLoadGLLoaderLazy): the functions of the available versions and extensions first point to a trampoline,
+   which resolves the function through the loader on its first call. Only the few functions a program uses are looked up */
+static GLADloadproc glad_lazy_loader = NULL;
+
+#define GLAD_ENTRY(ret, name, type, params, args) \
+    static type glad_lazy_real_##name = NULL; \
+    static ret APIENTRY glad_lazy_##name params { \
+        if(glad_lazy_real_##name == NULL) glad_lazy_real_##name = (type)glad_lazy_loader(#name); \
+        if(glad_##name == glad_lazy_##name) glad_##name = glad_lazy_real_##name; \
+        return glad_lazy_real_##name args; \
+    }
+#define GLAD_VOID_ENTRY(name, type, params, args) \
+    static type glad_lazy_real_##name = NULL; \
+    static void APIENTRY glad_lazy_##name params { \
+        if(glad_lazy_real_##name == NULL) glad_lazy_real_##name = (type)glad_lazy_loader(#name); \
+        if(glad_##name == glad_lazy_##name) glad_##name = glad_lazy_real_##name; \
+        glad_lazy_real_##name args; \
+    }
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+
+/* a wrapper installed in front of a trampoline (GLAD_INSTRUMENT) keeps calling it, the check above leaves it in place */
+static void *glad_lazy_trampolines[GLAD_INDEX_COUNT] = {
+#define GLAD_ENTRY(ret, name, type, params, args) (void*)glad_lazy_##name,
+#define GLAD_VOID_ENTRY(name, type, params, args) (void*)glad_lazy_##name,
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+};
+
+/* open addressing hash table of the function names (index + 1, 0: empty) */
+#define GLAD_LAZY_SLOTS 1024
+static short glad_lazy_slots[GLAD_LAZY_SLOTS];
+
+static void* glad_lazy_proc(const char *name) {
+    unsigned int slot;
+    if(glad_lazy_slots[glad_hash_string(glad_function_names[0]) & (GLAD_LAZY_SLOTS - 1)] == 0) {
+        int index;
+        for(index = 0; index < GLAD_INDEX_COUNT; index++) {
+            for(slot = glad_hash_string(glad_function_names[index]) & (GLAD_LAZY_SLOTS - 1); glad_lazy_slots[slot] != 0;
+                slot = (slot + 1) & (GLAD_LAZY_SLOTS - 1));
+            glad_lazy_slots[slot] = (short)(index + 1);
+        }
+    }
+    for(slot = glad_hash_string(name) & (GLAD_LAZY_SLOTS - 1); glad_lazy_slots[slot] != 0; slot = (slot + 1) & (GLAD_LAZY_SLOTS - 1)) {
+        if(strcmp(glad_function_names[glad_lazy_slots[slot] - 1], name) == 0) {
+            return glad_lazy_trampolines[glad_lazy_slots[slot] - 1];
+        }
+    }
+    return NULL;
+}
+
+int gladLoadGLLoaderLazy(GLADloadproc load) {
+    if(load("glGetString") == NULL) return 0;
+    /* a new context: forget the functions resolved for the previous one */
+#define GLAD_ENTRY(ret, name, type, params, args) glad_lazy_real_##name = NULL;
+#define GLAD_VOID_ENTRY(name, type, params, args) glad_lazy_real_##name = NULL;
+#include <glad/glad_entries.h>
+#undef GLAD_ENTRY
+#undef GLAD_VOID_ENTRY
+    glad_lazy_loader = load;
+    return gladLoadGLLoader(&glad_lazy_proc);
+}
+
 int gladLoadGLLoader(GLADloadproc load) {
 	GLVersion.major = 0; GLVersion.minor = 0;
 	glGetString = (PFNGLGETSTRINGPROC)load("glGetString");
@@ -1131,6 +1517,15 @@ int gladLoadGLLoader(GLADloadproc load) {
 	load_GL_VERSION_3_3(load);
 
 	if (!find_extensionsGL()) return 0;
+	load_GL_ARB_base_instance(load);
+	load_GL_ARB_compute_shader(load);
+	load_GL_ARB_draw_indirect(load);
+	load_GL_ARB_multi_draw_indirect(load);
+	load_GL_ARB_shader_image_load_store(load);
+	load_GL_ARB_shader_storage_buffer_object(load);
+#ifdef GLAD_INSTRUMENT
+	glad_instrument_install();
+#endif
 	return GLVersion.major != 0 || GLVersion.minor != 0;
 }
 
@@ -0,0 +1,4 @@
+// The stb_image implementation of all the samples, compiled once into the common library: the samples only include
+// stb_image.h for the declarations
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
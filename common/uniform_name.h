@@ -0,0 +1,49 @@
+#ifndef UNIFORM_NAME_H
+#define UNIFORM_NAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+// FNV-1a hash of a uniform name, usable in constant expressions (C++11 constexpr: recursion instead of a loop)
+constexpr uint32_t uniformNameHash(const char *name, uint32_t hash = 2166136261u)
+{
+    return *name == '\0' ? hash : uniformNameHash(name + 1, (hash ^ static_cast<unsigned char>(*name))*16777619u);
+}
+
+// hash of the first length characters (the name needn't be terminated)
+inline uint32_t uniformNameHashN(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ static_cast<unsigned char>(name[i]))*16777619u;
+    return hash;
+}
+
+constexpr size_t uniformNameLength(const char *name, size_t length = 0)
+{
+    return *name == '\0' ? length : uniformNameLength(name + 1, length + 1);
+}
+
+// Name of a uniform with its hash, what the Shader set* functions take: built from a string literal, a std::string or a
+// std::string_view without copying the characters (nothing is allocated). The name has to outlive the call. A constexpr
+// UniformName is hashed at compile time:
+//     constexpr UniformName MODEL("model");
+//     ShaderProgram.setMat4(MODEL, model);
+struct UniformName
+{
+    const char *Name;
+    size_t Length;
+    uint32_t Hash;
+
+    constexpr UniformName(const char *name) : Name(name), Length(uniformNameLength(name)), Hash(uniformNameHash(name)) {}
+    UniformName(const std::string &name) : Name(name.data()), Length(name.size()), Hash(uniformNameHashN(name.data(), name.size())) {}
+#if __cplusplus >= 201703L
+    UniformName(std::string_view name) : Name(name.data()), Length(name.size()), Hash(uniformNameHashN(name.data(), name.size())) {}
+#endif
+};
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef UNIFORM_STAGING_H
+#define UNIFORM_STAGING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// glUniform* call of one uniform type, from the staged copy of the value
+template <typename T>
+struct UniformUpload;
+
+template <>
+struct UniformUpload<int>
+{
+    static void upload(GLint location, const void *value) { glUniform1iv(location, 1, static_cast<const GLint*>(value)); }
+};
+
+template <>
+struct UniformUpload<float>
+{
+    static void upload(GLint location, const void *value) { glUniform1fv(location, 1, static_cast<const GLfloat*>(value)); }
+};
+
+template <>
+struct UniformUpload<glm::vec2>
+{
+    static void upload(GLint location, const void *value) { glUniform2fv(location, 1, static_cast<const GLfloat*>(value)); }
+};
+
+template <>
+struct UniformUpload<glm::vec3>
+{
+    static void upload(GLint location, const void *value) { glUniform3fv(location, 1, static_cast<const GLfloat*>(value)); }
+};
+
+template <>
+struct UniformUpload<glm::vec4>
+{
+    static void upload(GLint location, const void *value) { glUniform4fv(location, 1, static_cast<const GLfloat*>(value)); }
+};
+
+template <>
+struct UniformUpload<glm::mat3>
+{
+    static void upload(GLint location, const void *value)
+    {
+        glUniformMatrix3fv(location, 1, GL_FALSE, static_cast<const GLfloat*>(value));
+    }
+};
+
+template <>
+struct UniformUpload<glm::mat4>
+{
+    static void upload(GLint location, const void *value)
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, static_cast<const GLfloat*>(value));
+    }
+};
+
+// A uniform of a UniformStaging, typed so set() only takes values of its type
+template <typename T>
+struct UniformSlot
+{
+    unsigned Index;
+};
+
+// Staged uniforms of one program: set() only copies a value into the staging block and marks it dirty if it differs from
+// the value the program already has (a shadow copy of every uploaded value is kept), flush() then sends the dirty ones in
+// one pass right before the draw. Unchanged values (the projection matrix or the mix value of every frame) cost a
+// compare instead of a glUniform* call. All uniform writes of the program have to go through its staging, otherwise the
+// shadow copies are wrong (invalidate() after writing uniforms directly or relinking)
+class UniformStaging
+{
+public:
+    static const unsigned MAX_UNIFORMS = 64;
+    static const unsigned INVALID_SLOT = ~0u;
+
+    explicit UniformStaging(GLuint program) : program(program), dirty(0), written(0), uploaded(0), setCount(0),
+        uploadCount(0), skippedCount(0), flushCount(0)
+    {
+    }
+
+    // Adds the uniform name of the program (at most MAX_UNIFORMS); a name which isn't an active uniform is staged but
+    // never uploaded, like glUniform* ignores location -1. Past MAX_UNIFORMS the slot is INVALID_SLOT, which set() ignores
+    template <typename T>
+    UniformSlot<T> add(const std::string &name)
+    {
+        UniformSlot<T> slot;
+        slot.Index = static_cast<unsigned>(entries.size());
+        if (entries.size() == MAX_UNIFORMS)
+        {
+            std::cout << "ERROR::UNIFORM_STAGING::TOO_MANY_UNIFORMS: " << name << std::endl;
+            slot.Index = INVALID_SLOT;
+            return slot;
+        }
+        Entry entry;
+        entry.Location = glGetUniformLocation(program, name.c_str());
+        entry.Offset = static_cast<unsigned>(stagedValues.size());
+        entry.Size = sizeof(T);
+        entry.Upload = &UniformUpload<T>::upload;
+        entries.push_back(entry);
+        stagedValues.resize(stagedValues.size() + sizeof(T));
+        uploadedValues.resize(uploadedValues.size() + sizeof(T));
+        return slot;
+    }
+
+    template <typename T>
+    void set(UniformSlot<T> slot, const T &value)
+    {
+        if (slot.Index >= entries.size())
+            return;
+        const Entry &entry = entries[slot.Index];
+        const uint64_t bit = uint64_t(1) << slot.Index;
+        memcpy(&stagedValues[entry.Offset], &value, sizeof(T));
+        written |= bit;
+        if ((uploaded & bit) == 0 || memcmp(&uploadedValues[entry.Offset], &value, sizeof(T)) != 0)
+            dirty |= bit;
+        else
+            dirty &= ~bit;
+        ++setCount;
+    }
+
+    // Uploads the uniforms which changed since the last flush; the program has to be in use. Returns the bytes uploaded
+    size_t flush()
+    {
+        size_t bytes = 0;
+        for (uint64_t pending = dirty; pending != 0; pending &= pending - 1)
+        {
+            const unsigned index = lowestBit(pending);
+            if (index >= entries.size())
+                continue;
+            const Entry &entry = entries[index];
+            if (entry.Location >= 0)
+                entry.Upload(entry.Location, &stagedValues[entry.Offset]);
+            memcpy(&uploadedValues[entry.Offset], &stagedValues[entry.Offset], entry.Size);
+            bytes += entry.Size;
+            ++uploadCount;
+        }
+        skippedCount += bitCount(written & ~dirty);
+        uploaded |= dirty;
+        dirty = written = 0;
+        ++flushCount;
+        return bytes;
+    }
+
+    // Forgets the shadow copies: the next value set for every uniform is uploaded
+    void invalidate()
+    {
+        uploaded = 0;
+        dirty = written;
+    }
+
+    // counters since the start (or resetCounters): values set, uploaded and skipped because they were unchanged
+    uint64_t getSetCount() const { return setCount; }
+    uint64_t getUploadCount() const { return uploadCount; }
+    uint64_t getSkippedCount() const { return skippedCount; }
+    uint64_t getFlushCount() const { return flushCount; }
+
+    void resetCounters()
+    {
+        setCount = uploadCount = skippedCount = flushCount = 0;
+    }
+
+    // one line with the counters, e.g. "uniforms: 1000 set, 990 uploaded, 10 skipped (1.0%) in 500 flushes"
+    void printCounters(std::ostream &out, const std::string &label = "uniforms") const
+    {
+        const uint64_t flushed = uploadCount + skippedCount;
+        const std::ios_base::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision();
+        out << label << ": " << setCount << " set, " << uploadCount << " uploaded, " << skippedCount << " skipped ("
+            << std::fixed << std::setprecision(2) << (flushed > 0 ? 100.0*skippedCount/flushed : 0.0) << "%) in "
+            << flushCount << " flushes" << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    struct Entry
+    {
+        GLint Location;
+        unsigned Offset;  // of the value in stagedValues and uploadedValues
+        unsigned Size;
+        void (*Upload)(GLint location, const void *value);
+    };
+
+    GLuint program;
+    std::vector<Entry> entries;
+    std::vector<unsigned char> stagedValues;
+    std::vector<unsigned char> uploadedValues;
+    uint64_t dirty;     // staged value differs from the uploaded one
+    uint64_t written;   // set since the last flush
+    uint64_t uploaded;  // uploadedValues holds the value the program has
+    uint64_t setCount;
+    uint64_t uploadCount;
+    uint64_t skippedCount;
+    uint64_t flushCount;
+
+    static unsigned lowestBit(uint64_t bits)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+        unsigned index = 0;
+        while ((bits & 1) == 0)
+        {
+            bits >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    static unsigned bitCount(uint64_t bits)
+    {
+        unsigned count = 0;
+        for (; bits != 0; bits &= bits - 1)
+            ++count;
+        return count;
+    }
+};
+
+#endif
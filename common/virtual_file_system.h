@@ -0,0 +1,366 @@
+#ifndef VIRTUAL_FILE_SYSTEM_H
+#define VIRTUAL_FILE_SYSTEM_H
+
+#include <asset_archive.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bytes of an asset loaded through a VirtualFileSystem: a stored archive entry is used in place in the mapping of its
+// archive (valid while the archive is mounted), compressed entries and loose files have their own buffer
+class AssetData
+{
+public:
+    AssetData() : data(nullptr), size(0) {}
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    // true if the data is the mapped archive itself (nothing was copied)
+    bool isInPlace() const { return data != nullptr && !buffer; }
+
+    std::string toString() const { return std::string(data != nullptr ? data : "", size); }
+
+private:
+    friend class VirtualFileSystem;
+
+    const char *data;
+    size_t size;
+    std::shared_ptr<std::vector<char>> buffer;
+};
+
+// what a VirtualFileSystem has done so far
+struct VirtualFileSystemStats
+{
+    uint64_t ArchiveReads;   // assets found in a mounted archive
+    uint64_t LooseReads;     // assets read from loose files
+    uint64_t PrefetchHits;   // loads served by a prefetch
+    uint64_t FilesOpened;    // open() calls: archives at mount and loose files
+};
+
+// Resolves asset paths ("textures/container.jpg") through mount points to archives (AssetArchive) and to directories of
+// loose files, so the assets of a sample don't depend on the working directory and a packed build opens one file.
+// The archives mounted at a prefix of a path are searched first (the last mounted first), the directories after them:
+// in development the loose files are the fallback for assets which aren't packed yet, with setLooseFilesFirst(true) they
+// override the archives (e.g. while a shader is edited).
+// prefetch() loads assets on a background thread (pages of stored entries touched, compressed entries decompressed, loose
+// files read) into a cache which the next load() of each of them takes; a load of an asset whose prefetch is still
+// running waits for it instead of loading it a second time. Mounts must only change while no prefetch is pending
+class VirtualFileSystem
+{
+public:
+    VirtualFileSystem() : looseFilesFirst(false), running(false), stopping(false), pending(0)
+    {
+        resetStats();
+    }
+
+    ~VirtualFileSystem() { stopPrefetching(); }
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    // the archive at archivePath serves the paths below mountPoint ("" for all of them)
+    bool mountArchive(const std::string &mountPoint, const std::string &archivePath)
+    {
+        std::unique_ptr<AssetArchive> archive(new AssetArchive());
+        ++filesOpened;
+        if (!archive->open(archivePath))
+            return false;
+        mounts.push_back(Mount());
+        mounts.back().Point = normalizeAssetPath(mountPoint);
+        mounts.back().Archive = std::move(archive);
+        return true;
+    }
+
+    // the files below directory serve the paths below mountPoint
+    void mountDirectory(const std::string &mountPoint, const std::string &directory)
+    {
+        mounts.push_back(Mount());
+        mounts.back().Point = normalizeAssetPath(mountPoint);
+        mounts.back().Directory = directory.empty() ? "." : directory;
+    }
+
+    // waits for the prefetches and drops the cache and all the mounts (the in place data of their archives is unmapped)
+    void unmountAll()
+    {
+        waitForPrefetches();
+        clearCache();
+        mounts.clear();
+    }
+
+    void setLooseFilesFirst(bool first) { looseFilesFirst = first; }
+
+    bool exists(const std::string &path) const
+    {
+        AssetData data;
+        return resolve(normalizeAssetPath(path), data, false, true);
+    }
+
+    bool load(const std::string &path, AssetData &data)
+    {
+        const std::string normalized = normalizeAssetPath(path);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // looked up again after every wake-up: another load() or stopPrefetching() may have erased the entry meanwhile
+            // (it is then loaded directly)
+            std::map<std::string, CacheEntry>::iterator cached;
+            done.wait(lock, [this, &cached, &normalized]()
+            {
+                cached = cache.find(normalized);
+                return cached == cache.end() || cached->second.Ready;
+            });
+            if (cached != cache.end())
+            {
+                const bool found = cached->second.Found;
+                data = cached->second.Data;
+                cache.erase(cached);
+                if (found)
+                {
+                    ++prefetchHits;
+                    return true;
+                }
+                std::cout << "ERROR::VFS::FILE_NOT_FOUND: " << path << std::endl;
+                return false;
+            }
+        }
+        if (resolve(normalized, data, false, false))
+            return true;
+        std::cout << "ERROR::VFS::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+
+    // Queues the assets for the prefetch thread (started at the first call), e.g. the assets of the next scene while the
+    // current one is still drawn; returns at once
+    void prefetch(const std::vector<std::string> &paths)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < paths.size(); ++i)
+            {
+                const std::string normalized = normalizeAssetPath(paths[i]);
+                if (cache.find(normalized) != cache.end())
+                    continue;
+                cache[normalized] = CacheEntry();
+                queue.push_back(normalized);
+                ++pending;
+            }
+            if (!running)
+            {
+                running = true;
+                stopping = false;
+                thread = std::thread(&VirtualFileSystem::prefetchLoop, this);
+            }
+        }
+        wake.notify_one();
+    }
+
+    size_t getPendingPrefetches() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending;
+    }
+
+    void waitForPrefetches()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return pending == 0; });
+    }
+
+    // drops the prefetched assets which haven't been loaded (the pending ones stay)
+    void clearCache()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::map<std::string, CacheEntry>::iterator entry = cache.begin(); entry != cache.end(); )
+            if (entry->second.Ready)
+                cache.erase(entry++);
+            else
+                ++entry;
+    }
+
+    // ends the prefetch thread; the assets still queued aren't prefetched
+    void stopPrefetching()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running)
+                return;
+            stopping = true;
+        }
+        wake.notify_all();
+        thread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        for (size_t i = 0; i < queue.size(); ++i)
+            cache.erase(queue[i]);
+        queue.clear();
+        pending = 0;
+        done.notify_all();
+    }
+
+    VirtualFileSystemStats getStats() const
+    {
+        VirtualFileSystemStats stats;
+        stats.ArchiveReads = archiveReads;
+        stats.LooseReads = looseReads;
+        stats.PrefetchHits = prefetchHits;
+        stats.FilesOpened = filesOpened;
+        return stats;
+    }
+
+    void resetStats()
+    {
+        archiveReads = looseReads = prefetchHits = filesOpened = 0;
+    }
+
+private:
+    struct Mount
+    {
+        std::string Point;                       // normalized
+        std::unique_ptr<AssetArchive> Archive;   // or
+        std::string Directory;
+    };
+
+    struct CacheEntry
+    {
+        bool Ready;
+        bool Found;
+        AssetData Data;
+
+        CacheEntry() : Ready(false), Found(false) {}
+    };
+
+    std::vector<Mount> mounts;
+    bool looseFilesFirst;
+
+    // prefetching: the cache is a std::map, so load() can wait on an entry while others are inserted
+    std::thread thread;
+    mutable std::mutex mutex;               // guards cache, queue, pending, running and stopping
+    std::condition_variable wake;           // work for the thread
+    std::condition_variable done;           // a prefetch has finished
+    std::map<std::string, CacheEntry> cache;
+    std::deque<std::string> queue;
+    bool running;
+    bool stopping;
+    size_t pending;
+
+    mutable std::atomic<uint64_t> archiveReads;
+    mutable std::atomic<uint64_t> looseReads;
+    mutable std::atomic<uint64_t> prefetchHits;
+    mutable std::atomic<uint64_t> filesOpened;
+
+    // path relative to the mount point, false if the path isn't below it
+    static bool relativeTo(const std::string &point, const std::string &path, std::string &relative)
+    {
+        if (point.empty())
+        {
+            relative = path;
+            return true;
+        }
+        if (path.size() <= point.size() || path.compare(0, point.size(), point) != 0 || path[point.size()] != '/')
+            return false;
+        relative = path.substr(point.size() + 1);
+        return true;
+    }
+
+    // Finds the normalized path in the mounts and loads it into data (touch: bring the pages of stored archive entries in,
+    // probe: only check that it exists)
+    bool resolve(const std::string &path, AssetData &data, bool touch, bool probe) const
+    {
+        std::string relative;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const bool archives = (pass == 0) != looseFilesFirst;
+            for (size_t m = mounts.size(); m-- > 0; )
+            {
+                const Mount &mount = mounts[m];
+                if ((mount.Archive != nullptr) != archives || !relativeTo(mount.Point, path, relative))
+                    continue;
+                if (archives)
+                {
+                    const AssetArchiveEntry *entry = mount.Archive->find(relative);
+                    if (entry == nullptr)
+                        continue;
+                    if (probe)
+                        return true;
+                    return readEntry(*mount.Archive, *entry, data, touch);
+                }
+                const std::string filePath = mount.Directory + "/" + relative;
+                std::ifstream file(filePath.c_str(), std::ios::binary | std::ios::ate);
+                if (!file)
+                    continue;
+                if (probe)
+                    return true;
+                ++filesOpened;
+                std::shared_ptr<std::vector<char>> buffer(new std::vector<char>(static_cast<size_t>(file.tellg())));
+                file.seekg(0);
+                if (!buffer->empty() && !file.read(buffer->data(), buffer->size()))
+                {
+                    std::cout << "ERROR::VFS::FILE_NOT_SUCCESFULLY_READ: " << filePath << std::endl;
+                    return false;
+                }
+                ++looseReads;
+                data.buffer = buffer;
+                data.data = buffer->data();
+                data.size = buffer->size();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readEntry(const AssetArchive &archive, const AssetArchiveEntry &entry, AssetData &data, bool touch) const
+    {
+        ++archiveReads;
+        data.buffer.reset();
+        data.size = entry.Size;
+        if (entry.Compression == ASSET_STORED)
+        {
+            if (touch)
+                archive.touch(entry);
+            data.data = archive.getStoredData(entry);
+            return true;
+        }
+        std::shared_ptr<std::vector<char>> buffer(new std::vector<char>());
+        if (!archive.read(entry, *buffer))
+            return false;
+        data.buffer = buffer;
+        data.data = buffer->data();
+        return true;
+    }
+
+    void prefetchLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+            const std::string path = queue.front();
+            queue.pop_front();
+            lock.unlock();
+
+            AssetData data;
+            const bool found = resolve(path, data, true, false);
+
+            lock.lock();
+            CacheEntry &entry = cache[path];
+            entry.Ready = true;
+            entry.Found = found;
+            entry.Data = data;
+            --pending;
+            done.notify_all();
+        }
+    }
+};
+
+#endif
@@ -6,7 +6,6 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <shader.h>
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include <glm/glm.hpp>
@@ -3,13 +3,10 @@ CONFIG += console c++11
 CONFIG -= app_bundle
 CONFIG -= qt
 
-LIBS += -lglfw3 -lGL -lX11 -lpthread -lXrandr -lXi -ldl
-
-INCLUDEPATH += $$PWD/../../common
+include(../../common/common.pri)
 
 SOURCES += \
-    main.cpp \
-    ../../common/src/glad.c
+    main.cpp
 
 HEADERS += \
     ../../common/glad/glad.h \
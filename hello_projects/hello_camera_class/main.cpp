@@ -8,7 +8,6 @@
 #include <shader.h>
 #include <camera.h>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include <glm/glm.hpp>
@@ -3,19 +3,18 @@ CONFIG += console c++11
 CONFIG -= app_bundle
 CONFIG -= qt
 
-LIBS += -lglfw3 -lGL -lX11 -lpthread -lXrandr -lXi -ldl
-
-INCLUDEPATH += $$PWD/../../common
+include(../../common/common.pri)
 
 SOURCES += \
-    main.cpp \
-    ../../common/src/glad.c
+    main.cpp
 
 HEADERS += \
     ../../common/glad/glad.h \
     ../../common/KHR/khrplatform.h \
     ../../common/stb_image.h \
-    ../../common/shader.h
+    ../../common/shader.h \
+    ../../common/job_system.h \
+    ../../common/ecs.h
 
 DISTFILES += \
     hello_coordinatesystem.vert \
@@ -1,11 +1,12 @@
 // Draw Rectangular object/cube with multiple textures and use different coordinate systems matrices
-// Use: Shader class and files, VBO, VAO, EBO, textures, glm library for transformations and coordinate system matrices
+// Use: Shader class and files, VBO, VAO, EBO, textures, glm library for transformations and coordinate system matrices,
+//      EntityWorld (entities and systems) for the multiple cubes
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <shader.h>
-#define STB_IMAGE_IMPLEMENTATION
+#include <ecs.h>
 #include <stb_image.h>
 
 #include <glm/glm.hpp>
@@ -20,6 +21,30 @@ namespace
     float mixValueFromKey = 0.2f;
 }
 
+// Components of the multiple cubes: each cube is an entity with a position, a model matrix and either a fixed orientation
+// or a spin, so how a cube moves follows from its components instead of its index
+struct Position
+{
+    glm::vec3 Value;
+};
+
+struct Orientation
+{
+    glm::vec3 Axis;
+    float Angle;   // radians
+};
+
+struct Spin
+{
+    glm::vec3 Axis;
+    float Speed;   // radians per second
+};
+
+struct Model
+{
+    glm::mat4 Value;
+};
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window);
 int DrawTexturedRectangleWithCoordinateSystem();
@@ -864,12 +889,39 @@ int DrawMultipleTexturedCubesWithCoordinateSystem()
     projection = glm::perspective(glm::radians(45.0f), static_cast<float>(SCR_WIDTH/SCR_HEIGHT), 0.1f, 100.0f);
     ShaderProgram.setMat4("projection", projection);
 
+    // the containers as entities: every third one spins over time, the rest have a fixed orientation
+    EntityWorld world;
+    for(int i = 0; i < 10; ++i)
+    {
+        const Position position = { cubePositions[i] };
+        const Model model = { glm::mat4(1.0f) };
+        if(i % 3 == 0)
+        {
+            const Spin spin = { glm::vec3(0.5f, 1.0f, 0.0f), glm::radians(50.0f) };
+            world.create(position, spin, model);
+        }
+        else
+        {
+            const Orientation orientation = { glm::vec3(1.0f, 0.0f, 0.0f), glm::radians(-55.0f) };
+            world.create(position, orientation, model);
+        }
+    }
+
     // render loop
     while (!glfwWindowShouldClose(window))
     {
         // input
         processInput(window);
 
+        // systems: the model matrices (local space to world (model) space) of the spinning and of the static containers
+        const float time = static_cast<float>(glfwGetTime());
+        world.forEach<Position, Spin, Model>([time](const Position &position, const Spin &spin, Model &model) {
+            model.Value = glm::rotate(glm::translate(glm::mat4(1.0f), position.Value), time*spin.Speed, spin.Axis);
+        });
+        world.forEach<Position, Orientation, Model>([](const Position &position, const Orientation &orientation, Model &model) {
+            model.Value = glm::rotate(glm::translate(glm::mat4(1.0f), position.Value), orientation.Angle, orientation.Axis);
+        });
+
         // render
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
@@ -885,30 +937,18 @@ int DrawMultipleTexturedCubesWithCoordinateSystem()
         // set the texture mix value in the shader
         ShaderProgram.setFloat("mixValue", mixValueFromKey);
 
+        // view matrix : world (model) space to view (camera) space, the same for all the containers
+        glm::mat4 view = glm::mat4(1.0f);
+        view  = glm::translate(view,  glm::vec3(0.0f, 0.0f, -3.0f));
+        ShaderProgram.setMat4("view", view);
+
         glBindVertexArray(VAO);
 
-        // draw containers in a loop and use different transforms (matrices) for using different coordinate systems
-        for(int i = 0; i < 10; ++i)
-        {
-            // create transformations and send them to the shader program by setting the uniforms
-
-            // model matrix : local space to world (model) space
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, cubePositions[i]);
-            if(i % 3 == 0) // make every third container rotate over time
-                model = glm::rotate(model, static_cast<float>(glfwGetTime()) * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
-            else // rest of the containers are just static
-                model = glm::rotate(model, glm::radians(-55.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-            ShaderProgram.setMat4("model", model);
-
-            // view matrix : world (model) space to view (camera) space (in this case can also be set outside the loop as it's the same for all the containers)
-            glm::mat4 view = glm::mat4(1.0f);
-            view  = glm::translate(view,  glm::vec3(0.0f, 0.0f, -3.0f));
-            ShaderProgram.setMat4("view", view);
+        // draw every container with its model matrix (projection matrix: has been already set outside the main loop)
+        world.forEach<Model>([&ShaderProgram](const Model &model) {
+            ShaderProgram.setMat4("model", model.Value);
             glDrawArrays(GL_TRIANGLES, 0, 36); // glDrawArrays makes use of the vertices directly stored in the VBO
-
-            // projection matrix: has been already set outside the main loop
-        }
+        });
 
         glBindVertexArray(0);
 
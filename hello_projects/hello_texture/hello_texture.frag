@@ -4,10 +4,29 @@ out vec4 FragColor;
 in vec3 ourColor;
 in vec2 TexCoord;
 
+// features of the variants (ShaderPermutations defines them after the #version line):
+// USE_TEXTURE1, USE_TEXTURE2 - the textures sampled, both together are mixed by mixValue
+// VERTEX_COLOR - the texture color is multiplied by the vertex color
+
 // texture sampler
 uniform sampler2D texture1;
+uniform sampler2D texture2;
+
+// uniform mixValue coming from the program
+uniform float mixValue;
 
 void main()
 {
-    FragColor =texture2D(texture1, TexCoord)*vec4(ourColor,1.0);
+#if defined(USE_TEXTURE1) && defined(USE_TEXTURE2)
+    FragColor = mix(texture(texture1, TexCoord),
+                    texture(texture2, vec2(1.0-TexCoord.s, TexCoord.t)),
+                    mixValue);
+#elif defined(USE_TEXTURE2)
+    FragColor = texture(texture2, vec2(1.0-TexCoord.s, TexCoord.t));
+#else
+    FragColor = texture(texture1, TexCoord);
+#endif
+#ifdef VERTEX_COLOR
+    FragColor *= vec4(ourColor, 1.0);
+#endif
 }
@@ -3,21 +3,20 @@ CONFIG += console c++11
 CONFIG -= app_bundle
 CONFIG -= qt
 
-LIBS += -lglfw3 -lGL -lX11 -lpthread -lXrandr -lXi -ldl
-
-INCLUDEPATH += $$PWD/../../common
+include(../../common/common.pri)
 
 SOURCES += \
-    main.cpp \
-    ../../common/src/glad.c
+    main.cpp
 
 HEADERS += \
     ../../common/glad/glad.h \
     ../../common/KHR/khrplatform.h \
     ../../common/stb_image.h \
-    ../../common/shader.h
+    ../../common/shader.h \
+    ../../common/mapped_file.h \
+    ../../common/shader_source.h \
+    ../../common/shader_permutations.h
 
 DISTFILES += \
     hello_texture.vert \
-    hello_texture.frag \
-    hello_texture_multiple.frag
+    hello_texture.frag
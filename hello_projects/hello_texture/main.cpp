@@ -1,11 +1,11 @@
 // Draw Rectangle with texture
-// Use: Shader class and files, VBO, VAO, EBO and textures
+// Use: Shader class and files (variants of one fragment shader by ShaderPermutations), VBO, VAO, EBO and textures
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <shader.h>
-#define STB_IMAGE_IMPLEMENTATION
+#include <shader_permutations.h>
 #include <stb_image.h>
 
 namespace
@@ -15,6 +15,10 @@ namespace
 
     // initial mix value for how much we're seeing of either texture
     float mixValueFromKey = 0.2f;
+
+    // features of the fragment shader variants: the bits of their ShaderKey and the matching #define names
+    enum TextureFeature { USE_TEXTURE1, USE_TEXTURE2, VERTEX_COLOR };
+    const std::vector<std::string> textureFeatures = { "USE_TEXTURE1", "USE_TEXTURE2", "VERTEX_COLOR" };
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -96,8 +100,9 @@ int DrawRectangleTexture()
         return -1;
     }
 
-    // build and compile the shader program
-    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    // build and compile the shader program: the variant sampling one texture, multiplied by the vertex colors
+    ShaderPermutations Programs(relPathExePro+project_name+".vert", relPathExePro+project_name+".frag", textureFeatures);
+    Shader &ShaderProgram = Programs.get<shaderKey(USE_TEXTURE1, VERTEX_COLOR)>();
 
     // set up vertex data (vertex ordering from top right and go counter clockwise)
     const GLfloat vertices[] = {
@@ -193,6 +198,7 @@ int DrawRectangleTexture()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    Programs.destroy();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
@@ -233,8 +239,12 @@ int DrawRectangleMultipleTextures()
         return -1;
     }
 
-    // build and compile the shader program
-    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+"_multiple.frag").c_str());
+    // build and compile the shader programs: both textures mixed, and each texture alone for the mix values 0 and 1, so
+    // no blend is computed when only one of them is seen
+    ShaderPermutations Programs(relPathExePro+project_name+".vert", relPathExePro+project_name+".frag", textureFeatures);
+    constexpr ShaderKey MIXED = shaderKey(USE_TEXTURE1, USE_TEXTURE2);
+    constexpr ShaderKey FIRST_ONLY = shaderKey(USE_TEXTURE1);
+    constexpr ShaderKey SECOND_ONLY = shaderKey(USE_TEXTURE2);
 
     // set up vertex data (vertex ordering from top right and go counter clockwise)
     const GLfloat vertices[] = {
@@ -338,10 +348,14 @@ int DrawRectangleMultipleTextures()
     // uncomment this call to draw in wireframe polygons.
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
-    ShaderProgram.use(); // activate the shader before setting uniforms
-    glUniform1i(glGetUniformLocation(ShaderProgram.ID, "texture1"), 0); // set it manually
-    ShaderProgram.setInt("texture2", 1); // or with shader class uniform utility function
+    // tell opengl for each sampler (uniforms) of every variant to which texture unit it belongs to
+    for (ShaderKey key : { MIXED, FIRST_ONLY, SECOND_ONLY })
+    {
+        Shader &ShaderProgram = Programs.compile(key);
+        ShaderProgram.use(); // activate the shader before setting uniforms
+        glUniform1i(glGetUniformLocation(ShaderProgram.ID, "texture1"), 0); // set it manually
+        ShaderProgram.setInt("texture2", 1); // or with shader class uniform utility function
+    }
 
     // render loop
     while (!glfwWindowShouldClose(window))
@@ -359,10 +373,13 @@ int DrawRectangleMultipleTextures()
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, textures[1]);
 
-        // render container
+        // render container with the variant of the mix value
+        const ShaderKey key = mixValueFromKey <= 0.0f ? FIRST_ONLY : (mixValueFromKey >= 1.0f ? SECOND_ONLY : MIXED);
+        Shader &ShaderProgram = Programs.get(key);
         ShaderProgram.use();
         // set the texture mix value in the shader
-        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        if (key == MIXED)
+            ShaderProgram.setFloat("mixValue", mixValueFromKey);
 
         glBindVertexArray(VAO);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); // bind the EBO while a VAO is active as it is required to associate the correct indices of the vertices in the VBO stored in the VAO
@@ -379,6 +396,7 @@ int DrawRectangleMultipleTextures()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    Programs.destroy();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
@@ -0,0 +1,536 @@
+// Assets loaded through a virtual file system (common/virtual_file_system.h) instead of paths relative to the working
+// directory: the resources are packed into one archive (common/asset_archive.h) with a hashed path index and aligned,
+// optionally compressed entries, which is mounted next to the loose resource folder as the development fallback; the
+// textures of the scene are prefetched on a background thread while the window is created
+// Use: Shader class and files, VirtualFileSystem, AssetArchive and AssetArchiveWriter, MeshPool, camera object
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <asset_archive.h>
+#include <virtual_file_system.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_assetarchive";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // packing: entries stored uncompressed (--store) and their alignment (--align)
+    bool packCompressed = true;
+    unsigned packAlignment = 64;
+
+    // benchmark settings: generated asset files (--files), whether the files are dropped from the page cache before every
+    // load (--cold, Linux only) and the frames of the current scene drawn while the next one is prefetched (--frames)
+    unsigned benchmarkFiles = 2000;
+    bool benchmarkCold = false;
+    unsigned benchmarkFrames = 10;
+}
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(VirtualFileSystem &files, const std::string &path);
+bool listFiles(const std::string &directory, const std::string &relative, std::vector<std::string> &files);
+bool packDirectory(const std::string &directory, const std::string &archivePath);
+void dropFromPageCache(const std::string &path);
+double milliseconds(std::chrono::steady_clock::time_point start);
+
+int drawContainers(const std::string &archivePath);
+int benchmarkAssetArchive();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// the image is decoded from the bytes the file system hands out (in place for stored archive entries)
+GLuint loadTexture(VirtualFileSystem &files, const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    AssetData file;
+    unsigned char *data = nullptr;
+    if (files.load(path, file))
+        data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.getData()), static_cast<int>(file.getSize()),
+                                     &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// the regular files below directory, as paths relative to it (sorted, so the archive is the same on every run)
+bool listFiles(const std::string &directory, const std::string &relative, std::vector<std::string> &files)
+{
+#ifdef __linux__
+    const std::string path = relative.empty() ? directory : directory + "/" + relative;
+    DIR *listing = opendir(path.c_str());
+    if (listing == nullptr)
+    {
+        std::cout << "ERROR::PERF_ASSETARCHIVE::DIRECTORY_NOT_SUCCESFULLY_READ: " << path << std::endl;
+        return false;
+    }
+    std::vector<std::string> names;
+    while (dirent *entry = readdir(listing))
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            names.push_back(entry->d_name);
+    closedir(listing);
+    std::sort(names.begin(), names.end());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        const std::string name = relative.empty() ? names[i] : relative + "/" + names[i];
+        struct stat status;
+        if (stat((directory + "/" + name).c_str(), &status) != 0)
+            continue;
+        if (S_ISDIR(status.st_mode))
+        {
+            if (!listFiles(directory, name, files))
+                return false;
+        }
+        else if (S_ISREG(status.st_mode))
+            files.push_back(name);
+    }
+    return true;
+#else
+    std::cout << "ERROR::PERF_ASSETARCHIVE::DIRECTORY_LISTING_NOT_SUPPORTED: " << directory << std::endl;
+    return false;
+#endif
+}
+
+// the authoring step: every file below directory into one archive, by its path relative to directory
+bool packDirectory(const std::string &directory, const std::string &archivePath)
+{
+    std::vector<std::string> files;
+    if (!listFiles(directory, std::string(), files))
+        return false;
+    AssetArchiveWriter writer(packAlignment);
+    for (size_t i = 0; i < files.size(); ++i)
+        if (!writer.addFile(files[i], directory + "/" + files[i], packCompressed))
+            return false;
+    if (!writer.write(archivePath))
+        return false;
+    AssetArchive archive;
+    if (!archive.open(archivePath))
+        return false;
+    uint64_t size = 0, compressed = 0;
+    const std::vector<const AssetArchiveEntry*> entries = archive.getEntries();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        size += entries[i]->Size;
+        compressed += entries[i]->Compression != ASSET_STORED;
+    }
+    std::cout << directory << " packed into " << archivePath << ": " << entries.size() << " files (" << compressed << " compressed), "
+              << size << " bytes in an archive of " << archive.getFileSize() << " bytes" << std::endl;
+    return true;
+}
+
+// --cold: the next load of the file has to read it from the disk (its pages are written back and dropped from the cache)
+void dropFromPageCache(const std::string &path)
+{
+#ifdef __linux__
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return;
+    fdatasync(descriptor);
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+    close(descriptor);
+#endif
+}
+
+double milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --pack DIRECTORY ARCHIVE [--store] [--align N]: pack the files below DIRECTORY into ARCHIVE
+    // --benchmark [--files N] [--frames N] [--cold]: headless loads of generated assets, loose files against the archives
+    // ARCHIVE: draw the containers with the resources of ARCHIVE; without arguments the common resources are packed first
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--store") == 0)
+            packCompressed = false;
+        else if (strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+            packAlignment = std::max(8, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--files") == 0 && i + 1 < argc)
+            benchmarkFiles = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            benchmarkFrames = std::max(0, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--cold") == 0)
+            benchmarkCold = true;
+    }
+    if (argc > 3 && strcmp(argv[1], "--pack") == 0)
+        return packDirectory(argv[2], argv[3]) ? 0 : -1;
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+        return benchmarkAssetArchive();
+    if (argc > 1)
+        return drawContainers(argv[1]);
+
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+    if (!packDirectory(relPathExePro+"../../common/resources", "resources.pak"))
+        return -1;
+    return drawContainers("resources.pak");
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawContainers(const std::string &archivePath)
+{
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    // the archive serves resources/..., the loose files are the fallback for what it doesn't contain
+    VirtualFileSystem files;
+    if (!files.mountArchive("resources", archivePath))
+        return -1;
+    files.mountDirectory("resources", relPathExePro+"../../common/resources");
+
+    // the textures are read (and decompressed) on the prefetch thread while the window and the GL context are created
+    const std::string texturePaths[2] = { "resources/textures/container.jpg", "resources/textures/awesomeface.png" };
+    files.prefetch(std::vector<std::string>(texturePaths, texturePaths + 2));
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    GLuint textures[2];
+    for (int i = 0; i < 2; ++i)
+        textures[i] = loadTexture(files, texturePaths[i]);
+
+    // world space positions of our cubes
+    const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+    MeshPool pool;
+    const MeshRange box = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+    std::vector<glm::mat4> models(10);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        for (unsigned i = 0; i < 10; ++i)
+            models[i] = glm::rotate(glm::translate(glm::mat4(1.0f), cubePositions[i]), glm::radians(20.0f*i) + currentFrame*(i % 3 == 0),
+                                    glm::vec3(1.0f, 0.3f, 0.5f));
+        pool.setInstanceData(models);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", camera.GetViewMatrix());
+        ShaderProgram.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT));
+        pool.bind();
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, box.indexCount, GL_UNSIGNED_INT, (void*)(box.firstIndex*sizeof(GLuint)), 10, box.baseVertex);
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    const VirtualFileSystemStats stats = files.getStats();
+    std::cout << "files opened: " << stats.FilesOpened << ", archive reads: " << stats.ArchiveReads << ", loose reads: "
+              << stats.LooseReads << ", prefetch hits: " << stats.PrefetchHits << std::endl;
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkAssetArchive()
+{
+    // Benchmark: --files assets in 8 "scene" folders (three of four text files of 2-24 KB which compress well, every
+    // fourth 64 KB of noise which doesn't, like JPEG or PNG) are written as loose files and packed into a stored and a
+    // compressed archive. Every asset is then loaded through a VirtualFileSystem (and summed, so in place data is read too)
+    //  loose      : directory mount, one open() per asset
+    //  stored     : archive mount, the entries used in place
+    //  compressed : archive mount, the entries decompressed
+    //  prefetch   : compressed archive, the assets prefetched while --frames frames of 16 ms of the current scene pass,
+    //               then loaded: the time is what the drawing thread waits
+    // With --cold the files are dropped from the page cache before every mode
+
+    const std::string directory = project_name + "_assets";
+    const std::string archivePaths[2] = { project_name + "_stored.pak", project_name + "_compressed.pak" };
+    std::vector<std::string> paths;
+    uint64_t totalBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+#ifdef __linux__
+        mkdir(directory.c_str(), 0755);
+        for (int scene = 0; scene < 8; ++scene)
+            mkdir((directory + "/scene" + std::to_string(scene)).c_str(), 0755);
+#endif
+        uint32_t random = 2463534242u;
+        for (unsigned i = 0; i < benchmarkFiles; ++i)
+        {
+            std::string content;
+            const bool binary = i % 4 == 3;
+            const std::string path = "scene" + std::to_string(i % 8) + "/asset" + std::to_string(i) + (binary ? ".bin" : ".glsl");
+            if (binary)
+            {
+                content.resize(65536);
+                for (size_t b = 0; b < content.size(); ++b)
+                {
+                    random ^= random << 13;
+                    random ^= random >> 17;
+                    random ^= random << 5;
+                    content[b] = static_cast<char>(random);
+                }
+            }
+            else
+            {
+                std::ostringstream text;
+                text << "#version 330 core\n// generated asset " << i << "\n";
+                const unsigned lines = 40 + (i*7919) % 400;
+                for (unsigned line = 0; line < lines; ++line)
+                    text << "uniform vec4 parameter" << line << " = vec4(" << (line*31 + i) % 97 << ".0, 0.5, "
+                         << (line*17) % 13 << ".25, 1.0);\n";
+                content = text.str();
+            }
+            std::ofstream file((directory + "/" + path).c_str(), std::ios::binary);
+            file.write(content.data(), content.size());
+            if (!file)
+            {
+                std::cout << "ERROR::PERF_ASSETARCHIVE::WRITE_FAILED: " << directory + "/" + path << std::endl;
+                return -1;
+            }
+            paths.push_back("assets/" + path);
+            totalBytes += content.size();
+        }
+    }
+    std::cout << benchmarkFiles << " assets (" << std::fixed << std::setprecision(1) << totalBytes/(1024.0*1024.0)
+              << " MB) written in " << milliseconds(start) << " ms" << std::endl;
+    for (int compressed = 0; compressed < 2; ++compressed)
+    {
+        packCompressed = compressed != 0;
+        start = std::chrono::steady_clock::now();
+        if (!packDirectory(directory, archivePaths[compressed]))
+            return -1;
+        std::cout << "  packed in " << milliseconds(start) << " ms" << std::endl;
+    }
+
+    const char* names[4] = { "loose", "stored", "compressed", "prefetch" };
+    uint64_t referenceSum = 0;
+    std::cout << std::setw(12) << "mode" << std::setw(14) << "files opened" << std::setw(12) << "load [ms]" << std::setw(10) << "MB/s"
+              << std::setw(10) << "in place" << std::setw(8) << "same" << (benchmarkCold ? "   (cold page cache)" : "") << std::endl;
+    for (int mode = 0; mode < 4; ++mode)
+    {
+        if (benchmarkCold)
+        {
+            for (size_t i = 0; i < paths.size(); ++i)
+                dropFromPageCache(directory + "/" + paths[i].substr(7));
+            dropFromPageCache(archivePaths[0]);
+            dropFromPageCache(archivePaths[1]);
+        }
+        VirtualFileSystem files;
+        if (mode == 0)
+            files.mountDirectory("assets", directory);
+        else if (!files.mountArchive("assets", archivePaths[mode == 1 ? 0 : 1]))
+            return -1;
+        if (mode == 3)
+        {
+            // the next scene is requested at the start of the frames of the current one
+            files.prefetch(paths);
+            for (unsigned frame = 0; frame < benchmarkFrames; ++frame)
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+
+        start = std::chrono::steady_clock::now();
+        uint64_t sum = 0, inPlace = 0;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            AssetData data;
+            if (!files.load(paths[i], data))
+                return -1;
+            inPlace += data.isInPlace();
+            for (size_t b = 0; b < data.getSize(); b += 64)
+                sum = sum*31 + static_cast<unsigned char>(data.getData()[b]);
+            sum += data.getSize();
+        }
+        const double time = milliseconds(start);
+        if (mode == 0)
+            referenceSum = sum;
+        std::cout << std::setw(12) << names[mode] << std::setw(14) << files.getStats().FilesOpened << std::setw(12) << time
+                  << std::setw(10) << totalBytes/(1024.0*1024.0)/(time/1000.0) << std::setw(10) << inPlace
+                  << std::setw(8) << (sum == referenceSum ? "yes" : "NO") << std::endl;
+    }
+    return 0;
+}
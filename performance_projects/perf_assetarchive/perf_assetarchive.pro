@@ -0,0 +1,25 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/stb_image.h \
+    ../../common/shader.h \
+    ../../common/camera.h \
+    ../../common/mesh_pool.h \
+    ../../common/mapped_file.h \
+    ../../common/asset_archive.h \
+    ../../common/virtual_file_system.h
+
+DISTFILES += \
+    perf_assetarchive.vert \
+    perf_assetarchive.frag \
@@ -0,0 +1,558 @@
+// Containers as entities of an archetype based entity component system: the position, the rotation and the model matrix
+// of every container are components stored in chunks (structure of arrays), every third container of hello_coordinatesystem
+// rotates because it has a Spin component instead of an index test, and systems compute the model matrices and cull the
+// containers chunk by chunk on the threads of a job system. The same systems run from the ten containers to millions
+// Use: Shader class and files, MeshPool with instanced model matrices, camera object and frustum, EntityWorld (archetypes,
+//      chunks, queries, parallel systems), JobSystem
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <job_system.h>
+#include <ecs.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_ecs";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // number of containers, 10 is the scene of hello_coordinatesystem (--entities)
+    size_t entityCount = 10;
+    // largest number of containers of the benchmark (--max)
+    size_t benchmarkMax = 2000000;
+}
+
+// Components of a container
+struct Position
+{
+    glm::vec3 Value;
+};
+
+// fixed rotation of a static container
+struct Orientation
+{
+    glm::vec3 Axis;
+    float Angle;   // radians
+};
+
+// rotation over time of a spinning container
+struct Spin
+{
+    glm::vec3 Axis;
+    float Speed;   // radians per second
+};
+
+struct Model
+{
+    glm::mat4 Value;
+};
+
+// The systems of the containers: model matrices of the static and of the spinning ones, then the frustum culling which
+// appends the visible model matrices to Visible
+struct ContainerSystems
+{
+    std::vector<glm::mat4> Visible;
+    std::atomic<size_t> VisibleCount;
+
+    ContainerSystems() : VisibleCount(0) {}
+
+    static void orient(size_t count, const Position* positions, const Orientation* orientations, Model* models)
+    {
+        for (size_t i = 0; i < count; ++i)
+            models[i].Value = glm::rotate(glm::translate(glm::mat4(1.0f), positions[i].Value), orientations[i].Angle, orientations[i].Axis);
+    }
+
+    static void spin(size_t count, const Position* positions, const Spin* spins, Model* models, float time)
+    {
+        for (size_t i = 0; i < count; ++i)
+            models[i].Value = glm::rotate(glm::translate(glm::mat4(1.0f), positions[i].Value), time*spins[i].Speed, spins[i].Axis);
+    }
+
+    // the visible model matrices of a chunk are gathered locally and then copied into a range of Visible reserved with
+    // one atomic add, so the threads never write the same element
+    void cull(size_t count, const Position* positions, const Model* models, const Frustum &frustum)
+    {
+        // the rotated unit cube always fits into the sphere of radius sqrt(3)/2, use the box around that sphere
+        const glm::vec3 extents(0.87f);
+        const size_t BATCH = 256;
+        unsigned indices[BATCH];
+        size_t visible = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (frustum.IntersectsAABB(positions[i].Value, extents))
+                indices[visible++] = static_cast<unsigned>(i);
+            if (visible == BATCH || (i + 1 == count && visible > 0))
+            {
+                size_t first = VisibleCount.fetch_add(visible);
+                for (size_t j = 0; j < visible; ++j)
+                    Visible[first + j] = models[indices[j]].Value;
+                visible = 0;
+            }
+        }
+    }
+
+    // runs the systems on all the containers, chunk by chunk on the threads of jobs or on the calling thread without it
+    void update(EntityWorld &world, JobSystem* jobs, float time, const Frustum &frustum)
+    {
+        Visible.resize(world.count<Model>());
+        VisibleCount = 0;
+        auto spinning = [time](size_t count, const Position* positions, const Spin* spins, Model* models) { spin(count, positions, spins, models, time); };
+        auto culling = [this, &frustum](size_t count, const Position* positions, const Model* models) { cull(count, positions, models, frustum); };
+        if (jobs == nullptr)
+        {
+            world.forEachChunk<Position, Orientation, Model>(orient);
+            world.forEachChunk<Position, Spin, Model>(spinning);
+            world.forEachChunk<Position, Model>(culling);
+            return;
+        }
+        world.parallelForEachChunk<Position, Orientation, Model>(*jobs, orient);
+        world.parallelForEachChunk<Position, Spin, Model>(*jobs, spinning);
+        world.parallelForEachChunk<Position, Model>(*jobs, culling);
+    }
+};
+
+// The containers as an array of objects with the rotation chosen per index, the layout the samples used before the
+// entity component system; the baseline of the benchmark
+struct ContainerArray
+{
+    struct Object
+    {
+        glm::vec3 Position;
+        glm::vec3 Axis;
+        float Angle;
+        float Speed;
+        glm::mat4 Model;
+    };
+
+    std::vector<Object> Objects;
+    std::vector<glm::mat4> Visible;
+    size_t VisibleCount;
+
+    ContainerArray() : VisibleCount(0) {}
+
+    void update(float time, const Frustum &frustum)
+    {
+        const glm::vec3 extents(0.87f);
+        Visible.resize(Objects.size());
+        VisibleCount = 0;
+        for (size_t i = 0; i < Objects.size(); ++i)
+        {
+            Object &object = Objects[i];
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), object.Position);
+            if (i % 3 == 0) // make every third container rotate over time
+                object.Model = glm::rotate(model, time*object.Speed, object.Axis);
+            else
+                object.Model = glm::rotate(model, object.Angle, object.Axis);
+        }
+        for (size_t i = 0; i < Objects.size(); ++i)
+            if (frustum.IntersectsAABB(Objects[i].Position, extents))
+                Visible[VisibleCount++] = Objects[i].Model;
+    }
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+float spawnContainers(EntityWorld &world, ContainerArray* array, size_t count);
+double milliseconds(std::chrono::steady_clock::time_point start);
+
+int drawContainers();
+int benchmarkEcs();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Creates count containers in world (and in array if not null): the ten containers of hello_coordinatesystem, more are
+// spread at random over a cube in front of the camera with one container per 8 cubic units. As before every third
+// container spins, but that is decided here once by giving it a Spin component. Returns the distance to the farthest one
+float spawnContainers(EntityWorld &world, ContainerArray* array, size_t count)
+{
+    const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    const float side = 2.0f*std::cbrt(static_cast<float>(count));
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float farthest = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Position position;
+        Orientation orientation;
+        Spin spin;
+        if (i < 10)
+        {
+            position.Value = cubePositions[i];
+            orientation.Axis = glm::vec3(1.0f, 0.0f, 0.0f);
+            orientation.Angle = glm::radians(-55.0f);
+            spin.Axis = glm::normalize(glm::vec3(0.5f, 1.0f, 0.0f));
+            spin.Speed = glm::radians(50.0f);
+        }
+        else
+        {
+            position.Value = glm::vec3((unit(random) - 0.5f)*side, (unit(random) - 0.5f)*side, -unit(random)*side - 3.0f);
+            orientation.Axis = glm::normalize(glm::vec3(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) + 0.1f));
+            orientation.Angle = unit(random)*glm::radians(360.0f);
+            spin.Axis = orientation.Axis;
+            spin.Speed = glm::radians(50.0f)*(0.5f + unit(random));
+        }
+        farthest = std::max(farthest, glm::length(position.Value));
+
+        Model model = { glm::mat4(1.0f) };
+        if (i % 3 == 0)
+            world.create(position, spin, model);
+        else
+            world.create(position, orientation, model);
+
+        if (array != nullptr)
+        {
+            ContainerArray::Object object = { position.Value, i % 3 == 0 ? spin.Axis : orientation.Axis, orientation.Angle, spin.Speed, glm::mat4(1.0f) };
+            array->Objects.push_back(object);
+        }
+    }
+    return farthest;
+}
+
+double milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --entities N: number of containers; --benchmark: headless comparison of the systems with the array of objects for
+    // 10 containers up to --max N
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+        else if (strcmp(argv[i], "--entities") == 0 && i + 1 < argc)
+            entityCount = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc)
+            benchmarkMax = std::max<size_t>(10, strtoul(argv[++i], nullptr, 10));
+    }
+    return benchmark ? benchmarkEcs() : drawContainers();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawContainers()
+{
+    // Drawing the containers of the entity world: the systems compute their model matrices and cull them on all the
+    // threads every frame, the main thread uploads the visible ones and submits one instanced draw call
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    GLuint textures[2];
+    textures[0] = loadTexture(relPathExePro+"../../common/resources/textures/container.jpg");
+    textures[1] = loadTexture(relPathExePro+"../../common/resources/textures/awesomeface.png");
+
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+
+    EntityWorld world;
+    const float farPlane = std::max(100.0f, 2.0f*spawnContainers(world, nullptr, entityCount));
+    ContainerSystems systems;
+    JobSystem jobs;
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    double lastTitleUpdate = glfwGetTime();
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio, 0.1f, farPlane);
+        auto updateStart = std::chrono::steady_clock::now();
+        systems.update(world, &jobs, currentFrame, Frustum(projection * view));
+        double updateTime = milliseconds(updateStart);
+
+        // show the time of the systems once per second
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::string title = "LearnOpenGL - " + std::to_string(systems.VisibleCount) + " of " + std::to_string(world.getEntityCount()) +
+                                " containers visible (" + std::to_string(world.getChunkCount()) + " chunks), systems on " +
+                                std::to_string(jobs.getThreadCount()) + " threads: " + std::to_string(updateTime) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+        }
+
+        // upload the visible instances (GL calls on the main thread only)
+        glBindBuffer(GL_ARRAY_BUFFER, pool.InstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, systems.VisibleCount*sizeof(glm::mat4), systems.Visible.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", view);
+        ShaderProgram.setMat4("projection", projection);
+
+        pool.bind();
+        glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, GL_UNSIGNED_INT, (void*)(cube.firstIndex*sizeof(GLuint)), static_cast<GLsizei>(systems.VisibleCount));
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkEcs()
+{
+    // Benchmark without a window: the model matrices and the culling of 10 containers up to --max (1000 times more each
+    // step), per update in milliseconds and per container in nanoseconds
+    //  create : creating the entities
+    //  array  : the array of objects with the rotation chosen by index (the layout before the entity component system)
+    //  ecs    : the systems on the main thread, chunk after chunk
+    //  jobs   : the systems with one job per chunk on all the threads of the job system
+
+    JobSystem jobs;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 1000.0f);
+
+    std::cout << "job system with " << jobs.getThreadCount() << " threads, " << Archetype::CHUNK_BYTES << " bytes per chunk" << std::endl;
+    std::cout << std::setw(10) << "entities" << std::setw(8) << "chunks" << std::setw(10) << "visible" << std::setw(13) << "create [ms]"
+              << std::setw(12) << "array [ms]" << std::setw(10) << "ecs [ms]" << std::setw(11) << "jobs [ms]"
+              << std::setw(12) << "array [ns]" << std::setw(10) << "ecs [ns]" << std::setw(11) << "jobs [ns]" << std::endl;
+
+    std::vector<size_t> counts;
+    for (size_t count = 10; count < benchmarkMax; count *= 10)
+        counts.push_back(count);
+    counts.push_back(benchmarkMax);
+
+    for (size_t c = 0; c < counts.size(); ++c)
+    {
+        const size_t count = counts[c];
+        EntityWorld world;
+        ContainerArray array;
+        array.Objects.reserve(count);
+        auto start = std::chrono::steady_clock::now();
+        spawnContainers(world, &array, count);
+        // the time of the array is part of it, but small next to the entities
+        const double createTime = milliseconds(start);
+
+        // enough updates for about 20 million containers in total
+        const int updates = static_cast<int>(std::max<size_t>(3, std::min<size_t>(10000, 20000000 / count)));
+        ContainerSystems systems;
+        double times[3] = { 0.0, 0.0, 0.0 };
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            // one untimed update first: the memory of the visible matrices is touched for the first time there
+            for (int update = -1; update < updates; ++update)
+            {
+                const float time = update/60.0f;
+                const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(std::sin(time), 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+                const Frustum frustum(projection * view);
+                start = std::chrono::steady_clock::now();
+                if (mode == 0)
+                    array.update(time, frustum);
+                else
+                    systems.update(world, mode == 2 ? &jobs : nullptr, time, frustum);
+                if (update >= 0)
+                    times[mode] += milliseconds(start);
+            }
+            times[mode] /= updates;
+        }
+        if (systems.VisibleCount != array.VisibleCount)
+            std::cout << "ERROR::PERF_ECS::VISIBLE_COUNT_MISMATCH " << systems.VisibleCount << " != " << array.VisibleCount << std::endl;
+
+        std::cout << std::setw(10) << count << std::setw(8) << world.getChunkCount() << std::setw(10) << systems.VisibleCount
+                  << std::fixed << std::setprecision(3) << std::setw(13) << createTime << std::setw(12) << times[0]
+                  << std::setw(10) << times[1] << std::setw(11) << times[2] << std::setprecision(1)
+                  << std::setw(12) << times[0]*1e6/count << std::setw(10) << times[1]*1e6/count << std::setw(11) << times[2]*1e6/count << std::endl;
+    }
+    return 0;
+}
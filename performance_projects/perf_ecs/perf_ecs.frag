@@ -0,0 +1,18 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// texture sampler
+uniform sampler2D texture1;
+uniform sampler2D texture2;
+
+// uniform mixValue coming from the program
+uniform float mixValue;
+
+void main()
+{
+    FragColor = mix(texture(texture1, TexCoord),
+                    texture(texture2, TexCoord),
+                    mixValue);
+}
@@ -0,0 +1,472 @@
+// Deterministic camera flythroughs for benchmarks: record the camera of every frame (Position, Yaw, Pitch, Zoom) while
+// flying through a grid of containers, then replay the recording headless, so every run renders exactly the same frames and
+// the frame times of different runs (or builds) can be compared. Every frame's CPU and GPU time, draw calls and uploaded
+// bytes are collected for percentile reports and exported as CSV/JSON at exit. Either run can also be captured as a GL
+// command trace for perf_glreplay. The uniforms are staged and only the changed ones are uploaded before each draw
+// Use: Shader class and files, camera object (SetState), Scene, CameraPath, FrameStats, GlTraceCapture, UniformStaging
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+#include <camera_path.h>
+#include <frame_stats.h>
+#include <gl_trace.h>
+#include <uniform_staging.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_flythrough";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // containers per side of the grid (--grid N)
+    unsigned gridSize = 12;
+
+    // --stats PREFIX: the frame statistics are written to PREFIX.csv and PREFIX.json at exit
+    std::string statsPrefix;
+
+    // --capture FILE: every GL call is captured to FILE
+    std::string captureFile;
+}
+
+// uniforms of the container program, staged and flushed right before each draw
+struct ContainerUniforms
+{
+    UniformStaging Staging;
+    UniformSlot<float> MixValue;
+    UniformSlot<glm::mat4> Model;
+    UniformSlot<glm::mat4> View;
+    UniformSlot<glm::mat4> Projection;
+
+    explicit ContainerUniforms(GLuint program) : Staging(program), MixValue(Staging.add<float>("mixValue")),
+        Model(Staging.add<glm::mat4>("model")), View(Staging.add<glm::mat4>("view")),
+        Projection(Staging.add<glm::mat4>("projection"))
+    {
+    }
+};
+
+// GL objects of the scene: one VAO/VBO per mesh as in the samples, both textures and the shaders of hello_camera_class
+struct SceneResources
+{
+    Shader ShaderProgram;
+    ContainerUniforms Uniforms;
+    std::vector<GLuint> VAOs;
+    std::vector<GLuint> VBOs;
+    GLuint Textures[2];
+
+    SceneResources(const Scene &scene, const std::string &relPathExePro);
+    void destroy();
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+void renderScene(const Scene &scene, SceneResources &resources, float time, FrameStats &stats);
+void exportStats(const FrameStats &stats);
+bool beginCapture();
+void endCapture();
+uint64_t hashFramebuffer();
+
+int recordFlythrough(const std::string &pathFile);
+int replayFlythrough(const std::string &pathFile);
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// load image, create texture (RGB or RGBA depending on the file) and generate mipmaps
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+SceneResources::SceneResources(const Scene &scene, const std::string &relPathExePro)
+    : ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str()),
+      Uniforms(ShaderProgram.ID)
+{
+    VAOs.resize(scene.Meshes.size());
+    VBOs.resize(scene.Meshes.size());
+    glGenVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glGenBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    for (size_t i = 0; i < scene.Meshes.size(); ++i)
+    {
+        glBindVertexArray(VAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, scene.Meshes[i].Vertices.size()*sizeof(float), scene.Meshes[i].Vertices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    Textures[0] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[0]);
+    Textures[1] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[1]);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+}
+
+void SceneResources::destroy()
+{
+    glDeleteVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glDeleteBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    glDeleteTextures(2, Textures);
+    glDeleteProgram(ShaderProgram.ID);
+}
+
+// draws the scene with the camera as it is now; time drives the rotation of every third container, so a replay passes the
+// recorded time instead of the clock. Counts the draw calls and the uniform data uploaded in the frame
+void renderScene(const Scene &scene, SceneResources &resources, float time, FrameStats &stats)
+{
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // activate texture units and bind them
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[1]);
+
+    resources.ShaderProgram.use();
+    ContainerUniforms &uniforms = resources.Uniforms;
+    uniforms.Staging.set(uniforms.MixValue, mixValueFromKey);
+    uniforms.Staging.set(uniforms.View, camera.GetViewMatrix());
+    uniforms.Staging.set(uniforms.Projection, camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT));
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        const SceneObject &object = scene.Objects[i];
+        const SceneMesh &mesh = scene.Meshes[object.Mesh];
+        glm::mat4 model = object.Model;
+        if (i % 3 == 0) // make every third container rotate over time
+            model = glm::rotate(model, time*glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+        uniforms.Staging.set(uniforms.Model, model);
+        stats.addBytesUploaded(uniforms.Staging.flush());
+        glBindVertexArray(resources.VAOs[object.Mesh]);
+        glDrawArrays(mesh.Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, 0, mesh.vertexCount());
+    }
+    glBindVertexArray(0);
+    stats.addDrawCalls(static_cast<unsigned>(scene.Objects.size()));
+}
+
+// prints the frame statistics and writes them to the files of --stats
+void exportStats(const FrameStats &stats)
+{
+    stats.printSummary(std::cout);
+    if (statsPrefix.empty())
+        return;
+    if (stats.writeCsv(statsPrefix + ".csv") && stats.writeJson(statsPrefix + ".json"))
+        std::cout << "frame statistics written to " << statsPrefix << ".csv and " << statsPrefix << ".json" << std::endl;
+}
+
+// --capture: starts capturing right after the context is created, so the trace holds the creation of every GL object
+bool beginCapture()
+{
+    return captureFile.empty() || GlTraceCapture::begin(captureFile, SCR_WIDTH, SCR_HEIGHT);
+}
+
+void endCapture()
+{
+    if (!GlTraceCapture::isCapturing())
+        return;
+    std::cout << GlTraceCapture::getCallCount() << " GL calls in " << GlTraceCapture::getFrameCount() << " frames captured to "
+              << captureFile << " (" << GlTraceCapture::getBytesWritten() << " bytes)" << std::endl;
+    GlTraceCapture::end();
+}
+
+// FNV-1a hash of the pixels of the back buffer before the swap: the same for every replay of the same path on the same driver
+uint64_t hashFramebuffer()
+{
+    std::vector<unsigned char> pixels(SCR_WIDTH*SCR_HEIGHT*4);
+    glReadPixels(0, 0, SCR_WIDTH, SCR_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < pixels.size(); ++i)
+        hash = (hash ^ pixels[i])*1099511628211ull;
+    return hash;
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --record FILE: fly with the mouse and w-a-s-d, the camera of every frame is saved to FILE when the window closes
+    // --replay [FILE]: headless replay of a recorded path (without FILE: a built-in orbit around the grid)
+    // --grid N: N^3 containers (default 12)
+    // --stats PREFIX: write the frame statistics to PREFIX.csv (every frame) and PREFIX.json (percentiles)
+    // --capture FILE: capture all GL calls to FILE (replay it with perf_glreplay FILE)
+    std::string recordFile;
+    std::string replayFile;
+    bool replay = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordFile = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            replay = true;
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+                replayFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc)
+            gridSize = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+            statsPrefix = argv[++i];
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+            captureFile = argv[++i];
+    }
+
+    if (replay)
+        return replayFlythrough(replayFile);
+    return recordFlythrough(recordFile);
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int recordFlythrough(const std::string &pathFile)
+{
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr || !beginCapture())
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeCubeGridScene(gridSize);
+    SceneResources resources(scene, relPathExePro);
+
+    // room for ten minutes at 60 FPS, so recording does not allocate
+    CameraPath path(60*60*10);
+    FrameStats stats;
+    const float startTime = static_cast<float>(glfwGetTime());
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+        stats.beginFrame();
+
+        // input
+        processInput(window);
+
+        // the camera of the frame as it is rendered
+        if (!pathFile.empty())
+            path.record(currentFrame - startTime, camera);
+        renderScene(scene, resources, currentFrame - startTime, stats);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        stats.endFrame();
+        glfwPollEvents();
+    }
+
+    stats.destroy();
+    exportStats(stats);
+    resources.Uniforms.Staging.printCounters(std::cout);
+
+    if (!pathFile.empty() && path.save(pathFile))
+        std::cout << path.getFrameCount() << " frames recorded to " << pathFile << std::endl;
+
+    // de-allocate all resources once they've outlived their purpose:
+    resources.destroy();
+    endCapture();
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int replayFlythrough(const std::string &pathFile)
+{
+    // Headless replay: frame i uses the camera and the time of keyframe i, whatever the frame rate. Every frame ends with
+    // glFinish, so its CPU time includes the wait for the GPU; the hash of the last frame shows that two replays rendered the
+    // same frames
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    CameraPath path;
+    if (pathFile.empty())
+        path = makeOrbitCameraPath(glm::vec3(0.0f, 0.0f, -0.75f*gridSize - 1.25f), 1.2f*gridSize + 4.0f, 240);
+    else if (!path.load(pathFile))
+        return -1;
+    if (path.getFrameCount() == 0)
+    {
+        std::cout << "The camera path is empty" << std::endl;
+        return -1;
+    }
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr || !beginCapture())
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeCubeGridScene(gridSize);
+    SceneResources resources(scene, relPathExePro);
+
+    FrameStats stats(path.getFrameCount());
+    uint64_t hash = 0;
+    for (size_t frame = 0; frame < path.getFrameCount(); ++frame)
+    {
+        stats.beginFrame();
+        path.apply(frame, camera);
+        renderScene(scene, resources, path.getKeyframe(frame).Time, stats);
+        // the back buffer is undefined after the swap, so the last frame is read before it (the readback is part of the
+        // time of that frame)
+        if (frame + 1 == path.getFrameCount())
+            hash = hashFramebuffer();
+        glfwSwapBuffers(window);
+        glFinish();
+        stats.endFrame();
+    }
+    stats.destroy();
+
+    std::cout << "replayed " << path.getFrameCount() << " frames of " << (pathFile.empty() ? "the orbit path" : pathFile) << std::endl;
+    exportStats(stats);
+    resources.Uniforms.Staging.printCounters(std::cout);
+    std::cout << "last frame hash: " << std::hex << hash << std::dec << std::endl;
+
+    resources.destroy();
+    endCapture();
+    glfwTerminate();
+    return 0;
+}
@@ -1,7 +1,6 @@
 #version 330 core
 out vec4 FragColor;
 
-in vec3 ourColor;
 in vec2 TexCoord;
 
 // texture sampler
@@ -15,6 +14,6 @@ void main()
 {
     //FragColor = mix(texture2D(texture1, TexCoord), texture2D(texture2, TexCoord), 0.2);
     FragColor = mix(texture2D(texture1, TexCoord),
-                    texture2D(texture2, vec2(1.0-TexCoord.s, TexCoord.t)),
+                    texture2D(texture2, vec2(TexCoord.s, TexCoord.t)),
                     mixValue);
 }
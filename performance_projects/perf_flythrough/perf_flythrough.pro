@@ -0,0 +1,28 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/stb_image.h \
+    ../../common/shader.h \
+    ../../common/camera.h \
+    ../../common/scene.h \
+    ../../common/camera_path.h \
+    ../../common/frame_stats.h \
+    ../../common/glad/glad_entries.h \
+    ../../common/glad/glad_pixel_bytes.h \
+    ../../common/gl_trace.h \
+    ../../common/uniform_staging.h
+
+DISTFILES += \
+    perf_flythrough.vert \
+    perf_flythrough.frag \
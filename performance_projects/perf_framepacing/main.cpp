@@ -0,0 +1,577 @@
+// Frame pacing for a low input to swap latency: frames are paced to a target frame time with a sleep/spin hybrid wait, the
+// input is sampled as late as possible (just before the camera matrices are built, so the frame still ends at its
+// deadline), the GPU queue depth is limited with fences or glFinish and the swap interval is configurable. Every input
+// event is timestamped in its callback and its latency is measured up to the swap (presentation) of the first frame showing it
+// Use: Shader class and files, camera object, Scene, InputEventQueue, InputState and ActionMap, FramePacer,
+// GpuQueueLimiter, LatencyStats
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+#include <event_queue.h>
+#include <input_state.h>
+#include <frame_pacing.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_framepacing";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // framebuffer size from the framebuffer size events
+    int viewportWidth = SCR_WIDTH;
+    int viewportHeight = SCR_HEIGHT;
+
+    // events recorded by the callbacks, applied when the frame samples its input
+    InputEventQueue inputEvents;
+    InputState input;
+    // times of the events applied in the current frame, for their latency once it is swapped
+    std::vector<double> frameEventTimes;
+
+    // actions of the update and the keys bound to them
+    enum Action
+    {
+        ACTION_QUIT,
+        ACTION_MIX_UP,
+        ACTION_MIX_DOWN,
+        ACTION_FORWARD,
+        ACTION_BACKWARD,
+        ACTION_LEFT,
+        ACTION_RIGHT
+    };
+    const ActionBinding ACTION_BINDINGS[] = {
+        {ACTION_QUIT,     GLFW_KEY_ESCAPE, ACTION_ON_PRESS},
+        {ACTION_MIX_UP,   GLFW_KEY_UP,     ACTION_WHILE_DOWN},
+        {ACTION_MIX_DOWN, GLFW_KEY_DOWN,   ACTION_WHILE_DOWN},
+        {ACTION_FORWARD,  GLFW_KEY_W,      ACTION_WHILE_DOWN},
+        {ACTION_BACKWARD, GLFW_KEY_S,      ACTION_WHILE_DOWN},
+        {ACTION_LEFT,     GLFW_KEY_A,      ACTION_WHILE_DOWN},
+        {ACTION_RIGHT,    GLFW_KEY_D,      ACTION_WHILE_DOWN}
+    };
+    const ActionMap actionMap(ACTION_BINDINGS, sizeof(ACTION_BINDINGS)/sizeof(ACTION_BINDINGS[0]));
+}
+
+// How the frames are paced
+struct PacingOptions
+{
+    double TargetFrameTime;  // seconds per frame, 0: uncapped
+    bool LateSampling;       // wait before sampling the input instead of after the swap
+    GpuQueueMode QueueMode;
+    unsigned QueueDepth;     // frames in flight for GPU_QUEUE_FENCE
+    int SwapInterval;        // glfwSwapInterval: 0 (no vsync), 1 (every vertical blank), ...
+};
+
+// GL objects of the scene: one VAO/VBO per mesh as in the samples, both textures and the shaders of hello_camera_class
+struct SceneResources
+{
+    Shader ShaderProgram;
+    std::vector<GLuint> VAOs;
+    std::vector<GLuint> VBOs;
+    GLuint Textures[2];
+
+    SceneResources(const Scene &scene, const std::string &relPathExePro);
+    void destroy();
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window, uint64_t actions);
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+void processEvents();
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+void renderScene(const Scene &scene, SceneResources &resources, float time);
+void runFrame(GLFWwindow* window, const Scene &scene, SceneResources &resources, const PacingOptions &options,
+              FramePacer &pacer, GpuQueueLimiter &limiter, LatencyStats &latency);
+void cursorEventProducer(std::atomic<bool>* running, double interval);
+
+int drawWithFramePacing(const PacingOptions &options);
+int benchmarkFramePacing();
+
+// process all input: react to the actions triggered by the keyboard snapshot of this frame
+void processInput(GLFWwindow *window, uint64_t actions)
+{
+    if (isActionActive(actions, ACTION_QUIT))
+        glfwSetWindowShouldClose(window, true);
+
+    if (isActionActive(actions, ACTION_MIX_UP))
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (isActionActive(actions, ACTION_MIX_DOWN))
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (isActionActive(actions, ACTION_FORWARD))
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (isActionActive(actions, ACTION_BACKWARD))
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (isActionActive(actions, ACTION_LEFT))
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (isActionActive(actions, ACTION_RIGHT))
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_FRAMEBUFFER_SIZE;
+    event.Time = glfwGetTime();
+    event.Width = width;
+    event.Height = height;
+    inputEvents.push(event);
+}
+
+// glfw: whenever a key is pressed, repeated or released, this callback is called
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_KEY;
+    event.Time = glfwGetTime();
+    event.Key = key;
+    event.Scancode = scancode;
+    event.Action = action;
+    event.Mods = mods;
+    inputEvents.push(event);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_CURSOR_POS;
+    event.Time = glfwGetTime();
+    event.X = xpos;
+    event.Y = ypos;
+    inputEvents.push(event);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_SCROLL;
+    event.Time = glfwGetTime();
+    event.X = xScrollOffset;
+    event.Y = yScrollOffset;
+    inputEvents.push(event);
+}
+
+// applies the queued events in the order they happened and remembers their times
+void processEvents()
+{
+    InputEvent event;
+    while (inputEvents.pop(event))
+    {
+        switch (event.Type)
+        {
+        case INPUT_EVENT_KEY:
+            input.applyKeyEvent(event.Key, event.Action);
+            break;
+        case INPUT_EVENT_CURSOR_POS:
+        {
+            if(firstTimeMouseMoved)
+            {
+                lastX = event.X;
+                lastY = event.Y;
+                firstTimeMouseMoved = false;
+            }
+
+            float xMouseOffset = event.X - lastX;
+            float yMouseOffset = lastY - event.Y;
+            lastX = event.X;
+            lastY = event.Y;
+
+            camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+            break;
+        }
+        case INPUT_EVENT_SCROLL:
+            camera.ProcessMouseScroll(event.Y);
+            break;
+        case INPUT_EVENT_FRAMEBUFFER_SIZE:
+            viewportWidth = event.Width;
+            viewportHeight = event.Height;
+            break;
+        }
+        frameEventTimes.push_back(event.Time);
+    }
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// load image, create texture (RGB or RGBA depending on the file) and generate mipmaps
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+SceneResources::SceneResources(const Scene &scene, const std::string &relPathExePro)
+    : ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str())
+{
+    VAOs.resize(scene.Meshes.size());
+    VBOs.resize(scene.Meshes.size());
+    glGenVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glGenBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    for (size_t i = 0; i < scene.Meshes.size(); ++i)
+    {
+        glBindVertexArray(VAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, scene.Meshes[i].Vertices.size()*sizeof(float), scene.Meshes[i].Vertices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    Textures[0] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[0]);
+    Textures[1] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[1]);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+}
+
+void SceneResources::destroy()
+{
+    glDeleteVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glDeleteBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    glDeleteTextures(2, Textures);
+    glDeleteProgram(ShaderProgram.ID);
+}
+
+// draws the scene with the camera as it is now (every third container rotates over time)
+void renderScene(const Scene &scene, SceneResources &resources, float time)
+{
+    glViewport(0, 0, viewportWidth, viewportHeight);
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // activate texture units and bind them
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[1]);
+
+    // the camera matrices are built from the input sampled just before
+    resources.ShaderProgram.use();
+    resources.ShaderProgram.setFloat("mixValue", mixValueFromKey);
+    resources.ShaderProgram.setMat4("view", camera.GetViewMatrix());
+    resources.ShaderProgram.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT));
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        const SceneObject &object = scene.Objects[i];
+        const SceneMesh &mesh = scene.Meshes[object.Mesh];
+        glm::mat4 model = object.Model;
+        if (i % 3 == 0) // make every third container rotate over time
+            model = glm::rotate(model, time*glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+        resources.ShaderProgram.setMat4("model", model);
+        glBindVertexArray(resources.VAOs[object.Mesh]);
+        glDrawArrays(mesh.Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, 0, mesh.vertexCount());
+    }
+    glBindVertexArray(0);
+}
+
+// One paced frame: [wait] - sample input - update - render - swap - limit the GPU queue - [wait]
+// With late sampling the wait comes first, so the events which arrive while waiting are in this frame instead of the next
+void runFrame(GLFWwindow* window, const Scene &scene, SceneResources &resources, const PacingOptions &options,
+              FramePacer &pacer, GpuQueueLimiter &limiter, LatencyStats &latency)
+{
+    pacer.beginFrame();
+    if (options.LateSampling)
+        pacer.waitForLateStart();
+    pacer.beginWork();
+
+    // per-frame time logic
+    float currentFrame = static_cast<float>(glfwGetTime());
+    deltaTime = currentFrame - lastFrame;
+    lastFrame = currentFrame;
+
+    // input: poll IO events into the event queue and apply them
+    glfwPollEvents();
+    input.nextFrame();
+    processEvents();
+    processInput(window, actionMap.evaluate(input));
+
+    // render
+    renderScene(scene, resources, currentFrame);
+
+    // glfw: swap buffers; a paced frame is shown at its deadline (the vertical blank the target frame time stands for), an
+    // uncapped one right away
+    glfwSwapBuffers(window);
+    double presentTime = glfwGetTime();
+    if (options.TargetFrameTime > 0.0)
+        presentTime += std::max(0.0, pacer.getTimeToDeadline());
+    for (size_t i = 0; i < frameEventTimes.size(); ++i)
+        latency.add(presentTime - frameEventTimes[i]);
+    frameEventTimes.clear();
+
+    limiter.frameSubmitted();
+    pacer.endWork();
+    if (!options.LateSampling)
+        pacer.waitForDeadline();
+}
+
+// Stands in for the window system in the benchmark: a cursor event with its time every interval seconds
+void cursorEventProducer(std::atomic<bool>* running, double interval)
+{
+    double x = 0.0;
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (running->load())
+    {
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+        sleepUntil(next, 0.0);
+        mouse_callback(nullptr, x, 0.0);
+        x += 1.0;
+    }
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --benchmark: headless comparison of the latency of the pacing modes
+    // --fps N: target frame rate (default 60, 0: uncapped), --early: sample the input at the beginning of the frame,
+    // --queue none|fence|finish: GPU queue limit (default fence), --queue-depth N: frames in flight with fences (default 1),
+    // --swap-interval N (default 1)
+    PacingOptions options = {1.0/60.0, true, GPU_QUEUE_FENCE, 1, 1};
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            return benchmarkFramePacing();
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            const double fps = atof(argv[++i]);
+            options.TargetFrameTime = fps > 0.0 ? 1.0/fps : 0.0;
+        }
+        else if (strcmp(argv[i], "--early") == 0)
+            options.LateSampling = false;
+        else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc)
+        {
+            ++i;
+            options.QueueMode = strcmp(argv[i], "none") == 0 ? GPU_QUEUE_UNLIMITED :
+                                strcmp(argv[i], "finish") == 0 ? GPU_QUEUE_FINISH : GPU_QUEUE_FENCE;
+        }
+        else if (strcmp(argv[i], "--queue-depth") == 0 && i + 1 < argc)
+            options.QueueDepth = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--swap-interval") == 0 && i + 1 < argc)
+            options.SwapInterval = std::max(0, atoi(argv[++i]));
+    }
+    return drawWithFramePacing(options);
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawWithFramePacing(const PacingOptions &options)
+{
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSwapInterval(options.SwapInterval);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeContainersScene();
+    SceneResources resources(scene, relPathExePro);
+    frameEventTimes.reserve(InputEventQueue::CAPACITY);
+
+    FramePacer pacer(options.TargetFrameTime);
+    GpuQueueLimiter limiter(options.QueueMode, options.QueueDepth);
+    LatencyStats latency;
+    double lastTitleUpdate = glfwGetTime();
+    int framesSinceTitleUpdate = 0;
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        runFrame(window, scene, resources, options, pacer, limiter, latency);
+
+        ++framesSinceTitleUpdate;
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::ostringstream title;
+            title << "LearnOpenGL - " << static_cast<int>(framesSinceTitleUpdate/(glfwGetTime() - lastTitleUpdate)) << " FPS, "
+                  << std::fixed << std::setprecision(1) << 1000.0*latency.getMean() << " ms input latency";
+            glfwSetWindowTitle(window, title.str().c_str());
+            lastTitleUpdate = glfwGetTime();
+            framesSinceTitleUpdate = 0;
+        }
+    }
+
+    std::cout << latency.getCount() << " input events, input to swap latency " << std::fixed << std::setprecision(2)
+              << 1000.0*latency.getMean() << " ms mean, " << 1000.0*latency.getPercentile(99.0) << " ms p99, "
+              << 1000.0*latency.getMax() << " ms max" << std::endl;
+
+    // de-allocate all resources once they've outlived their purpose:
+    limiter.destroy();
+    resources.destroy();
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkFramePacing()
+{
+    // Benchmark: a producer thread stands in for the window system and timestamps a cursor event every millisecond; the same
+    // frames are run with every pacing mode and the latency from the event to the swap of the frame applying it (at the deadline of a paced frame) is measured
+    //  a) uncapped: no target frame time, the frames follow each other without waiting
+    //  b) classic: poll input, render, swap and then wait for the deadline of the frame (like a swap with vsync)
+    //  c) late sampling: wait first, then poll input, render and swap just before the deadline
+    //  d) late sampling with the GPU queue limited to one frame by a fence
+    //  e) late sampling with glFinish after every swap
+    // The latency ends at the swap: frames the driver queued are not on screen yet, which shows up in the GPU work still queued
+    // at the end of a mode
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+    glfwSwapInterval(0);
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeContainersScene();
+    SceneResources resources(scene, relPathExePro);
+    frameEventTimes.reserve(InputEventQueue::CAPACITY);
+
+    const double target = 1.0/30.0;
+    const int frames = 120;
+    const PacingOptions modes[] = {
+        {0.0,    false, GPU_QUEUE_UNLIMITED, 1, 0},
+        {target, false, GPU_QUEUE_UNLIMITED, 1, 0},
+        {target, true,  GPU_QUEUE_UNLIMITED, 1, 0},
+        {target, true,  GPU_QUEUE_FENCE,     1, 0},
+        {target, true,  GPU_QUEUE_FINISH,    1, 0}
+    };
+    const char* names[] = {"uncapped", "classic (wait after swap)", "late sampling", "late sampling + fence", "late sampling + glFinish"};
+
+    std::cout << frames << " frames per mode, target " << 1000.0*target << " ms per frame (except uncapped), cursor event every 1 ms" << std::endl;
+    std::cout << std::setw(28) << "mode" << std::setw(8) << "FPS" << std::setw(12) << "mean [ms]" << std::setw(12) << "p99 [ms]"
+              << std::setw(12) << "max [ms]" << std::setw(12) << "work [ms]" << std::setw(16) << "wake err [ms]" << std::setw(16) << "GPU wait [ms]" << std::setw(18) << "queued work [ms]" << std::endl;
+    for (size_t mode = 0; mode < sizeof(modes)/sizeof(modes[0]); ++mode)
+    {
+        FramePacer pacer(modes[mode].TargetFrameTime);
+        GpuQueueLimiter limiter(modes[mode].QueueMode, modes[mode].QueueDepth);
+        LatencyStats latency;
+
+        std::atomic<bool> running(true);
+        std::thread producer(cursorEventProducer, &running, 0.001);
+        // warm up the work estimate, then drop the events of the warm up
+        for (int frame = 0; frame < 10; ++frame)
+            runFrame(window, scene, resources, modes[mode], pacer, limiter, latency);
+        latency = LatencyStats();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+            runFrame(window, scene, resources, modes[mode], pacer, limiter, latency);
+        // the frames the driver still has queued count too: without a queue limit the swaps only measure the CPU
+        const std::chrono::steady_clock::time_point drainStart = std::chrono::steady_clock::now();
+        glFinish();
+        const double drain = std::chrono::duration<double>(std::chrono::steady_clock::now() - drainStart).count();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        running.store(false);
+        producer.join();
+        // events still queued belong to no frame
+        InputEvent event;
+        while (inputEvents.pop(event))
+            ;
+
+        std::cout << std::setw(28) << names[mode] << std::fixed << std::setprecision(1) << std::setw(8) << frames/seconds
+                  << std::setprecision(2) << std::setw(12) << 1000.0*latency.getMean() << std::setw(12) << 1000.0*latency.getPercentile(99.0)
+                  << std::setw(12) << 1000.0*latency.getMax() << std::setw(12) << 1000.0*pacer.getWorkEstimate()
+                  << std::setw(16) << 1000.0*pacer.getMeanWakeError() << std::setw(16) << 1000.0*limiter.getWaitTime() << std::setw(18) << 1000.0*drain << std::endl;
+        limiter.destroy();
+    }
+
+    resources.destroy();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,25 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/stb_image.h \
+    ../../common/shader.h \
+    ../../common/camera.h \
+    ../../common/scene.h \
+    ../../common/event_queue.h \
+    ../../common/input_state.h \
+    ../../common/frame_pacing.h
+
+DISTFILES += \
+    perf_framepacing.vert \
+    perf_framepacing.frag \
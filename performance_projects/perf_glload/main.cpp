@@ -0,0 +1,215 @@
+// Startup cost of the OpenGL function loader: gladLoadGLLoader looks up every function of the supported versions and
+// extensions through glfwGetProcAddress, gladLoadGLLoaderLazy only installs trampolines which look a function up on its
+// first call. Both are run repeatedly on the same context with a counting loader, then a small typical workload (a
+// triangle drawn with a shader) shows how many functions a program really resolves and what the first call of a lazily
+// loaded function costs compared to the following ones
+// Use: gladLoadGLLoader, gladLoadGLLoaderLazy
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_glload";
+
+    // loads of every kind (--runs N), the median is reported
+    unsigned runs = 25;
+
+    // calls to glfwGetProcAddress through countingLoader and the time spent in them
+    unsigned loaderCalls = 0;
+    double loaderSeconds = 0.0;
+}
+
+// result of loading the functions once
+struct LoadTime
+{
+    double Time;        // milliseconds in gladLoadGLLoader(Lazy)
+    double LoaderTime;  // milliseconds of it in glfwGetProcAddress
+    unsigned Lookups;   // glfwGetProcAddress calls
+};
+
+GLFWwindow* createWindow();
+void* countingLoader(const char *name);
+LoadTime loadFunctions(bool lazy);
+LoadTime medianLoad(bool lazy);
+uint32_t drawWorkload();
+double callTime(unsigned count);
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // perf_glload [--runs N]
+    for (int i = 1; i < argc; ++i)
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+            runs = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+
+    GLFWwindow* window = createWindow();
+    if (window == nullptr)
+        return -1;
+
+    const LoadTime eager = medianLoad(false);
+    const LoadTime lazy = medianLoad(true);
+    std::cout << "OpenGL " << GLVersion.major << "." << GLVersion.minor << ", " << runs << " loads each (median)" << std::endl;
+    std::cout << std::setw(8) << "loader" << std::setw(12) << "load [ms]" << std::setw(14) << "lookups" << std::setw(18)
+              << "in lookups [ms]" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(8) << "eager" << std::setw(12) << eager.Time << std::setw(14) << eager.Lookups << std::setw(18)
+              << eager.LoaderTime << std::endl;
+    std::cout << std::setw(8) << "lazy" << std::setw(12) << lazy.Time << std::setw(14) << lazy.Lookups << std::setw(18)
+              << lazy.LoaderTime << std::endl;
+
+    // the workload with lazily loaded functions: every function it calls is looked up once
+    loadFunctions(true);
+    loaderCalls = 0;
+    loaderSeconds = 0.0;
+    const uint32_t lazyPixel = drawWorkload();
+    const unsigned resolved = loaderCalls;
+    std::cout << "workload: " << resolved << " functions resolved on first use ("
+              << std::setprecision(3) << loaderSeconds*1000.0 << " ms in lookups)" << std::endl;
+
+    // a function's first call resolves it, the following ones go straight to the driver through the replaced pointer
+    loadFunctions(true);
+    const double firstCall = callTime(1);
+    const double lazyCall = callTime(100000);
+    loadFunctions(false);
+    const double eagerCall = callTime(100000);
+    const uint32_t eagerPixel = drawWorkload();
+    std::cout << "glGetError: first lazy call " << std::setprecision(2) << firstCall*1.0e6 << " us, then "
+              << std::setprecision(1) << lazyCall*1.0e9 << " ns per call (eager: " << eagerCall*1.0e9 << " ns)" << std::endl;
+
+    const bool same = lazyPixel == eagerPixel && glGetError() == GL_NO_ERROR;
+    std::cout << "workload image " << (same ? "identical" : "DIFFERS") << " with both loaders" << std::endl;
+
+    glfwTerminate();
+    return same ? 0 : -1;
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+GLFWwindow* createWindow()
+{
+    // glfw: initialize and configure an invisible window, the loaders are measured on its context
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw window creation
+    GLFWwindow* window = glfwCreateWindow(64, 64, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    return window;
+}
+
+// glfwGetProcAddress, counted and timed
+void* countingLoader(const char *name)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    void *function = reinterpret_cast<void*>(glfwGetProcAddress(name));
+    loaderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++loaderCalls;
+    return function;
+}
+
+LoadTime loadFunctions(bool lazy)
+{
+    loaderCalls = 0;
+    loaderSeconds = 0.0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int loaded = lazy ? gladLoadGLLoaderLazy(countingLoader) : gladLoadGLLoader(countingLoader);
+    LoadTime load;
+    load.Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    load.LoaderTime = loaderSeconds*1000.0;
+    load.Lookups = loaderCalls;
+    if (!loaded)
+        std::cout << "ERROR::GLLOAD::LOADING_FAILED" << std::endl;
+    return load;
+}
+
+LoadTime medianLoad(bool lazy)
+{
+    std::vector<LoadTime> loads;
+    for (unsigned i = 0; i < runs; ++i)
+        loads.push_back(loadFunctions(lazy));
+    std::sort(loads.begin(), loads.end(), [](const LoadTime &a, const LoadTime &b) { return a.Time < b.Time; });
+    return loads[loads.size()/2];
+}
+
+// a typical small program: buffer, vertex array, shader program, uniform, one draw call; returns the center pixel
+uint32_t drawWorkload()
+{
+    const char *vertexSource = "#version 330 core\n"
+                               "layout (location = 0) in vec2 aPos;\n"
+                               "void main() { gl_Position = vec4(aPos, 0.0, 1.0); }\n";
+    const char *fragmentSource = "#version 330 core\n"
+                                 "uniform vec4 color;\n"
+                                 "out vec4 FragColor;\n"
+                                 "void main() { FragColor = color; }\n";
+    const float vertices[] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+
+    GLuint VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexSource, nullptr);
+    glCompileShader(vertex);
+    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fragmentSource, nullptr);
+    glCompileShader(fragment);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+        std::cout << "ERROR::GLLOAD::PROGRAM_LINKING_FAILED" << std::endl;
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    glViewport(0, 0, 64, 64);
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glUseProgram(program);
+    glUniform4f(glGetUniformLocation(program, "color"), 1.0f, 0.5f, 0.25f, 1.0f);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    uint32_t pixel = 0;
+    glReadPixels(32, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+
+    glDeleteProgram(program);
+    glDeleteBuffers(1, &VBO);
+    glDeleteVertexArrays(1, &VAO);
+    return pixel;
+}
+
+// mean time of a glGetError call in seconds
+double callTime(unsigned count)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        glGetError();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()/count;
+}
@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h
@@ -0,0 +1,182 @@
+// Headless replay of GL command traces (GlTraceCapture, e.g. perf_flythrough --capture FILE): the recorded calls run again
+// in an invisible window of the recorded size and GL version, frame by frame, so slow frames of an application can be
+// examined on a machine without it. Frame times go into FrameStats; with --timing every call is timed and the functions
+// which took the most time and the slowest frames are listed
+// Use: GlTraceReplayer, FrameStats
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gl_trace.h>
+#include <frame_stats.h>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_glreplay";
+
+    // replay options
+    bool timing = false;        // --timing: time every call
+    bool finishFrames = false;  // --finish: glFinish after every frame, so the frame times include the GPU
+    unsigned topCount = 15;     // --top N: functions and frames listed
+    std::string statsPrefix;    // --stats PREFIX: frame statistics written to PREFIX.csv and PREFIX.json
+}
+
+// one replayed frame for the list of the slowest frames
+struct ReplayedFrame
+{
+    uint64_t Index;
+    double Time;        // milliseconds
+    double CallTime;    // milliseconds spent in the GL calls (--timing)
+    uint64_t Calls;
+    unsigned DrawCalls;
+};
+
+GLFWwindow* createWindow(const GlTraceHeader &header);
+void printTiming(const GlTraceReplayer &replayer, std::vector<ReplayedFrame> frames);
+uint64_t hashFramebuffer(unsigned width, unsigned height);
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // perf_glreplay TRACE [--timing] [--finish] [--top N] [--stats PREFIX]
+    std::string traceFile;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--timing") == 0)
+            timing = true;
+        else if (strcmp(argv[i], "--finish") == 0)
+            finishFrames = true;
+        else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+            topCount = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+            statsPrefix = argv[++i];
+        else
+            traceFile = argv[i];
+    }
+    if (traceFile.empty())
+    {
+        std::cout << "Usage: " << project_name << " TRACE [--timing] [--finish] [--top N] [--stats PREFIX]" << std::endl;
+        return -1;
+    }
+
+    GlTraceReplayer replayer;
+    if (!replayer.load(traceFile))
+        return -1;
+    const GlTraceHeader &header = replayer.getHeader();
+
+    GLFWwindow* window = createWindow(header);
+    if (window == nullptr)
+        return -1;
+    replayer.setTiming(timing);
+
+    // the calls before the first frame (loading) are reported on their own
+    GlTraceFrame frame;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    replayer.replayFrame(frame);
+    const double setupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "setup: " << frame.Calls << " calls, " << frame.PayloadBytes << " bytes of data in "
+              << std::fixed << std::setprecision(2) << setupTime << " ms" << std::endl;
+
+    FrameStats stats(16384, false);
+    std::vector<ReplayedFrame> frames;
+    uint64_t totalCalls = frame.Calls;
+    uint64_t hash = 0;
+    for (;;)
+    {
+        stats.beginFrame();
+        start = std::chrono::steady_clock::now();
+        if (!replayer.replayFrame(frame))
+            break;
+        // read where perf_flythrough reads it: after the calls of the last frame, before anything else touches the buffer
+        if (replayer.isAtEnd())
+            hash = hashFramebuffer(header.Width, header.Height);
+        if (finishFrames)
+            glFinish();
+        ReplayedFrame replayed;
+        replayed.Index = frames.size() + 1;
+        replayed.Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        replayed.CallTime = frame.CallTime*1000.0;
+        replayed.Calls = frame.Calls;
+        replayed.DrawCalls = frame.DrawCalls;
+        frames.push_back(replayed);
+        totalCalls += frame.Calls;
+        stats.addDrawCalls(frame.DrawCalls);
+        stats.addBytesUploaded(frame.PayloadBytes);
+        stats.endFrame();
+    }
+    const bool failed = replayer.hasFailed();
+
+    std::cout << "replayed " << totalCalls << " calls in " << frames.size() << " frames of " << traceFile << " ("
+              << header.Width << "x" << header.Height << ", OpenGL " << header.GLMajor << "." << header.GLMinor << ")"
+              << (failed ? " until an error" : "") << std::endl;
+    stats.printSummary(std::cout);
+    if (replayer.getMismatchedNames() > 0)
+        std::cout << replayer.getMismatchedNames() << " object names differ from the capture: the replay may not be faithful" << std::endl;
+    if (timing)
+        printTiming(replayer, frames);
+    if (!statsPrefix.empty() && stats.writeCsv(statsPrefix + ".csv") && stats.writeJson(statsPrefix + ".json"))
+        std::cout << "frame statistics written to " << statsPrefix << ".csv and " << statsPrefix << ".json" << std::endl;
+    std::cout << "last frame hash: " << std::hex << hash << std::dec << std::endl;
+
+    stats.destroy();
+    glfwTerminate();
+    return failed ? -1 : 0;
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+// glfw + glad: an invisible window like the one of the capture
+GLFWwindow* createWindow(const GlTraceHeader &header)
+{
+    return createGLWindow(static_cast<int>(header.Width), static_cast<int>(header.Height), "LearnOpenGL", false,
+                          static_cast<int>(header.GLMajor), static_cast<int>(header.GLMinor));
+}
+
+// the functions with the most time in their calls and the slowest frames
+void printTiming(const GlTraceReplayer &replayer, std::vector<ReplayedFrame> frames)
+{
+    std::vector<GlTraceCallStats> calls(replayer.getCallStats());
+    double total = 0.0;
+    for (size_t i = 0; i < calls.size(); ++i)
+        total += calls[i].Seconds;
+    std::sort(calls.begin(), calls.end(), [](const GlTraceCallStats &a, const GlTraceCallStats &b) { return a.Seconds > b.Seconds; });
+
+    std::cout << "time in GL calls: " << std::fixed << std::setprecision(2) << total*1000.0 << " ms" << std::endl;
+    std::cout << std::setw(36) << std::left << "function" << std::right << std::setw(12) << "calls" << std::setw(12)
+              << "total [ms]" << std::setw(12) << "mean [us]" << std::setw(8) << "%" << std::endl;
+    for (size_t i = 0; i < calls.size() && i < topCount && calls[i].Calls > 0; ++i)
+        std::cout << std::setw(36) << std::left << calls[i].Name << std::right << std::setw(12) << calls[i].Calls
+                  << std::setw(12) << calls[i].Seconds*1000.0 << std::setw(12) << calls[i].Seconds*1.0e6/calls[i].Calls
+                  << std::setw(8) << (total > 0.0 ? 100.0*calls[i].Seconds/total : 0.0) << std::endl;
+
+    std::sort(frames.begin(), frames.end(), [](const ReplayedFrame &a, const ReplayedFrame &b) { return a.Time > b.Time; });
+    std::cout << "slowest frames:" << std::endl;
+    std::cout << std::setw(8) << "frame" << std::setw(12) << "time [ms]" << std::setw(12) << "calls [ms]" << std::setw(10)
+              << "calls" << std::setw(8) << "draws" << std::endl;
+    for (size_t i = 0; i < frames.size() && i < topCount; ++i)
+        std::cout << std::setw(8) << frames[i].Index << std::setw(12) << frames[i].Time << std::setw(12) << frames[i].CallTime
+                  << std::setw(10) << frames[i].Calls << std::setw(8) << frames[i].DrawCalls << std::endl;
+}
+
+// FNV-1a hash of the pixels of the back buffer after the last frame of the trace (as perf_flythrough --replay prints it,
+// read before its swap)
+uint64_t hashFramebuffer(unsigned width, unsigned height)
+{
+    std::vector<unsigned char> pixels(width*height*4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < pixels.size(); ++i)
+        hash = (hash ^ pixels[i])*1099511628211ull;
+    return hash;
+}
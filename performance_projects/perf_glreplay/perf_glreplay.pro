@@ -0,0 +1,18 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/glad/glad_entries.h \
+    ../../common/glad/glad_pixel_bytes.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/gl_trace.h \
+    ../../common/frame_stats.h
@@ -0,0 +1,417 @@
+// Cull a large number of cubes against the camera frustum on the GPU with a compute shader which writes the indirect draw arguments
+// Use: Shader class and files (vertex, fragment and compute), MeshPool, GpuFrustumCuller (shader storage buffers, atomic append,
+//      glDrawElementsIndirect), camera object and frustum
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <gpu_culling.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_gpuculling";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // the cubes are scattered in a box of this half size around the origin
+    const float SCENE_HALF_SIZE = 100.0f;
+    const float FAR_PLANE = 150.0f;
+}
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path, GLenum format);
+void buildScene(GLuint cubeCount, std::vector<glm::mat4> &models, std::vector<ObjectBounds> &bounds);
+GLuint countVisibleOnCpu(const Frustum &frustum, const std::vector<ObjectBounds> &bounds);
+
+int drawGpuCulledCubes();
+int testGpuCulling();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 4.3 core context (needed for compute shaders) and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible, 4, 3);
+    if (window == nullptr)
+        return nullptr;
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+    if (!GLAD_GL_ARB_compute_shader || !GLAD_GL_ARB_shader_storage_buffer_object || !GLAD_GL_ARB_draw_indirect)
+    {
+        std::cout << "GL_ARB_compute_shader, GL_ARB_shader_storage_buffer_object and GL_ARB_draw_indirect are required" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+
+    return window;
+}
+
+// load image, create texture and generate mipmaps
+GLuint loadTexture(const std::string &path, GLenum format)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Scatters cubeCount unit cubes with random positions and rotations and computes their world space bounding boxes
+void buildScene(GLuint cubeCount, std::vector<glm::mat4> &models, std::vector<ObjectBounds> &bounds)
+{
+    srand(42); // same scene for every run
+    models.resize(cubeCount);
+    bounds.resize(cubeCount);
+    for (GLuint i = 0; i < cubeCount; ++i)
+    {
+        glm::vec3 position(SCENE_HALF_SIZE*(2.0f*rand()/RAND_MAX - 1.0f),
+                           SCENE_HALF_SIZE*(2.0f*rand()/RAND_MAX - 1.0f),
+                           SCENE_HALF_SIZE*(2.0f*rand()/RAND_MAX - 1.0f));
+        glm::vec3 axis(1.0f*rand()/RAND_MAX, 1.0f*rand()/RAND_MAX, 1.0f*rand()/RAND_MAX + 0.1f);
+
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(360.0f*rand()/RAND_MAX), glm::normalize(axis));
+        models[i] = model;
+
+        // the box enclosing the rotated unit cube: every axis gets the projected half sizes of the 3 rotated cube axes
+        glm::mat3 rotation(model);
+        glm::vec3 extents(0.0f);
+        for (int column = 0; column < 3; ++column)
+            extents += 0.5f*glm::abs(rotation[column]);
+        bounds[i].Center = glm::vec4(position, 1.0f);
+        bounds[i].Extents = glm::vec4(extents, 0.0f);
+    }
+}
+
+// Reference result of the culling pass
+GLuint countVisibleOnCpu(const Frustum &frustum, const std::vector<ObjectBounds> &bounds)
+{
+    GLuint visible = 0;
+    for (size_t i = 0; i < bounds.size(); ++i)
+        if (frustum.IntersectsAABB(glm::vec3(bounds[i].Center), glm::vec3(bounds[i].Extents)))
+            ++visible;
+    return visible;
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --test: headless check of the GPU result against the CPU frustum test (also runs on Mesa llvmpipe without a GPU,
+    //         e.g. LIBGL_ALWAYS_SOFTWARE=1 ./perf_gpuculling --test), followed by the CPU cost per frame for growing object counts
+    if (argc > 1 && strcmp(argv[1], "--test") == 0)
+        return testGpuCulling();
+    return drawGpuCulledCubes();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawGpuCulledCubes()
+{
+    // Drawing cubes scattered around the camera; only the cubes inside the view frustum (found by the compute shader)
+    // are drawn with one indirect draw call
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader programs
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    GpuFrustumCuller culler((relPathExePro+project_name+".comp").c_str());
+
+    const GLuint cubeCount = 100000;
+    std::vector<glm::mat4> models;
+    std::vector<ObjectBounds> bounds;
+    buildScene(cubeCount, models, bounds);
+
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+    pool.setInstanceData(models); // allocates room for every cube being visible
+    culler.setObjects(bounds, models);
+    culler.setOutput(cube, pool.InstanceVBO);
+
+    // load and create multiple textures
+    GLuint textures[2];
+    textures[0] = loadTexture(relPathExePro+"../../common/resources/textures/container.jpg", GL_RGB);
+    textures[1] = loadTexture(relPathExePro+"../../common/resources/textures/awesomeface.png", GL_RGBA);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        // culling: fills the instances and the instance count of the draw record
+        culler.cull(camera.GetFrustum(aspectRatio, 0.1f, FAR_PLANE));
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", camera.GetViewMatrix());
+        ShaderProgram.setMat4("projection", camera.GetProjectionMatrix(aspectRatio, 0.1f, FAR_PLANE));
+
+        pool.bind();
+        culler.draw();
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    culler.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int testGpuCulling()
+{
+    // 1. the number of instances written by the compute shader has to match the CPU frustum test for a set of camera poses
+    // 2. CPU time per frame (reset + dispatch + indirect draw) for growing object counts, which should stay constant
+    //    (on Mesa llvmpipe the compute shader and the draw run on the CPU inside the GL calls, so there it grows)
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+
+    glEnable(GL_DEPTH_TEST);
+
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    GpuFrustumCuller culler((relPathExePro+project_name+".comp").c_str());
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+
+    std::vector<glm::mat4> models;
+    std::vector<ObjectBounds> bounds;
+    buildScene(200000, models, bounds);
+
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+    pool.setInstanceData(models);
+    culler.setObjects(bounds, models);
+    culler.setOutput(cube, pool.InstanceVBO);
+
+    // camera poses: position, yaw, pitch
+    const glm::vec3 positions[] = { glm::vec3(0.0f), glm::vec3(50.0f, 10.0f, -20.0f), glm::vec3(-90.0f, 0.0f, 90.0f), glm::vec3(0.0f, 200.0f, 0.0f) };
+    const float yaws[] = { -90.0f, 0.0f, 45.0f, -90.0f };
+    const float pitches[] = { 0.0f, 30.0f, -10.0f, -89.0f };
+
+    int failures = 0;
+    for (int pose = 0; pose < 4; ++pose)
+    {
+        Camera testCamera(positions[pose], glm::vec3(0.0f, 1.0f, 0.0f), yaws[pose], pitches[pose]);
+        Frustum frustum = testCamera.GetFrustum(aspectRatio, 0.1f, FAR_PLANE);
+
+        culler.cull(frustum);
+        GLuint gpuVisible = culler.readVisibleCount();
+        GLuint cpuVisible = countVisibleOnCpu(frustum, bounds);
+
+        // the culled instances must also be drawable
+        ShaderProgram.use();
+        ShaderProgram.setMat4("view", testCamera.GetViewMatrix());
+        ShaderProgram.setMat4("projection", testCamera.GetProjectionMatrix(aspectRatio, 0.1f, FAR_PLANE));
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        pool.bind();
+        culler.draw();
+        glBindVertexArray(0);
+        glFinish();
+        GLenum error = glGetError();
+
+        bool passed = gpuVisible == cpuVisible && error == GL_NO_ERROR;
+        if (!passed)
+            ++failures;
+        std::cout << "pose " << pose << ": visible gpu " << gpuVisible << ", cpu " << cpuVisible
+                  << ", gl error 0x" << std::hex << error << std::dec << (passed ? "  OK" : "  FAILED") << std::endl;
+    }
+
+    // CPU cost of culling + drawing for growing object counts (the visible set is read back nowhere)
+    std::cout << std::endl << std::setw(10) << "objects" << std::setw(20) << "cpu per frame [ms]" << std::setw(20) << "visible" << std::endl;
+    const GLuint objectCounts[] = {1000, 10000, 100000, 1000000};
+    for (GLuint objectCount : objectCounts)
+    {
+        buildScene(objectCount, models, bounds);
+        pool.setInstanceData(models);
+        culler.setObjects(bounds, models);
+
+        Frustum frustum = camera.GetFrustum(aspectRatio, 0.1f, FAR_PLANE);
+        const int frames = 20;
+        double cpuTime = 0.0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            auto start = std::chrono::steady_clock::now();
+            culler.cull(frustum);
+            ShaderProgram.use();
+            pool.bind();
+            culler.draw();
+            glBindVertexArray(0);
+            cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            glFinish();
+        }
+        std::cout << std::setw(10) << objectCount << std::setw(20) << std::fixed << std::setprecision(4) << cpuTime/frames
+                  << std::setw(20) << culler.readVisibleCount() << std::endl;
+    }
+
+    pool.destroy();
+    culler.destroy();
+    glfwTerminate();
+
+    std::cout << (failures == 0 ? "GPU frustum culling test passed" : "GPU frustum culling test FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
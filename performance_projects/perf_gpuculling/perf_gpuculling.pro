@@ -0,0 +1,24 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/stb_image.h \
+    ../../common/shader.h \
+    ../../common/camera.h \
+    ../../common/mesh_pool.h \
+    ../../common/gpu_culling.h
+
+DISTFILES += \
+    perf_gpuculling.vert \
+    perf_gpuculling.frag \
+    perf_gpuculling.comp \
@@ -0,0 +1,464 @@
+// Shader hot reload: a grid of containers is drawn with shaders generated into a folder (a vertex shader including a large
+// pattern module, a fragment shader including a tint); edit and save any of the files while the program runs and it is recompiled and
+// swapped in without a restart (ShaderHotReloader). The watcher thread gets the changes from inotify, the programs are
+// compiled and linked on a thread with a context sharing the objects of the window's, and a program is only swapped in
+// between two frames after it linked: a shader with an error keeps the last working program.
+// Run with --benchmark for a headless comparison of the frame times while reloads run against a blocking recompile
+// Use: Shader class, ShaderHotReloader, ShaderFileWatcher, Scene, FrameStats
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <shader.h>
+#include <shader_reload.h>
+#include <scene.h>
+#include <frame_stats.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_hotreload";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    // shader settings
+    std::string shaderDir = "hotreload_shaders";  // --dir DIR: where the shaders are generated (existing files are kept)
+    unsigned patternFunctions = 80;               // --functions N: size of the pattern module, for the compile time
+
+    // scene settings
+    unsigned gridSize = 5;                        // --grid N: containers per side of the grid
+
+    // benchmark settings
+    unsigned benchmarkFrames = 360;               // --frames N: frames of every mode
+    double frameRate = 60.0;                      // --fps N: frames are paced to this rate (0: back to back)
+
+    // the tints the benchmark saves, the second one with a syntax error
+    const char *TINT_EDITS[] = {
+        "const vec3 TINT = vec3(0.4, 0.8, 1.0);\n",
+        "const vec3 TINT = vec3(0.4, 0.8;\n",
+        "const vec3 TINT = vec3(1.0, 0.4, 0.4);\n"
+    };
+    const char *INITIAL_TINT = "const vec3 TINT = vec3(1.0, 0.9, 0.6);\n";
+
+    constexpr UniformName MODEL("model");
+    constexpr UniformName VIEW("view");
+    constexpr UniformName PROJECTION("projection");
+    constexpr UniformName DETAIL("detail");
+}
+
+// GL objects of the grid: the cube mesh and the program of the generated shaders
+struct GridResources
+{
+    GLuint VAO;
+    GLuint VBO;
+    unsigned VertexCount;
+    Shader ShaderProgram;
+
+    GridResources(const Scene &scene, const std::string &vertexPath, const std::string &fragmentPath);
+    void destroy();
+};
+
+// frame times of one benchmark mode: the frames from saving a file to the swap (reload frames) and the others
+struct ReloadRun
+{
+    FrameStats SteadyFrames;
+    FrameStats ReloadFrames;
+    std::vector<double> Latencies;   // milliseconds from saving a file to the swap of a program which linked
+    uint64_t Reloads;
+    uint64_t Failures;
+    double CompileTime;
+
+    ReloadRun() : SteadyFrames(benchmarkFrames, false), ReloadFrames(benchmarkFrames, false), Reloads(0), Failures(0),
+        CompileTime(0.0)
+    {
+    }
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+GLFWwindow* createWindow(bool visible);
+bool generateShaders(bool overwrite);
+bool writeFile(const std::string &path, const std::string &text, bool overwrite);
+std::string uniqueComment();
+std::string vertexPath();
+std::string fragmentPath();
+std::string tintPath();
+void renderGrid(const Scene &scene, GridResources &resources, float time);
+void warmUpGrid(const GridResources &resources);
+int benchmarkHotReload();
+bool runBenchmark(GLFWwindow *window, const Scene &scene, bool background, ReloadRun &run);
+void printRun(const char *name, const ReloadRun &run);
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // perf_hotreload [--dir DIR] [--functions N] [--grid N] [--benchmark [--frames N] [--fps N]]
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+        else if (i + 1 < argc && strcmp(argv[i], "--dir") == 0)
+            shaderDir = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--functions") == 0)
+            patternFunctions = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        else if (i + 1 < argc && strcmp(argv[i], "--grid") == 0)
+            gridSize = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        else if (i + 1 < argc && strcmp(argv[i], "--frames") == 0)
+            benchmarkFrames = static_cast<unsigned>(std::max(8, atoi(argv[++i])));
+        else if (i + 1 < argc && strcmp(argv[i], "--fps") == 0)
+            frameRate = std::max(0.0, atof(argv[++i]));
+    }
+    if (benchmark)
+        return benchmarkHotReload();
+
+    if (!generateShaders(false))
+        return -1;
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeCubeGridScene(gridSize);
+    GridResources resources(scene, vertexPath(), fragmentPath());
+    ShaderHotReloader reloader;
+    reloader.setWarmUp([&resources](GLuint) { warmUpGrid(resources); });
+    if (!reloader.start(window))
+    {
+        glfwTerminate();
+        return -1;
+    }
+    reloader.add(resources.ShaderProgram, vertexPath(), fragmentPath());
+    std::cout << "Edit and save the shaders in " << shaderDir << "/ (e.g. the TINT in " << tintPath() << ")" << std::endl;
+
+    // render loop
+    // -----------
+    while (!glfwWindowShouldClose(window))
+    {
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+
+        if (reloader.update() > 0)
+            std::cout << "reloaded " << shaderDir << " (compiled in " << reloader.getLastCompileTime() << " ms)" << std::endl;
+        renderGrid(scene, resources, static_cast<float>(glfwGetTime()));
+
+        const std::string title = "LearnOpenGL - " + std::to_string(reloader.getReloadCount()) + " reloads, " +
+            std::to_string(reloader.getFailureCount()) + " failed" + (reloader.isReloading() ? ", compiling" : "");
+        glfwSetWindowTitle(window, title.c_str());
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    reloader.stop();
+    resources.destroy();
+    glfwTerminate();
+    return 0;
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// DIR/hotreload.vert, DIR/hotreload.frag and the modules they include: DIR/lib/pattern.glsl (vertex shader), a chain of
+// patternFunctions functions which makes it slow to compile, and DIR/lib/tint.glsl (fragment shader), the constant the
+// benchmark edits. Files which exist are only replaced with overwrite, so the edits of an interactive session survive a
+// restart
+bool generateShaders(bool overwrite)
+{
+    mkdir(shaderDir.c_str(), 0755);
+    mkdir((shaderDir + "/lib").c_str(), 0755);
+
+    std::string pattern = "// a chain of smooth waves, mixed in by detail (it is here for its compile time)\n"
+                          "vec3 pattern0(vec3 v)\n{\n    return v;\n}\n\n";
+    for (unsigned function = 1; function < patternFunctions; ++function)
+        pattern += "vec3 pattern" + std::to_string(function) + "(vec3 v)\n{\n"
+                   "    vec3 wave = sin(v*" + std::to_string(function % 7 + 1) + ".0 + vec3(0.5, 0.25, 0.125));\n"
+                   "    return pattern" + std::to_string(function - 1) + "(mix(v, wave*0.5 + 0.5, " +
+                   std::to_string(function % 5 + 1) + ".0/16.0));\n}\n\n";
+    pattern += "vec3 pattern(vec3 v, float detail)\n{\n    return mix(v, pattern" + std::to_string(patternFunctions - 1) +
+               "(v), detail);\n}\n";
+
+    return writeFile(vertexPath(),
+                     "#version 330 core\n"
+                     "layout (location = 0) in vec3 aPos;\n"
+                     "layout (location = 1) in vec2 aTexCoord;\n\n"
+                     "out vec3 Color;\n\n"
+                     "uniform mat4 model;\n"
+                     "uniform mat4 view;\n"
+                     "uniform mat4 projection;\n"
+                     "uniform float detail;\n\n"
+                     "#include \"lib/pattern.glsl\"\n\n"
+                     "void main()\n{\n"
+                     "    Color = pattern(vec3(aTexCoord, aPos.z + 0.5), detail);\n"
+                     "    gl_Position = projection*view*model*vec4(aPos, 1.0);\n}\n", overwrite) &&
+           writeFile(fragmentPath(),
+                     "#version 330 core\n"
+                     "in vec3 Color;\n\n"
+                     "out vec4 FragColor;\n\n"
+                     "#include \"lib/tint.glsl\"\n\n"
+                     "void main()\n{\n"
+                     "    FragColor = vec4(TINT*Color, 1.0);\n}\n", overwrite) &&
+           writeFile(tintPath(), INITIAL_TINT + uniqueComment(), overwrite) &&
+           writeFile(shaderDir + "/lib/pattern.glsl", pattern + uniqueComment(), overwrite);
+}
+
+bool writeFile(const std::string &path, const std::string &text, bool overwrite)
+{
+    struct stat status;
+    if (!overwrite && stat(path.c_str(), &status) == 0)
+        return true;
+    std::ofstream file(path.c_str());
+    file << text;
+    file.close();
+    if (!file)
+    {
+        std::cout << "ERROR::HOTRELOAD::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// a comment which makes the source new to the driver: a shader cache (Mesa keeps one on disk) would otherwise hand the
+// benchmark the programs compiled by an earlier run
+std::string uniqueComment()
+{
+    return "// " + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "\n";
+}
+
+std::string vertexPath()
+{
+    return shaderDir + "/hotreload.vert";
+}
+
+std::string fragmentPath()
+{
+    return shaderDir + "/hotreload.frag";
+}
+
+std::string tintPath()
+{
+    return shaderDir + "/lib/tint.glsl";
+}
+
+GridResources::GridResources(const Scene &scene, const std::string &vertexPath, const std::string &fragmentPath)
+    : VertexCount(scene.Meshes[0].vertexCount()), ShaderProgram(vertexPath.c_str(), fragmentPath.c_str())
+{
+    // the cube of the grid (mesh 0), the coordinate axes are left out
+    const SceneMesh &cube = scene.Meshes[0];
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, cube.Vertices.size()*sizeof(float), cube.Vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GridResources::destroy()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteProgram(ShaderProgram.ID);
+}
+
+// draws the containers of the grid seen from a camera circling around it; the uniforms are set every frame, so a program
+// swapped in gets them without a callback
+void renderGrid(const Scene &scene, GridResources &resources, float time)
+{
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const glm::vec3 center(0.0f, 0.0f, -0.75f*gridSize - 1.25f);
+    const float radius = 1.2f*gridSize + 4.0f;
+    const glm::vec3 eye = center + glm::vec3(radius*std::sin(0.3f*time), 0.3f*radius, radius*std::cos(0.3f*time));
+    resources.ShaderProgram.use();
+    resources.ShaderProgram.setMat4(VIEW, glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f)));
+    resources.ShaderProgram.setMat4(PROJECTION, glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 200.0f));
+    resources.ShaderProgram.setFloat(DETAIL, 0.25f);
+    glBindVertexArray(resources.VAO);
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+        if (scene.Objects[i].Mesh == 0)
+        {
+            resources.ShaderProgram.setMat4(MODEL, scene.Objects[i].Model);
+            glDrawArrays(GL_TRIANGLES, 0, resources.VertexCount);
+        }
+    glBindVertexArray(0);
+}
+
+// on the compile thread of the reloader: one container drawn with a new program and the state of renderGrid into the
+// (hidden) framebuffer of the thread's context, so the driver generates the program's code there and not in the frame
+// which swaps it in
+void warmUpGrid(const GridResources &resources)
+{
+    // vertex arrays aren't shared between contexts, every compile thread makes its own for the shared VBO
+    thread_local GLuint VAO = 0;
+    if (VAO == 0)
+    {
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, resources.VBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glEnable(GL_DEPTH_TEST);
+    }
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, resources.VertexCount);
+    glBindVertexArray(0);
+}
+
+int benchmarkHotReload()
+{
+    // Headless: the same frames are drawn twice, with the reloads compiled on the thread with the shared context and with
+    // the compile in update() on the drawing thread. Both save the three TINT_EDITS (the second one doesn't compile) and
+    // compare the frame times from each save to its swap with the other frames. Every frame ends with glFinish, so its
+    // CPU time includes the wait for the GPU, and is paced to frameRate so the compile thread finds idle time as it would
+    // next to a vsynced frame loop
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+    Scene scene = makeCubeGridScene(gridSize);
+
+    std::cout << "perf_hotreload benchmark: " << benchmarkFrames << " frames per mode at " << frameRate << " fps, "
+              << gridSize*gridSize*gridSize << " containers, " << patternFunctions << " pattern functions; "
+              << sizeof(TINT_EDITS)/sizeof(TINT_EDITS[0]) << " saves of " << tintPath()
+              << " (the compile error of the second is expected)" << std::endl;
+    ReloadRun background, blocking;
+    const bool passed = runBenchmark(window, scene, true, background) && runBenchmark(window, scene, false, blocking);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(20) << "[ms]" << std::setw(8) << "frames" << std::setw(8) << "p50" << std::setw(8) << "p99"
+              << std::setw(9) << "max" << "   reload frames" << std::setw(7) << "p50" << std::setw(8) << "p99"
+              << std::setw(9) << "max" << "   latency   compile" << std::endl;
+    printRun("shared context", background);
+    printRun("blocking", blocking);
+
+    glfwTerminate();
+    return passed ? 0 : -1;
+}
+
+// renders benchmarkFrames frames while the tint is saved three times; true if exactly the two good saves were swapped in
+bool runBenchmark(GLFWwindow *window, const Scene &scene, bool background, ReloadRun &run)
+{
+    if (!generateShaders(true))
+        return false;
+    GridResources resources(scene, vertexPath(), fragmentPath());
+    ShaderHotReloader reloader;
+    reloader.setWarmUp([&resources](GLuint) { warmUpGrid(resources); });
+    if (!reloader.start(window, background))
+        return false;
+    reloader.add(resources.ShaderProgram, vertexPath(), fragmentPath());
+
+    // the first draw of the program generates its code, not a frame of the benchmark
+    renderGrid(scene, resources, 0.0f);
+    glFinish();
+
+    const unsigned editCount = sizeof(TINT_EDITS)/sizeof(TINT_EDITS[0]);
+    unsigned edits = 0;
+    bool reloading = false;
+    std::chrono::steady_clock::time_point saved;
+    const std::chrono::steady_clock::duration frameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(frameRate > 0.0 ? 1.0/frameRate : 0.0));
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+    for (unsigned frame = 0; frame < benchmarkFrames; ++frame)
+    {
+        // save the next edit at 1/8, 3/8 and 5/8 of the frames
+        if (edits < editCount && frame == (2*edits + 1)*benchmarkFrames/8)
+        {
+            if (!writeFile(tintPath(), TINT_EDITS[edits++] + uniqueComment(), true))
+                return false;
+            saved = std::chrono::steady_clock::now();
+            reloading = true;
+        }
+        deadline += frameTime;
+
+        // a frame belongs to the reload from the save up to the one which swaps the program in (or fails)
+        FrameStats &stats = reloading ? run.ReloadFrames : run.SteadyFrames;
+        stats.beginFrame();
+        const uint64_t done = reloader.getReloadCount() + reloader.getFailureCount();
+        if (reloader.update() > 0)
+            run.Latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - saved).count());
+        if (reloader.getReloadCount() + reloader.getFailureCount() > done && !reloader.isReloading())
+            reloading = false;
+        renderGrid(scene, resources, frame/60.0f);
+        glfwSwapBuffers(window);
+        glFinish();
+        stats.endFrame();
+
+        std::this_thread::sleep_until(deadline);
+    }
+    // the last reload may still be running
+    for (unsigned wait = 0; wait < 500 && reloader.isReloading(); ++wait)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        reloader.update();
+    }
+
+    run.Reloads = reloader.getReloadCount();
+    run.Failures = reloader.getFailureCount();
+    run.CompileTime = reloader.getLastCompileTime();
+    reloader.stop();
+    resources.destroy();
+    if (run.Reloads != 2 || run.Failures != 1)
+    {
+        std::cout << "ERROR::HOTRELOAD::UNEXPECTED_RELOADS: " << run.Reloads << " swapped, " << run.Failures << " failed"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void printRun(const char *name, const ReloadRun &run)
+{
+    const DurationHistogram &steady = run.SteadyFrames.getCpuHistogram();
+    const DurationHistogram &reload = run.ReloadFrames.getCpuHistogram();
+    double latency = 0.0;
+    for (size_t i = 0; i < run.Latencies.size(); ++i)
+        latency = std::max(latency, run.Latencies[i]);
+    std::cout << std::setw(20) << name << std::setw(8) << steady.getCount() << std::setw(8) << steady.getPercentile(50.0)
+              << std::setw(8) << steady.getPercentile(99.0) << std::setw(9) << steady.getMax() << std::setw(16)
+              << reload.getCount() << std::setw(7) << reload.getPercentile(50.0) << std::setw(8)
+              << reload.getPercentile(99.0) << std::setw(9) << reload.getMax() << std::setw(10) << latency
+              << std::setw(10) << run.CompileTime << std::endl;
+}
@@ -0,0 +1,21 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/shader.h \
+    ../../common/mapped_file.h \
+    ../../common/shader_source.h \
+    ../../common/uniform_name.h \
+    ../../common/shader_reload.h \
+    ../../common/scene.h \
+    ../../common/frame_stats.h
@@ -0,0 +1,511 @@
+// Spread the per-frame work of a scene with a large number of containers (transforms, frustum culling) and the decoding of
+// textures over all cores with a job system, while all OpenGL calls stay on the main thread
+// Use: Shader class and files, MeshPool with instanced model matrices, camera object and frustum, JobSystem (work-stealing
+//      deques, parallelFor, counters and dependencies between jobs)
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <job_system.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_jobs";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // containers per side of the cubic grid and indices per job of the parallel loops
+    const unsigned GRID_SIZE = 48;
+    const size_t GRAIN = 1024;
+    const float FAR_PLANE = 150.0f;
+}
+
+// Per-frame data of the containers: positions are fixed, model matrices are rebuilt every frame (every third container
+// rotates over time as in hello_coordinatesystem) and the visible ones are appended to Visible
+struct CubeField
+{
+    std::vector<glm::vec3> Positions;
+    std::vector<glm::mat4> Models;
+    std::vector<glm::mat4> Visible;
+    std::atomic<size_t> VisibleCount;
+
+    explicit CubeField(unsigned gridSize) : VisibleCount(0)
+    {
+        const float offset = 0.5f*2.0f*(gridSize - 1);
+        for (unsigned x = 0; x < gridSize; ++x)
+            for (unsigned y = 0; y < gridSize; ++y)
+                for (unsigned z = 0; z < gridSize; ++z)
+                    Positions.push_back(glm::vec3(2.0f*x - offset, 2.0f*y - offset, -2.0f*z));
+        Models.resize(Positions.size());
+        Visible.resize(Positions.size());
+    }
+
+    // transform stage for the containers [begin, end)
+    void transform(size_t begin, size_t end, float time)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), Positions[i]);
+            if (i % 3 == 0) // make every third container rotate over time
+                model = glm::rotate(model, time*glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+            else
+                model = glm::rotate(model, glm::radians(20.0f*(i % 18)), glm::vec3(1.0f, 0.3f, 0.5f));
+            Models[i] = model;
+        }
+    }
+
+    // culling stage for the containers [begin, end): the visible model matrices are gathered locally and then copied into
+    // a range of Visible reserved with one atomic add, so the threads never write the same element
+    void cull(size_t begin, size_t end, const Frustum &frustum)
+    {
+        // the rotated unit cube always fits into the sphere of radius sqrt(3)/2, use the box around that sphere
+        const glm::vec3 extents(0.87f);
+        unsigned indices[GRAIN];
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (frustum.IntersectsAABB(Positions[i], extents))
+                indices[count++] = static_cast<unsigned>(i);
+            if (count == GRAIN || (i + 1 == end && count > 0))
+            {
+                size_t first = VisibleCount.fetch_add(count);
+                for (size_t j = 0; j < count; ++j)
+                    Visible[first + j] = Models[indices[j]];
+                count = 0;
+            }
+        }
+    }
+};
+
+// Encoded image files and their decoded pixels
+struct TextureDecodeBatch
+{
+    std::vector<std::vector<unsigned char> > Files;
+    std::vector<unsigned char*> Pixels;
+    std::vector<glm::ivec3> Sizes; // width, height, channels
+
+    void decode(size_t index)
+    {
+        int width, height, nrChannels;
+        Pixels[index] = stbi_load_from_memory(Files[index].data(), static_cast<int>(Files[index].size()), &width, &height, &nrChannels, 0);
+        Sizes[index] = glm::ivec3(width, height, nrChannels);
+    }
+
+    void release()
+    {
+        for (size_t i = 0; i < Pixels.size(); ++i)
+        {
+            stbi_image_free(Pixels[i]);
+            Pixels[i] = nullptr;
+        }
+    }
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+std::vector<unsigned char> readFile(const std::string &path);
+GLuint createTexture(const unsigned char* data, const glm::ivec3 &size);
+void prepareFrame(JobSystem* jobs, CubeField &cubes, float time, const Frustum &frustum);
+double milliseconds(std::chrono::steady_clock::time_point start);
+
+int drawCubeField();
+int benchmarkJobSystem();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+std::vector<unsigned char> readFile(const std::string &path)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+        std::cout << "Failed to read file " << path << std::endl;
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// create texture from decoded pixels and generate mipmaps (must run on the main thread, which owns the GL context)
+GLuint createTexture(const unsigned char* data, const glm::ivec3 &size)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (data)
+    {
+        GLenum format = size.z == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Transform and cull all the containers; with a job system both stages are split into jobs and the culling jobs only start
+// once all the transform jobs are done, otherwise everything runs on the calling thread
+void prepareFrame(JobSystem* jobs, CubeField &cubes, float time, const Frustum &frustum)
+{
+    cubes.VisibleCount = 0;
+    if (jobs == nullptr)
+    {
+        cubes.transform(0, cubes.Positions.size(), time);
+        cubes.cull(0, cubes.Positions.size(), frustum);
+        return;
+    }
+
+    auto transform = [&cubes, time](size_t begin, size_t end) { cubes.transform(begin, end, time); };
+    auto cull = [&cubes, &frustum](size_t begin, size_t end) { cubes.cull(begin, end, frustum); };
+    JobCounter transformed, culled;
+    jobs->parallelFor(0, cubes.Positions.size(), GRAIN, transform, transformed);
+    jobs->parallelForAfter(transformed, 0, cubes.Positions.size(), GRAIN, cull, culled);
+    jobs->wait(culled);
+}
+
+double milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --benchmark: headless comparison of the stages on the main thread only against the job system
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+        return benchmarkJobSystem();
+    return drawCubeField();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawCubeField()
+{
+    // Drawing a large grid of containers (every third one rotating) which are transformed and culled by jobs every frame;
+    // the main thread only uploads the visible instances and submits one instanced draw call
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    JobSystem jobs;
+
+    // decode both textures in parallel, create the GL textures on the main thread
+    TextureDecodeBatch batch;
+    batch.Files.push_back(readFile(relPathExePro+"../../common/resources/textures/container.jpg"));
+    batch.Files.push_back(readFile(relPathExePro+"../../common/resources/textures/awesomeface.png"));
+    batch.Pixels.resize(2);
+    batch.Sizes.resize(2);
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    jobs.parallelFor(0, 2, 1, [&batch](size_t begin, size_t end) { for (size_t i = begin; i < end; ++i) batch.decode(i); });
+    GLuint textures[2];
+    textures[0] = createTexture(batch.Pixels[0], batch.Sizes[0]);
+    textures[1] = createTexture(batch.Pixels[1], batch.Sizes[1]);
+    batch.release();
+
+    CubeField cubes(GRID_SIZE);
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    double lastTitleUpdate = glfwGetTime();
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio, 0.1f, FAR_PLANE);
+        auto prepareStart = std::chrono::steady_clock::now();
+        prepareFrame(&jobs, cubes, currentFrame, Frustum(projection * view));
+        double prepareTime = milliseconds(prepareStart);
+
+        // show the time of the parallel stages once per second
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::string title = "LearnOpenGL - " + std::to_string(cubes.VisibleCount) + " of " + std::to_string(cubes.Positions.size()) +
+                                " containers visible, transform + cull on " + std::to_string(jobs.getThreadCount()) + " threads: " + std::to_string(prepareTime) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+        }
+
+        // upload the visible instances (GL calls on the main thread only)
+        glBindBuffer(GL_ARRAY_BUFFER, pool.InstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, cubes.VisibleCount*sizeof(glm::mat4), cubes.Visible.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", view);
+        ShaderProgram.setMat4("projection", projection);
+
+        pool.bind();
+        glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, GL_UNSIGNED_INT, (void*)(cube.firstIndex*sizeof(GLuint)), static_cast<GLsizei>(cubes.VisibleCount));
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkJobSystem()
+{
+    // Benchmark: every stage is timed on the main thread alone and with the job system (all hardware threads)
+    //  transform : model matrices of all the containers
+    //  cull      : frustum test of all the containers and compaction of the visible model matrices
+    //  decode    : decoding of 32 JPEG/PNG textures (one job per image)
+    //  frame     : transform + cull (chained through a counter) + upload + instanced draw + glFinish on the main thread
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    ShaderProgram.use();
+    ShaderProgram.setFloat("mixValue", 0.2f);
+
+    CubeField cubes(GRID_SIZE);
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+
+    TextureDecodeBatch batch;
+    const std::vector<unsigned char> container = readFile(relPathExePro+"../../common/resources/textures/container.jpg");
+    const std::vector<unsigned char> face = readFile(relPathExePro+"../../common/resources/textures/awesomeface.png");
+    for (int i = 0; i < 32; ++i)
+        batch.Files.push_back(i % 2 == 0 ? container : face);
+    batch.Pixels.resize(batch.Files.size());
+    batch.Sizes.resize(batch.Files.size());
+    stbi_set_flip_vertically_on_load(true);
+
+    JobSystem jobs;
+    const int frames = 30;
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, FAR_PLANE);
+
+    std::cout << cubes.Positions.size() << " containers, " << batch.Files.size() << " textures to decode, job system with "
+              << jobs.getThreadCount() << " threads (grain " << GRAIN << ")" << std::endl;
+    std::cout << std::setw(14) << "threads" << std::setw(12) << "visible" << std::setw(16) << "transform [ms]"
+              << std::setw(12) << "cull [ms]" << std::setw(14) << "decode [ms]" << std::setw(13) << "frame [ms]" << std::endl;
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        JobSystem* jobSystem = mode == 1 ? &jobs : nullptr;
+        double transformTime = 0.0, cullTime = 0.0, decodeTime = 0.0, frameTime = 0.0;
+        size_t visible = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float time = frame/60.0f;
+            const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(std::sin(time), 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            const Frustum frustum(projection * view);
+
+            // the stages one after another
+            auto start = std::chrono::steady_clock::now();
+            if (jobSystem == nullptr)
+                cubes.transform(0, cubes.Positions.size(), time);
+            else
+                jobSystem->parallelFor(0, cubes.Positions.size(), GRAIN, [&cubes, time](size_t begin, size_t end) { cubes.transform(begin, end, time); });
+            transformTime += milliseconds(start);
+
+            cubes.VisibleCount = 0;
+            start = std::chrono::steady_clock::now();
+            if (jobSystem == nullptr)
+                cubes.cull(0, cubes.Positions.size(), frustum);
+            else
+                jobSystem->parallelFor(0, cubes.Positions.size(), GRAIN, [&cubes, &frustum](size_t begin, size_t end) { cubes.cull(begin, end, frustum); });
+            cullTime += milliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            if (jobSystem == nullptr)
+                for (size_t i = 0; i < batch.Files.size(); ++i)
+                    batch.decode(i);
+            else
+                jobSystem->parallelFor(0, batch.Files.size(), 1, [&batch](size_t begin, size_t end) { for (size_t i = begin; i < end; ++i) batch.decode(i); });
+            decodeTime += milliseconds(start);
+            batch.release();
+
+            // a whole frame with the chained stages and the GL submission on the main thread
+            start = std::chrono::steady_clock::now();
+            prepareFrame(jobSystem, cubes, time, frustum);
+            glBindBuffer(GL_ARRAY_BUFFER, pool.InstanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, cubes.VisibleCount*sizeof(glm::mat4), cubes.Visible.data(), GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            ShaderProgram.setMat4("view", view);
+            ShaderProgram.setMat4("projection", projection);
+            pool.bind();
+            glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, GL_UNSIGNED_INT, (void*)(cube.firstIndex*sizeof(GLuint)), static_cast<GLsizei>(cubes.VisibleCount));
+            glBindVertexArray(0);
+            glFinish();
+            frameTime += milliseconds(start);
+            visible += cubes.VisibleCount;
+        }
+
+        std::cout << std::setw(14) << (mode == 0 ? "main only" : std::to_string(jobs.getThreadCount()) + " (jobs)")
+                  << std::setw(12) << visible/frames << std::fixed << std::setprecision(3)
+                  << std::setw(16) << transformTime/frames << std::setw(12) << cullTime/frames
+                  << std::setw(14) << decodeTime/frames << std::setw(13) << frameTime/frames << std::endl;
+    }
+
+    pool.destroy();
+    glfwTerminate();
+    return 0;
+}
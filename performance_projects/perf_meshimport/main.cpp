@@ -0,0 +1,551 @@
+// Meshes imported from model files (common/mesh_import.h) instead of vertex arrays typed into main.cpp: Wavefront OBJ
+// text split into chunks that are parsed in parallel on the job system, binary glTF (.glb) read in place from the mapped
+// file, both merged into one indexed mesh with the interleaved layout of MeshPool by a vertex deduplication hash
+// Use: Shader class and files, MeshImporter and ImportedMesh, JobSystem, MeshPool, camera object
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <job_system.h>
+#include <mesh_import.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_meshimport";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // segments around the generated torus (the tube has half as many): the drawn model (--segments) and the benchmark
+    // model (--benchmark --segments), imports per importer (--runs) and threads of the job system (--threads, 0: one per core)
+    unsigned drawSegments = 96;
+    unsigned benchmarkSegments = 1024;
+    int benchmarkRuns = 3;
+    unsigned benchmarkThreads = 0;
+}
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+bool writeTorusObj(const std::string &path, unsigned segments);
+bool writeGlb(const std::string &path, const ImportedMesh &mesh);
+bool importClassicObj(const std::string &path, ImportedMesh &mesh);
+glm::mat4 fitToUnitCube(const ImportedMesh &mesh);
+double milliseconds(std::chrono::steady_clock::time_point start);
+
+int drawMesh(const std::string &modelPath);
+int benchmarkMeshImport();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// A torus as an exporter would write it: positions shared across the seams, texture coordinates per grid point,
+// normals, one quad per grid cell with "v/vt/vn" corners (the container texture repeats 4 times around the ring)
+bool writeTorusObj(const std::string &path, unsigned segments)
+{
+    const unsigned ring = std::max(3u, segments), tube = std::max(3u, segments / 2);
+    const float R = 0.7f, r = 0.3f, twoPi = 6.28318530718f;
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << "# torus, " << ring << " x " << tube << " quads\no torus\n" << std::fixed << std::setprecision(6);
+    for (unsigned i = 0; i < ring; ++i)
+        for (unsigned j = 0; j < tube; ++j)
+        {
+            const float u = twoPi*i/ring, v = twoPi*j/tube;
+            file << "v " << (R + r*cos(v))*cos(u) << " " << r*sin(v) << " " << (R + r*cos(v))*sin(u) << "\n";
+        }
+    for (unsigned i = 0; i <= ring; ++i)
+        for (unsigned j = 0; j <= tube; ++j)
+            file << "vt " << 4.0f*i/ring << " " << static_cast<float>(j)/tube << "\n";
+    for (unsigned i = 0; i < ring; ++i)
+        for (unsigned j = 0; j < tube; ++j)
+        {
+            const float u = twoPi*i/ring, v = twoPi*j/tube;
+            file << "vn " << cos(v)*cos(u) << " " << sin(v) << " " << cos(v)*sin(u) << "\n";
+        }
+    file << "s 1\n";
+    for (unsigned i = 0; i < ring; ++i)
+        for (unsigned j = 0; j < tube; ++j)
+        {
+            const unsigned corners[4][2] = { { i, j }, { i, j + 1 }, { i + 1, j + 1 }, { i + 1, j } };
+            file << "f";
+            for (int c = 0; c < 4; ++c)
+            {
+                const unsigned position = (corners[c][0] % ring)*tube + corners[c][1] % tube + 1;
+                file << " " << position << "/" << corners[c][0]*(tube + 1) + corners[c][1] + 1 << "/" << position;
+            }
+            file << "\n";
+        }
+    if (!file)
+    {
+        std::cout << "ERROR::PERF_MESHIMPORT::WRITE_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// mesh as a .glb with one buffer view per attribute and one for the indices (texture coordinates flipped back to glTF)
+bool writeGlb(const std::string &path, const ImportedMesh &mesh)
+{
+    const uint32_t vertexCount = mesh.vertexCount();
+    std::vector<float> positions(vertexCount*3), texCoords(vertexCount*2);
+    float minimum[3] = { 1e30f, 1e30f, 1e30f }, maximum[3] = { -1e30f, -1e30f, -1e30f };
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        const float* vertex = &mesh.Vertices[v*ImportedMesh::VERTEX_SIZE];
+        for (int c = 0; c < 3; ++c)
+        {
+            positions[v*3 + c] = vertex[c];
+            minimum[c] = std::min(minimum[c], vertex[c]);
+            maximum[c] = std::max(maximum[c], vertex[c]);
+        }
+        texCoords[v*2] = vertex[3];
+        texCoords[v*2 + 1] = 1.0f - vertex[4];
+    }
+    const size_t positionBytes = positions.size()*sizeof(float), texCoordBytes = texCoords.size()*sizeof(float);
+    const size_t indexBytes = mesh.Indices.size()*sizeof(uint32_t);
+
+    std::ostringstream json;
+    json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"" << project_name << "\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+         << "\"nodes\":[{\"mesh\":0}],\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"TEXCOORD_0\":1},\"indices\":2}]}],"
+         << "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\","
+         << "\"min\":[" << minimum[0] << "," << minimum[1] << "," << minimum[2] << "],\"max\":[" << maximum[0] << "," << maximum[1] << "," << maximum[2] << "]},"
+         << "{\"bufferView\":1,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC2\"},"
+         << "{\"bufferView\":2,\"componentType\":5125,\"count\":" << mesh.Indices.size() << ",\"type\":\"SCALAR\"}],"
+         << "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << positionBytes << ",\"target\":34962},"
+         << "{\"buffer\":0,\"byteOffset\":" << positionBytes << ",\"byteLength\":" << texCoordBytes << ",\"target\":34962},"
+         << "{\"buffer\":0,\"byteOffset\":" << positionBytes + texCoordBytes << ",\"byteLength\":" << indexBytes << ",\"target\":34963}],"
+         << "\"buffers\":[{\"byteLength\":" << positionBytes + texCoordBytes + indexBytes << "}]}";
+    std::string text = json.str();
+    text.resize((text.size() + 3) & ~size_t(3), ' '); // chunks are 4 byte aligned, JSON is padded with spaces
+
+    const uint32_t binarySize = static_cast<uint32_t>(positionBytes + texCoordBytes + indexBytes);
+    const uint32_t header[5] = { 0x46546C67, 2, static_cast<uint32_t>(20 + text.size() + 8 + binarySize),
+                                 static_cast<uint32_t>(text.size()), 0x4E4F534A };
+    const uint32_t binaryHeader[2] = { binarySize, 0x004E4942 };
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(text.data(), text.size());
+    file.write(reinterpret_cast<const char*>(binaryHeader), sizeof(binaryHeader));
+    file.write(reinterpret_cast<const char*>(positions.data()), positionBytes);
+    file.write(reinterpret_cast<const char*>(texCoords.data()), texCoordBytes);
+    file.write(reinterpret_cast<const char*>(mesh.Indices.data()), indexBytes);
+    if (!file)
+    {
+        std::cout << "ERROR::PERF_MESHIMPORT::WRITE_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// The usual tutorial OBJ loader for comparison: std::getline and an istringstream per line, the vertices deduplicated
+// through a std::map of the (position, texture coordinate) index pairs
+bool importClassicObj(const std::string &path, ImportedMesh &mesh)
+{
+    std::ifstream file(path.c_str());
+    if (!file)
+        return false;
+    mesh.clear();
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::map<std::pair<long, long>, uint32_t> vertices;
+    std::string line, type, corner;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        stream >> type;
+        if (type == "v")
+        {
+            glm::vec3 position;
+            stream >> position.x >> position.y >> position.z;
+            positions.push_back(position);
+        }
+        else if (type == "vt")
+        {
+            glm::vec2 texCoord;
+            stream >> texCoord.x >> texCoord.y;
+            texCoords.push_back(texCoord);
+        }
+        else if (type == "f")
+        {
+            std::vector<uint32_t> polygon;
+            while (stream >> corner)
+            {
+                long position = 0, texCoord = 0;
+                sscanf(corner.c_str(), "%ld/%ld", &position, &texCoord);
+                position = position < 0 ? long(positions.size()) + position : position - 1;
+                texCoord = texCoord < 0 ? long(texCoords.size()) + texCoord : texCoord - 1;
+                if (position < 0 || position >= long(positions.size()) || texCoord >= long(texCoords.size()))
+                    return false;
+                auto found = vertices.find(std::make_pair(position, texCoord));
+                if (found == vertices.end())
+                {
+                    const glm::vec2 uv = texCoord >= 0 ? texCoords[texCoord] : glm::vec2(0.0f);
+                    const float vertex[ImportedMesh::VERTEX_SIZE] = { positions[position].x, positions[position].y, positions[position].z, uv.x, uv.y };
+                    found = vertices.insert(std::make_pair(std::make_pair(position, texCoord), mesh.vertexCount())).first;
+                    mesh.Vertices.insert(mesh.Vertices.end(), vertex, vertex + ImportedMesh::VERTEX_SIZE);
+                }
+                polygon.push_back(found->second);
+            }
+            for (size_t i = 2; i < polygon.size(); ++i)
+            {
+                mesh.Indices.push_back(polygon[0]);
+                mesh.Indices.push_back(polygon[i - 1]);
+                mesh.Indices.push_back(polygon[i]);
+            }
+        }
+    }
+    return true;
+}
+
+// model matrix which centers the bounding box of the mesh at the origin and scales its largest side to 2
+glm::mat4 fitToUnitCube(const ImportedMesh &mesh)
+{
+    glm::vec3 minimum(1e30f), maximum(-1e30f);
+    for (size_t i = 0; i < mesh.Vertices.size(); i += ImportedMesh::VERTEX_SIZE)
+    {
+        const glm::vec3 position(mesh.Vertices[i], mesh.Vertices[i + 1], mesh.Vertices[i + 2]);
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+    const glm::vec3 size = maximum - minimum;
+    const float largest = std::max(size.x, std::max(size.y, size.z));
+    if (largest <= 0.0f)
+        return glm::mat4(1.0f);
+    return glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(2.0f/largest)), -0.5f*(minimum + maximum));
+}
+
+double milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --benchmark [--segments N] [--runs N] [--threads N]: headless import throughput of a generated torus, OBJ and GLB
+    // MODEL: draw an .obj or .glb file; without a model a generated torus (--segments N) is drawn
+    bool benchmark = false;
+    std::string modelPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+        else if (strcmp(argv[i], "--segments") == 0 && i + 1 < argc)
+            benchmarkSegments = drawSegments = std::max(3, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+            benchmarkRuns = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            benchmarkThreads = std::max(0, atoi(argv[++i]));
+        else
+            modelPath = argv[i];
+    }
+    if (benchmark)
+        return benchmarkMeshImport();
+    if (modelPath.empty())
+    {
+        modelPath = project_name + "_torus.obj";
+        if (!writeTorusObj(modelPath, drawSegments))
+            return -1;
+    }
+    return drawMesh(modelPath);
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawMesh(const std::string &modelPath)
+{
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    JobSystem jobs;
+    MeshImporter importer(&jobs);
+    ImportedMesh mesh;
+    if (!importer.importFile(modelPath, mesh) || mesh.Indices.empty())
+        return -1;
+    const MeshImportStats &stats = importer.getStats();
+    std::cout << modelPath << ": " << stats.SourceVertices << " source vertices, " << mesh.vertexCount() << " vertices, "
+              << stats.Triangles << " triangles, imported in " << std::fixed << std::setprecision(1)
+              << stats.ParseTime + stats.BuildTime << " ms" << std::endl;
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    GLuint textures[2];
+    textures[0] = loadTexture(relPathExePro+"../../common/resources/textures/container.jpg");
+    textures[1] = loadTexture(relPathExePro+"../../common/resources/textures/awesomeface.png");
+
+    // the imported mesh has the layout of the pool, it is added as it is
+    MeshPool pool;
+    const MeshRange range = pool.addMesh(mesh.Vertices.data(), mesh.vertexCount(), mesh.Indices.data(), static_cast<GLuint>(mesh.Indices.size()));
+    pool.upload();
+    const glm::mat4 fit = fitToUnitCube(mesh);
+    std::vector<glm::mat4> models(1);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        models[0] = glm::rotate(glm::mat4(1.0f), 0.5f*currentFrame, glm::vec3(0.5f, 1.0f, 0.0f))*fit;
+        pool.setInstanceData(models);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", camera.GetViewMatrix());
+        ShaderProgram.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT));
+        pool.bind();
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT, (void*)(range.firstIndex*sizeof(GLuint)), 1, range.baseVertex);
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkMeshImport()
+{
+    // Benchmark: a torus of --segments x --segments/2 quads is written as OBJ (positions, texture coordinates, normals),
+    // imported once and written as GLB (the deduplicated mesh), then each file is imported --runs times (best counts,
+    // the files are in the page cache after the first run)
+    //  classic OBJ : std::getline/istringstream loader with a std::map of the index pairs
+    //  OBJ 1 thread: MeshImporter without a job system (chunks parsed one after another)
+    //  OBJ jobs    : MeshImporter on the job system (chunks parsed on all the threads)
+    //  GLB         : MeshImporter, accessors read in place from the mapped file
+    // The results of all the importers are compared with the one of the single threaded OBJ import
+
+    const std::string objPath = project_name + "_benchmark.obj";
+    const std::string glbPath = project_name + "_benchmark.glb";
+    auto start = std::chrono::steady_clock::now();
+    if (!writeTorusObj(objPath, benchmarkSegments))
+        return -1;
+    ImportedMesh reference;
+    MeshImporter serial;
+    if (!serial.importFile(objPath, reference) || !writeGlb(glbPath, reference))
+        return -1;
+    std::cout << "models written in " << std::fixed << std::setprecision(1) << milliseconds(start) << " ms: "
+              << serial.getStats().SourceVertices << " positions, " << reference.vertexCount() << " vertices after deduplication, "
+              << reference.Indices.size() / 3 << " triangles" << std::endl;
+
+    JobSystem jobs(benchmarkThreads > 0 ? benchmarkThreads - 1 : std::max(1u, std::thread::hardware_concurrency()) - 1);
+    MeshImporter parallel(&jobs);
+
+    const char* names[4] = { "classic OBJ", "OBJ 1 thread", "OBJ jobs", "GLB" };
+    std::cout << std::setw(14) << "importer" << std::setw(12) << "size [MB]" << std::setw(12) << "total [ms]" << std::setw(12) << "parse [ms]"
+              << std::setw(12) << "build [ms]" << std::setw(10) << "MB/s" << std::setw(10) << "chunks" << std::setw(8) << "same"
+              << "   (" << jobs.getThreadCount() << " threads)" << std::endl;
+    for (int importer = 0; importer < 4; ++importer)
+    {
+        const std::string &path = importer == 3 ? glbPath : objPath;
+        double best = 0.0;
+        MeshImportStats bestStats;
+        ImportedMesh mesh;
+        for (int run = 0; run < benchmarkRuns; ++run)
+        {
+            start = std::chrono::steady_clock::now();
+            bool imported;
+            if (importer == 0)
+                imported = importClassicObj(path, mesh);
+            else
+                imported = (importer == 1 ? serial : parallel).importFile(path, mesh);
+            const double time = milliseconds(start);
+            if (!imported)
+            {
+                std::cout << "ERROR::PERF_MESHIMPORT::IMPORT_FAILED: " << path << std::endl;
+                return -1;
+            }
+            if (run == 0 || time < best)
+            {
+                best = time;
+                bestStats = importer == 0 ? MeshImportStats() : (importer == 1 ? serial : parallel).getStats();
+            }
+        }
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        const double megabytes = static_cast<double>(file.tellg())/(1024.0*1024.0);
+        const bool same = mesh.Indices == reference.Indices && mesh.Vertices.size() == reference.Vertices.size() &&
+                          (importer == 3 || memcmp(mesh.Vertices.data(), reference.Vertices.data(), mesh.Vertices.size()*sizeof(float)) == 0);
+        std::cout << std::setw(14) << names[importer] << std::setw(12) << megabytes << std::setw(12) << best;
+        if (importer == 0)
+            std::cout << std::setw(12) << "-" << std::setw(12) << "-";
+        else
+            std::cout << std::setw(12) << bestStats.ParseTime << std::setw(12) << bestStats.BuildTime;
+        std::cout << std::setw(10) << megabytes/(best/1000.0) << std::setw(10) << bestStats.Chunks << std::setw(8) << (same ? "yes" : "NO") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,418 @@
+// Draw many distinct meshes sub-allocated in one shared VBO/EBO with a single glMultiDrawElementsIndirect call
+// Use: Shader class and files, MeshPool (shared VBO, EBO, VAO and instanced per-object attributes), GL_DRAW_INDIRECT_BUFFER,
+//      camera object and a benchmark comparing the submission time of one draw call per mesh against multi-draw indirect
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_multidraw";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // distance between the centers of two neighbouring meshes of the grid
+    const float GRID_SPACING = 2.0f;
+}
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path, GLenum format);
+void buildScene(GLuint meshCount, MeshPool &pool, IndirectDrawBuffer &drawBuffer, std::vector<glm::mat4> &models, std::vector<MeshRange> &meshes);
+
+int drawMultiDrawIndirect();
+int benchmarkMultiDrawIndirect();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 4.3 core context (needed for multi-draw indirect) and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible, 4, 3);
+    if (window == nullptr)
+        return nullptr;
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+    if (!GLAD_GL_ARB_multi_draw_indirect || !GLAD_GL_ARB_base_instance)
+    {
+        std::cout << "GL_ARB_multi_draw_indirect and GL_ARB_base_instance are required" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+
+    return window;
+}
+
+// load image, create texture and generate mipmaps
+GLuint loadTexture(const std::string &path, GLenum format)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Builds a cubic grid of meshCount distinct meshes (boxes of different sizes), their model matrices and one draw record per mesh
+void buildScene(GLuint meshCount, MeshPool &pool, IndirectDrawBuffer &drawBuffer, std::vector<glm::mat4> &models, std::vector<MeshRange> &meshes)
+{
+    srand(42); // same scene for every run
+    const GLuint side = static_cast<GLuint>(std::ceil(std::cbrt(static_cast<double>(meshCount))));
+    const float offset = 0.5f*GRID_SPACING*(side - 1);
+
+    meshes.clear();
+    models.clear();
+    drawBuffer.clear();
+    for (GLuint i = 0; i < meshCount; ++i)
+    {
+        glm::vec3 size(0.4f + 0.8f*rand()/RAND_MAX, 0.4f + 0.8f*rand()/RAND_MAX, 0.4f + 0.8f*rand()/RAND_MAX);
+        meshes.push_back(pool.addBox(size));
+
+        glm::vec3 position(GRID_SPACING*(i % side) - offset,
+                           GRID_SPACING*((i / side) % side) - offset,
+                           -GRID_SPACING*(i / (side*side)));
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(20.0f*(i % 18)), glm::vec3(1.0f, 0.3f, 0.5f));
+        models.push_back(model);
+
+        // per-object data of mesh i is record i of the instance attributes
+        drawBuffer.add(meshes.back(), i);
+    }
+
+    pool.upload();
+    pool.setInstanceData(models);
+    drawBuffer.upload();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main()
+{
+//    return drawMultiDrawIndirect();
+    return benchmarkMultiDrawIndirect();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawMultiDrawIndirect()
+{
+    // Drawing a large grid of distinct meshes from one shared VBO/EBO with a single multi-draw indirect call per frame
+    // along with a mouse controlled camera object
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    // sub-allocate all the meshes in one pool and record one indirect draw per mesh
+    const GLuint meshCount = 10000;
+    MeshPool pool;
+    IndirectDrawBuffer drawBuffer;
+    std::vector<glm::mat4> models;
+    std::vector<MeshRange> meshes;
+    buildScene(meshCount, pool, drawBuffer, models, meshes);
+    camera.Position = glm::vec3(0.0f, 0.0f, 30.0f);
+
+    // load and create multiple textures
+    GLuint textures[2];
+    textures[0] = loadTexture(relPathExePro+"../../common/resources/textures/container.jpg", GL_RGB);
+    textures[1] = loadTexture(relPathExePro+"../../common/resources/textures/awesomeface.png", GL_RGBA);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    double lastTitleUpdate = glfwGetTime();
+    double submitTimeSum = 0.0;
+    int submitFrames = 0;
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", camera.GetViewMatrix());
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 200.0f);
+        ShaderProgram.setMat4("projection", projection);
+
+        // all meshes of the pool in one call: the model matrix of each draw is fetched through its baseInstance
+        auto submitStart = std::chrono::steady_clock::now();
+        pool.bind();
+        drawBuffer.draw();
+        glBindVertexArray(0);
+        submitTimeSum += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitStart).count();
+        ++submitFrames;
+
+        // show the average CPU submission time once per second
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::string title = "LearnOpenGL - " + std::to_string(meshCount) + " meshes, submission " + std::to_string(submitTimeSum/submitFrames) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+            submitTimeSum = 0.0;
+            submitFrames = 0;
+        }
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    drawBuffer.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkMultiDrawIndirect()
+{
+    // Benchmark: CPU time spent submitting the draws of N distinct meshes per frame with
+    //  a) one glUniformMatrix4fv + glDrawElementsBaseVertex per mesh (the way the hello projects draw their cubes)
+    //  b) one glMultiDrawElementsIndirect for all meshes
+    // Runs in a hidden window; the GPU is drained with glFinish after every frame so that the driver queue never fills up
+    // Note: software drivers (Mesa llvmpipe) transform the vertices inside the draw call itself, so there the submission
+    //       time also grows with the vertex count; on a GPU the multi-draw column stays flat
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+
+    glEnable(GL_DEPTH_TEST);
+
+    Shader IndirectProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    Shader SingleProgram((relPathExePro+project_name+"_single.vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    const GLuint meshCounts[] = {100, 1000, 10000, 50000, 100000};
+    const int warmupFrames = 5;
+    const int measuredFrames = 50;
+
+    std::cout << std::setw(10) << "meshes"
+              << std::setw(22) << "draw per mesh [ms]"
+              << std::setw(22) << "multi-draw [ms]"
+              << std::setw(12) << "speedup" << std::endl;
+
+    for (GLuint meshCount : meshCounts)
+    {
+        MeshPool pool;
+        IndirectDrawBuffer drawBuffer;
+        std::vector<glm::mat4> models;
+        std::vector<MeshRange> meshes;
+        buildScene(meshCount, pool, drawBuffer, models, meshes);
+
+        const float depth = GRID_SPACING*std::cbrt(static_cast<float>(meshCount));
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, depth), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 4.0f*depth + 10.0f);
+
+        SingleProgram.use();
+        SingleProgram.setFloat("mixValue", 0.2f);
+        SingleProgram.setMat4("view", view);
+        SingleProgram.setMat4("projection", projection);
+        const GLint modelLocation = glGetUniformLocation(SingleProgram.ID, "model");
+
+        IndirectProgram.use();
+        IndirectProgram.setFloat("mixValue", 0.2f);
+        IndirectProgram.setMat4("view", view);
+        IndirectProgram.setMat4("projection", projection);
+
+        double singleTime = 0.0, indirectTime = 0.0;
+        for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+        {
+            // a) one draw call per mesh
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            auto start = std::chrono::steady_clock::now();
+            SingleProgram.use();
+            pool.bind();
+            for (GLuint i = 0; i < meshCount; ++i)
+            {
+                glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &models[i][0][0]);
+                glDrawElementsBaseVertex(GL_TRIANGLES, meshes[i].indexCount, GL_UNSIGNED_INT,
+                                         (void*)(meshes[i].firstIndex*sizeof(GLuint)), meshes[i].baseVertex);
+            }
+            glBindVertexArray(0);
+            if (frame >= warmupFrames)
+                singleTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            glFinish();
+
+            // b) all meshes with one multi-draw indirect call
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            start = std::chrono::steady_clock::now();
+            IndirectProgram.use();
+            pool.bind();
+            drawBuffer.draw();
+            glBindVertexArray(0);
+            if (frame >= warmupFrames)
+                indirectTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            glFinish();
+
+            glfwPollEvents();
+        }
+
+        singleTime /= measuredFrames;
+        indirectTime /= measuredFrames;
+        std::cout << std::setw(10) << meshCount
+                  << std::setw(22) << std::fixed << std::setprecision(4) << singleTime
+                  << std::setw(22) << indirectTime
+                  << std::setw(11) << std::setprecision(1) << singleTime/indirectTime << "x" << std::endl;
+
+        pool.destroy();
+        drawBuffer.destroy();
+    }
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,468 @@
+// Cull cubes hidden behind a few large walls with a software depth-only rasterizer and a hierarchical-Z (Hi-Z) pyramid on the CPU
+// Use: Shader class and files, MeshPool with instanced model matrices, camera object and frustum, OcclusionCuller (multithreaded
+//      SIMD occluder rasterization, Hi-Z bounding box tests) and a benchmark scene built for heavy occlusion
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <mesh_pool.h>
+#include <occlusion_culling.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_occlusion";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    const float FAR_PLANE = 200.0f;
+
+    // set up vertex data (retrieved directly from LearnOpenGL), used as occluder geometry on the CPU
+    const GLfloat vertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+}
+
+// Scene built for heavy occlusion: a few long walls in front of the camera hide most of a large field of small cubes
+struct OcclusionScene
+{
+    std::vector<glm::mat4> wallModels;    // occluders (also drawn)
+    std::vector<glm::mat4> cubeModels;    // occludees
+    std::vector<glm::vec3> cubePositions; // bounding box centers of the occludees (unit cubes, no rotation)
+};
+
+// Per-frame culling statistics
+struct CullStats
+{
+    size_t frustumVisible;
+    size_t drawn;
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path, GLenum format);
+void buildScene(OcclusionScene &scene);
+CullStats cullScene(const OcclusionScene &scene, const glm::mat4 &view, const glm::mat4 &projection, OcclusionCuller* occlusion,
+                    std::vector<glm::mat4> &instances);
+
+int drawOcclusionCulledCubes();
+int benchmarkOcclusionCulling();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// load image, create texture and generate mipmaps
+GLuint loadTexture(const std::string &path, GLenum format)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Three rows of walls with gaps between them and a 60 x 8 x 60 field of cubes behind the first row
+void buildScene(OcclusionScene &scene)
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int wall = -2; wall <= 2; ++wall)
+        {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(wall*22.0f + (row % 2)*11.0f, 2.0f, -8.0f - row*30.0f));
+            model = glm::scale(model, glm::vec3(20.0f, 16.0f, 1.0f));
+            scene.wallModels.push_back(model);
+        }
+    }
+
+    for (int x = 0; x < 60; ++x)
+        for (int y = 0; y < 8; ++y)
+            for (int z = 0; z < 60; ++z)
+            {
+                glm::vec3 position(-60.0f + 2.0f*x, -4.0f + 1.5f*y, -12.0f - 2.5f*z);
+                scene.cubePositions.push_back(position);
+                scene.cubeModels.push_back(glm::translate(glm::mat4(1.0f), position));
+            }
+}
+
+// Fills instances with the walls followed by every cube which passes the frustum test and (if occlusion is given) the Hi-Z test
+CullStats cullScene(const OcclusionScene &scene, const glm::mat4 &view, const glm::mat4 &projection, OcclusionCuller* occlusion,
+                    std::vector<glm::mat4> &instances)
+{
+    const glm::mat4 viewProjection = projection * view;
+    const Frustum frustum(viewProjection);
+    const glm::vec3 extents(0.5f);
+
+    instances.assign(scene.wallModels.begin(), scene.wallModels.end());
+
+    if (occlusion != nullptr)
+    {
+        occlusion->beginFrame(viewProjection);
+        for (size_t i = 0; i < scene.wallModels.size(); ++i)
+            occlusion->addOccluder(vertices, 36, 5, scene.wallModels[i]);
+        occlusion->rasterize();
+    }
+
+    CullStats stats = {0, 0};
+    for (size_t i = 0; i < scene.cubePositions.size(); ++i)
+    {
+        if (!frustum.IntersectsAABB(scene.cubePositions[i], extents))
+            continue;
+        ++stats.frustumVisible;
+        if (occlusion != nullptr && !occlusion->isVisible(scene.cubePositions[i], extents))
+            continue;
+        instances.push_back(scene.cubeModels[i]);
+    }
+    stats.drawn = instances.size() - scene.wallModels.size();
+    return stats;
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --benchmark: headless comparison of frustum culling alone against frustum + occlusion culling
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+        return benchmarkOcclusionCulling();
+    return drawOcclusionCulledCubes();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawOcclusionCulledCubes()
+{
+    // Drawing the walls and only the cubes which are not hidden behind them, along with a mouse controlled camera object
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    OcclusionScene scene;
+    buildScene(scene);
+
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+
+    OcclusionCuller occlusion;
+    std::vector<glm::mat4> instances;
+
+    // load and create multiple textures
+    GLuint textures[2];
+    textures[0] = loadTexture(relPathExePro+"../../common/resources/textures/container.jpg", GL_RGB);
+    textures[1] = loadTexture(relPathExePro+"../../common/resources/textures/awesomeface.png", GL_RGBA);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    double lastTitleUpdate = glfwGetTime();
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio, 0.1f, FAR_PLANE);
+        CullStats stats = cullScene(scene, view, projection, &occlusion, instances);
+        pool.setInstanceData(instances);
+
+        // show how many cubes survived the culling once per second
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::string title = "LearnOpenGL - cubes in frustum " + std::to_string(stats.frustumVisible) + ", not occluded " + std::to_string(stats.drawn);
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+        }
+
+        // render
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", view);
+        ShaderProgram.setMat4("projection", projection);
+
+        pool.bind();
+        glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, GL_UNSIGNED_INT, (void*)(cube.firstIndex*sizeof(GLuint)), static_cast<GLsizei>(instances.size()));
+        glBindVertexArray(0);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    pool.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkOcclusionCulling()
+{
+    // Benchmark: the camera pans over the scene along a fixed path; for every frame the cubes are culled
+    //  a) against the frustum only
+    //  b) against the frustum and the Hi-Z pyramid of the walls
+    // and the surviving cubes are drawn. Reports the culled fraction, the culling time and the end-to-end frame time (glFinish)
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+
+    glEnable(GL_DEPTH_TEST);
+
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    ShaderProgram.use();
+    ShaderProgram.setFloat("mixValue", 0.2f);
+
+    OcclusionScene scene;
+    buildScene(scene);
+
+    MeshPool pool;
+    MeshRange cube = pool.addBox(glm::vec3(1.0f));
+    pool.upload();
+
+    OcclusionCuller occlusion;
+    std::vector<glm::mat4> instances;
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    const int frames = 60;
+
+    std::cout << "cubes: " << scene.cubePositions.size() << ", occluder triangles: " << 12*scene.wallModels.size()
+              << ", Hi-Z buffer: " << occlusion.getWidth() << "x" << occlusion.getHeight() << std::endl;
+    std::cout << std::setw(20) << "culling" << std::setw(16) << "in frustum" << std::setw(12) << "drawn"
+              << std::setw(18) << "occluded [%]" << std::setw(14) << "cull [ms]" << std::setw(15) << "frame [ms]" << std::endl;
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        OcclusionCuller* occlusionCuller = mode == 1 ? &occlusion : nullptr;
+        double cullTime = 0.0, frameTime = 0.0;
+        size_t frustumVisible = 0, drawn = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            // deterministic camera path: pan from left to right while moving slowly forward
+            Camera pathCamera(glm::vec3(-20.0f + 40.0f*frame/frames, 1.0f, 5.0f - 0.1f*frame), glm::vec3(0.0f, 1.0f, 0.0f), -110.0f + 40.0f*frame/frames, 0.0f);
+            glm::mat4 view = pathCamera.GetViewMatrix();
+            glm::mat4 projection = pathCamera.GetProjectionMatrix(aspectRatio, 0.1f, FAR_PLANE);
+
+            auto frameStart = std::chrono::steady_clock::now();
+            CullStats stats = cullScene(scene, view, projection, occlusionCuller, instances);
+            cullTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+            frustumVisible += stats.frustumVisible;
+            drawn += stats.drawn;
+
+            pool.setInstanceData(instances);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            ShaderProgram.setMat4("view", view);
+            ShaderProgram.setMat4("projection", projection);
+            pool.bind();
+            glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, GL_UNSIGNED_INT, (void*)(cube.firstIndex*sizeof(GLuint)), static_cast<GLsizei>(instances.size()));
+            glBindVertexArray(0);
+            glFinish();
+            frameTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        }
+
+        std::cout << std::setw(20) << (mode == 0 ? "frustum" : "frustum + Hi-Z")
+                  << std::setw(16) << frustumVisible/frames << std::setw(12) << drawn/frames
+                  << std::setw(18) << std::fixed << std::setprecision(1) << 100.0*(frustumVisible - drawn)/std::max<size_t>(1, frustumVisible)
+                  << std::setw(14) << std::setprecision(3) << cullTime/frames
+                  << std::setw(15) << frameTime/frames << std::endl;
+    }
+
+    pool.destroy();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,628 @@
+// Split the update stage (input, camera, transforms, draw list) from a render thread which owns the GL context; the two
+// threads exchange double or triple buffered frame packets, so the update of frame N+1 overlaps the submission of frame N
+// The main thread only pumps the window events: the GLFW callbacks push them with their time into a lock-free queue which
+// the update thread drains, so no callback touches the camera or the viewport while another thread reads them
+// Keys are not polled with glfwGetKey: the key events build an input snapshot (key bitsets) which an action mapping table
+// turns into the actions of the update. The camera and the containers are simulated with a fixed timestep (key events are
+// applied to the step in which they happened) and the frame packets interpolate between the last two simulated states
+// Use: Shader class and files, camera object, Scene (meshes, draw list entries), FramePacketQueue, InputEventQueue,
+// InputState and ActionMap, FixedTimestep, GLFW context handover
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+#include <frame_packets.h>
+#include <event_queue.h>
+#include <input_state.h>
+#include <fixed_timestep.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_renderthread";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for the simulation (w-a-s-d movement, mix value, rotating containers): fixed steps per second and at most this
+    // many steps per frame (--step-rate, --max-steps)
+    double stepRate = 120.0;
+    unsigned maxStepsPerFrame = 8;
+    FixedTimestep timestep;
+    const float MIX_SPEED = 0.3f; // mix value change per second
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // framebuffer size, updated from the framebuffer size events on the update thread
+    int viewportWidth = SCR_WIDTH;
+    int viewportHeight = SCR_HEIGHT;
+
+    // events recorded by the callbacks on the main thread, applied by the update thread
+    InputEventQueue inputEvents;
+    // keyboard snapshot built from the key events applied so far and the key events waiting for their simulation step
+    // (update thread)
+    InputState input;
+    std::vector<InputEvent> pendingKeyEvents;
+
+    // actions of the update and the keys bound to them
+    enum Action
+    {
+        ACTION_QUIT,
+        ACTION_MIX_UP,
+        ACTION_MIX_DOWN,
+        ACTION_FORWARD,
+        ACTION_BACKWARD,
+        ACTION_LEFT,
+        ACTION_RIGHT
+    };
+    const ActionBinding ACTION_BINDINGS[] = {
+        {ACTION_QUIT,     GLFW_KEY_ESCAPE, ACTION_ON_PRESS},
+        {ACTION_MIX_UP,   GLFW_KEY_UP,     ACTION_WHILE_DOWN},
+        {ACTION_MIX_DOWN, GLFW_KEY_DOWN,   ACTION_WHILE_DOWN},
+        {ACTION_FORWARD,  GLFW_KEY_W,      ACTION_WHILE_DOWN},
+        {ACTION_BACKWARD, GLFW_KEY_S,      ACTION_WHILE_DOWN},
+        {ACTION_LEFT,     GLFW_KEY_A,      ACTION_WHILE_DOWN},
+        {ACTION_RIGHT,    GLFW_KEY_D,      ACTION_WHILE_DOWN}
+    };
+    const ActionMap actionMap(ACTION_BINDINGS, sizeof(ACTION_BINDINGS)/sizeof(ACTION_BINDINGS[0]));
+    // events applied and how long they waited in the queue (update thread)
+    unsigned long long eventsApplied = 0;
+    double eventDelaySum = 0.0;
+    double eventDelayMax = 0.0;
+
+    // frames swapped by the render thread, for the FPS shown in the title by the main thread
+    std::atomic<unsigned> framesSwapped(0);
+
+    // containers per side of the grid
+    const unsigned GRID_SIZE = 16;
+}
+
+// What the fixed steps simulate and the frames interpolate (the camera orientation and zoom follow the mouse right away)
+struct SimulationState
+{
+    glm::vec3 CameraPosition;
+    float Time;
+    float MixValue;
+};
+
+// GL objects of a scene: one VAO/VBO per mesh as in the samples, both textures and the shaders of hello_camera_class
+// Created on the main thread before the context is handed over to the render thread, which is the only one using them
+struct SceneResources
+{
+    Shader ShaderProgram;
+    std::vector<GLuint> VAOs;
+    std::vector<GLuint> VBOs;
+    GLuint Textures[2];
+
+    SceneResources(const Scene &scene, const std::string &relPathExePro);
+    void destroy();
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window, uint64_t actions, float stepTime);
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+void processEvents(double now);
+void applyKeyEvents(double stepEndTime);
+SimulationState interpolate(const SimulationState &previous, const SimulationState &current, float alpha);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+void updatePacket(FramePacket &packet, const Scene &scene, float time, float mixValue, const glm::mat4 &view, const glm::mat4 &projection);
+void renderPacket(const FramePacket &packet, const Scene &scene, SceneResources &resources);
+void renderThreadLoop(GLFWwindow* window, FramePacketQueue* queue, const Scene* scene, SceneResources* resources);
+void updateThreadLoop(GLFWwindow* window, FramePacketQueue* queue, const Scene* scene);
+
+int drawWithRenderThread();
+int benchmarkRenderThread();
+
+// process all input: react to the actions triggered by the keyboard snapshot of one simulation step
+void processInput(GLFWwindow *window, uint64_t actions, float stepTime)
+{
+    if (isActionActive(actions, ACTION_QUIT))
+    {
+        glfwSetWindowShouldClose(window, true);
+        glfwPostEmptyEvent(); // wake the main thread waiting for events
+    }
+
+    if (isActionActive(actions, ACTION_MIX_UP))
+    {
+        mixValueFromKey += MIX_SPEED*stepTime;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (isActionActive(actions, ACTION_MIX_DOWN))
+    {
+        mixValueFromKey -= MIX_SPEED*stepTime;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (isActionActive(actions, ACTION_FORWARD))
+        camera.ProcessKeyboard(FORWARD, stepTime);
+    if (isActionActive(actions, ACTION_BACKWARD))
+        camera.ProcessKeyboard(BACKWARD, stepTime);
+    if (isActionActive(actions, ACTION_LEFT))
+        camera.ProcessKeyboard(LEFT, stepTime);
+    if (isActionActive(actions, ACTION_RIGHT))
+        camera.ProcessKeyboard(RIGHT, stepTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // the GL context belongs to the render thread: the new size travels with the next frame packet, which calls glViewport
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_FRAMEBUFFER_SIZE;
+    event.Time = glfwGetTime();
+    event.Width = width;
+    event.Height = height;
+    inputEvents.push(event);
+}
+
+// glfw: whenever a key is pressed, repeated or released, this callback is called
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_KEY;
+    event.Time = glfwGetTime();
+    event.Key = key;
+    event.Scancode = scancode;
+    event.Action = action;
+    event.Mods = mods;
+    inputEvents.push(event);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_CURSOR_POS;
+    event.Time = glfwGetTime();
+    event.X = xpos;
+    event.Y = ypos;
+    inputEvents.push(event);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    InputEvent event = InputEvent();
+    event.Type = INPUT_EVENT_SCROLL;
+    event.Time = glfwGetTime();
+    event.X = xScrollOffset;
+    event.Y = yScrollOffset;
+    inputEvents.push(event);
+}
+
+// Update thread: applies the queued mouse and framebuffer size events in the order they happened and keeps the key events
+// for the simulation steps (now is the time of the update, to measure how long the events waited)
+void processEvents(double now)
+{
+    InputEvent event;
+    while (inputEvents.pop(event))
+    {
+        switch (event.Type)
+        {
+        case INPUT_EVENT_KEY:
+            pendingKeyEvents.push_back(event);
+            break;
+        case INPUT_EVENT_CURSOR_POS:
+        {
+            if(firstTimeMouseMoved)
+            {
+                lastX = event.X;
+                lastY = event.Y;
+                firstTimeMouseMoved = false;
+            }
+
+            float xMouseOffset = event.X - lastX;
+            float yMouseOffset = lastY - event.Y;
+            lastX = event.X;
+            lastY = event.Y;
+
+            camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+            break;
+        }
+        case INPUT_EVENT_SCROLL:
+            camera.ProcessMouseScroll(event.Y);
+            break;
+        case INPUT_EVENT_FRAMEBUFFER_SIZE:
+            viewportWidth = event.Width;
+            viewportHeight = event.Height;
+            break;
+        }
+
+        const double delay = now - event.Time;
+        eventDelaySum += delay;
+        eventDelayMax = std::max(eventDelayMax, delay);
+        ++eventsApplied;
+    }
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// load image, create texture (RGB or RGBA depending on the file) and generate mipmaps
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+SceneResources::SceneResources(const Scene &scene, const std::string &relPathExePro)
+    : ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str())
+{
+    VAOs.resize(scene.Meshes.size());
+    VBOs.resize(scene.Meshes.size());
+    glGenVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glGenBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    for (size_t i = 0; i < scene.Meshes.size(); ++i)
+    {
+        glBindVertexArray(VAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, scene.Meshes[i].Vertices.size()*sizeof(float), scene.Meshes[i].Vertices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    Textures[0] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[0]);
+    Textures[1] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[1]);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+}
+
+void SceneResources::destroy()
+{
+    glDeleteVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glDeleteBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    glDeleteTextures(2, Textures);
+    glDeleteProgram(ShaderProgram.ID);
+}
+
+// Update stage: camera matrices and the draw list of the frame (every third container rotates over time)
+void updatePacket(FramePacket &packet, const Scene &scene, float time, float mixValue, const glm::mat4 &view, const glm::mat4 &projection)
+{
+    packet.View = view;
+    packet.Projection = projection;
+    packet.MixValue = mixValue;
+    packet.ViewportWidth = viewportWidth;
+    packet.ViewportHeight = viewportHeight;
+    packet.DrawList.resize(scene.Objects.size());
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        packet.DrawList[i] = scene.Objects[i];
+        if (i % 3 == 0) // make every third container rotate over time
+            packet.DrawList[i].Model = glm::rotate(scene.Objects[i].Model, time*glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+    }
+}
+
+// Render stage: only reads the packet and issues the GL calls
+void renderPacket(const FramePacket &packet, const Scene &scene, SceneResources &resources)
+{
+    glViewport(0, 0, packet.ViewportWidth, packet.ViewportHeight);
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // activate texture units and bind them
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, resources.Textures[1]);
+
+    resources.ShaderProgram.use();
+    resources.ShaderProgram.setFloat("mixValue", packet.MixValue);
+    resources.ShaderProgram.setMat4("view", packet.View);
+    resources.ShaderProgram.setMat4("projection", packet.Projection);
+    for (size_t i = 0; i < packet.DrawList.size(); ++i)
+    {
+        const SceneObject &object = packet.DrawList[i];
+        const SceneMesh &mesh = scene.Meshes[object.Mesh];
+        resources.ShaderProgram.setMat4("model", object.Model);
+        glBindVertexArray(resources.VAOs[object.Mesh]);
+        glDrawArrays(mesh.Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, 0, mesh.vertexCount());
+    }
+    glBindVertexArray(0);
+}
+
+// Render thread: takes over the GL context and draws the queued packets until the queue is closed
+void renderThreadLoop(GLFWwindow* window, FramePacketQueue* queue, const Scene* scene, SceneResources* resources)
+{
+    glfwMakeContextCurrent(window);
+    glEnable(GL_DEPTH_TEST);
+    for (const FramePacket* packet = queue->beginRead(); packet != nullptr; packet = queue->beginRead())
+    {
+        renderPacket(*packet, *scene, *resources);
+        // the GL calls have copied everything they need, so the update thread may refill the packet during the swap
+        queue->endRead();
+        glfwSwapBuffers(window);
+        framesSwapped.fetch_add(1, std::memory_order_relaxed);
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+// Update thread: applies the input events, runs the simulation steps due and fills the frame packets until the window should
+// close
+void updateThreadLoop(GLFWwindow* window, FramePacketQueue* queue, const Scene* scene)
+{
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    pendingKeyEvents.reserve(InputEventQueue::CAPACITY);
+
+    SimulationState current = {camera.Position, 0.0f, mixValueFromKey};
+    SimulationState previous = current;
+    timestep.reset(glfwGetTime());
+    while (!glfwWindowShouldClose(window))
+    {
+        // waits for a free packet first, so the input is sampled as late as possible for the frame
+        FramePacket* packet = queue->beginWrite();
+        if (packet == nullptr)
+            break;
+
+        const double now = glfwGetTime();
+        processEvents(now);
+
+        // fixed steps: the same movement for the same key presses at any frame rate
+        const unsigned steps = timestep.advance(now);
+        const float stepTime = static_cast<float>(timestep.getStepTime());
+        for (unsigned step = 0; step < steps; ++step)
+        {
+            previous = current;
+            input.nextFrame();
+            applyKeyEvents(timestep.getStepEndTime(step));
+            processInput(window, actionMap.evaluate(input), stepTime);
+            current.CameraPosition = camera.Position;
+            current.Time += stepTime;
+            current.MixValue = mixValueFromKey;
+        }
+
+        // the frame shows the state between the last two steps which matches the time of the frame
+        const SimulationState frame = interpolate(previous, current, timestep.getAlpha());
+        const glm::mat4 view = glm::lookAt(frame.CameraPosition, frame.CameraPosition + camera.Front, camera.Up);
+        updatePacket(*packet, *scene, frame.Time, frame.MixValue, view, camera.GetProjectionMatrix(aspectRatio));
+        queue->endWrite();
+    }
+
+    // let the render thread draw the queued packets and stop
+    queue->close();
+}
+
+// Update thread: applies the key events which happened up to the end of a simulation step
+void applyKeyEvents(double stepEndTime)
+{
+    size_t applied = 0;
+    while (applied < pendingKeyEvents.size() && pendingKeyEvents[applied].Time <= stepEndTime)
+    {
+        input.applyKeyEvent(pendingKeyEvents[applied].Key, pendingKeyEvents[applied].Action);
+        ++applied;
+    }
+    pendingKeyEvents.erase(pendingKeyEvents.begin(), pendingKeyEvents.begin() + applied);
+}
+
+SimulationState interpolate(const SimulationState &previous, const SimulationState &current, float alpha)
+{
+    SimulationState state;
+    state.CameraPosition = glm::mix(previous.CameraPosition, current.CameraPosition, alpha);
+    state.Time = previous.Time + (current.Time - previous.Time)*alpha;
+    state.MixValue = previous.MixValue + (current.MixValue - previous.MixValue)*alpha;
+    return state;
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --benchmark: headless comparison of the single threaded loop against the render thread with 2 and 3 frame packets
+    // --step-rate N: simulation steps per second (default 120), --max-steps N: at most N steps per frame (default 8)
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+        else if (strcmp(argv[i], "--step-rate") == 0 && i + 1 < argc)
+            stepRate = std::max(1.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc)
+            maxStepsPerFrame = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+    }
+    timestep = FixedTimestep(1.0/stepRate, maxStepsPerFrame);
+
+    if (benchmark)
+        return benchmarkRenderThread();
+    return drawWithRenderThread();
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawWithRenderThread()
+{
+    // The main thread pumps the events into the input queue, the update thread applies them, moves the camera and fills the
+    // frame packets, the render thread submits them
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    Scene scene = makeCubeGridScene(GRID_SIZE);
+    SceneResources resources(scene, relPathExePro);
+
+    // hand the context over to the render thread (a context can only be current on one thread at a time)
+    glfwMakeContextCurrent(nullptr);
+    FramePacketQueue queue(3);
+    std::thread renderThread(renderThreadLoop, window, &queue, &scene, &resources);
+    std::thread updateThread(updateThreadLoop, window, &queue, &scene);
+
+    double lastTitleUpdate = glfwGetTime();
+    unsigned framesAtTitleUpdate = 0;
+
+    // event loop: GLFW requires the events to be processed on the main thread, the callbacks only queue them
+    while (!glfwWindowShouldClose(window))
+    {
+        // returns as soon as events arrive, the timeout keeps the title up to date
+        glfwWaitEventsTimeout(0.1);
+
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            const unsigned frames = framesSwapped.load(std::memory_order_relaxed);
+            std::string title = "LearnOpenGL - " + std::to_string(static_cast<int>((frames - framesAtTitleUpdate)/(glfwGetTime() - lastTitleUpdate))) + " FPS with a render thread";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+            framesAtTitleUpdate = frames;
+        }
+    }
+
+    // the update thread closes the packet queue, then the render thread draws the queued packets and gives the context back
+    updateThread.join();
+    renderThread.join();
+    glfwMakeContextCurrent(window);
+
+    std::cout << eventsApplied << " input events applied, " << std::fixed << std::setprecision(3)
+              << (eventsApplied > 0 ? 1000.0*eventDelaySum/eventsApplied : 0.0) << " ms mean and " << 1000.0*eventDelayMax
+              << " ms max delay between callback and update, " << inputEvents.getDroppedCount() << " dropped" << std::endl;
+    std::cout << timestep.getStepCount() << " simulation steps of " << 1000.0*timestep.getStepTime() << " ms ("
+              << timestep.getSimulationTime() << " s simulated, " << timestep.getDroppedTime()
+              << " s dropped by the limit of " << timestep.getMaxStepsPerFrame() << " steps per frame)" << std::endl;
+
+    // de-allocate all resources once they've outlived their purpose:
+    resources.destroy();
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkRenderThread()
+{
+    // Benchmark: the same frames (update of the draw list of a 16^3 grid of containers + one draw call per container) are
+    //  a) updated and submitted one after another on the main thread
+    //  b) updated on the main thread and submitted by the render thread, with 2 (double) and 3 (triple buffered) packets
+    // Reports the frame rate and how long each thread waited for the other one
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeCubeGridScene(GRID_SIZE);
+    SceneResources resources(scene, relPathExePro);
+    const int frames = 200;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
+
+    std::cout << scene.Objects.size() << " draw calls per frame, " << frames << " frames, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::setw(26) << "loop" << std::setw(10) << "FPS" << std::setw(22) << "update waited [ms]" << std::setw(22) << "render waited [ms]" << std::endl;
+
+    // a) single threaded
+    FramePacket packet;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        const float time = frame/60.0f;
+        updatePacket(packet, scene, time, mixValueFromKey, glm::lookAt(glm::vec3(8.0f*std::sin(time), 2.0f, 16.0f), glm::vec3(0.0f, 0.0f, -12.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+        renderPacket(packet, scene, resources);
+        glfwSwapBuffers(window);
+    }
+    glFinish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(26) << "single thread" << std::fixed << std::setprecision(1) << std::setw(10) << frames/seconds
+              << std::setw(22) << "-" << std::setw(22) << "-" << std::endl;
+
+    // b) render thread
+    for (size_t packetCount = 2; packetCount <= 3; ++packetCount)
+    {
+        glfwMakeContextCurrent(nullptr);
+        FramePacketQueue queue(packetCount);
+        start = std::chrono::steady_clock::now();
+        std::thread renderThread(renderThreadLoop, window, &queue, &scene, &resources);
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float time = frame/60.0f;
+            FramePacket* next = queue.beginWrite();
+            updatePacket(*next, scene, time, mixValueFromKey, glm::lookAt(glm::vec3(8.0f*std::sin(time), 2.0f, 16.0f), glm::vec3(0.0f, 0.0f, -12.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+            queue.endWrite();
+        }
+        queue.close();
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+        glFinish();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(26) << ("render thread, " + std::to_string(packetCount) + " packets") << std::setw(10) << frames/seconds
+                  << std::setw(22) << queue.getWriterWaitTime() << std::setw(22) << queue.getReaderWaitTime() << std::endl;
+    }
+
+    resources.destroy();
+    glfwTerminate();
+    return 0;
+}
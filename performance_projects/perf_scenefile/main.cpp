@@ -0,0 +1,501 @@
+// Scenes loaded from binary scene files (common/scene_file.h) instead of being compiled into main.cpp: a text description
+// (containers.scene) is compiled once into a file of aligned sections, which is memory mapped at load and handed to
+// OpenGL in place as the vertex, index and instance buffers, without parsing anything
+// Use: Shader class and files, SceneFile (mapped binary scene), writeSceneFile and parseSceneDescription (authoring),
+//      camera object, instanced draws with a base vertex
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+#include <scene_file.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_scenefile";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // benchmark settings: containers per side of the generated scene (--grid), loads per format (--runs) and whether the
+    // files are dropped from the page cache before every load (--cold, Linux only)
+    unsigned benchmarkGrid = 100;
+    int benchmarkRuns = 3;
+    bool benchmarkCold = false;
+}
+
+// The buffers of a scene on the GPU: one VBO/EBO pair for all the meshes and the model matrices of all the instances,
+// behind one VAO. Every batch is one instanced draw of its mesh (base vertex) starting at its first instance (the
+// instanced attribute is pointed at it, glDrawElementsInstancedBaseVertexBaseInstance needs OpenGL 4.2)
+struct SceneBuffers
+{
+    GLuint VAO;
+    GLuint VBO;
+    GLuint EBO;
+    GLuint InstanceVBO;
+
+    SceneBuffers() : VAO(0), VBO(0), EBO(0), InstanceVBO(0) {}
+
+    // the arrays can be the sections of a mapped scene file: glBufferData reads them straight from the mapping
+    void upload(const float* vertices, uint64_t vertexCount, const uint32_t* indices, uint64_t indexCount,
+                const glm::mat4* instances, uint64_t instanceCount)
+    {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glGenBuffers(1, &InstanceVBO);
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount*SceneMesh::VERTEX_SIZE*sizeof(float), vertices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE*sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE*sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount*sizeof(uint32_t), indices, GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceCount*sizeof(glm::mat4), instances, GL_STATIC_DRAW);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(2 + column);
+            glVertexAttribDivisor(2 + column, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void draw(const SceneFileMesh* meshes, const SceneFileBatch* batches, uint64_t batchCount) const
+    {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+        for (uint64_t b = 0; b < batchCount; ++b)
+        {
+            const SceneFileBatch &batch = batches[b];
+            const SceneFileMesh &mesh = meshes[batch.Mesh];
+            for (GLuint column = 0; column < 4; ++column)
+                glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                      (void*)(batch.FirstInstance*sizeof(glm::mat4) + column*sizeof(glm::vec4)));
+            glDrawElementsInstancedBaseVertex(mesh.Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, mesh.IndexCount, GL_UNSIGNED_INT,
+                                              (void*)(mesh.FirstIndex*sizeof(uint32_t)), batch.InstanceCount, mesh.FirstVertex);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    void destroy()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteBuffers(1, &InstanceVBO);
+        VAO = VBO = EBO = InstanceVBO = 0;
+    }
+};
+
+// page faults of the process so far (minor: page already in memory, major: read from disk)
+struct PageFaults
+{
+    long Minor;
+    long Major;
+
+    static PageFaults now()
+    {
+        PageFaults faults = { 0, 0 };
+#ifdef __linux__
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            faults.Minor = usage.ru_minflt;
+            faults.Major = usage.ru_majflt;
+        }
+#endif
+        return faults;
+    }
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+bool compileScene(const std::string &descriptionPath, const std::string &scenePath);
+void dropFromPageCache(const std::string &path);
+double milliseconds(std::chrono::steady_clock::time_point start);
+
+int drawSceneFile(const std::string &scenePath);
+int benchmarkSceneFile();
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// the authoring step: text description to binary scene file
+bool compileScene(const std::string &descriptionPath, const std::string &scenePath)
+{
+    Scene scene;
+    if (!parseSceneDescription(descriptionPath, scene) || !writeSceneFile(scenePath, scene))
+        return false;
+    std::cout << descriptionPath << " compiled to " << scenePath << ": " << scene.Meshes.size() << " meshes, "
+              << scene.Objects.size() << " objects" << std::endl;
+    return true;
+}
+
+// --cold: the next load of the file has to read it from the disk (its pages are written back and dropped from the cache)
+void dropFromPageCache(const std::string &path)
+{
+#ifdef __linux__
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return;
+    fdatasync(descriptor);
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+    close(descriptor);
+#endif
+}
+
+double milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --compile DESCRIPTION SCENE: compile a text description into a binary scene file
+    // --benchmark [--grid N] [--runs N] [--cold]: headless load times of a generated scene, text against binary
+    // SCENE: draw a binary scene file; without arguments containers.scene is compiled and drawn
+    if (argc > 3 && strcmp(argv[1], "--compile") == 0)
+        return compileScene(argv[2], argv[3]) ? 0 : -1;
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+    {
+        for (int i = 2; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc)
+                benchmarkGrid = std::max(1, atoi(argv[++i]));
+            else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+                benchmarkRuns = std::max(1, atoi(argv[++i]));
+            else if (strcmp(argv[i], "--cold") == 0)
+                benchmarkCold = true;
+        }
+        return benchmarkSceneFile();
+    }
+    if (argc > 1)
+        return drawSceneFile(argv[1]);
+
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+    if (!compileScene(relPathExePro+"containers.scene", "containers.bin"))
+        return -1;
+    return drawSceneFile("containers.bin");
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawSceneFile(const std::string &scenePath)
+{
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    SceneFile scene;
+    if (!scene.open(scenePath))
+        return -1;
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    // build and compile the shader program
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+
+    GLuint textures[2];
+    for (int i = 0; i < 2; ++i)
+        textures[i] = loadTexture(relPathExePro+"../../common/"+scene.getTexturePath(i));
+    mixValueFromKey = scene.getSettings().MixValue;
+
+    // the sections of the mapped file are the buffers
+    SceneBuffers buffers;
+    buffers.upload(scene.getVertices(), scene.getVertexCount(), scene.getIndices(), scene.getIndexCount(),
+                   scene.getInstances(), scene.getInstanceCount());
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    ShaderProgram.use();
+    ShaderProgram.setInt("texture1", 0);
+    ShaderProgram.setInt("texture2", 1);
+
+    const float* clearColor = scene.getSettings().ClearColor;
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        // render
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // activate texture units and bind them
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ShaderProgram.use();
+        ShaderProgram.setFloat("mixValue", mixValueFromKey);
+        ShaderProgram.setMat4("view", camera.GetViewMatrix());
+        ShaderProgram.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT));
+        buffers.draw(scene.getMeshes(), scene.getBatches(), scene.getBatchCount());
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    buffers.destroy();
+    glDeleteTextures(2, textures);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkSceneFile()
+{
+    // Benchmark: a scene of grid^3 containers (one object line each) is written as text description and compiled to a
+    // binary scene file, then both are loaded into GL buffers (glFinish included) in a hidden window, best of --runs
+    //  text   : parseSceneDescription, deduplication and batching (SceneFileContent), upload
+    //  binary : SceneFile::open (map and check) and upload straight from the mapping
+
+    const std::string descriptionPath = project_name + "_benchmark.scene";
+    const std::string scenePath = project_name + "_benchmark.bin";
+    {
+        std::ofstream description(descriptionPath.c_str());
+        description << "texture1 resources/textures/container.jpg\ntexture2 resources/textures/awesomeface.png\n"
+                    << "mesh cube cube\nmesh axes axes\nobject axes 0 0 0\n";
+        const float offset = 0.75f*(benchmarkGrid - 1);
+        for (unsigned x = 0; x < benchmarkGrid; ++x)
+            for (unsigned y = 0; y < benchmarkGrid; ++y)
+                for (unsigned z = 0; z < benchmarkGrid; ++z)
+                    description << "object cube " << 1.5f*x - offset << " " << 1.5f*y - offset << " " << -1.5f*z - 2.0f
+                                << " rotate " << 20*((x + y + z) % 18) << " 1 0.3 0.5 scale 0.5\n";
+        if (!description)
+        {
+            std::cout << "ERROR::PERF_SCENEFILE::WRITE_FAILED: " << descriptionPath << std::endl;
+            return -1;
+        }
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!compileScene(descriptionPath, scenePath))
+        return -1;
+    std::cout << "compile time: " << milliseconds(start) << " ms" << std::endl;
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+
+    const char* names[2] = { "text", "binary" };
+    const std::string paths[2] = { descriptionPath, scenePath };
+    std::cout << std::setw(8) << "format" << std::setw(12) << "size [MB]" << std::setw(12) << "load [ms]" << std::setw(10) << "MB/s"
+              << std::setw(16) << "minor faults" << std::setw(14) << "major faults" << (benchmarkCold ? "   (cold page cache)" : "") << std::endl;
+    for (int format = 0; format < 2; ++format)
+    {
+        double best = 0.0;
+        PageFaults bestFaults = { 0, 0 };
+        double megabytes = 0.0;
+        for (int run = 0; run < benchmarkRuns; ++run)
+        {
+            if (benchmarkCold)
+                dropFromPageCache(paths[format]);
+            SceneBuffers buffers;
+            PageFaults faults = PageFaults::now();
+            start = std::chrono::steady_clock::now();
+            if (format == 0)
+            {
+                Scene scene;
+                SceneFileContent content;
+                if (!parseSceneDescription(descriptionPath, scene))
+                    return -1;
+                content.build(scene);
+                buffers.upload(content.Vertices.data(), content.Vertices.size() / SceneMesh::VERTEX_SIZE, content.Indices.data(),
+                               content.Indices.size(), content.Instances.data(), content.Instances.size());
+                glFinish();
+                std::ifstream file(descriptionPath.c_str(), std::ios::binary | std::ios::ate);
+                megabytes = static_cast<double>(file.tellg())/(1024.0*1024.0);
+            }
+            else
+            {
+                SceneFile scene;
+                if (!scene.open(scenePath))
+                    return -1;
+                buffers.upload(scene.getVertices(), scene.getVertexCount(), scene.getIndices(), scene.getIndexCount(),
+                               scene.getInstances(), scene.getInstanceCount());
+                glFinish();
+                megabytes = static_cast<double>(scene.getFileSize())/(1024.0*1024.0);
+            }
+            const double time = milliseconds(start);
+            const PageFaults after = PageFaults::now();
+            buffers.destroy();
+            if (run == 0 || time < best)
+            {
+                best = time;
+                bestFaults.Minor = after.Minor - faults.Minor;
+                bestFaults.Major = after.Major - faults.Major;
+            }
+        }
+        std::cout << std::setw(8) << names[format] << std::fixed << std::setprecision(1) << std::setw(12) << megabytes
+                  << std::setw(12) << best << std::setw(10) << megabytes/(best/1000.0)
+                  << std::setw(16) << bestFaults.Minor << std::setw(14) << bestFaults.Major << std::endl;
+    }
+
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,313 @@
+// Loading a large shader library: a generated set of programs whose shaders #include shared modules (which include a
+// common file themselves) is loaded the classic way, every file read through std::ifstream into a std::stringstream and
+// the includes pasted into one std::string per shader, and through ShaderSourceCache, which maps every file once per
+// session and hands glShaderSource the pieces of the mapped files without copying them. Reports the time, file reads and
+// bytes copied of both, then compiles a few programs both ways (and with the Shader class) to check they link alike
+// Use: ShaderSourceCache, ShaderSource, Shader class
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <sys/stat.h>
+#include <shader.h>
+#include <shader_source.h>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_shaderload";
+
+    // library settings
+    std::string libraryDir = "shader_library";  // --dir DIR: where the library is generated
+    unsigned programCount = 200;                // --programs N
+    unsigned moduleCount = 32;                  // --modules N: shared files in DIR/lib
+    unsigned includeCount = 8;                  // --includes N: modules included by every shader
+    const unsigned FUNCTIONS_PER_MODULE = 24;
+
+    unsigned runs = 5;                          // --runs N: loads of the whole library, the median is reported
+    unsigned compileCount = 8;                  // --compile N: programs compiled both ways
+
+    // classic loading: files opened and bytes copied into strings
+    uint64_t classicReads = 0;
+    uint64_t classicBytesCopied = 0;
+}
+
+bool generateLibrary();
+std::string programPath(unsigned program, const char *stage);
+std::string readClassic(const std::string &path, std::unordered_set<std::string> &included);
+GLuint compileClassic(const std::string &vertexPath, const std::string &fragmentPath);
+GLuint compileMapped(ShaderSourceCache &cache, const std::string &vertexPath, const std::string &fragmentPath);
+GLuint linkProgram(GLuint vertex, GLuint fragment);
+double median(std::vector<double> times);
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // perf_shaderload [--dir DIR] [--programs N] [--modules N] [--includes N] [--runs N] [--compile N]
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const unsigned value = static_cast<unsigned>(std::max(1, atoi(argv[i + 1])));
+        if (strcmp(argv[i], "--dir") == 0)
+            libraryDir = argv[i + 1];
+        else if (strcmp(argv[i], "--programs") == 0)
+            programCount = value;
+        else if (strcmp(argv[i], "--modules") == 0)
+            moduleCount = value;
+        else if (strcmp(argv[i], "--includes") == 0)
+            includeCount = value;
+        else if (strcmp(argv[i], "--runs") == 0)
+            runs = value;
+        else if (strcmp(argv[i], "--compile") == 0)
+            compileCount = value;
+    }
+    includeCount = std::min(includeCount, moduleCount);
+    compileCount = std::min(compileCount, programCount);
+    if (!generateLibrary())
+        return -1;
+
+    // classic: every shader reads its files again and builds one string
+    std::vector<double> classicTimes;
+    size_t classicSourceBytes = 0;
+    for (unsigned run = 0; run < runs; ++run)
+    {
+        classicReads = classicBytesCopied = 0;
+        classicSourceBytes = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned program = 0; program < programCount; ++program)
+            for (const char *stage : { "vert", "frag" })
+            {
+                std::unordered_set<std::string> included;
+                classicSourceBytes += readClassic(programPath(program, stage), included).size();
+            }
+        classicTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // mapped: the first run maps every file (a fresh session), the following ones find them in the cache
+    std::vector<double> mappedTimes;
+    double coldTime = 0.0;
+    size_t pieces = 0, mappedSourceBytes = 0;
+    ShaderSourceCache cache;
+    ShaderSource source;
+    for (unsigned run = 0; run <= runs; ++run)
+    {
+        pieces = mappedSourceBytes = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned program = 0; program < programCount; ++program)
+            for (const char *stage : { "vert", "frag" })
+            {
+                if (!cache.load(programPath(program, stage), source))
+                    return -1;
+                pieces += source.Strings.size();
+                mappedSourceBytes += source.Bytes;
+            }
+        const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0)
+            coldTime = time;
+        else
+            mappedTimes.push_back(time);
+    }
+
+    const unsigned shaders = 2*programCount;
+    std::cout << programCount << " programs (" << shaders << " shaders) including " << includeCount << " of " << moduleCount
+              << " modules each, median of " << runs << " loads" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "classic (ifstream, stringstream, string): " << median(classicTimes) << " ms, " << classicReads
+              << " file reads, " << classicBytesCopied/1024 << " KiB copied into strings, " << classicSourceBytes/1024
+              << " KiB of source" << std::endl;
+    std::cout << "mapped (ShaderSourceCache): " << coldTime << " ms first load, " << median(mappedTimes) << " ms cached, "
+              << cache.getFileCount() << " files mapped once (" << cache.getBytesMapped()/1024 << " KiB), 0 bytes copied, "
+              << std::setprecision(1) << double(pieces)/shaders << " pieces per glShaderSource" << std::endl;
+
+    // compile a few programs both ways on a hidden context
+    GLFWwindow* window = createGLWindow(64, 64, "LearnOpenGL", false);
+    if (window == nullptr)
+        return -1;
+
+    unsigned linked = 0;
+    double classicCompile = 0.0, mappedCompile = 0.0;
+    for (unsigned program = 0; program < compileCount; ++program)
+    {
+        const std::string vertexPath = programPath(program, "vert"), fragmentPath = programPath(program, "frag");
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const GLuint classic = compileClassic(vertexPath, fragmentPath);
+        classicCompile += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        const GLuint mapped = compileMapped(cache, vertexPath, fragmentPath);
+        mappedCompile += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Shader shader(vertexPath.c_str(), fragmentPath.c_str());
+        linked += classic != 0 && mapped != 0 && glIsProgram(shader.ID);
+        glDeleteProgram(classic);
+        glDeleteProgram(mapped);
+        glDeleteProgram(shader.ID);
+    }
+    std::cout << linked << " of " << compileCount << " programs linked both ways (load and compile: classic "
+              << std::setprecision(2) << classicCompile << " ms, mapped " << mappedCompile << " ms)" << std::endl;
+
+    glfwTerminate();
+    return linked == compileCount ? 0 : -1;
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+// DIR/lib/common.glsl, DIR/lib/module_M.glsl (each including common.glsl) and DIR/program_P.vert/.frag, which include
+// includeCount modules picked by a fixed pseudo random sequence and call one function of each
+bool generateLibrary()
+{
+    mkdir(libraryDir.c_str(), 0755);
+    mkdir((libraryDir + "/lib").c_str(), 0755);
+    std::ofstream common((libraryDir + "/lib/common.glsl").c_str());
+    common << "// shared by every module\n"
+              "const float PI = 3.14159265;\n"
+              "float saturate(float x) { return clamp(x, 0.0, 1.0); }\n"
+              "vec3 saturate(vec3 x) { return clamp(x, vec3(0.0), vec3(1.0)); }\n";
+    if (!common)
+    {
+        std::cout << "ERROR::SHADERLOAD::LIBRARY_NOT_WRITTEN: " << libraryDir << std::endl;
+        return false;
+    }
+    for (unsigned module = 0; module < moduleCount; ++module)
+    {
+        std::ofstream file((libraryDir + "/lib/module_" + std::to_string(module) + ".glsl").c_str());
+        file << "#include \"common.glsl\"\n\n";
+        for (unsigned function = 0; function < FUNCTIONS_PER_MODULE; ++function)
+        {
+            const std::string name = "m" + std::to_string(module) + "_f" + std::to_string(function);
+            file << "// " << name << ": a smooth wave of the input, scaled and biased\n"
+                 << "vec3 " << name << "(vec3 v)\n{\n"
+                 << "    vec3 wave = sin(v*" << (function + 1) << ".0 + vec3(" << module << ".0, 0.5, 0.25));\n"
+                 << "    float weight = saturate(dot(wave, vec3(0.299, 0.587, 0.114)));\n"
+                 << "    return mix(v, saturate(wave*0.5 + 0.5), weight*" << (function % 4 + 1) << ".0/PI);\n}\n\n";
+        }
+    }
+    uint32_t random = 12345u;
+    for (unsigned program = 0; program < programCount; ++program)
+    {
+        std::string includes, calls;
+        for (unsigned i = 0; i < includeCount; ++i)
+        {
+            random = random*1664525u + 1013904223u;
+            const unsigned module = (random >> 8) % moduleCount;
+            includes += "#include \"lib/module_" + std::to_string(module) + ".glsl\"\n";
+            calls += "    v = m" + std::to_string(module) + "_f" + std::to_string(i % FUNCTIONS_PER_MODULE) + "(v);\n";
+        }
+        std::ofstream vertex(programPath(program, "vert").c_str());
+        vertex << "#version 330 core\nlayout (location = 0) in vec3 aPos;\nout vec3 color;\n\n" << includes
+               << "\nvoid main()\n{\n    vec3 v = aPos;\n" << calls << "    color = v;\n    gl_Position = vec4(aPos, 1.0);\n}\n";
+        std::ofstream fragment(programPath(program, "frag").c_str());
+        fragment << "#version 330 core\nin vec3 color;\nout vec4 FragColor;\n\n" << includes
+                 << "\nvoid main()\n{\n    vec3 v = color;\n" << calls << "    FragColor = vec4(v, 1.0);\n}\n";
+        if (!vertex || !fragment)
+        {
+            std::cout << "ERROR::SHADERLOAD::LIBRARY_NOT_WRITTEN: " << libraryDir << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string programPath(unsigned program, const char *stage)
+{
+    return libraryDir + "/program_" + std::to_string(program) + "." + stage;
+}
+
+// the file through ifstream, stringstream and string as the samples' Shader did, includes pasted in (once per shader)
+std::string readClassic(const std::string &path, std::unordered_set<std::string> &included)
+{
+    std::ifstream file(path.c_str());
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string text = stream.str();
+    ++classicReads;
+    classicBytesCopied += 2*text.size();
+
+    std::string result;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        const size_t quote = line.find('"');
+        if (line.compare(0, 8, "#include") == 0 && quote != std::string::npos)
+        {
+            const std::string name = line.substr(quote + 1, line.find('"', quote + 1) - quote - 1);
+            const std::string includePath = path.substr(0, path.find_last_of('/') + 1) + name;
+            if (included.insert(includePath).second)
+                result += readClassic(includePath, included);
+        }
+        else
+            result += line + "\n";
+    }
+    classicBytesCopied += result.size();
+    return result;
+}
+
+GLuint compileClassic(const std::string &vertexPath, const std::string &fragmentPath)
+{
+    GLuint shaders[2];
+    const std::string paths[2] = { vertexPath, fragmentPath };
+    for (int i = 0; i < 2; ++i)
+    {
+        std::unordered_set<std::string> included;
+        const std::string code = readClassic(paths[i], included);
+        const char *text = code.c_str();
+        shaders[i] = glCreateShader(i == 0 ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
+        glShaderSource(shaders[i], 1, &text, nullptr);
+        glCompileShader(shaders[i]);
+    }
+    return linkProgram(shaders[0], shaders[1]);
+}
+
+GLuint compileMapped(ShaderSourceCache &cache, const std::string &vertexPath, const std::string &fragmentPath)
+{
+    GLuint shaders[2];
+    const std::string paths[2] = { vertexPath, fragmentPath };
+    ShaderSource source;
+    for (int i = 0; i < 2; ++i)
+    {
+        cache.load(paths[i], source);
+        shaders[i] = glCreateShader(i == 0 ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
+        source.setSource(shaders[i]);
+        glCompileShader(shaders[i]);
+    }
+    return linkProgram(shaders[0], shaders[1]);
+}
+
+// the linked program of both shaders (deleted) or 0
+GLuint linkProgram(GLuint vertex, GLuint fragment)
+{
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[1024];
+        glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
+        std::cout << "ERROR::SHADERLOAD::PROGRAM_LINKING_FAILED\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+double median(std::vector<double> times)
+{
+    std::sort(times.begin(), times.end());
+    return times[times.size()/2];
+}
@@ -0,0 +1,597 @@
+// Render the same scene description through OpenGL or through a tile based, multithreaded SIMD software rasterizer on the CPU
+// Use: Shader class and files, camera object, Scene (renderer independent meshes/objects), SoftwareRasterizer and SoftwareTexture
+//      (binning, edge functions, depth test, perspective correct bilinear texturing, GL_LINES), per-tile timing report
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+#include <software_rasterizer.h>
+
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_softraster";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    // initial mix value for how much we're seeing of either texture
+    float mixValueFromKey = 0.2f;
+
+    // setup for keyboard (w-a-s-d) movement
+    float deltaTime = 0.0f;	// Time between current frame and last frame
+    float lastFrame = 0.0f; // Time of last frame
+
+    // setup for mouse movement
+    float lastX = SCR_WIDTH/2.0f;
+    float lastY = SCR_HEIGHT/2.0f;
+    bool firstTimeMouseMoved(true);
+
+    // backend of the interactive mode, switched with the B key
+    bool useSoftwareBackend(false);
+}
+
+// OpenGL backend: one VAO/VBO per scene mesh (as in the samples) and the shaders of hello_camera_class
+class GLSceneRenderer
+{
+public:
+    GLSceneRenderer(const Scene &scene, const std::string &relPathExePro);
+    void render(const Scene &scene, const glm::mat4 &view, const glm::mat4 &projection);
+    void destroy();
+
+private:
+    Shader shader;
+    std::vector<GLuint> VAOs;
+    std::vector<GLuint> VBOs;
+    GLuint textures[2];
+};
+
+// Software backend: the same scene drawn with the same uniforms by the SoftwareRasterizer
+class SoftwareSceneRenderer
+{
+public:
+    SoftwareSceneRenderer(const Scene &scene, const std::string &relPathExePro, int tileSize, unsigned threadCount);
+    void render(const Scene &scene, const glm::mat4 &view, const glm::mat4 &projection);
+
+    SoftwareRasterizer Rasterizer;
+    size_t PrimitiveCount; // primitives binned by the last render
+
+private:
+    SoftwareTexture textures[2];
+};
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+GLFWwindow* createWindow(bool visible);
+GLuint loadTexture(const std::string &path);
+void loadSoftwareTexture(const std::string &path, SoftwareTexture &texture);
+Scene makeScene(unsigned gridSize);
+glm::mat4 benchmarkView(int frame, int frames, unsigned gridSize);
+void printTileReport(const SoftwareRasterizer &rasterizer, const std::vector<double> &tileTimes, int frames);
+void writePPM(const std::string &path, const std::vector<uint32_t> &pixels, int width, int height);
+
+int drawScene(unsigned gridSize);
+int benchmarkSoftware(unsigned gridSize, int frames, int tileSize, unsigned threadCount);
+int compareBackends(unsigned gridSize, int frames);
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    {
+        mixValueFromKey += 0.005f;
+        if(mixValueFromKey >= 1.0f)
+            mixValueFromKey = 1.0f;
+    }
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    {
+        mixValueFromKey -= 0.005f;
+        if (mixValueFromKey <= 0.0f)
+            mixValueFromKey = 0.0f;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
+
+// glfw: whenever the mouse moves, this callback is called
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if(firstTimeMouseMoved)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstTimeMouseMoved = false;
+    }
+
+    float xMouseOffset = xpos - lastX;
+    float yMouseOffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xMouseOffset, yMouseOffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+void scroll_callback(GLFWwindow* window, double xScrollOffset, double yScrollOffset)
+{
+    camera.ProcessMouseScroll(yScrollOffset);
+}
+
+// glfw: the B key switches between the OpenGL and the software backend
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+        useSoftwareBackend = !useSoftwareBackend;
+}
+
+// glfw + glad: create a window with an OpenGL 3.3 core context and load all function pointers
+GLFWwindow* createWindow(bool visible)
+{
+    GLFWwindow* window = createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", visible);
+    if (window != nullptr)
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    return window;
+}
+
+// load image, create texture (RGB or RGBA depending on the file) and generate mipmaps
+GLuint loadTexture(const std::string &path)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data)
+    {
+        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+        std::cout << "Failed to load texture" << std::endl;
+    }
+    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// load image into a texture of the software rasterizer (same orientation as the GL texture)
+void loadSoftwareTexture(const std::string &path, SoftwareTexture &texture)
+{
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    if (data && (nrChannels == 3 || nrChannels == 4))
+        texture.setImage(data, width, height, nrChannels);
+    else
+        std::cout << "Failed to load texture" << std::endl;
+    stbi_image_free(data);
+}
+
+GLSceneRenderer::GLSceneRenderer(const Scene &scene, const std::string &relPathExePro)
+    : shader((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str())
+{
+    VAOs.resize(scene.Meshes.size());
+    VBOs.resize(scene.Meshes.size());
+    glGenVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glGenBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    for (size_t i = 0; i < scene.Meshes.size(); ++i)
+    {
+        glBindVertexArray(VAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, scene.Meshes[i].Vertices.size()*sizeof(float), scene.Meshes[i].Vertices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    textures[0] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[0]);
+    textures[1] = loadTexture(relPathExePro+"../../common/"+scene.TexturePaths[1]);
+
+    // tell opengl for each sampler (uniforms) to which texture unit it belongs to
+    shader.use();
+    shader.setInt("texture1", 0);
+    shader.setInt("texture2", 1);
+}
+
+void GLSceneRenderer::render(const Scene &scene, const glm::mat4 &view, const glm::mat4 &projection)
+{
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // activate texture units and bind them
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+    shader.use();
+    shader.setFloat("mixValue", scene.MixValue);
+    shader.setMat4("view", view);
+    shader.setMat4("projection", projection);
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        const SceneObject &object = scene.Objects[i];
+        const SceneMesh &mesh = scene.Meshes[object.Mesh];
+        shader.setMat4("model", object.Model);
+        glBindVertexArray(VAOs[object.Mesh]);
+        glDrawArrays(mesh.Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, 0, mesh.vertexCount());
+    }
+    glBindVertexArray(0);
+}
+
+void GLSceneRenderer::destroy()
+{
+    glDeleteVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glDeleteBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    glDeleteTextures(2, textures);
+    glDeleteProgram(shader.ID);
+}
+
+SoftwareSceneRenderer::SoftwareSceneRenderer(const Scene &scene, const std::string &relPathExePro, int tileSize, unsigned threadCount)
+    : Rasterizer(SCR_WIDTH, SCR_HEIGHT, tileSize, threadCount), PrimitiveCount(0)
+{
+    loadSoftwareTexture(relPathExePro+"../../common/"+scene.TexturePaths[0], textures[0]);
+    loadSoftwareTexture(relPathExePro+"../../common/"+scene.TexturePaths[1], textures[1]);
+}
+
+void SoftwareSceneRenderer::render(const Scene &scene, const glm::mat4 &view, const glm::mat4 &projection)
+{
+    Rasterizer.clear(scene.ClearColor);
+    Rasterizer.bindTexture(0, &textures[0]);
+    Rasterizer.bindTexture(1, &textures[1]);
+    Rasterizer.setMixValue(scene.MixValue);
+    Rasterizer.setView(view);
+    Rasterizer.setProjection(projection);
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        const SceneObject &object = scene.Objects[i];
+        const SceneMesh &mesh = scene.Meshes[object.Mesh];
+        Rasterizer.setModel(object.Model);
+        Rasterizer.drawArrays(mesh.Primitive, mesh.Vertices.data(), 0, mesh.vertexCount());
+    }
+    PrimitiveCount = Rasterizer.getPrimitiveCount();
+    Rasterizer.finish();
+}
+
+// gridSize 0 = the ten containers of hello_camera_class with coordinate axes, otherwise a grid of gridSize^3 containers
+Scene makeScene(unsigned gridSize)
+{
+    return gridSize == 0 ? makeContainersScene() : makeCubeGridScene(gridSize);
+}
+
+// deterministic camera path of the benchmarks: one orbit around the scene
+glm::mat4 benchmarkView(int frame, int frames, unsigned gridSize)
+{
+    const float angle = glm::radians(360.0f*frame/frames);
+    const float radius = gridSize == 0 ? 6.0f : 1.5f*gridSize + 4.0f;
+    const glm::vec3 target = gridSize == 0 ? glm::vec3(0.0f, 0.0f, -3.0f) : glm::vec3(0.0f, 0.0f, -0.75f*gridSize - 2.0f);
+    return glm::lookAt(target + glm::vec3(radius*std::sin(angle), 1.5f, radius*std::cos(angle)), target, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+// Prints the average time per tile as a grid (top row of the screen first) and the spread between the tiles
+void printTileReport(const SoftwareRasterizer &rasterizer, const std::vector<double> &tileTimes, int frames)
+{
+    const int tilesX = rasterizer.getTilesX(), tilesY = rasterizer.getTilesY();
+    double minTime = tileTimes[0], maxTime = tileTimes[0], sum = 0.0;
+    for (size_t i = 0; i < tileTimes.size(); ++i)
+    {
+        minTime = std::min(minTime, tileTimes[i]);
+        maxTime = std::max(maxTime, tileTimes[i]);
+        sum += tileTimes[i];
+    }
+
+    std::cout << "average time per tile [ms] (" << tilesX << "x" << tilesY << " tiles of " << rasterizer.getTileSize() << "x" << rasterizer.getTileSize() << " pixels):" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (int ty = tilesY - 1; ty >= 0; --ty)
+    {
+        for (int tx = 0; tx < tilesX; ++tx)
+            std::cout << std::setw(7) << tileTimes[ty*tilesX + tx]/frames;
+        std::cout << std::endl;
+    }
+    std::cout << "tile time min/mean/max [ms]: " << minTime/frames << " / " << sum/tileTimes.size()/frames << " / " << maxTime/frames
+              << ", sum over all tiles: " << sum/frames << " ms on " << rasterizer.getThreadCount() << " threads" << std::endl;
+}
+
+// Writes RGBA8 pixels (row 0 at the bottom) as binary PPM
+void writePPM(const std::string &path, const std::vector<uint32_t> &pixels, int width, int height)
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (int y = height - 1; y >= 0; --y)
+        for (int x = 0; x < width; ++x)
+        {
+            const uint32_t p = pixels[y*width + x];
+            const char rgb[3] = { static_cast<char>(p & 0xff), static_cast<char>((p >> 8) & 0xff), static_cast<char>((p >> 16) & 0xff) };
+            file.write(rgb, 3);
+        }
+}
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // --software : headless software rendering without any OpenGL context (e.g. on servers without a GPU), FPS and per-tile timing
+    // --compare  : headless rendering of the same frames through OpenGL and the software rasterizer, FPS and image difference
+    // --grid N   : grid of N^3 containers instead of the hello_camera_class scene
+    // --frames N, --tile N, --threads N : benchmark length, tile size and number of software rasterizer threads
+    std::string mode;
+    unsigned gridSize = 0, threadCount = std::thread::hardware_concurrency();
+    int frames = 100, tileSize = 64;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--software") == 0 || strcmp(argv[i], "--compare") == 0)
+            mode = argv[i];
+        else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc)
+            gridSize = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc)
+            tileSize = std::max(4, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+    }
+
+    if (mode == "--software")
+        return benchmarkSoftware(gridSize, frames, tileSize, threadCount);
+    if (mode == "--compare")
+        return compareBackends(gridSize, frames);
+    return drawScene(gridSize);
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+int drawScene(unsigned gridSize)
+{
+    // Drawing the scene with a mouse controlled camera object; the B key switches between OpenGL and the software rasterizer,
+    // whose frames are copied into a texture and blitted to the window
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(true);
+    if (window == nullptr)
+        return -1;
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+
+    // tell GLFW to capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeScene(gridSize);
+    GLSceneRenderer glRenderer(scene, relPathExePro);
+    SoftwareSceneRenderer softwareRenderer(scene, relPathExePro, 64, std::thread::hardware_concurrency());
+
+    // the software frames are presented through a texture attached to a read framebuffer
+    GLuint presentTexture, presentFBO;
+    glGenTextures(1, &presentTexture);
+    glBindTexture(GL_TEXTURE_2D, presentTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, softwareRenderer.Rasterizer.getWidth(), softwareRenderer.Rasterizer.getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &presentFBO);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, presentFBO);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, presentTexture, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    const float aspectRatio = (float)SCR_WIDTH/(float)SCR_HEIGHT;
+    double lastTitleUpdate = glfwGetTime();
+    int framesSinceTitleUpdate = 0;
+
+    // render loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // input
+        processInput(window);
+
+        scene.MixValue = mixValueFromKey;
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = camera.GetProjectionMatrix(aspectRatio);
+
+        if (useSoftwareBackend)
+        {
+            softwareRenderer.render(scene, view, projection);
+            glBindTexture(GL_TEXTURE_2D, presentTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, softwareRenderer.Rasterizer.getWidth(), softwareRenderer.Rasterizer.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE,
+                            softwareRenderer.Rasterizer.getColorBuffer().data());
+            glBindTexture(GL_TEXTURE_2D, 0);
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, presentFBO);
+            glBlitFramebuffer(0, 0, SCR_WIDTH, SCR_HEIGHT, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        }
+        else
+        {
+            glRenderer.render(scene, view, projection);
+        }
+
+        // show the backend and its frame rate once per second
+        ++framesSinceTitleUpdate;
+        if (glfwGetTime() - lastTitleUpdate >= 1.0)
+        {
+            std::string title = std::string("LearnOpenGL - ") + (useSoftwareBackend ? "software rasterizer" : "OpenGL") + " (B to switch) - " +
+                                std::to_string(static_cast<int>(framesSinceTitleUpdate/(glfwGetTime() - lastTitleUpdate))) + " FPS";
+            glfwSetWindowTitle(window, title.c_str());
+            lastTitleUpdate = glfwGetTime();
+            framesSinceTitleUpdate = 0;
+        }
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // de-allocate all resources once they've outlived their purpose:
+    glRenderer.destroy();
+    glDeleteFramebuffers(1, &presentFBO);
+    glDeleteTextures(1, &presentTexture);
+
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+int benchmarkSoftware(unsigned gridSize, int frames, int tileSize, unsigned threadCount)
+{
+    // Benchmark of the software backend alone: no window and no OpenGL context are created. The camera orbits the scene once,
+    // the FPS and the average time of every tile are reported and the last frame is written to perf_softraster.ppm
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    Scene scene = makeScene(gridSize);
+    SoftwareSceneRenderer renderer(scene, relPathExePro, tileSize, threadCount);
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
+
+    std::vector<double> tileTimes(renderer.Rasterizer.getTileTimes().size(), 0.0);
+    double frameTime = 0.0, maxFrameTime = 0.0;
+    size_t primitives = 0;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        auto start = std::chrono::steady_clock::now();
+        renderer.render(scene, benchmarkView(frame, frames, gridSize), projection);
+        double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        frameTime += time;
+        maxFrameTime = std::max(maxFrameTime, time);
+        primitives += renderer.PrimitiveCount;
+        for (size_t i = 0; i < tileTimes.size(); ++i)
+            tileTimes[i] += renderer.Rasterizer.getTileTimes()[i];
+    }
+
+    std::cout << "software rasterizer: " << SCR_WIDTH << "x" << SCR_HEIGHT << ", " << scene.Objects.size() << " objects, "
+              << primitives/frames << " primitives binned per frame, " << frames << " frames" << std::endl;
+    std::cout << std::fixed << std::setprecision(2) << "FPS: " << 1000.0*frames/frameTime << " (frame time average " << frameTime/frames
+              << " ms, max " << maxFrameTime << " ms)" << std::endl;
+    printTileReport(renderer.Rasterizer, tileTimes, frames);
+
+    writePPM(project_name+".ppm", renderer.Rasterizer.getColorBuffer(), renderer.Rasterizer.getWidth(), renderer.Rasterizer.getHeight());
+    std::cout << "last frame written to " << project_name << ".ppm" << std::endl;
+    return 0;
+}
+
+int compareBackends(unsigned gridSize, int frames)
+{
+    // Renders the same frames of the same scene through OpenGL (hidden window, glFinish per frame) and the software rasterizer,
+    // reports the FPS of both and how far the images of the last frame differ
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow(false);
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Scene scene = makeScene(gridSize);
+    GLSceneRenderer glRenderer(scene, relPathExePro);
+    SoftwareSceneRenderer softwareRenderer(scene, relPathExePro, 64, std::thread::hardware_concurrency());
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
+
+    double glTime = 0.0, softwareTime = 0.0;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        const glm::mat4 view = benchmarkView(frame, frames, gridSize);
+
+        auto start = std::chrono::steady_clock::now();
+        glRenderer.render(scene, view, projection);
+        glFinish();
+        glTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        softwareRenderer.render(scene, view, projection);
+        softwareTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // compare the color channels of the last frame
+    std::vector<uint32_t> glPixels(SCR_WIDTH*SCR_HEIGHT);
+    glReadPixels(0, 0, SCR_WIDTH, SCR_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, glPixels.data());
+    const std::vector<uint32_t> &softwarePixels = softwareRenderer.Rasterizer.getColorBuffer();
+    double difference = 0.0;
+    size_t differentPixels = 0;
+    for (size_t i = 0; i < glPixels.size(); ++i)
+    {
+        int maxChannelDifference = 0;
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            int d = std::abs(static_cast<int>((glPixels[i] >> (8*channel)) & 0xff) - static_cast<int>((softwarePixels[i] >> (8*channel)) & 0xff));
+            difference += d;
+            maxChannelDifference = std::max(maxChannelDifference, d);
+        }
+        if (maxChannelDifference > 16)
+            ++differentPixels;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "OpenGL (" << glGetString(GL_RENDERER) << "): " << 1000.0*frames/glTime << " FPS" << std::endl;
+    std::cout << "software rasterizer (" << softwareRenderer.Rasterizer.getThreadCount() << " threads): " << 1000.0*frames/softwareTime << " FPS" << std::endl;
+    std::cout << "last frame: mean channel difference " << difference/(3.0*glPixels.size()) << "/255, "
+              << 100.0*differentPixels/glPixels.size() << "% of the pixels differ by more than 16/255" << std::endl;
+
+    writePPM(project_name+"_gl.ppm", glPixels, SCR_WIDTH, SCR_HEIGHT);
+    writePPM(project_name+"_software.ppm", softwarePixels, SCR_WIDTH, SCR_HEIGHT);
+
+    glRenderer.destroy();
+    glfwTerminate();
+    return 0;
+}
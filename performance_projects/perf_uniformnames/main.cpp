@@ -0,0 +1,305 @@
+// Heap allocations of the uniform setters in a draw loop: a grid of containers is drawn headless with the model matrix and
+// the color of every container set by name (members of a struct uniform, "object.modelMatrix", too long for the small
+// string buffer of std::string), once the way Shader::set* did it before (a std::string built from the
+// literal and glGetUniformLocation on every call), then through the UniformName setters (string literals, std::string_view
+// and constexpr hashed names looked up in the reflected uniforms of the program). Global operator new is counted over the
+// frames, the run fails if a frame of the UniformName setters allocates or a name isn't an active uniform of the program.
+// Every frame also sets a misspelled name ("mixvalue"): its first miss is remembered in the warm-up frame, the run fails if
+// a later miss allocates again or another name is missing.
+// The time of the setters is measured in frames without the draw calls, which would hide it on a software rasterizer
+// Use: Shader class and files (UniformName setters), camera object, Scene
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <gl_window.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <shader.h>
+#include <camera.h>
+#include <scene.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    std::string project_folder = "performance_projects";
+    std::string project_name = "perf_uniformnames";
+
+    // screen settings
+    const GLuint SCR_WIDTH = 800;
+    const GLuint SCR_HEIGHT = 600;
+
+    unsigned gridSize = 12;     // --grid N: N^3 containers
+    unsigned frameCount = 100;  // --frames N: frames drawn with every kind of setter
+
+    // operator new calls since the start
+    std::atomic<uint64_t> allocationCount(0);
+
+    // names hashed at compile time
+    constexpr UniformName MODEL("object.modelMatrix");
+    constexpr UniformName COLOR("object.diffuseColor");
+    constexpr UniformName VIEW("view");
+    constexpr UniformName PROJECTION("projection");
+    constexpr UniformName MIX_VALUE("mixValue");
+    constexpr UniformName MISSPELLED("mixvalue");  // not a uniform of the program: set* does nothing
+}
+
+// every allocation of the program goes through these
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    if (void *memory = malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+// how the uniforms of a frame are set
+enum SetterKind { SETTER_STRING, SETTER_LITERAL, SETTER_STRING_VIEW, SETTER_CONSTEXPR, SETTER_KIND_COUNT };
+
+const char *setterNames[SETTER_KIND_COUNT] = { "std::string + glGetUniformLocation", "string literal", "std::string_view",
+                                               "constexpr UniformName" };
+
+struct SetterResult
+{
+    double SetterTime;       // milliseconds per frame of setting the uniforms without drawing
+    double AllocationCount;  // operator new calls per frame
+};
+
+GLFWwindow* createWindow();
+void drawFrame(const Scene &scene, const Shader &shader, const std::vector<GLuint> &VAOs, Camera &camera, unsigned frame,
+               SetterKind kind, bool draw);
+void setMat4String(const Shader &shader, const std::string &name, const glm::mat4 &mat);
+void setVec4String(const Shader &shader, const std::string &name, const glm::vec4 &value);
+void setFloatString(const Shader &shader, const std::string &name, float value);
+
+//  ----------------------------------------MAIN METHOD--------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // perf_uniformnames [--grid N] [--frames N]
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--grid") == 0)
+            gridSize = static_cast<unsigned>(std::max(1, atoi(argv[i + 1])));
+        else if (strcmp(argv[i], "--frames") == 0)
+            frameCount = static_cast<unsigned>(std::max(1, atoi(argv[i + 1])));
+    }
+
+    // set relative path of project from the location of the executable file
+    std::string relPathExePro("../../LearnOpenGL/"+project_folder+"/"+project_name+"/");
+
+    GLFWwindow* window = createWindow();
+    if (window == nullptr)
+        return -1;
+    glEnable(GL_DEPTH_TEST);
+
+    Shader ShaderProgram((relPathExePro+project_name+".vert").c_str(), (relPathExePro+project_name+".frag").c_str());
+    Scene scene = makeCubeGridScene(gridSize);
+    std::vector<GLuint> VAOs(scene.Meshes.size()), VBOs(scene.Meshes.size());
+    glGenVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glGenBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    for (size_t i = 0; i < scene.Meshes.size(); ++i)
+    {
+        glBindVertexArray(VAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, scene.Meshes[i].Vertices.size()*sizeof(float), scene.Meshes[i].Vertices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)nullptr);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, SceneMesh::VERTEX_SIZE * sizeof(float), (void*)(3*sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindVertexArray(0);
+
+    Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+    SetterResult results[SETTER_KIND_COUNT];
+    for (int kind = 0; kind < SETTER_KIND_COUNT; ++kind)
+    {
+#if __cplusplus < 201703L
+        if (kind == SETTER_STRING_VIEW)
+            continue; // std::string_view needs C++17
+#endif
+        // one frame first: the driver allocates on the first draws
+        const SetterKind setters = static_cast<SetterKind>(kind);
+        drawFrame(scene, ShaderProgram, VAOs, camera, 0, setters, true);
+        glFinish();
+        const uint64_t allocations = allocationCount;
+        for (unsigned frame = 0; frame < frameCount; ++frame)
+        {
+            drawFrame(scene, ShaderProgram, VAOs, camera, frame, setters, true);
+            glFinish();
+        }
+        results[kind].AllocationCount = double(allocationCount - allocations)/frameCount;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned frame = 0; frame < frameCount; ++frame)
+            drawFrame(scene, ShaderProgram, VAOs, camera, frame, setters, false);
+        results[kind].SetterTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()/frameCount;
+        glFinish();
+    }
+
+    std::cout << scene.Objects.size() << " containers, " << 2*scene.Objects.size() + 4 << " uniforms set per frame, "
+              << frameCount << " frames each" << std::endl;
+    std::cout << std::setw(38) << std::left << "names" << std::right << std::setw(14) << "setters [ms]" << std::setw(20)
+              << "allocations/frame" << std::endl;
+    std::cout << std::fixed;
+    bool passed = true;
+    for (int kind = 0; kind < SETTER_KIND_COUNT; ++kind)
+    {
+#if __cplusplus < 201703L
+        if (kind == SETTER_STRING_VIEW)
+            continue;
+#endif
+        std::cout << std::setw(38) << std::left << setterNames[kind] << std::right << std::setprecision(3) << std::setw(14)
+                  << results[kind].SetterTime << std::setprecision(1) << std::setw(20) << results[kind].AllocationCount << std::endl;
+        if (kind != SETTER_STRING && results[kind].AllocationCount > 0.0)
+            passed = false;
+    }
+    // the misspelled name is the only one expected to be missing
+    const std::vector<std::string> &missingUniforms = ShaderProgram.getMissingUniforms();
+    for (size_t i = 0; i < missingUniforms.size(); ++i)
+        if (missingUniforms[i] != MISSPELLED.Name)
+        {
+            std::cout << "ERROR::UNIFORMNAMES::UNIFORM_NOT_ACTIVE: " << missingUniforms[i] << std::endl;
+            passed = false;
+        }
+    if (std::count(missingUniforms.begin(), missingUniforms.end(), std::string(MISSPELLED.Name)) != 1)
+    {
+        std::cout << "ERROR::UNIFORMNAMES::MISSING_UNIFORM_NOT_REMEMBERED: " << MISSPELLED.Name << std::endl;
+        passed = false;
+    }
+    std::cout << (passed ? "no heap allocation in the frames of the UniformName setters"
+                         : "ERROR::UNIFORMNAMES::ALLOCATIONS_IN_DRAW_LOOP") << std::endl;
+
+    glDeleteVertexArrays(static_cast<GLsizei>(VAOs.size()), VAOs.data());
+    glDeleteBuffers(static_cast<GLsizei>(VBOs.size()), VBOs.data());
+    glDeleteProgram(ShaderProgram.ID);
+    glfwTerminate();
+    return passed ? 0 : -1;
+}
+
+//  -----------------------------------------------------------------------------------------------
+
+// glfw + glad: an invisible window with an OpenGL 3.3 core context
+GLFWwindow* createWindow()
+{
+    return createGLWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false);
+}
+
+// draws the grid from a camera circling it, every container with its own color (with draw false only the uniforms are set)
+void drawFrame(const Scene &scene, const Shader &shader, const std::vector<GLuint> &VAOs, Camera &camera, unsigned frame,
+               SetterKind kind, bool draw)
+{
+    glClearColor(scene.ClearColor.r, scene.ClearColor.g, scene.ClearColor.b, scene.ClearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const float angle = glm::radians(3.0f*frame);
+    const float radius = 1.2f*gridSize + 4.0f;
+    const glm::vec3 center(0.0f, 0.0f, -0.75f*gridSize - 1.25f);
+    camera.SetState(center + radius*glm::vec3(std::sin(angle), 0.0f, std::cos(angle)), glm::degrees(angle) + 90.0f + 180.0f, 0.0f, 45.0f);
+    const glm::mat4 view = camera.GetViewMatrix();
+    const glm::mat4 projection = camera.GetProjectionMatrix((float)SCR_WIDTH/(float)SCR_HEIGHT);
+
+    glUseProgram(shader.ID);
+#if __cplusplus >= 201703L
+    const std::string_view viewName("view"), projectionName("projection"), mixValueName("mixValue"), misspelledName("mixvalue");
+    const std::string_view modelName("object.modelMatrix"), colorName("object.diffuseColor");
+#endif
+    switch (kind)
+    {
+    case SETTER_STRING:
+        setMat4String(shader, "view", view);
+        setMat4String(shader, "projection", projection);
+        setFloatString(shader, "mixValue", scene.MixValue);
+        setFloatString(shader, "mixvalue", scene.MixValue);
+        break;
+    case SETTER_LITERAL:
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+        shader.setFloat("mixValue", scene.MixValue);
+        shader.setFloat("mixvalue", scene.MixValue);
+        break;
+    case SETTER_STRING_VIEW:
+#if __cplusplus >= 201703L
+        shader.setMat4(viewName, view);
+        shader.setMat4(projectionName, projection);
+        shader.setFloat(mixValueName, scene.MixValue);
+        shader.setFloat(misspelledName, scene.MixValue);
+#endif
+        break;
+    default:
+        shader.setMat4(VIEW, view);
+        shader.setMat4(PROJECTION, projection);
+        shader.setFloat(MIX_VALUE, scene.MixValue);
+        shader.setFloat(MISSPELLED, scene.MixValue);
+        break;
+    }
+
+    for (size_t i = 0; i < scene.Objects.size(); ++i)
+    {
+        const SceneObject &object = scene.Objects[i];
+        const glm::vec4 color(0.5f + 0.5f*std::sin(0.37f*i), 0.5f + 0.5f*std::sin(0.53f*i), 0.5f + 0.5f*std::sin(0.71f*i), 1.0f);
+        switch (kind)
+        {
+        case SETTER_STRING:
+            setMat4String(shader, "object.modelMatrix", object.Model);
+            setVec4String(shader, "object.diffuseColor", color);
+            break;
+        case SETTER_LITERAL:
+            shader.setMat4("object.modelMatrix", object.Model);
+            shader.setVec4("object.diffuseColor", color);
+            break;
+        case SETTER_STRING_VIEW:
+#if __cplusplus >= 201703L
+            shader.setMat4(modelName, object.Model);
+            shader.setVec4(colorName, color);
+#endif
+            break;
+        default:
+            shader.setMat4(MODEL, object.Model);
+            shader.setVec4(COLOR, color);
+            break;
+        }
+        if (!draw)
+            continue;
+        glBindVertexArray(VAOs[object.Mesh]);
+        glDrawArrays(scene.Meshes[object.Mesh].Primitive == SCENE_LINES ? GL_LINES : GL_TRIANGLES, 0, scene.Meshes[object.Mesh].vertexCount());
+    }
+    glBindVertexArray(0);
+}
+
+// the setters as they were before UniformName: the literal becomes a std::string, its location is queried on every call
+void setMat4String(const Shader &shader, const std::string &name, const glm::mat4 &mat)
+{
+    glUniformMatrix4fv(glGetUniformLocation(shader.ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+}
+
+void setVec4String(const Shader &shader, const std::string &name, const glm::vec4 &value)
+{
+    glUniform4fv(glGetUniformLocation(shader.ID, name.c_str()), 1, &value[0]);
+}
+
+void setFloatString(const Shader &shader, const std::string &name, float value)
+{
+    glUniform1f(glGetUniformLocation(shader.ID, name.c_str()), value);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+
+// how much the color of the container fades towards its edges
+uniform float mixValue;
+
+void main()
+{
+    vec2 edge = min(TexCoord, 1.0 - TexCoord);
+    FragColor = Color*mix(1.0, smoothstep(0.0, 0.1, min(edge.x, edge.y)), mixValue);
+}
@@ -0,0 +1,24 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../../common/common.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../common/glad/glad.h \
+    ../../common/KHR/khrplatform.h \
+    ../../common/gl_window.h \
+    ../../common/shader.h \
+    ../../common/mapped_file.h \
+    ../../common/shader_source.h \
+    ../../common/uniform_name.h \
+    ../../common/camera.h \
+    ../../common/scene.h
+
+DISTFILES += \
+    perf_uniformnames.vert \
+    perf_uniformnames.frag
@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+// transformation and color of the container drawn
+struct Object
+{
+    mat4 modelMatrix;
+    vec4 diffuseColor;
+};
+uniform Object object;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection*view*object.modelMatrix*vec4(aPos, 1.0);
+    TexCoord = aTexCoord;
+    Color = object.diffuseColor;
+}